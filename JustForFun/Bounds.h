@@ -0,0 +1,204 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Vec.h"
+#include "Mat.h"
+
+#include <algorithm>
+
+namespace JFF
+{
+	/*
+	* Bounding volumes used by spatial queries.
+	* They store plain floats instead of Vec3 to keep them small and trivially copyable, because the Spatial subsystem
+	* stores and tests thousands of them every frame
+	*/
+
+	// Axis aligned bounding box
+	struct AABB
+	{
+		AABB() :
+			min{ 0.0f, 0.0f, 0.0f },
+			max{ 0.0f, 0.0f, 0.0f }
+		{}
+
+		AABB(const Vec3& min, const Vec3& max) :
+			min{ min.x, min.y, min.z },
+			max{ max.x, max.y, max.z }
+		{}
+
+		// Gets the smallest AABB that contains a and b
+		static AABB merge(const AABB& a, const AABB& b)
+		{
+			AABB result;
+			for (int i = 0; i < 3; ++i)
+			{
+				result.min[i] = std::min(a.min[i], b.min[i]);
+				result.max[i] = std::max(a.max[i], b.max[i]);
+			}
+			return result;
+		}
+
+		// Returns true if other is completely inside this AABB
+		bool contains(const AABB& other) const
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				if (other.min[i] < min[i] || other.max[i] > max[i])
+					return false;
+			}
+			return true;
+		}
+
+		bool overlaps(const AABB& other) const
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				if (other.max[i] < min[i] || other.min[i] > max[i])
+					return false;
+			}
+			return true;
+		}
+
+		// Half of the surface area. Only used to compare AABBs, so the constant factor is omitted
+		float surfaceArea() const
+		{
+			float dx = max[0] - min[0];
+			float dy = max[1] - min[1];
+			float dz = max[2] - min[2];
+			return dx * dy + dy * dz + dz * dx;
+		}
+
+		// Gets this AABB grown by margin on each side
+		AABB expanded(float margin) const
+		{
+			AABB result;
+			for (int i = 0; i < 3; ++i)
+			{
+				result.min[i] = min[i] - margin;
+				result.max[i] = max[i] + margin;
+			}
+			return result;
+		}
+
+		// Gets the AABB that contains this AABB transformed by m (Arvo's method: no need to transform the 8 corners)
+		AABB transformed(const Mat4& m) const
+		{
+			const float* mat = *m; // Column major
+
+			AABB result;
+			for (int i = 0; i < 3; ++i)
+			{
+				result.min[i] = result.max[i] = mat[12 + i]; // Translation
+				for (int j = 0; j < 3; ++j)
+				{
+					float a = mat[j * 4 + i] * min[j];
+					float b = mat[j * 4 + i] * max[j];
+					result.min[i] += std::min(a, b);
+					result.max[i] += std::max(a, b);
+				}
+			}
+			return result;
+		}
+
+		float min[3];
+		float max[3];
+	};
+
+	struct Sphere
+	{
+		Sphere(const Vec3& center, float radius) :
+			center{ center.x, center.y, center.z },
+			radius(radius)
+		{}
+
+		bool overlaps(const AABB& box) const
+		{
+			// Squared distance from center to the closest point of the box
+			float sqrDistance = 0.0f;
+			for (int i = 0; i < 3; ++i)
+			{
+				float closest = std::max(box.min[i], std::min(center[i], box.max[i]));
+				float d = center[i] - closest;
+				sqrDistance += d * d;
+			}
+			return sqrDistance <= radius * radius;
+		}
+
+		float center[3];
+		float radius;
+	};
+
+	struct Ray
+	{
+		// Direction doesn't need to be normalized, but then distances are measured in direction lengths
+		Ray(const Vec3& origin, const Vec3& direction) :
+			origin{ origin.x, origin.y, origin.z },
+			invDirection{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z }
+		{}
+
+		// Slab test. Returns true if the ray enters the box before maxDistance. outDistance is 0 if origin is inside the box
+		bool intersects(const AABB& box, float maxDistance, float& outDistance) const
+		{
+			float tMin = 0.0f;
+			float tMax = maxDistance;
+			for (int i = 0; i < 3; ++i)
+			{
+				float t1 = (box.min[i] - origin[i]) * invDirection[i];
+				float t2 = (box.max[i] - origin[i]) * invDirection[i];
+				tMin = std::max(tMin, std::min(t1, t2));
+				tMax = std::min(tMax, std::max(t1, t2));
+			}
+
+			outDistance = tMin;
+			return tMin <= tMax;
+		}
+
+		float origin[3];
+		float invDirection[3];
+	};
+
+	struct Frustum
+	{
+		// Extracts the 6 planes from a projection * view matrix (Gribb-Hartmann). Planes point inwards
+		explicit Frustum(const Mat4& viewProjection)
+		{
+			const float* m = *viewProjection; // Column major: row i is (m[i], m[4 + i], m[8 + i], m[12 + i])
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = 0; j < 4; ++j)
+				{
+					planes[i * 2][j]	 = m[j * 4 + 3] + m[j * 4 + i];
+					planes[i * 2 + 1][j] = m[j * 4 + 3] - m[j * 4 + i];
+				}
+			}
+		}
+
+		// Conservative test: some boxes near frustum corners are reported as overlapping even if they're outside
+		bool overlaps(const AABB& box) const
+		{
+			for (int p = 0; p < 6; ++p)
+			{
+				// Test the box corner that is furthest along the plane normal
+				float distance = planes[p][3];
+				for (int i = 0; i < 3; ++i)
+					distance += planes[p][i] * (planes[p][i] >= 0.0f ? box.max[i] : box.min[i]);
+
+				if (distance < 0.0f)
+					return false;
+			}
+			return true;
+		}
+
+		float planes[6][4]; // Left, right, bottom, top, near, far
+	};
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -47,6 +47,13 @@ namespace JFF
 		*/
 		virtual void removeCacheItem(const std::string& cacheItemName) = 0;
 
+		/*
+		* Removes an item from cache given its cache name, but only if the cache is its last owner.
+		* Call this after dropping your own reference to a cached object instead of destroying it:
+		* the object is effectively destroyed only when nobody else is sharing it
+		*/
+		virtual void releaseCacheItem(const std::string& cacheItemName) = 0;
+
 		/*
 		* Clear all cached items, effectively destroying the cacheable objects if they aren't referenced anymore
 		*/
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -67,6 +67,22 @@ void JFF::CacheSTD::removeCacheItem(const std::string& cacheItemName)
 	cachedItems.erase(cacheItemName);
 }
 
+void JFF::CacheSTD::releaseCacheItem(const std::string& cacheItemName)
+{
+	auto iter = cachedItems.find(cacheItemName);
+	if (iter == cachedItems.end())
+	{
+		JFF_LOG_WARNING("There is no cached items with name " << cacheItemName << ". Releasing aborted")
+		return;
+	}
+
+	// Keep the item cached while there are other owners sharing it
+	if (iter->second.use_count() > 1)
+		return;
+
+	cachedItems.erase(iter);
+}
+
 void JFF::CacheSTD::clearCache()
 {
 	cachedItems.clear();
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -40,6 +40,7 @@ namespace JFF
 
 		virtual void addCacheItem(const std::shared_ptr<Cacheable>& cacheItem) override;
 		virtual void removeCacheItem(const std::string& cacheItemName) override;
+		virtual void releaseCacheItem(const std::string& cacheItemName) override;
 		virtual void clearCache() override;
 		virtual std::shared_ptr<Cacheable> getCachedItem(const std::string& cachedItemName) override;
 
@@ -3,12 +3,13 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "CameraComponentGL.h"
+#include "MathFunctions.h"
 
 #include "Log.h"
 #include "Engine.h"
@@ -89,14 +90,13 @@ void JFF::CameraComponentGL::setActiveCamera()
 
 void JFF::CameraComponentGL::setOrthographicProjection(float left, float right, float bottom, float top, float zNear, float zFar)
 {
-	projectionMatrix = gameObject->engine->math.lock()->ortho(left, right, bottom, top, zNear, zFar);
+	projectionMatrix = JFF::ortho<4>(left, right, bottom, top, zNear, zFar);
 	dirtyProjectionMatrix = true;
 }
 
 void JFF::CameraComponentGL::setPerspectiveProjection(float FOVDeg, float aspectRatio, float zNear, float zFar)
 {
-	auto math = gameObject->engine->math.lock();
-	projectionMatrix = math->perspective(math->radians(FOVDeg), aspectRatio, zNear, zFar);
+	projectionMatrix = JFF::perspective<4>(JFF::radians(FOVDeg), aspectRatio, zNear, zFar);
 	dirtyProjectionMatrix = true;
 }
 
@@ -164,5 +164,5 @@ inline void JFF::CameraComponentGL::generateViewMatrix()
 	Vec4 gazeDir4 = gameObject->transform.getRotationMatrix() * Vec4::FORWARD;
 	Vec3 gazeDir(gazeDir4.pitch, gazeDir4.yaw, gazeDir4.roll);
 
-	viewMatrix = gameObject->engine->math.lock()->lookAt(eye, eye + gazeDir, Vec3::UP);
+	viewMatrix = JFF::lookAt<4>(eye, eye + gazeDir, Vec3::UP);
 }
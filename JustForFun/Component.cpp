@@ -3,21 +3,24 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "Component.h"
 
+#include "GameObject.h"
+
 #include "Log.h"
 
+std::atomic<unsigned int> JFF::ComponentTypeID::nextID(0u);
+
 JFF::Component::Component(GameObject* const gameObject, const char* name, bool initiallyEnabled) :
 	gameObject(gameObject),
 	name(name),
 	componentEnabledHint(initiallyEnabled),
-	componentEnabled(false),
-	executeFn(std::bind(&Component::initialize, this))
+	state(State::UNINITIALIZED)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor Component")
 }
@@ -29,29 +32,51 @@ JFF::Component::~Component()
 
 void JFF::Component::setEnabled(bool enabled)
 {
+	bool changed = componentEnabledHint != enabled;
 	componentEnabledHint = enabled;
+
+	// Let the GameObject know this component must change its state on next applyEnabledHint() pass
+	if (changed && state != State::UNINITIALIZED)
+		gameObject->queueComponentStateChange(this);
 }
 
 bool JFF::Component::isEnabled() const
 {
-	return componentEnabled;
+	return state == State::ENABLED;
 }
 
 void JFF::Component::execute()
 {
-	executeFn();
+	switch (state)
+	{
+	case State::UNINITIALIZED:
+		start();
+		update();
+		break;
+	case State::ENABLED:
+	case State::DISABLED:
+		applyEnabledHint();
+		update();
+		break;
+	default:
+		break;
+	}
 }
 
 void JFF::Component::destroy() noexcept
 {
-	if (componentEnabled)
+	if (state == State::ENABLED)
 		disable();
 
 	onDestroy();
 }
 
-void JFF::Component::initialize()
+void JFF::Component::start()
 {
+	// A component may have already started if it was executed explicitly
+	if (state != State::UNINITIALIZED)
+		return;
+
 	onStart();
 	if (componentEnabledHint)
 	{
@@ -63,35 +88,26 @@ void JFF::Component::initialize()
 	}
 }
 
-void JFF::Component::enable()
-{
-	componentEnabled = true;
-	onEnable();
-	updateEnabled();
-	executeFn = std::bind(&Component::updateEnabled, this);
-}
-
-void JFF::Component::updateEnabled()
+void JFF::Component::applyEnabledHint()
 {
-	if (componentEnabledHint)
+	if (componentEnabledHint && state != State::ENABLED)
 	{
-		onUpdate();
+		enable();
 	}
-	else
+	else if (!componentEnabledHint && state == State::ENABLED)
 	{
 		disable();
 	}
 }
 
-void JFF::Component::disable()
+void JFF::Component::enable()
 {
-	componentEnabled = false;
-	onDisable();
-	executeFn = std::bind(&Component::updateDisabled, this);
+	state = State::ENABLED;
+	onEnable();
 }
 
-void JFF::Component::updateDisabled()
+void JFF::Component::disable()
 {
-	if (componentEnabledHint)
-		enable();
+	state = State::DISABLED;
+	onDisable();
 }
\ No newline at end of file
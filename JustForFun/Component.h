@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,11 +12,30 @@
 
 #include <string>
 #include <functional>
+#include <atomic>
+#include <type_traits>
 
 namespace JFF
 {
 	class GameObject;
 
+	/*
+	* Dense integer ID per component type, assigned the first time each type is requested.
+	* GameObject uses it to index its components by type without comparing type names or casting
+	*/
+	class ComponentTypeID
+	{
+	public:
+		template<typename C> static unsigned int get()
+		{
+			static const unsigned int id = nextID++;
+			return id;
+		}
+
+	private:
+		static std::atomic<unsigned int> nextID;
+	};
+
 	class Component
 	{
 	public:
@@ -43,6 +62,16 @@ namespace JFF
 		void execute();
 		void destroy() noexcept;
 
+		/*
+		* Lifecycle phases, called by GameObject in separate batches every frame. Together they do the same as execute():
+		*	* start(): Calls onStart() and enables/disables the component. Once, when the component is added
+		*	* applyEnabledHint(): Enables/disables the component if setEnabled() changed its state
+		*	* update(): Calls onUpdate() if the component is enabled
+		*/
+		void start();
+		void applyEnabledHint();
+		void update() { if (state == State::ENABLED) onUpdate(); }
+
 		// ----------------------------- OVERRIDABLE FUNCTIONS ----------------------------- //
 
 		virtual void onStart() = 0;			 // Programmable on children (Mandatory)
@@ -52,21 +81,29 @@ namespace JFF
 		virtual void onDestroy() noexcept {} // Programmable on children (Optional)
 
 	private: // State functions
-		void initialize();
 		void enable();
-		void updateEnabled();
 		void disable();
-		void updateDisabled();
 
 	public:
 		GameObject* const gameObject;
 
 	protected:
+		enum class State : char
+		{
+			UNINITIALIZED,
+			ENABLED,
+			DISABLED,
+		};
+
 		std::string name;
 
 		// State member
-		bool componentEnabledHint; // This is only a hint. The real state is stored in 'componentEnabled' member
-		bool componentEnabled;
-		std::function<void()> executeFn;
+		bool componentEnabledHint; // This is only a hint. The real state is stored in 'state' member
+		State state;
 	};
+
+	// True if C overrides Component::onUpdate(). Components that don't override it are never called on update
+	template<typename C>
+	struct ComponentOverridesOnUpdate : 
+		std::integral_constant<bool, !std::is_same<decltype(&C::onUpdate), void (Component::*)()>::value> {};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -122,7 +122,10 @@ namespace JFF
 		// Make the cubemap available to the material sampler on the selected texture unit
 		virtual void use(int textureUnit) = 0;
 
-		// Free memory that contains this cubemap and makes it unavailable
+		/*
+		* Free memory that contains this cubemap and makes it unavailable.
+		* Don't call this on a cached cubemap because it may be shared. Use Cache::releaseCacheItem() instead
+		*/
 		virtual void destroy() = 0;
 
 		// Gets the cubemap name. This name will match the name of the shader's sampler
@@ -3,12 +3,13 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "CubemapGLSTBI.h"
+#include "MathFunctions.h"
 
 #include "Log.h"
 #include "Engine.h"
@@ -19,7 +20,6 @@
 #include "FileSystemSetup.h"
 
 #include <sstream>
-#include <regex>
 #include <stdexcept>
 
 JFF::CubemapGLSTBI::CubemapGLSTBI(Engine* const engine, const char* name, const char* assetFilePath) :
@@ -52,7 +52,7 @@ JFF::CubemapGLSTBI::CubemapGLSTBI(Engine* const engine, const char* name, const
 	// Extract other image loading parameters
 	std::string folder;
 	if(iniFile->has("image", "folder"))
-		folder = std::regex_replace(iniFile->getString("image", "folder"), std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+		folder = toPlatformPath(iniFile->getString("image", "folder"));
 
 	bool HDRImage = false;
 	if (iniFile->has("image", "img-hdr"))
@@ -87,12 +87,12 @@ JFF::CubemapGLSTBI::CubemapGLSTBI(Engine* const engine, const char* name, const
 
 		// Load generated images
 		flipVertically = false; // Don't flip vertically generated images
-		imgInfo.imageRightFilename	 = std::regex_replace(imageFilePath, std::regex(R"raw(\.)raw"), "_posx.");
-		imgInfo.imageLeftFilename	 = std::regex_replace(imageFilePath, std::regex(R"raw(\.)raw"), "_negx.");
-		imgInfo.imageTopFilename	 = std::regex_replace(imageFilePath, std::regex(R"raw(\.)raw"), "_posy.");
-		imgInfo.imageBottomFilename	 = std::regex_replace(imageFilePath, std::regex(R"raw(\.)raw"), "_negy.");
-		imgInfo.imageBackFilename	 = std::regex_replace(imageFilePath, std::regex(R"raw(\.)raw"), "_posz.");
-		imgInfo.imageFrontFilename	 = std::regex_replace(imageFilePath, std::regex(R"raw(\.)raw"), "_negz.");
+		imgInfo.imageRightFilename	 = replaceDots(imageFilePath, "_posx.");
+		imgInfo.imageLeftFilename	 = replaceDots(imageFilePath, "_negx.");
+		imgInfo.imageTopFilename	 = replaceDots(imageFilePath, "_posy.");
+		imgInfo.imageBottomFilename	 = replaceDots(imageFilePath, "_negy.");
+		imgInfo.imageBackFilename	 = replaceDots(imageFilePath, "_posz.");
+		imgInfo.imageFrontFilename	 = replaceDots(imageFilePath, "_negz.");
 
 		imgInfo.folder = "Generated";
 
@@ -219,12 +219,12 @@ JFF::CubemapGLSTBI::~CubemapGLSTBI()
 {
 	JFF_LOG_INFO("Dtor CubemapGLSTBI")
 
-	// Ensure the cubemap GPU memory is destroyed
+	/*
+	* Ensure the cubemap GPU memory is destroyed. Cached cubemaps are never destroyed by their users, 
+	* so this is the place where their GPU memory is released, once the cache and all materials drop them
+	*/
 	if (!isDestroyed)
-	{
-		JFF_LOG_WARNING("Cubemap GPU memory successfully destroyed on Cubemap's destructor. You should call destroy() before destructor is called")
 		destroy();
-	}
 }
 
 std::string JFF::CubemapGLSTBI::getCacheName() const
@@ -238,8 +238,7 @@ void JFF::CubemapGLSTBI::writeToFile(const char* newFilename, bool storeInGenera
 	use(0); // Used texture unit 0 because it's not important here
 
 	// Loop over all mipmap levels (mip level 0 is included)
-	auto math = engine->math.lock();
-	int mipmapLevels = math->clamp(imgInfo.numMipmapsGenerated, 0, 1'000'000); // Don't write auto-generated mipmaps (mipLevel == -1)
+	int mipmapLevels = JFF::clamp(imgInfo.numMipmapsGenerated, 0, 1'000'000); // Don't write auto-generated mipmaps (mipLevel == -1)
 	int numChannels  = imgInfo.numChannels;
 	bool HDR		 = imgInfo.HDR;
 	bool bgra		 = imgInfo.bgra;
@@ -704,12 +703,12 @@ inline void JFF::CubemapGLSTBI::generate(const std::shared_ptr<Image>& imageLeft
 			bool HDRImage = imgInfo.HDR;
 			std::string mipSuffix = "_mip" + std::to_string(mipmap) + ".";
 
-			std::string imageMipRightPath	= std::regex_replace(imgRight.filepath,  std::regex(R"raw(\.)raw"), mipSuffix);
-			std::string imageMipLeftPath	= std::regex_replace(imgLeft.filepath,	 std::regex(R"raw(\.)raw"), mipSuffix);
-			std::string imageMipTopPath		= std::regex_replace(imgTop.filepath,	 std::regex(R"raw(\.)raw"), mipSuffix);
-			std::string imageMipBottomPath	= std::regex_replace(imgBottom.filepath, std::regex(R"raw(\.)raw"), mipSuffix);
-			std::string imageMipBackPath	= std::regex_replace(imgBack.filepath,	 std::regex(R"raw(\.)raw"), mipSuffix);
-			std::string imageMipFrontPath	= std::regex_replace(imgFront.filepath,  std::regex(R"raw(\.)raw"), mipSuffix);
+			std::string imageMipRightPath	= replaceDots(imgRight.filepath,  mipSuffix);
+			std::string imageMipLeftPath	= replaceDots(imgLeft.filepath,	 mipSuffix);
+			std::string imageMipTopPath		= replaceDots(imgTop.filepath,	 mipSuffix);
+			std::string imageMipBottomPath	= replaceDots(imgBottom.filepath, mipSuffix);
+			std::string imageMipBackPath	= replaceDots(imgBack.filepath,	 mipSuffix);
+			std::string imageMipFrontPath	= replaceDots(imgFront.filepath,  mipSuffix);
 
 			std::shared_ptr<Image> imageMipRight	= io->loadImage(imageMipRightPath.c_str(),	flipVertically, HDRImage);
 			std::shared_ptr<Image> imageMipLeft		= io->loadImage(imageMipLeftPath.c_str(),	flipVertically, HDRImage);
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -18,6 +18,8 @@ namespace JFF
 	class DirectedNodeBase : public NodeBase<_E>
 	{
 	public:
+		using NodeType = typename _E::NodeType;
+
 		// Ctor & Dtor
 		DirectedNodeBase();
 		virtual ~DirectedNodeBase();
@@ -32,10 +34,10 @@ namespace JFF
 
 		// ------------------------------------ Overrides ------------------------------------ //
 
-		// Connect with incoming edge. This node doesn't allow edge repetition. Expensive operation
+		// Connect with incoming edge. This node doesn't allow edge repetition. O(1) expected
 		virtual void operator<<(const std::weak_ptr<_E>& edge) override;
 
-		// Connect with outcoming edge. This node doesn't allow edge repetition. Expensive operation
+		// Connect with outcoming edge. This node doesn't allow edge repetition. O(1) expected
 		virtual void operator>>(const std::weak_ptr<_E>& edge) override;
 
 		/*
@@ -65,9 +67,16 @@ namespace JFF
 		// Gets the number of outcoming edges connected to this node
 		size_t numOutcomingEdges() const { return outcomingEdges.size(); }
 
+		/*
+		* Gets the destination node of each outcoming edge, in the same order as outcoming edges.
+		* Traversals should use this instead of locking edges and nodes. Nodes are owned by their graph
+		*/
+		const std::vector<NodeType*>& getOutcomingNodes() const { return outcomingNodes; }
+
 	protected:
 		std::vector<std::weak_ptr<_E>> incomingEdges;
 		std::vector<std::weak_ptr<_E>> outcomingEdges;
+		std::vector<NodeType*> outcomingNodes;
 	};
 }
 
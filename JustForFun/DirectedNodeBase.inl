@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -15,7 +15,10 @@
 #include <stdexcept>
 
 template<typename _E>
-JFF::DirectedNodeBase<_E>::DirectedNodeBase()
+JFF::DirectedNodeBase<_E>::DirectedNodeBase() :
+	incomingEdges(),
+	outcomingEdges(),
+	outcomingNodes()
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor DirectedNodeBase")
 }
@@ -37,7 +40,10 @@ template<typename _E>
 void JFF::DirectedNodeBase<_E>::operator>>(const std::weak_ptr<_E>& edge)
 {
 	if (this->addUniqueEdge(edge))
+	{
 		outcomingEdges.push_back(edge);
+		outcomingNodes.push_back(edge.lock()->getDstNode().lock().get());
+	}
 }
 
 template<typename _E>
@@ -53,15 +59,10 @@ bool JFF::DirectedNodeBase<_E>::isConnectedTo(const std::weak_ptr<JFF::NodeBase<
 	if (*this == dstNode)
 		return false;
 
-	// Build a predicate to check if there is an edge that goes from this to dstNode
-	auto predicate = [&dstNodeHandler](const std::weak_ptr<_E>& edge)
-	{
-		auto edgeDstEnd = edge.lock()->getDstNode();
-		return *dstNodeHandler == edgeDstEnd;
-	};
-
-	// Execute find
-	return std::find_if(outcomingEdges.begin(), outcomingEdges.end(), predicate) != outcomingEdges.end();
+	// Check if there is an edge that goes from this to dstNode
+	const NodeBase<_E>* dstNodePtr = dstNodeHandler.get();
+	auto predicate = [dstNodePtr](const NodeType* node) { return static_cast<const NodeBase<_E>*>(node) == dstNodePtr; };
+	return std::find_if(outcomingNodes.begin(), outcomingNodes.end(), predicate) != outcomingNodes.end();
 }
 
 template<typename _E>
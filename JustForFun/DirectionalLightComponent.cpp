@@ -3,24 +3,25 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "DirectionalLightComponent.h"
+#include "MathFunctions.h"
 
 #include "Log.h"
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
 
-#include <sstream>
-
-extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(JFF::Framebuffer::PrefabFramebuffer fboType,
-	unsigned int width, unsigned int height, unsigned int samplesPerPixel = 0);
+#include <cmath>
+#include <limits>
 
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name);
 
+const float JFF::DirectionalLightComponent::CASCADE_SNAP_FRACTION = 0.125f;
+
 JFF::DirectionalLightComponent::DirectionalLightComponent(GameObject* const gameObject, const char* name, bool initiallyEnabled, 
 	DirectionalLightComponent::Params params) :
 	LightComponent(gameObject, name, initiallyEnabled),
@@ -29,12 +30,20 @@ JFF::DirectionalLightComponent::DirectionalLightComponent(GameObject* const game
 	params(params),
 
 	shadowProjectionMatrix(),
-	shadowMapFBO(),
+
+	activeCascades(1u),
+	cascadeViewMatrices(),
+	cascadeProjectionMatrices(),
+	cascadeSplits(),
 	shadowCastMaterial()
 {
 	JFF_LOG_INFO("Ctor DirectionalLightComponent")
 
 	setShadowImportanceVolume(params.left, params.right, params.bottom, params.top, params.zNear, params.zFar);
+
+	// Until cascades are fitted to a camera, the fixed shadow volume is used
+	cascadeProjectionMatrices[0] = shadowProjectionMatrix;
+	std::fill(cascadeSplits, cascadeSplits + ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES, std::numeric_limits<float>::max());
 }
 
 JFF::DirectionalLightComponent::~DirectionalLightComponent()
@@ -44,11 +53,9 @@ JFF::DirectionalLightComponent::~DirectionalLightComponent()
 
 void JFF::DirectionalLightComponent::onStart()
 {
-	// Create a shadowmap framebuffer if this light casts shadows
+	// Create the shadow cast material if this light casts shadows. The shadow map is a region of the renderer's shadow atlas
 	if (params.castShadows)
 	{
-		shadowMapFBO = createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_SHADOW_MAP, params.shadowMapWidth, params.shadowMapHeight);
-
 		shadowCastMaterial = createMaterial(engine, "Directional light material");
 		shadowCastMaterial->setDomain(Material::MaterialDomain::SHADOW_CAST);
 		shadowCastMaterial->cook();
@@ -63,42 +70,38 @@ void JFF::DirectionalLightComponent::onDestroy() noexcept
 	// Unregister the light in Renderer
 	gameObject->engine->renderer.lock()->removeLight(this);
 	
-	// Destroy framebuffer and material
-	if (shadowMapFBO)
-		shadowMapFBO->destroy();
-
+	// Destroy material
 	if (shadowCastMaterial)
 		shadowCastMaterial->destroy();
 }
 
 void JFF::DirectionalLightComponent::sendLightParams(RenderComponent* const renderComponent, int lightIndex)
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
 
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::DIR_LIGHT_DIRECTION;
 	auto lightDir = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightDir.x, lightDir.y, lightDir.z));
+	renderComponent->sendVec3(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::DIR_LIGHT_DIRECTION.c_str()), Vec3(lightDir.x, lightDir.y, lightDir.z));
 	
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::DIR_LIGHT_COLOR;
-	renderComponent->sendVec3(ss.str().c_str(), params.color);
+	renderComponent->sendVec3(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::DIR_LIGHT_COLOR.c_str()), params.color);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::DIR_LIGHT_INTENSITY;
-	renderComponent->sendFloat(ss.str().c_str(), params.intensity);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::DIR_LIGHT_INTENSITY.c_str()), params.intensity);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::DIR_LIGHT_CAST_SHADOWS;
-	renderComponent->sendFloat(ss.str().c_str(), params.castShadows ? 1.0f : 0.0f);
+	// Lights without a region in the shadow atlas (it's full) don't cast shadows
+	auto shadowAtlas = engine->renderer.lock()->getShadowAtlas().lock();
+	Vec4 shadowMapRegion;
+	bool hasShadowMap = params.castShadows && shadowAtlas->getRegionUV(this, shadowMapRegion);
 
-	if (params.castShadows)
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::DIR_LIGHT_CAST_SHADOWS.c_str()), hasShadowMap ? 1.0f : 0.0f);
+
+	if (hasShadowMap)
 	{
-		renderComponent->sendDirLightShadowMap(lightIndex, shadowMapFBO);
+		renderComponent->sendDirLightShadowMap(lightIndex, shadowAtlas->getFramebuffer());
+
+		renderComponent->sendVec4(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::DIR_LIGHT_SHADOW_MAP_REGION.c_str()), shadowMapRegion);
 
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_MATRICES << "[" << lightIndex << "]";
-		renderComponent->sendMat4(ss.str().c_str(), getProjectionMatrix() * getViewMatrix());
+		sendCascades(renderComponent, frameAllocator.format("%s[%d]", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY.c_str(), lightIndex), 
+			ShaderCodeBuilder::DIRECTIONAL_LIGHT_MATRICES.c_str(), lightIndex * ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES);
 	}
 	else
 	{
@@ -108,32 +111,30 @@ void JFF::DirectionalLightComponent::sendLightParams(RenderComponent* const rend
 
 void JFF::DirectionalLightComponent::sendLightParams(RenderComponent* const renderComponent)
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
 
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT << "." << ShaderCodeBuilder::DIR_LIGHT_DIRECTION;
 	auto lightDir = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightDir.x, lightDir.y, lightDir.z));
+	renderComponent->sendVec3(frameAllocator.format("%s.%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::DIR_LIGHT_DIRECTION.c_str()), Vec3(lightDir.x, lightDir.y, lightDir.z));
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT << "." << ShaderCodeBuilder::DIR_LIGHT_COLOR;
-	renderComponent->sendVec3(ss.str().c_str(), params.color);
+	renderComponent->sendVec3(frameAllocator.format("%s.%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::DIR_LIGHT_COLOR.c_str()), params.color);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT << "." << ShaderCodeBuilder::DIR_LIGHT_INTENSITY;
-	renderComponent->sendFloat(ss.str().c_str(), params.intensity);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::DIR_LIGHT_INTENSITY.c_str()), params.intensity);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT << "." << ShaderCodeBuilder::DIR_LIGHT_CAST_SHADOWS;
-	renderComponent->sendFloat(ss.str().c_str(), params.castShadows ? 1.0f : 0.0f);
+	// Lights without a region in the shadow atlas (it's full) don't cast shadows
+	auto shadowAtlas = engine->renderer.lock()->getShadowAtlas().lock();
+	Vec4 shadowMapRegion;
+	bool hasShadowMap = params.castShadows && shadowAtlas->getRegionUV(this, shadowMapRegion);
 
-	if (params.castShadows)
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::DIR_LIGHT_CAST_SHADOWS.c_str()), hasShadowMap ? 1.0f : 0.0f);
+
+	if (hasShadowMap)
 	{
-		renderComponent->sendDirLightShadowMap(0, shadowMapFBO);
+		renderComponent->sendDirLightShadowMap(0, shadowAtlas->getFramebuffer());
 
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_MATRIX;
-		renderComponent->sendMat4(ss.str().c_str(), getProjectionMatrix() * getViewMatrix());
+		renderComponent->sendVec4(frameAllocator.format("%s.%s", ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::DIR_LIGHT_SHADOW_MAP_REGION.c_str()), shadowMapRegion);
+
+		sendCascades(renderComponent, ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::DIRECTIONAL_LIGHT_MATRIX.c_str(), 0);
 	}
 	else
 	{
@@ -143,18 +144,40 @@ void JFF::DirectionalLightComponent::sendLightParams(RenderComponent* const rend
 
 void JFF::DirectionalLightComponent::enableShadowMapFramebuffer()
 {
-	shadowMapFBO->enable();
+	// Only binds the atlas. Its region is cleared by the shadow cast render pass
+	engine->renderer.lock()->getShadowAtlas().lock()->enable();
 }
 
 void JFF::DirectionalLightComponent::disableShadowMapFramebuffer()
 {
-	shadowMapFBO->disable();
+	engine->renderer.lock()->getShadowAtlas().lock()->disable();
+}
+
+bool JFF::DirectionalLightComponent::hasStaticShadowMap() const
+{
+	return engine->renderer.lock()->getShadowAtlas().lock()->hasStaticCache();
+}
+
+void JFF::DirectionalLightComponent::enableStaticShadowMapFramebuffer()
+{
+	// Static casters are cached in the same region of the static atlas
+	engine->renderer.lock()->getShadowAtlas().lock()->enableStatic();
+}
+
+void JFF::DirectionalLightComponent::restoreStaticShadowMap()
+{
+	engine->renderer.lock()->getShadowAtlas().lock()->restoreStaticRegion(this);
 }
 
 void JFF::DirectionalLightComponent::getShadowMapSizePixels(unsigned int& outWidth, unsigned int& outHeight) const
 {
-	outWidth = params.shadowMapWidth;
-	outHeight = params.shadowMapHeight;
+	// Size of this light's region in the shadow atlas
+	ShadowAtlas::Region region;
+	if (!engine->renderer.lock()->getShadowAtlas().lock()->getRegion(this, region))
+		region.size = 0u;
+
+	outWidth = region.size;
+	outHeight = region.size;
 }
 
 void JFF::DirectionalLightComponent::useMaterial()
@@ -179,21 +202,12 @@ void JFF::DirectionalLightComponent::sendFloat(const char* variableName, float f
 
 JFF::Mat4 JFF::DirectionalLightComponent::getViewMatrix() const
 {
-	// TODO: Don't calculate this every frame. Link this to transform's changes
-	
-	// Get world position of the light
-	Vec3 lightPos = gameObject->transform.getWorldPos();
-
-	// Get world rotation
-	Vec4 lightDir4 = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
-	Vec3 lightDir(lightDir4.pitch, lightDir4.yaw, lightDir4.roll);
-
-	return gameObject->engine->math.lock()->lookAt(lightPos, lightPos + lightDir, Vec3::UP);
+	return cascadeViewMatrices[0];
 }
 
 JFF::Mat4 JFF::DirectionalLightComponent::getProjectionMatrix() const
 {
-	return shadowProjectionMatrix;
+	return cascadeProjectionMatrices[0];
 }
 
 void JFF::DirectionalLightComponent::setColor(Vec3 newColor)
@@ -218,7 +232,7 @@ void JFF::DirectionalLightComponent::setShadowImportanceVolume(float left, float
 	params.zFar = zFar;
 
 	// Selected ortho matrix because directional light rays are parallel
-	shadowProjectionMatrix = gameObject->engine->math.lock()->ortho(left, right, bottom, top, zNear, zFar);
+	shadowProjectionMatrix = JFF::ortho<4>(left, right, bottom, top, zNear, zFar);
 }
 
 void JFF::DirectionalLightComponent::setIntensity(float newIntensity)
@@ -245,3 +259,173 @@ float JFF::DirectionalLightComponent::getIntensity() const
 {
 	return params.intensity;
 }
+
+unsigned int JFF::DirectionalLightComponent::getShadowMapMaxSizePixels() const
+{
+	return std::max(params.shadowMapWidth, params.shadowMapHeight);
+}
+
+void JFF::DirectionalLightComponent::updateCascades()
+{
+	ShadowAtlas::Region region;
+	bool hasRegion = engine->renderer.lock()->getShadowAtlas().lock()->getRegion(this, region);
+
+	auto camera = engine->camera.lock();
+	bool hasCamera = camera && camera->hasAnyActiveCamera();
+	Mat4 cameraProjection = hasCamera ? camera->getActiveCameraProjectionMatrix() : Mat4();
+	const float* proj = *cameraProjection;
+
+	// Cascades need a perspective camera (element [2][3] of the projection is -1). Otherwise, use the fixed shadow volume
+	if (params.numCascades <= 1u || !hasRegion || !hasCamera || proj[11] == 0.0f)
+	{
+		activeCascades = 1u;
+		cascadeViewMatrices[0] = getFixedViewMatrix();
+		cascadeProjectionMatrices[0] = shadowProjectionMatrix;
+		std::fill(cascadeSplits, cascadeSplits + ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES, std::numeric_limits<float>::max());
+		return;
+	}
+
+	activeCascades = std::min(params.numCascades, (unsigned int)ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES);
+
+	// Camera near and far planes from the projection matrix
+	float cameraNear = proj[14] / (proj[10] - 1.0f);
+	float cameraFar = proj[14] / (proj[10] + 1.0f);
+	float shadowFar = std::min(cameraFar, params.cascadesDistance);
+	float tanHalfFovy = 1.0f / proj[5];
+	float aspect = proj[5] / proj[0];
+
+	// Camera basis is stored in the columns of the inverse view matrix
+	const Mat4 cameraToWorld = JFF::inverse(camera->getActiveCameraViewMatrix());
+	const float* m = *cameraToWorld;
+	Vec3 cameraRight(m[0], m[1], m[2]);
+	Vec3 cameraUp(m[4], m[5], m[6]);
+	Vec3 cameraForward(-m[8], -m[9], -m[10]);
+	Vec3 cameraPos(m[12], m[13], m[14]);
+
+	// Light view only depends on light direction, so rotating the camera never rotates the shadow map texels
+	Vec4 lightDir4 = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
+	Vec3 lightDir = JFF::normalize(Vec3(lightDir4.x, lightDir4.y, lightDir4.z));
+	Vec3 lightUp = std::abs(lightDir.y) > 0.99f ? Vec3::FORWARD : Vec3::UP;
+	Mat4 lightRotation = JFF::lookAt<4>(Vec3::ZERO, lightDir, lightUp);
+
+	float tileSize = (float)(region.size / 2u);
+
+	float sliceNear = cameraNear;
+	for (unsigned int cascade = 0; cascade < activeCascades; ++cascade)
+	{
+		// Practical split scheme: blend of logarithmic and uniform splits
+		float t = (float)(cascade + 1u) / (float)activeCascades;
+		float logSplit = cameraNear * std::pow(shadowFar / cameraNear, t);
+		float uniformSplit = cameraNear + (shadowFar - cameraNear) * t;
+		float sliceFar = params.cascadeSplitLambda * logSplit + (1.0f - params.cascadeSplitLambda) * uniformSplit;
+
+		// Corners of the frustum slice
+		Vec3 corners[8];
+		float sliceDistances[2] = { sliceNear, sliceFar };
+		for (int i = 0; i < 2; ++i)
+		{
+			Vec3 planeCenter = cameraPos + cameraForward * sliceDistances[i];
+			float halfHeight = sliceDistances[i] * tanHalfFovy;
+			float halfWidth = halfHeight * aspect;
+			corners[i * 4 + 0] = planeCenter + cameraRight * halfWidth + cameraUp * halfHeight;
+			corners[i * 4 + 1] = planeCenter - cameraRight * halfWidth + cameraUp * halfHeight;
+			corners[i * 4 + 2] = planeCenter + cameraRight * halfWidth - cameraUp * halfHeight;
+			corners[i * 4 + 3] = planeCenter - cameraRight * halfWidth - cameraUp * halfHeight;
+		}
+
+		// Fit a bounding sphere to the slice. Its size doesn't change when the camera rotates, so the texel size is constant
+		Vec3 sphereCenter = Vec3::ZERO;
+		for (const Vec3& corner : corners)
+			sphereCenter += corner;
+		sphereCenter *= 1.0f / 8.0f;
+
+		float sphereRadius = 0.0f;
+		for (const Vec3& corner : corners)
+			sphereRadius = std::max(sphereRadius, JFF::distance(corner, sphereCenter));
+		sphereRadius = std::ceil(sphereRadius * 16.0f) / 16.0f;
+
+		/*
+		* Snap the cascade center, in light space, to a grid of whole texels a fraction of the radius apart. The cascade
+		* then stays the same while the camera moves inside a grid cell, so cached shadows remain valid and shadow edges
+		* don't shimmer. The cascade is padded to still contain the slice after snapping
+		*/
+		float paddedRadius = sphereRadius * (1.0f + CASCADE_SNAP_FRACTION);
+		float texelSize = 2.0f * paddedRadius / tileSize;
+		float snapStep = texelSize * std::max(1.0f, std::floor(CASCADE_SNAP_FRACTION * sphereRadius / texelSize));
+
+		Vec4 centerLightSpace = lightRotation * Vec4(sphereCenter.x, sphereCenter.y, sphereCenter.z, 1.0f);
+		Vec3 snappedCenter(
+			std::round(centerLightSpace.x / snapStep) * snapStep,
+			std::round(centerLightSpace.y / snapStep) * snapStep,
+			std::round(centerLightSpace.z / snapStep) * snapStep);
+
+		// Casters between the light and the slice are captured by pulling back the near plane
+		cascadeViewMatrices[cascade] = JFF::translate(Mat4(), Vec3(-snappedCenter.x, -snappedCenter.y, -snappedCenter.z)) * lightRotation;
+		cascadeProjectionMatrices[cascade] = JFF::ortho<4>(-paddedRadius, paddedRadius, -paddedRadius, paddedRadius,
+			-paddedRadius - params.cascadesDistance, paddedRadius);
+		cascadeSplits[cascade] = sliceFar;
+
+		sliceNear = sliceFar;
+	}
+}
+
+unsigned int JFF::DirectionalLightComponent::getNumCascades() const
+{
+	return activeCascades;
+}
+
+JFF::Mat4 JFF::DirectionalLightComponent::getCascadeViewMatrix(unsigned int cascade) const
+{
+	return cascadeViewMatrices[cascade];
+}
+
+JFF::Mat4 JFF::DirectionalLightComponent::getCascadeProjectionMatrix(unsigned int cascade) const
+{
+	return cascadeProjectionMatrices[cascade];
+}
+
+bool JFF::DirectionalLightComponent::getCascadeRegion(unsigned int cascade, ShadowAtlas::Region& outRegion) const
+{
+	if (!engine->renderer.lock()->getShadowAtlas().lock()->getRegion(this, outRegion))
+		return false;
+
+	// Cascades are tiles of 2x2 in the region. A single cascade takes the whole region
+	if (activeCascades > 1u)
+	{
+		outRegion.size /= 2u;
+		outRegion.x += (cascade % 2u) * outRegion.size;
+		outRegion.y += (cascade / 2u) * outRegion.size;
+	}
+
+	return true;
+}
+
+inline JFF::Mat4 JFF::DirectionalLightComponent::getFixedViewMatrix() const
+{
+	// Get world position of the light
+	Vec3 lightPos = gameObject->transform.getWorldPos();
+
+	// Get world rotation
+	Vec4 lightDir4 = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
+	Vec3 lightDir(lightDir4.pitch, lightDir4.yaw, lightDir4.roll);
+
+	return JFF::lookAt<4>(lightPos, lightPos + lightDir, Vec3::UP);
+}
+
+inline void JFF::DirectionalLightComponent::sendCascades(RenderComponent* const renderComponent, const char* lightStructName, const char* matricesName, int firstMatrixIndex)
+{
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
+
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", lightStructName, ShaderCodeBuilder::DIR_LIGHT_NUM_CASCADES.c_str()), (float)activeCascades);
+
+	static_assert(ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES == 4, "Cascade splits are sent as a vec4");
+	Vec4 splits(cascadeSplits[0], cascadeSplits[1], cascadeSplits[2], cascadeSplits[3]);
+	renderComponent->sendVec4(frameAllocator.format("%s.%s", lightStructName, ShaderCodeBuilder::DIR_LIGHT_CASCADE_SPLITS.c_str()), splits);
+
+	for (unsigned int cascade = 0; cascade < activeCascades; ++cascade)
+	{
+		renderComponent->sendMat4(frameAllocator.format("%s[%d]", matricesName, firstMatrixIndex + (int)cascade),
+			cascadeProjectionMatrices[cascade] * cascadeViewMatrices[cascade]);
+	}
+}
\ No newline at end of file
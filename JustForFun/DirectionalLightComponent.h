@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,6 +13,8 @@
 #include "LightComponent.h"
 
 #include "Framebuffer.h"
+#include "ShadowAtlas.h"
+#include "ShaderCodeBuilder.h"
 
 namespace JFF
 {
@@ -20,6 +22,10 @@ namespace JFF
 
 	class DirectionalLightComponent : public LightComponent
 	{
+	public:
+		// Cascade centers are snapped to a grid whose step is this fraction of the cascade radius
+		static const float CASCADE_SNAP_FRACTION;
+
 	public:
 		struct Params
 		{
@@ -31,6 +37,10 @@ namespace JFF
 				shadowMapWidth(4096),
 				shadowMapHeight(4096),
 
+				numCascades(4),
+				cascadesDistance(100.0f),
+				cascadeSplitLambda(0.75f),
+
 				left(-10.0f),
 				right(10.0f),
 				bottom(-10.0f),
@@ -44,11 +54,19 @@ namespace JFF
 			Vec3 color;
 			float intensity;
 
-			// Shadow casting
+			// Shadow casting. The shadow map is a square region of the shadow atlas, sized by the importance of this light on screen.
+			// Its size is never bigger than the biggest of shadowMapWidth and shadowMapHeight
 			bool castShadows;
 			unsigned int shadowMapWidth, shadowMapHeight;
 
-			// Shadow area (cube) of influence
+			// Cascaded shadow maps. The camera frustum, up to cascadesDistance, is split in numCascades slices (Max: 
+			// ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES) and each one is rendered in a tile of 2x2 of the shadow map.
+			// Split distances blend uniform (lambda = 0) and logarithmic (lambda = 1) schemes
+			unsigned int numCascades;
+			float cascadesDistance;
+			float cascadeSplitLambda;
+
+			// Shadow area (cube) of influence. Only used with a single cascade or without an active perspective camera
 			float left;
 			float right;
 			float bottom;
@@ -85,13 +103,16 @@ namespace JFF
 		virtual bool castShadows() const override { return params.castShadows; }
 		virtual void enableShadowMapFramebuffer() override;
 		virtual void disableShadowMapFramebuffer() override;
+		virtual bool hasStaticShadowMap() const override;
+		virtual void enableStaticShadowMapFramebuffer() override;
+		virtual void restoreStaticShadowMap() override;
 		virtual void getShadowMapSizePixels(unsigned int& outWidth, unsigned int& outHeight) const override;
 		virtual void useMaterial() override;
 		virtual void sendMat4(const char* variableName, const Mat4& matrix) override;
 		virtual void sendVec3(const char* variableName, const Vec3& vec) override;
 		virtual void sendFloat(const char* variableName, float f) override;
-		virtual Mat4 getViewMatrix() const override;
-		virtual Mat4 getProjectionMatrix() const override;
+		virtual Mat4 getViewMatrix() const override; // View matrix of first cascade
+		virtual Mat4 getProjectionMatrix() const override; // Projection matrix of first cascade
 
 		// ------------------------------- DIRECTIONAL LIGHT COMPONENT INTERFACE ------------------------------- //
 
@@ -103,6 +124,21 @@ namespace JFF
 		virtual Vec3 getColor() const;
 		virtual float getIntensity() const;
 		virtual void getShadowImportanceVolume(float& outLeft, float& outRight, float& outBottom, float& outTop, float& outZNear, float& outZFar) const;
+		virtual unsigned int getShadowMapMaxSizePixels() const;
+
+		// Fits the cascades to the active camera frustum. Called once per frame, after this light gets its region of the shadow atlas
+		virtual void updateCascades();
+
+		virtual unsigned int getNumCascades() const;
+		virtual Mat4 getCascadeViewMatrix(unsigned int cascade) const;
+		virtual Mat4 getCascadeProjectionMatrix(unsigned int cascade) const;
+
+		// Gets the tile of the shadow atlas where the cascade is rendered. Returns false if this light has no region in the atlas
+		virtual bool getCascadeRegion(unsigned int cascade, ShadowAtlas::Region& outRegion) const;
+
+	private:
+		inline Mat4 getFixedViewMatrix() const;
+		inline void sendCascades(RenderComponent* const renderComponent, const char* lightStructName, const char* matricesName, int firstMatrixIndex);
 
 	protected:
 		Engine* engine;
@@ -111,7 +147,11 @@ namespace JFF
 		Params params;
 
 		Mat4 shadowProjectionMatrix;
-		std::shared_ptr<Framebuffer> shadowMapFBO;
+
+		unsigned int activeCascades;
+		Mat4 cascadeViewMatrices[ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES];
+		Mat4 cascadeProjectionMatrices[ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES];
+		float cascadeSplits[ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES]; // Distance from the camera to the far plane of each cascade
 		std::shared_ptr<Material> shadowCastMaterial;
 	};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -18,6 +18,8 @@ namespace JFF
 	class EdgeBase
 	{
 	public:
+		using NodeType = _N;
+
 		// Ctor & Dtor
 		explicit EdgeBase(const std::weak_ptr<_N>& nodeSrc, const std::weak_ptr<_N>& nodeDst);
 		virtual ~EdgeBase();
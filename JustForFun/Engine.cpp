@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -19,12 +19,15 @@
 #include <algorithm>
 
 JFF::Engine::Engine() : 
+	frameAllocator(),
+
 	cache(),
 	math(),
 	io(),
 	camera(),
 	time(),
 	physics(),
+	spatial(),
 	input(),
 	logic(),
 	renderer(),
@@ -79,6 +82,8 @@ void JFF::Engine::mainLoop()
 	bool keepExecutingMainLoop = true;
 	while (keepExecutingMainLoop)
 	{
+		frameAllocator.beginFrame(); // Frame memory of two frames ago is reused
+
 		std::for_each(executables.begin(), executables.end(), [&keepExecutingMainLoop](auto& exec)
 			{
 				keepExecutingMainLoop = keepExecutingMainLoop && exec.second->execute();
@@ -184,6 +189,9 @@ void JFF::Engine::initBasicSubsystems()
 	// Physics subsystem
 	if (physics.expired())	attachSubsystem<Physics>(createPhysicsSubsystem());
 
+	// Spatial subsystem
+	if (spatial.expired())	attachSubsystem<Spatial>(createSpatialSubsystem());
+
 	// Input subsystem
 	if (input.expired())	attachSubsystem<Input>(createInputSubsystem());
 
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,10 +12,12 @@
 
 // Core subsystem functionality
 #include "ExecutableSubsystem.h"
+#include "FrameAllocator.h"
 
 // Basic subsystems
 #include "Time.h"
 #include "Physics.h"
+#include "Spatial.h"
 #include "Input.h"
 #include "Logic.h"
 #include "Renderer.h"
@@ -74,6 +76,9 @@ namespace JFF
 		inline void logWarning(const std::string& msg); // Walkaround to log in Engine.inl
 
 	public: // Public attributes
+		// Transient memory of current frame. It's declared first to outlive subsystems, which can hold frame commands
+		FrameAllocator frameAllocator;
+
 		// Direct access to basic subsystems
 		std::weak_ptr<Cache> cache;
 		std::weak_ptr<Math> math;
@@ -81,6 +86,7 @@ namespace JFF
 		std::weak_ptr<Camera> camera;
 		std::weak_ptr<Time> time;
 		std::weak_ptr<Physics> physics;
+		std::weak_ptr<Spatial> spatial;
 		std::weak_ptr<Input> input;
 		std::weak_ptr<Logic> logic;
 		std::weak_ptr<Renderer> renderer;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -48,6 +48,7 @@ void JFF::Engine::attachSubsystem(std::shared_ptr<Y>&& subsystem)
 	// Init direct access to basic subsystems
 	if (std::dynamic_pointer_cast<Time>(subsystem).get())			time = getSubsystem<Time>();
 	else if (std::dynamic_pointer_cast<Physics>(subsystem).get())	physics = getSubsystem<Physics>();
+	else if (std::dynamic_pointer_cast<Spatial>(subsystem).get())	spatial = getSubsystem<Spatial>();
 	else if (std::dynamic_pointer_cast<Input>(subsystem).get())		input = getSubsystem<Input>();
 	else if (std::dynamic_pointer_cast<Logic>(subsystem).get())		logic = getSubsystem<Logic>();
 	else if (std::dynamic_pointer_cast<Renderer>(subsystem).get())	renderer = getSubsystem<Renderer>();
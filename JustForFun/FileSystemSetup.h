@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -17,4 +17,50 @@
 #	define JFF_SLASH '/'
 #	define JFF_SLASH_STRING "/"
 #	error Unknown filesystem platform
-#endif
\ No newline at end of file
+#endif
+
+#include <string>
+
+namespace JFF
+{
+	// Converts a path written with '/' separators (asset files) to a path with platform slashes
+	inline std::string toPlatformPath(std::string path)
+	{
+		if (JFF_SLASH != '/')
+		{
+			for (char& c : path)
+			{
+				if (c == '/')
+					c = JFF_SLASH;
+			}
+		}
+
+		return path;
+	}
+
+	// Replaces each dot in path by replacement. Ex: "sky.png" with "_posx." -> "sky_posx.png"
+	inline std::string replaceDots(const std::string& path, const std::string& replacement)
+	{
+		std::string result;
+		result.reserve(path.size() + replacement.size());
+		for (char c : path)
+		{
+			if (c == '.')
+				result.append(replacement);
+			else
+				result.push_back(c);
+		}
+
+		return result;
+	}
+
+	// Replaces everything from the first dot of path by appendix. Path is returned unchanged if it has no dot
+	inline std::string replaceFromFirstDot(const std::string& path, const std::string& appendix)
+	{
+		size_t dotPos = path.find('.');
+		if (dotPos == std::string::npos)
+			return path;
+
+		return path.substr(0u, dotPos) + appendix;
+	}
+}
\ No newline at end of file
@@ -3,12 +3,13 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "FlyCamInputComponent.h"
+#include "MathFunctions.h"
 
 #include "Engine.h"
 
@@ -198,13 +199,13 @@ void JFF::FlyCamInputComponent::onStart()
 void JFF::FlyCamInputComponent::onUpdate()
 {
 	float deltaTime = (float)gameObject->engine->time.lock()->deltaTime();
-	auto math = gameObject->engine->math.lock();
 
-	// Limit pitch to (-90, 90)
-	rotation.pitch = gameObject->engine->math.lock()->clamp(rotation.pitch, -89.9f, 89.9f);
+	// Limit pitch to (-90, 90)º
+	rotation.pitch = JFF::clamp(rotation.pitch, -89.9f, 89.9f);
 
-	// Rotate this game object
-	gameObject->transform.setLocalRotation(rotation);
+	// Rotate this game object. A fly cam has no roll, so its orientation is yaw around UP after pitch around RIGHT
+	Quat orientation = JFF::angleAxis(JFF::radians(rotation.yaw), Vec3::UP) * JFF::angleAxis(JFF::radians(rotation.pitch), Vec3::RIGHT);
+	gameObject->transform.setLocalRotation(orientation);
 
 	// Moving this gameobject keeping in mind the relative orientation
 	moveDir.y = moveUp - moveDown;
@@ -212,9 +213,9 @@ void JFF::FlyCamInputComponent::onUpdate()
 
 	// Calculate speed and acceleration
 	Vec3 acceleration(rotatedDir.x, rotatedDir.y, rotatedDir.z);
-	float currentMaxSpeed = math->length(rotatedDir) * maxSpeed * boostMaxSpeed;
+	float currentMaxSpeed = JFF::length(rotatedDir) * maxSpeed * boostMaxSpeed;
 
-	float speedMagnitude = math->length(speed);
+	float speedMagnitude = JFF::length(speed);
 	if (speedMagnitude > currentMaxSpeed)
 	{
 		Vec3 deceleration = speed * brakeFactor * deltaTime;
@@ -225,14 +226,14 @@ void JFF::FlyCamInputComponent::onUpdate()
 		
 		acceleration *= accelerationFactor * boost * deltaTime;
 		speed += acceleration;
-		speed = math->normalize(acceleration) * math->length(speed); // Use acceleration direction and speed magnitude
+		speed = JFF::normalize(acceleration) * JFF::length(speed); // Use acceleration direction and speed magnitude
 	}
 
-	speedMagnitude = math->length(speed);
+	speedMagnitude = JFF::length(speed);
 	if (speedMagnitude > (currentMaxSpeed - speedThreshold) &&
 		speedMagnitude < (currentMaxSpeed + speedThreshold))
 	{
-		speed = math->normalize(acceleration) * currentMaxSpeed;
+		speed = JFF::normalize(acceleration) * currentMaxSpeed;
 	}
 
 	// Set final position
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -44,7 +44,7 @@ namespace JFF
 		float moveUp;
 		float moveDown;
 		
-		Vec3 rotation;
+		Vec3 rotation; // Accumulated pitch and yaw in degrees
 
 		// Variables
 		float maxSpeed;
@@ -0,0 +1,201 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "FrameAllocator.h"
+
+#include "Log.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+
+const size_t JFF::FrameAllocator::DEFAULT_BYTES_PER_FRAME = 256 * 1024;
+
+JFF::FrameAllocator::FrameAllocator(size_t initialBytesPerFrame) :
+	buffers(),
+	currentBuffer(0)
+{
+	JFF_LOG_INFO("Ctor FrameAllocator")
+
+	for (Buffer& buffer : buffers)
+	{
+		buffer.blocks.push_back({ std::make_unique<unsigned char[]>(initialBytesPerFrame), initialBytesPerFrame });
+		buffer.currentBlock = 0;
+		buffer.offset = 0;
+	}
+}
+
+JFF::FrameAllocator::~FrameAllocator()
+{
+	JFF_LOG_INFO("Dtor FrameAllocator")
+}
+
+void JFF::FrameAllocator::beginFrame()
+{
+	currentBuffer = 1 - currentBuffer;
+	resetBuffer(buffers[currentBuffer]);
+}
+
+void* JFF::FrameAllocator::allocate(size_t size, size_t alignment)
+{
+	if (alignment > alignof(std::max_align_t))
+	{
+		JFF_LOG_ERROR("Frame allocator alignment can't be bigger than std::max_align_t")
+		return nullptr;
+	}
+
+	Buffer& buffer = buffers[currentBuffer];
+	Block& block = buffer.blocks[buffer.currentBlock];
+
+	// Bump the offset of current block if the aligned allocation fits in it
+	uintptr_t blockStart = reinterpret_cast<uintptr_t>(block.data.get());
+	uintptr_t alignedAddress = (blockStart + buffer.offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	size_t alignedOffset = (size_t)(alignedAddress - blockStart);
+	if (alignedOffset + size <= block.capacity)
+	{
+		buffer.offset = alignedOffset + size;
+		return block.data.get() + alignedOffset;
+	}
+
+	return allocateInNewBlock(buffer, size, alignment);
+}
+
+const char* JFF::FrameAllocator::format(const char* format, ...)
+{
+	va_list args;
+
+	// Measure the string first
+	va_start(args, format);
+	int length = std::vsnprintf(nullptr, 0, format, args);
+	va_end(args);
+
+	if (length < 0)
+	{
+		JFF_LOG_ERROR("Invalid format string in frame allocator")
+		return "";
+	}
+
+	char* str = allocateArray<char>((size_t)length + 1);
+	va_start(args, format);
+	std::vsnprintf(str, (size_t)length + 1, format, args);
+	va_end(args);
+
+	return str;
+}
+
+JFF::FrameAllocator::Marker JFF::FrameAllocator::getMarker() const
+{
+	const Buffer& buffer = buffers[currentBuffer];
+	return { buffer.currentBlock, buffer.offset };
+}
+
+void JFF::FrameAllocator::rewind(const Marker& marker)
+{
+	Buffer& buffer = buffers[currentBuffer];
+	buffer.currentBlock = marker.block;
+	buffer.offset = marker.offset;
+}
+
+size_t JFF::FrameAllocator::getFrameUsedBytes() const
+{
+	const Buffer& buffer = buffers[currentBuffer];
+
+	size_t usedBytes = buffer.offset;
+	for (size_t i = 0; i < buffer.currentBlock; ++i)
+		usedBytes += buffer.blocks[i].capacity;
+
+	return usedBytes;
+}
+
+inline void JFF::FrameAllocator::resetBuffer(Buffer& buffer)
+{
+	// Merge chained blocks in a single one, so next time this buffer is used it doesn't need to grow
+	if (buffer.blocks.size() > 1)
+	{
+		size_t totalCapacity = 0;
+		for (const Block& block : buffer.blocks)
+			totalCapacity += block.capacity;
+
+		buffer.blocks.clear();
+		buffer.blocks.push_back({ std::make_unique<unsigned char[]>(totalCapacity), totalCapacity });
+		JFF_LOG_INFO("Frame allocator buffer grown to " << totalCapacity << " bytes")
+	}
+
+	buffer.currentBlock = 0;
+	buffer.offset = 0;
+}
+
+inline void* JFF::FrameAllocator::allocateInNewBlock(Buffer& buffer, size_t size, size_t alignment)
+{
+	// Reuse next block if it was released by rewind() and it's big enough. Otherwise, chain a new one
+	size_t nextBlock = buffer.currentBlock + 1;
+	if (nextBlock < buffer.blocks.size() && buffer.blocks[nextBlock].capacity >= size)
+	{
+		buffer.currentBlock = nextBlock;
+		buffer.offset = size;
+		return buffer.blocks[nextBlock].data.get(); // Blocks are aligned to std::max_align_t
+	}
+
+	// Blocks grow geometrically to keep the number of chained blocks low
+	size_t capacity = std::max(size, buffer.blocks[buffer.currentBlock].capacity * 2);
+	buffer.blocks.insert(buffer.blocks.begin() + nextBlock, { std::make_unique<unsigned char[]>(capacity), capacity });
+	buffer.currentBlock = nextBlock;
+	buffer.offset = size;
+	return buffer.blocks[nextBlock].data.get();
+}
+
+JFF::FrameCommandQueue::FrameCommandQueue() :
+	first(nullptr),
+	last(nullptr)
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Ctor FrameCommandQueue")
+}
+
+JFF::FrameCommandQueue::~FrameCommandQueue()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Dtor FrameCommandQueue")
+	clear();
+}
+
+void JFF::FrameCommandQueue::dispatch()
+{
+	// Detach the list first. Commands can push new commands while they are called
+	Command* command = first;
+	first = nullptr;
+	last = nullptr;
+
+	while (command)
+	{
+		Command* next = command->next;
+		command->invoke(command->fn);
+		command->destroy(command->fn);
+		command = next;
+	}
+}
+
+void JFF::FrameCommandQueue::clear()
+{
+	Command* command = first;
+	first = nullptr;
+	last = nullptr;
+
+	while (command)
+	{
+		Command* next = command->next;
+		command->destroy(command->fn);
+		command = next;
+	}
+}
+
+bool JFF::FrameCommandQueue::empty() const
+{
+	return first == nullptr;
+}
\ No newline at end of file
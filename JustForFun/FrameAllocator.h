@@ -0,0 +1,164 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace JFF
+{
+	/*
+	* Double buffered linear allocator for transient data of a frame (uniform names, queued requests, temporary arrays...).
+	* Allocating is a pointer bump in the buffer of the current frame, and nothing is freed individually: a buffer is
+	* reset as a whole when it becomes the current one again. So, memory allocated during a frame is valid until the end
+	* of the next frame, which lets requests queued in a frame be consumed in the next one.
+	*
+	* If a frame needs more memory than its buffer has, new blocks are chained to it, and the buffer is merged in a single
+	* block big enough on its next reset. After a few frames, allocations never touch the heap
+	*/
+	class FrameAllocator final
+	{
+	public:
+		// A position inside the current buffer. Check rewind()
+		struct Marker
+		{
+			size_t block;
+			size_t offset;
+		};
+
+		// Rewinds the allocator to the position it had on construction when the scope ends
+		class Scope final
+		{
+		public:
+			explicit Scope(FrameAllocator& allocator) : allocator(allocator), marker(allocator.getMarker()) {}
+			~Scope() { allocator.rewind(marker); }
+
+			Scope(const Scope& other) = delete;
+			Scope& operator=(const Scope& other) = delete;
+			Scope(Scope&& other) = delete;
+			Scope operator=(Scope&& other) = delete;
+
+		private:
+			FrameAllocator& allocator;
+			Marker marker;
+		};
+
+	public:
+		// Ctor & Dtor
+		explicit FrameAllocator(size_t initialBytesPerFrame = DEFAULT_BYTES_PER_FRAME);
+		~FrameAllocator();
+
+		// Copy ctor and copy assignment
+		FrameAllocator(const FrameAllocator& other) = delete;
+		FrameAllocator& operator=(const FrameAllocator& other) = delete;
+
+		// Move ctor and assignment
+		FrameAllocator(FrameAllocator&& other) = delete;
+		FrameAllocator operator=(FrameAllocator&& other) = delete;
+
+		// Swaps buffers and resets the new current one. Memory allocated two frames ago is not valid anymore
+		void beginFrame();
+
+		// Returns uninitialized memory valid until the end of next frame. Alignment can't be bigger than std::max_align_t
+		void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		// Uninitialized array of count elements. Destructors are never called, so T must be trivially destructible
+		template<typename T>
+		T* allocateArray(size_t count);
+
+		// Creates an object. Destructors are never called, so T must be trivially destructible
+		template<typename T, typename ...Args>
+		T* create(Args&&... args);
+
+		// Writes a printf formatted null-terminated string
+		const char* format(const char* format, ...);
+
+		// Position in current buffer. Everything allocated after it can be released with rewind(), in the same frame
+		Marker getMarker() const;
+		void rewind(const Marker& marker);
+
+		// Bytes allocated in the current frame
+		size_t getFrameUsedBytes() const;
+
+	public:
+		static const size_t DEFAULT_BYTES_PER_FRAME;
+
+	private:
+		struct Block
+		{
+			std::unique_ptr<unsigned char[]> data;
+			size_t capacity;
+		};
+
+		struct Buffer
+		{
+			std::vector<Block> blocks;
+			size_t currentBlock;
+			size_t offset;
+		};
+
+		inline void resetBuffer(Buffer& buffer);
+		inline void* allocateInNewBlock(Buffer& buffer, size_t size, size_t alignment);
+
+	private:
+		Buffer buffers[2];
+		int currentBuffer;
+	};
+
+	/*
+	* List of deferred calls stored in frame memory, for requests that are executed later in the same frame or on the
+	* next one (Spawn game objects, change their state...). Pushing a call doesn't allocate heap memory, unlike
+	* std::function with captures. All pushed calls must be dispatched or cleared before the end of next frame
+	*/
+	class FrameCommandQueue final
+	{
+	public:
+		// Ctor & Dtor
+		FrameCommandQueue();
+		~FrameCommandQueue();
+
+		// Copy ctor and copy assignment
+		FrameCommandQueue(const FrameCommandQueue& other) = delete;
+		FrameCommandQueue& operator=(const FrameCommandQueue& other) = delete;
+
+		// Move ctor and assignment
+		FrameCommandQueue(FrameCommandQueue&& other) = delete;
+		FrameCommandQueue operator=(FrameCommandQueue&& other) = delete;
+
+		// Stores a callable in frame memory. It will be called with no arguments
+		template<typename Fn>
+		void push(FrameAllocator& allocator, Fn&& fn);
+
+		// Calls all pushed commands in push order and destroys them. Commands pushed meanwhile are kept for next dispatch
+		void dispatch();
+
+		// Destroys all pushed commands without calling them
+		void clear();
+
+		bool empty() const;
+
+	private:
+		struct Command
+		{
+			void (*invoke)(void* fn);
+			void (*destroy)(void* fn);
+			void* fn;
+			Command* next;
+		};
+
+		Command* first;
+		Command* last;
+	};
+}
+
+// Include template definitions
+#include "FrameAllocator.inl"
\ No newline at end of file
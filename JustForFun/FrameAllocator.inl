@@ -0,0 +1,49 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "FrameAllocator.h"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename T>
+inline T* JFF::FrameAllocator::allocateArray(size_t count)
+{
+	static_assert(std::is_trivially_destructible<T>::value, "Frame memory is never destroyed. T must be trivially destructible");
+	return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+}
+
+template<typename T, typename ...Args>
+inline T* JFF::FrameAllocator::create(Args&&... args)
+{
+	static_assert(std::is_trivially_destructible<T>::value, "Frame memory is never destroyed. T must be trivially destructible");
+	return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+}
+
+template<typename Fn>
+inline void JFF::FrameCommandQueue::push(FrameAllocator& allocator, Fn&& fn)
+{
+	using FnType = std::decay_t<Fn>;
+
+	// The callable can hold non trivial captures (shared_ptr...), so its destructor is called by the queue
+	Command* command = static_cast<Command*>(allocator.allocate(sizeof(Command), alignof(Command)));
+	command->fn = new (allocator.allocate(sizeof(FnType), alignof(FnType))) FnType(std::forward<Fn>(fn));
+	command->invoke = [](void* fn) { (*static_cast<FnType*>(fn))(); };
+	command->destroy = [](void* fn) { static_cast<FnType*>(fn)->~FnType(); };
+	command->next = nullptr;
+
+	if (last)
+		last->next = command;
+	else
+		first = command;
+
+	last = command;
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -120,6 +120,7 @@ namespace JFF
 			bool HDR;						// Only valid for color attachments
 			unsigned int numColorChannels;	// Only valid for color attachments
 			int mipmapLevel;				// Default is zero. This uses a lower res version of this texture (e.g. level=1 -> width/2 height/2 with bilinear filter)
+			bool mipmaps;					// Allocates the whole mip chain. Needed to render to or sample from levels other than zero
 		};
 
 		struct Params
@@ -159,6 +160,19 @@ namespace JFF
 		// Get the size of buffer on attachment point. Attached mipmap level alter the resulting size
 		virtual void getSize(AttachmentPoint attachmentPoint, unsigned int& width, unsigned int& height) = 0;
 
+		/*
+		* Attach another mip level of a 2D texture as render target. The texture must have mipmaps (mipmap level > 0 or
+		* AttachmentData::mipmaps set). Attached mipmap level alter the size returned by getSize().
+		* WARNING: This function leaves this framebuffer bound. Not allowed in multisample framebuffers
+		*/
+		virtual void setRenderMipLevel(AttachmentPoint attachmentPoint, int mipLevel) = 0;
+
+		/*
+		* Restrict sampling of a 2D texture to one mip level, which is seen as level 0 in shaders (e.g. textureSize(sampler, 0)).
+		* This allows rendering to a mip level of a texture while sampling another one of the same texture
+		*/
+		virtual void setSampledMipLevel(AttachmentPoint attachmentPoint, int mipLevel) = 0;
+
 		/*
 		* Copy the pixels from src buffer's attachment point to this buffer.
 		* In case of copying depth, stencil or depth-stencil buffers, both attachment points should be DEPTH, STENCIL, or DEPTH_STENCIL.
@@ -166,7 +180,21 @@ namespace JFF
 		*/
 		virtual void copyBuffer(AttachmentPoint dstAttachmentPoint, AttachmentPoint srcAttachmentPoint, std::weak_ptr<Framebuffer> src) = 0;
 
+		/*
+		* Same as copyBuffer(), but only the pixels in the rectangle at (x, y) with given width and height are copied. Both buffers
+		* use the same rectangle. In cubemaps, the rectangle is copied on all faces.
+		* WARNING: This function could change internal currently bound framebuffers
+		*/
+		virtual void copyBufferRegion(AttachmentPoint dstAttachmentPoint, AttachmentPoint srcAttachmentPoint, std::weak_ptr<Framebuffer> src,
+			int x, int y, int width, int height) = 0;
+
 		// Free GPU memory of this framebuffer making it useless
 		virtual void destroy() = 0;
+
+		/*
+		* Same as writeToFile(), but the render loop doesn't wait for the GPU nor for the encoding: pixels are copied to a GPU
+		* buffer and the file is written some frames later by a worker thread
+		*/
+		virtual void writeToFileAsync(const char* newFilename, bool storeInGeneratedSubfolder = true) = 0;
 	};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -14,6 +14,7 @@
 
 #include "stb_image_write.h"
 #include "FileSystemSetup.h"
+#include "ImageReadbackGLSTBI.h"
 
 #include <sstream>
 #include <vector>
@@ -67,115 +68,7 @@ JFF::FramebufferGLSTBI::~FramebufferGLSTBI()
 
 void JFF::FramebufferGLSTBI::writeToFile(const char* newFilename, bool storeInGeneratedSubfolder)
 {
-	// Select main FBO or aux FBO depending if this framebuffer is multisample
-	if (samplesPerPixel > 1)
-	{
-		// Resolve buffers in case of multisample framebuffer
-		//disable();
-
-		JFF_LOG_ERROR("Cannot write multisample framebuffer to disk. Not implemented")
-		return;
-		// TODO: Implement
-	}
-
-	// Use main framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, mainFBO.fbo);
-
-	// Full path
-	std::ostringstream oss;
-	oss << "Assets" << JFF_SLASH;
-	if (storeInGeneratedSubfolder)
-		oss << "Generated" << JFF_SLASH;
-	oss << newFilename;
-
-	std::string relativePath = oss.str();
-
-	// TODO: mipmaps
-
-	// Loop over all attachment points and create a file with their content
-	for (auto& pair : mainFBO.fboAttachments)
-	{
-		if (pair.second.texType == TextureType::CUBEMAP)
-		{
-			JFF_LOG_WARNING("Cannot write to disk a framebuffer channel based in a cubemap texture")
-			continue;
-		}
-
-		if (pair.first == AttachmentPoint::DEPTH || pair.first == AttachmentPoint::STENCIL || pair.first == AttachmentPoint::DEPTH_STENCIL)
-		{
-			continue; // Cannot write to disk framebuffer channels: depth, stencil and depth_stencil
-		}
-
-		glReadBuffer(GL_COLOR_ATTACHMENT0 + (char)pair.first);
-
-		if (pair.second.HDR)
-		{
-			/* 
-			* NOTE: As STBI documentation says: 
-			* 
-			* HDR expects linear float data. Since the format is always 32 - bit rgb(e)
-			* data, alpha (if provided) is discarded, and for monochrome data it is
-			* replicated across all three channels.
-			*/
-
-			/*
-			* WARNING: STBI can't store negative floats on disk. Don not use this function to store textures like
-			* position or normals
-			*/
-
-			// HDR have .hdr extension
-			oss.str("");
-			if (mainFBO.fboAttachments.size() == 1)
-				oss << relativePath << ".hdr";
-			else
-				oss << relativePath << "_color_" << (int) pair.first << ".hdr";
-
-			std::string fullPath = oss.str();
-
-			unsigned int width	= pair.second.width;
-			unsigned int height = pair.second.height;
-			int numChannels		= pair.second.numColorChannels;
-			GLenum format		= imgFormatToGL(pair.first, numChannels);
-			GLenum type			= GL_FLOAT;
-			float* pixels		= new float[(size_t) width * height * numChannels]; // TODO: Keep in mind memory alignment (glPixelStorei())
-
-			glReadPixels(0, 0, width, height, format, type, pixels);
-			stbi_write_hdr(fullPath.c_str(), width, height, numChannels, pixels);
-
-			delete[] pixels;
-		}
-		else
-		{
-			// Non HDR have .png extension
-			oss.str("");
-			if (mainFBO.fboAttachments.size() == 1)
-				oss << relativePath << ".png";
-			else
-				oss << relativePath << "_color_" << (int) pair.first << ".png";
-
-			std::string fullPath = oss.str();
-
-			unsigned int width	  = pair.second.width;
-			unsigned int height   = pair.second.height;
-			int numChannels		  = pair.second.numColorChannels;
-			GLenum format		  = imgFormatToGL(pair.first, numChannels);
-			GLenum type			  = GL_UNSIGNED_BYTE;
-			unsigned char* pixels = new unsigned char[(size_t) width * height * numChannels]; // TODO: Keep in mind memory alignment (glPixelStorei())
-					
-			glReadPixels(0, 0, width, height, format, type, pixels);
-			stbi_write_png(fullPath.c_str(), width, height, numChannels, pixels, /* Stride between rows */ 0);
-
-			delete[] pixels;
-		}
-		
-	} // End for loop
-
-	// We have to tell OpenGL we are rendering to multiple color buffers or none of them
-	configureReadAndWriteColorBuffers();
-
-	// Bind main screen framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	
+	writeColorAttachmentsToFile(newFilename, storeInGeneratedSubfolder, /* async = */ false);
 }
 
 void JFF::FramebufferGLSTBI::enable(bool clearBuffers)
@@ -310,10 +203,77 @@ void JFF::FramebufferGLSTBI::getSize(AttachmentPoint attachmentPoint, unsigned i
 	}
 }
 
+void JFF::FramebufferGLSTBI::setRenderMipLevel(AttachmentPoint attachmentPoint, int mipLevel)
+{
+	if (samplesPerPixel > 1)
+	{
+		JFF_LOG_WARNING("Multisample framebuffers don't allow textures with mipmap level other than 0. Aborted")
+		return;
+	}
+
+	try
+	{
+		AttachmentDataInternal& attachmentData = mainFBO.fboAttachments.at(attachmentPoint);
+
+		if (attachmentData.renderBuffer || attachmentData.texType != TextureType::TEXTURE_2D)
+		{
+			JFF_LOG_WARNING("Only 2D textures can change their attached mipmap level. Aborted")
+			return;
+		}
+
+		attachmentData.mipmapLevel = mipLevel; // Also keeps getSize() and setSize() coherent with the attached level
+
+		glBindFramebuffer(GL_FRAMEBUFFER, mainFBO.fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentPointToGL(attachmentPoint), GL_TEXTURE_2D, attachmentData.buffer, mipLevel);
+	}
+	catch (std::out_of_range e)
+	{
+		JFF_LOG_WARNING("Attachment point not found on current Framebuffer. Aborted")
+	}
+}
+
+void JFF::FramebufferGLSTBI::setSampledMipLevel(AttachmentPoint attachmentPoint, int mipLevel)
+{
+	try
+	{
+		AttachmentDataInternal& attachmentData = samplesPerPixel > 1 ?
+			auxFBO.fboAttachments.at(attachmentPoint) : mainFBO.fboAttachments.at(attachmentPoint);
+
+		if (attachmentData.renderBuffer || attachmentData.texType != TextureType::TEXTURE_2D)
+		{
+			JFF_LOG_WARNING("Only 2D textures can restrict their sampled mipmap level. Aborted")
+			return;
+		}
+
+		// Sampling only one level avoids feedback loops when other level of the same texture is attached for rendering
+		glBindTexture(GL_TEXTURE_2D, attachmentData.buffer);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mipLevel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevel);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+	catch (std::out_of_range e)
+	{
+		JFF_LOG_WARNING("Attachment point not found on current Framebuffer. Aborted")
+	}
+}
+
 void JFF::FramebufferGLSTBI::copyBuffer(
 	AttachmentPoint dstAttachmentPoint, 
 	AttachmentPoint srcAttachmentPoint,
 	std::weak_ptr<Framebuffer> src)
+{
+	// Use width and height of this FBO's attachment point. Sizes on both buffers should be equal
+	unsigned int w = mainFBO.fboAttachments[dstAttachmentPoint].width;
+	unsigned int h = mainFBO.fboAttachments[dstAttachmentPoint].height;
+
+	copyBufferRegion(dstAttachmentPoint, srcAttachmentPoint, src, 0, 0, w, h);
+}
+
+void JFF::FramebufferGLSTBI::copyBufferRegion(
+	AttachmentPoint dstAttachmentPoint,
+	AttachmentPoint srcAttachmentPoint,
+	std::weak_ptr<Framebuffer> src,
+	int x, int y, int width, int height)
 {
 	std::shared_ptr<FramebufferGLSTBI> srcGL = std::dynamic_pointer_cast<FramebufferGLSTBI>(src.lock());
 	if (srcGL)
@@ -321,9 +281,8 @@ void JFF::FramebufferGLSTBI::copyBuffer(
 		glBindFramebuffer(GL_READ_FRAMEBUFFER, srcGL->mainFBO.fbo);
 		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->mainFBO.fbo);
 
-		// Use width and height of this FBO's attachment point. Sizes on both buffers should be equal
-		unsigned int w = mainFBO.fboAttachments[dstAttachmentPoint].width;
-		unsigned int h = mainFBO.fboAttachments[dstAttachmentPoint].height;
+		int x1 = x + width;
+		int y1 = y + height;
 
 		if (dstAttachmentPoint == AttachmentPoint::DEPTH)
 		{
@@ -333,7 +292,27 @@ void JFF::FramebufferGLSTBI::copyBuffer(
 				return;
 			}
 
-			glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+			// Blits only use the first layer of layered attachments, so cubemap faces are attached and copied one by one
+			const AttachmentDataInternal& dstData = mainFBO.fboAttachments[AttachmentPoint::DEPTH];
+			const AttachmentDataInternal& srcData = srcGL->mainFBO.fboAttachments[AttachmentPoint::DEPTH];
+			if (!dstData.renderBuffer && dstData.texType == TextureType::CUBEMAP && 
+				!srcData.renderBuffer && srcData.texType == TextureType::CUBEMAP)
+			{
+				for (int face = 0; face < 6; ++face)
+				{
+					glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, srcData.buffer, srcData.mipmapLevel);
+					glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, dstData.buffer, dstData.mipmapLevel);
+					glBlitFramebuffer(x, y, x1, y1, x, y, x1, y1, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+				}
+
+				// Restore layered attachments
+				glFramebufferTexture(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, srcData.buffer, srcData.mipmapLevel);
+				glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, dstData.buffer, dstData.mipmapLevel);
+			}
+			else
+			{
+				glBlitFramebuffer(x, y, x1, y1, x, y, x1, y1, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+			}
 		}
 		else if (dstAttachmentPoint == AttachmentPoint::STENCIL)
 		{
@@ -343,7 +322,7 @@ void JFF::FramebufferGLSTBI::copyBuffer(
 				return;
 			}
 
-			glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+			glBlitFramebuffer(x, y, x1, y1, x, y, x1, y1, GL_STENCIL_BUFFER_BIT, GL_NEAREST);
 		}
 		else if (dstAttachmentPoint == AttachmentPoint::DEPTH_STENCIL)
 		{
@@ -353,14 +332,14 @@ void JFF::FramebufferGLSTBI::copyBuffer(
 				return;
 			}
 
-			glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+			glBlitFramebuffer(x, y, x1, y1, x, y, x1, y1, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
 		}
 		else
 		{
 			glReadBuffer(GL_COLOR_ATTACHMENT0 + (char) srcAttachmentPoint);
 			glDrawBuffer(GL_COLOR_ATTACHMENT0 + (char) dstAttachmentPoint);
 
-			glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			glBlitFramebuffer(x, y, x1, y1, x, y, x1, y1, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
 			glBindFramebuffer(GL_FRAMEBUFFER, this->mainFBO.fbo);
 			this->configureReadAndWriteColorBuffers();
@@ -412,6 +391,142 @@ void JFF::FramebufferGLSTBI::destroy()
 	mainFBOColorBuffersUsed.clear();
 }
 
+void JFF::FramebufferGLSTBI::writeToFileAsync(const char* newFilename, bool storeInGeneratedSubfolder)
+{
+	writeColorAttachmentsToFile(newFilename, storeInGeneratedSubfolder, /* async = */ true);
+}
+
+inline void JFF::FramebufferGLSTBI::writeColorAttachmentsToFile(const char* newFilename, bool storeInGeneratedSubfolder, bool async)
+{
+	// Select main FBO or aux FBO depending if this framebuffer is multisample
+	if (samplesPerPixel > 1)
+	{
+		// Resolve buffers in case of multisample framebuffer
+		//disable();
+
+		JFF_LOG_ERROR("Cannot write multisample framebuffer to disk. Not implemented")
+		return;
+		// TODO: Implement
+	}
+
+	// Use main framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, mainFBO.fbo);
+
+	// Full path
+	std::ostringstream oss;
+	oss << "Assets" << JFF_SLASH;
+	if (storeInGeneratedSubfolder)
+		oss << "Generated" << JFF_SLASH;
+	oss << newFilename;
+
+	std::string relativePath = oss.str();
+
+	// TODO: mipmaps
+
+	// Loop over all attachment points and create a file with their content
+	for (auto& pair : mainFBO.fboAttachments)
+	{
+		if (pair.second.texType == TextureType::CUBEMAP)
+		{
+			JFF_LOG_WARNING("Cannot write to disk a framebuffer channel based in a cubemap texture")
+			continue;
+		}
+
+		if (pair.first == AttachmentPoint::DEPTH || pair.first == AttachmentPoint::STENCIL || pair.first == AttachmentPoint::DEPTH_STENCIL)
+		{
+			continue; // Cannot write to disk framebuffer channels: depth, stencil and depth_stencil
+		}
+
+		glReadBuffer(GL_COLOR_ATTACHMENT0 + (char)pair.first);
+
+		if (async)
+		{
+			// Readback adds .hdr or .png extension
+			oss.str("");
+			if (mainFBO.fboAttachments.size() == 1)
+				oss << relativePath;
+			else
+				oss << relativePath << "_color_" << (int) pair.first;
+
+			ImageReadbackGLSTBI::Request request;
+			request.filePath	= oss.str();
+			request.width		= pair.second.width;
+			request.height		= pair.second.height;
+			request.numChannels = pair.second.numColorChannels;
+			request.HDR			= pair.second.HDR;
+			request.imgFormat	= imgFormatToGL(pair.first, pair.second.numColorChannels);
+
+			ImageReadbackGLSTBI::getInstance().readPixels(request);
+		}
+		else if (pair.second.HDR)
+		{
+			/* 
+			* NOTE: As STBI documentation says: 
+			* 
+			* HDR expects linear float data. Since the format is always 32 - bit rgb(e)
+			* data, alpha (if provided) is discarded, and for monochrome data it is
+			* replicated across all three channels.
+			*/
+
+			/*
+			* WARNING: STBI can't store negative floats on disk. Don not use this function to store textures like
+			* position or normals
+			*/
+
+			// HDR have .hdr extension
+			oss.str("");
+			if (mainFBO.fboAttachments.size() == 1)
+				oss << relativePath << ".hdr";
+			else
+				oss << relativePath << "_color_" << (int) pair.first << ".hdr";
+
+			std::string fullPath = oss.str();
+
+			unsigned int width	= pair.second.width;
+			unsigned int height = pair.second.height;
+			int numChannels		= pair.second.numColorChannels;
+			GLenum format		= imgFormatToGL(pair.first, numChannels);
+			GLenum type			= GL_FLOAT;
+			float* pixels		= new float[(size_t) width * height * numChannels]; // TODO: Keep in mind memory alignment (glPixelStorei())
+
+			glReadPixels(0, 0, width, height, format, type, pixels);
+			stbi_write_hdr(fullPath.c_str(), width, height, numChannels, pixels);
+
+			delete[] pixels;
+		}
+		else
+		{
+			// Non HDR have .png extension
+			oss.str("");
+			if (mainFBO.fboAttachments.size() == 1)
+				oss << relativePath << ".png";
+			else
+				oss << relativePath << "_color_" << (int) pair.first << ".png";
+
+			std::string fullPath = oss.str();
+
+			unsigned int width	  = pair.second.width;
+			unsigned int height   = pair.second.height;
+			int numChannels		  = pair.second.numColorChannels;
+			GLenum format		  = imgFormatToGL(pair.first, numChannels);
+			GLenum type			  = GL_UNSIGNED_BYTE;
+			unsigned char* pixels = new unsigned char[(size_t) width * height * numChannels]; // TODO: Keep in mind memory alignment (glPixelStorei())
+					
+			glReadPixels(0, 0, width, height, format, type, pixels);
+			stbi_write_png(fullPath.c_str(), width, height, numChannels, pixels, /* Stride between rows */ 0);
+
+			delete[] pixels;
+		}
+		
+	} // End for loop
+
+	// We have to tell OpenGL we are rendering to multiple color buffers or none of them
+	configureReadAndWriteColorBuffers();
+
+	// Bind main screen framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
 inline void JFF::FramebufferGLSTBI::extractParamsData(PrefabFramebuffer fboType, unsigned int width, unsigned int height, unsigned int samplesPerPixel)
 {
 	switch (fboType)
@@ -428,6 +543,7 @@ inline void JFF::FramebufferGLSTBI::extractParamsData(PrefabFramebuffer fboType,
 			textureData.HDR					= true;
 			textureData.numColorChannels	= 4;
 			textureData.mipmapLevel			= 0;
+			textureData.mipmaps				= false;
 
 			AttachmentData renderbufferData;
 			renderbufferData.width			= width;
@@ -454,6 +570,7 @@ inline void JFF::FramebufferGLSTBI::extractParamsData(PrefabFramebuffer fboType,
 			textureDataHighPrecision.HDR				= true; // High precision (GL_RGBA16F)
 			textureDataHighPrecision.numColorChannels	= 4;
 			textureDataHighPrecision.mipmapLevel		= 0;
+			textureDataHighPrecision.mipmaps			= false;
 
 			AttachmentData textureDataLowPrecision = textureDataHighPrecision;
 			textureDataLowPrecision.HDR	= false; // Low precision (GL_RGBA)
@@ -492,6 +609,7 @@ inline void JFF::FramebufferGLSTBI::extractParamsData(PrefabFramebuffer fboType,
 			textureDataHighPrecision.HDR				= true; // High precision (GL_RGBA16F)
 			textureDataHighPrecision.numColorChannels	= 4;
 			textureDataHighPrecision.mipmapLevel		= 0;
+			textureDataHighPrecision.mipmaps			= false;
 
 			AttachmentData renderbufferData;
 			renderbufferData.width = width;
@@ -523,6 +641,7 @@ inline void JFF::FramebufferGLSTBI::extractParamsData(PrefabFramebuffer fboType,
 			textureData.HDR					= true; // TODO: Is this precision really needed?
 			textureData.numColorChannels	= 4;
 			textureData.mipmapLevel			= 0;
+			textureData.mipmaps				= false;
 
 			Params params;
 			params.samplesPerPixel = 0u;
@@ -542,6 +661,7 @@ inline void JFF::FramebufferGLSTBI::extractParamsData(PrefabFramebuffer fboType,
 			textureData.borderColor		= Vec4(1.0f, 1.0f, 1.0f, 1.0f); // Use white as border color to make objects outside shadow map frustum (in x and y) to not have shadow
 			textureData.filterMode		= { MinificationFilter::NEAREST, MagnificationFilter::NEAREST };
 			textureData.mipmapLevel		= 0;
+			textureData.mipmaps			= false;
 
 			Params params;
 			params.samplesPerPixel = 0u;
@@ -560,6 +680,7 @@ inline void JFF::FramebufferGLSTBI::extractParamsData(PrefabFramebuffer fboType,
 			textureData.wrapMode		= { Wrap::CLAMP_TO_EDGE, Wrap::CLAMP_TO_EDGE, Wrap::CLAMP_TO_EDGE };
 			textureData.filterMode		= { MinificationFilter::NEAREST, MagnificationFilter::NEAREST };
 			textureData.mipmapLevel		= 0;
+			textureData.mipmaps			= false;
 
 			Params params;
 			params.samplesPerPixel = 0u;
@@ -593,6 +714,7 @@ inline void JFF::FramebufferGLSTBI::extractParamsData(const Params& params)
 		attachmentDataInternal.HDR				= attachmentData.HDR;
 		attachmentDataInternal.numColorChannels = attachmentData.numColorChannels;
 		attachmentDataInternal.mipmapLevel		= attachmentData.mipmapLevel;
+		attachmentDataInternal.mipmaps			= attachmentData.mipmaps;
 
 		// Fill the main fbo with params info
 		mainFBO.fboAttachments[attachmentPoint] = attachmentDataInternal;
@@ -902,9 +1024,9 @@ inline void JFF::FramebufferGLSTBI::createTexture2D(AttachmentPoint attachmentPo
 	glTexImage2D(GL_TEXTURE_2D, mipmapLevel, textureFormat, attachmentData.width, attachmentData.height,
 		border, imageFormat, imageType, pixels);
 
-	// Generate mipmaps if mipmap level request is greater than the default one (zero)
+	// Allocate the mip chain only if it was requested or a mipmap level other than the default one (zero) is attached
 	// TODO: This is suboptimal because we are generating a whole set of mipmaps, but framebuffer is gonna use only one of them
-	if (attachmentData.mipmapLevel > 0)
+	if (attachmentData.mipmaps || attachmentData.mipmapLevel > 0)
 	{
 		glGenerateMipmap(GL_TEXTURE_2D);
 	}
@@ -944,9 +1066,9 @@ inline void JFF::FramebufferGLSTBI::createCubemap(AttachmentPoint attachmentPoin
 		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mipmapLevel, textureFormat,
 			attachmentData.width, attachmentData.height, border, imageFormat, imageType, pixels);
 
-	// Generate mipmaps if mipmap level request is greater than the default one (zero)
+	// Allocate the mip chain only if it was requested or a mipmap level other than the default one (zero) is attached
 	// TODO: This is suboptimal because we are generating a whole set of mipmaps, but framebuffer is gonna use only one of them
-	if (attachmentData.mipmapLevel > 0)
+	if (attachmentData.mipmaps || attachmentData.mipmapLevel > 0)
 	{
 		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 	}
@@ -1093,9 +1215,9 @@ inline GLint JFF::FramebufferGLSTBI::texFormatToGL(AttachmentPoint attachmentPoi
 		// 16 bits per channel. This is used for HDR because this format doesn't clamp colors in range [0,1]
 		// NOTE: 4 byte color depth (GL_RGBA) is preferred on Windows platform for aligment purposes // TODO: Check
 		if (numColorChannels == 1)
-			return HDR ? GL_R16F : GL_RED;
+			return HDR ? GL_R16F : GL_R8;
 		else if (numColorChannels == 2)
-			return HDR ? GL_RG16F : GL_RG;
+			return HDR ? GL_RG16F : GL_RG8;
 		else if (numColorChannels == 3)
 			return HDR ? GL_RGB16F : GL_RGB;
 		else
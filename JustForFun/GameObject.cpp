@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,6 +11,7 @@
 #include "GameObject.h"
 
 #include "Log.h"
+#include "SceneStorage.h"
 
 #include <algorithm>
 
@@ -22,11 +23,18 @@ JFF::GameObject::GameObject(
 	const Vec3& localScale,
 	bool initiallyEnabled) :
 	engine(engine),
-	name(name),
 	transform(this, "Transform", /* Initially enabled */ true, localPosition, localRotation, localScale),
+	parent(),
+	name(name),
+	tag(),
 	enabled(initiallyEnabled),
+	storage(nullptr),
+	storageHandle(SceneStorage::INVALID_HANDLE),
 	components(),
-	parent()
+	componentsByType(),
+	updatableComponents(),
+	componentsToStart(),
+	componentStateChanges()
 {
 	JFF_LOG_INFO("Ctor GameObject")
 }
@@ -36,7 +44,10 @@ JFF::GameObject::~GameObject()
 	JFF_LOG_INFO("Dtor GameObject")
 
 	// Calls onDestroy() on all components before destruction
-	std::for_each(components.begin(), components.end(), [](const auto& pair) { pair.second->destroy(); });
+	std::for_each(components.begin(), components.end(), [](const auto& comp) { comp->destroy(); });
+
+	if (storage)
+		storage->remove(this);
 }
 
 void JFF::GameObject::findParent()
@@ -47,39 +58,61 @@ void JFF::GameObject::findParent()
 	parent = getIncomingEdge(0).lock()->getSrcNode();
 }
 
+void JFF::GameObject::setName(const std::string& name)
+{
+	// Keep the scene's name index up to date
+	if (storage)
+		storage->renameGameObject(storageHandle, this->name, name);
+
+	this->name = name;
+}
+
+void JFF::GameObject::setTag(const std::string& tag)
+{
+	if (storage)
+		storage->retagGameObject(storageHandle, this->tag, tag);
+
+	this->tag = tag;
+}
+
 void JFF::GameObject::setEnabled(bool enabled, bool applyRecursively)
 {
 	// Enable/Disable this GameObject
 	this->enabled = enabled;
+	if (storage)
+		storage->setEnabled(storageHandle, enabled);
 
 	if (applyRecursively)
 	{
 		// Apply to this GameObject's components
-		for (const auto& pair : components)
+		for (const auto& comp : components)
 		{
-			pair.second->setEnabled(enabled);
+			comp->setEnabled(enabled);
 		
 			/* 
 			* When disabling a Component and its parent GameObject at the same time, the component doesn't have the oportunity
 			* to execute to pass to a 'disabled' state. Next line solves that
 			*/
 			if (!enabled)
-				pair.second->execute();
+				comp->execute();
 		}
 
 		// Apply to child GameObjects
-		auto visitor = [enabled, applyRecursively](const std::weak_ptr<EdgeBase<GameObject>>& edge) 
-		{
-			edge.lock()->getDstNode().lock()->setEnabled(enabled, applyRecursively);
-		};
-		visitOutcomingEdges(visitor);
+		for (GameObject* child : outcomingNodes)
+			child->setEnabled(enabled, applyRecursively);
 	}
 }
 
 void JFF::GameObject::executeComponents()
 {
-	dispatchLoadComponents();	// Load all delay loaded components
-	updateComponents();	// Update Components
+	/*
+	* Components are executed in phases instead of calling Component::execute() on each one. Every phase is a tight
+	* loop over a plain list, and components that don't override onUpdate() are never touched on update
+	*/
+	dispatchLoadComponents();		// Load all delay loaded components
+	startComponents();				// onStart() on new components
+	applyComponentStateChanges();	// onEnable()/onDisable() on components whose state changed
+	updateComponents();				// onUpdate() on enabled components
 }
 
 inline void JFF::GameObject::dispatchLoadComponents()
@@ -91,7 +124,31 @@ inline void JFF::GameObject::dispatchLoadComponents()
 	}
 }
 
+inline void JFF::GameObject::startComponents()
+{
+	if (!componentsToStart.empty())
+	{
+		// NOTE: onStart() may add new components, which will be started on next frame
+		std::vector<Component*> toStart;
+		toStart.swap(componentsToStart);
+		for (Component* comp : toStart)
+			comp->start();
+	}
+}
+
+inline void JFF::GameObject::applyComponentStateChanges()
+{
+	if (!componentStateChanges.empty())
+	{
+		std::vector<Component*> stateChanges;
+		stateChanges.swap(componentStateChanges);
+		for (Component* comp : stateChanges)
+			comp->applyEnabledHint();
+	}
+}
+
 inline void JFF::GameObject::updateComponents()
 {
-	std::for_each(components.begin(), components.end(), [](const auto& pair) { pair.second->execute(); });
+	for (Component* comp : updatableComponents)
+		comp->update();
 }
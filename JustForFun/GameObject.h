@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -15,13 +15,17 @@
 #include "TransformComponent.h" // Includes Component inside
 
 #include <utility>
+#include <functional>
 
 namespace JFF
 {
 	class Engine;
+	class SceneStorage;
 
 	class GameObject final : public DirectedNodeBase<EdgeBase<GameObject>>
 	{
+		friend class SceneStorage;
+
 	public:
 		// Ctor & Dtor
 		explicit GameObject(
@@ -45,24 +49,38 @@ namespace JFF
 		void findParent();
 
 		// Name
-		void setName(const std::string& name) { this->name = name; }
+		void setName(const std::string& name);
 		std::string getName() const { return name; }
 
+		// Tag. Used to group GameObjects for fast lookups (Check Logic::findGameObjectsByTag()). Empty by default
+		void setTag(const std::string& tag);
+		std::string getTag() const { return tag; }
+
 		// State machine
 		void setEnabled(bool enabled, bool applyRecursively); // Can be applied recursively to child objects and their components
 		bool isEnabled() const { return enabled; }
 		void executeComponents();
 
+		// Called by Component::setEnabled(). The component changes its state on next executeComponents()
+		void queueComponentStateChange(Component* comp) { componentStateChanges.push_back(comp); }
+
+		// Scene storage where this GameObject's data is stored contiguously. nullptr if it isn't part of a scene yet
+		SceneStorage* getStorage() const { return storage; }
+		unsigned int getStorageHandle() const { return storageHandle; }
+
 		// Component management
 		template<typename C, typename...Args> std::weak_ptr<C> addComponent(const char* componentName, bool initiallyEnabled, const Args&...args);
 		template<typename C> std::weak_ptr<C> getComponent() const;
 		template<typename C> std::weak_ptr<C> getComponent(const std::string& componentName);
-		// TODO: Get all components of a class
+		template<typename C> std::vector<std::weak_ptr<C>> getComponents() const;
 		// TODO: Get components on children
 
 	protected:
 		inline void dispatchLoadComponents();
+		inline void startComponents();
+		inline void applyComponentStateChanges();
 		inline void updateComponents();
+		template<typename C> inline void registerComponent(const std::shared_ptr<C>& comp, bool updatable = ComponentOverridesOnUpdate<C>::value);
 
 	public:
 		Engine* const engine;
@@ -71,12 +89,27 @@ namespace JFF
 
 	protected:
 		std::string name;
+		std::string tag;
 	
 		// State machine attributes
 		bool enabled;
 
-		// List of components
-		std::vector<std::pair<std::string, std::shared_ptr<Component>>> components;
+		// Scene storage entry (Set by SceneStorage)
+		SceneStorage* storage;
+		unsigned int storageHandle;
+
+		// List of components, in execution order
+		std::vector<std::shared_ptr<Component>> components;
+
+		// Components indexed by their ComponentTypeID. Each slot stores all components of that exact type
+		std::vector<std::vector<std::shared_ptr<Component>>> componentsByType;
+
+		// Components that override onUpdate(), in execution order. The rest are never visited on update
+		std::vector<Component*> updatableComponents;
+
+		// Components registered since last executeComponents() (Pending onStart()) and components whose enabled state changed
+		std::vector<Component*> componentsToStart;
+		std::vector<Component*> componentStateChanges;
 
 		// Delay loaded lists
 		std::vector<std::function<void()>> delayLoadedComponents;
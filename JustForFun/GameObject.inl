@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -14,7 +14,6 @@
 #include "CameraComponent.h"
 
 #include <type_traits>
-#include <typeinfo>
 
 // ----------------------------------- GENERIC TEMPLATE DEFINITIONS ----------------------------------- //
 
@@ -29,8 +28,7 @@ inline std::weak_ptr<C> JFF::GameObject::addComponent(const char* componentName,
 	// Create a delay loaded function to add the Component to component list
 	auto delayLoadedComponentLambda = [this](const std::shared_ptr<C>& comp)
 	{
-		std::string componentName = typeid(C).name();
-		components.push_back(std::pair<std::string, std::shared_ptr<Component>>(componentName, comp));
+		registerComponent<C>(comp);
 	};
 	auto delayLoadedComponentFn = std::bind(delayLoadedComponentLambda, comp);
 	delayLoadedComponents.push_back(delayLoadedComponentFn);
@@ -43,21 +41,44 @@ inline std::weak_ptr<C> JFF::GameObject::getComponent() const
 {
 	static_assert(std::is_base_of_v<Component, C>, "Requested component must inherit from Component");
 
-	auto iter = std::find_if(components.begin(), components.end(), [](const auto& comp)
-		{
-			std::string componentName = typeid(C).name();
-			return componentName == comp.first;
-		});
-
-	if (iter != components.end())
-	{
-		std::shared_ptr<C> component = std::dynamic_pointer_cast<C>(iter->second); // If cast doesn't succeed, the shared ptr is empty
-		return component;
-	}
-	else
-	{
+	unsigned int typeID = ComponentTypeID::get<C>();
+	if (typeID >= componentsByType.size() || componentsByType[typeID].empty())
 		return std::weak_ptr<C>();
-	}
+
+	// Components are stored under the exact type they were added with, so the cast is always valid
+	return std::static_pointer_cast<C>(componentsByType[typeID].front());
+}
+
+template<typename C>
+inline std::vector<std::weak_ptr<C>> JFF::GameObject::getComponents() const
+{
+	static_assert(std::is_base_of_v<Component, C>, "Requested component must inherit from Component");
+
+	std::vector<std::weak_ptr<C>> result;
+
+	unsigned int typeID = ComponentTypeID::get<C>();
+	if (typeID >= componentsByType.size())
+		return result;
+
+	result.reserve(componentsByType[typeID].size());
+	for (const auto& comp : componentsByType[typeID])
+		result.push_back(std::static_pointer_cast<C>(comp));
+
+	return result;
+}
+
+template<typename C>
+inline void JFF::GameObject::registerComponent(const std::shared_ptr<C>& comp, bool updatable)
+{
+	components.push_back(comp);
+	componentsToStart.push_back(comp.get());
+	if (updatable)
+		updatableComponents.push_back(comp.get());
+
+	unsigned int typeID = ComponentTypeID::get<C>();
+	if (typeID >= componentsByType.size())
+		componentsByType.resize(typeID + 1u);
+	componentsByType[typeID].push_back(comp);
 }
 
 template<typename C>
@@ -67,12 +88,12 @@ inline std::weak_ptr<C> JFF::GameObject::getComponent(const std::string& compone
 
 	auto iter = std::find_if(components.begin(), components.end(), [&componentName](const auto& comp)
 		{
-			return componentName == comp.second->getName();
+			return componentName == comp->getName();
 		});
 	
 	if (iter != components.end())
 	{
-		std::shared_ptr<C> component = std::dynamic_pointer_cast<C>(iter->second); // If cast doesn't succeed, the shared ptr is empty
+		std::shared_ptr<C> component = std::dynamic_pointer_cast<C>(*iter); // If cast doesn't succeed, the shared ptr is empty
 		return component; 
  	}
 	else
@@ -101,8 +122,8 @@ inline std::weak_ptr<JFF::CameraComponent> JFF::GameObject::addComponent(
 	// Create a delay loaded function to add the Component to component list
 	auto delayLoadedComponentLambda = [this](const std::shared_ptr<CameraComponent>& comp)
 	{
-		std::string componentName = typeid(CameraComponent).name();
-		components.push_back(std::pair<std::string, std::shared_ptr<Component>>(componentName, comp));
+		// CameraComponent doesn't declare onUpdate(), but its implementations do
+		registerComponent<CameraComponent>(comp, true);
 	};
 	auto delayLoadedComponentFn = std::bind(delayLoadedComponentLambda, comp);
 	delayLoadedComponents.push_back(delayLoadedComponentFn);
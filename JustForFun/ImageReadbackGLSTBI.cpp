@@ -0,0 +1,293 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "ImageReadbackGLSTBI.h"
+
+#include "Log.h"
+
+#include "stb_image_write.h"
+
+#include <cstring>
+
+JFF::ImageReadbackGLSTBI& JFF::ImageReadbackGLSTBI::getInstance()
+{
+	static ImageReadbackGLSTBI instance;
+	return instance;
+}
+
+JFF::ImageReadbackGLSTBI::ImageReadbackGLSTBI() :
+	slots(),
+	nextSlot(0),
+
+	worker(),
+	mutex(),
+	jobsAvailable(),
+	jobsFinished(),
+	jobs(),
+	numUnfinishedJobs(0u),
+	failedWrites(),
+	stopWorker(false)
+{
+	JFF_LOG_INFO("Ctor ImageReadbackGLSTBI")
+}
+
+JFF::ImageReadbackGLSTBI::~ImageReadbackGLSTBI()
+{
+	JFF_LOG_INFO("Dtor ImageReadbackGLSTBI")
+
+	// GPU resources must be freed in destroy(), while the graphics context is alive. Here, only the worker thread is stopped
+	if (worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopWorker = true;
+		}
+		jobsAvailable.notify_all();
+		worker.join();
+	}
+}
+
+void JFF::ImageReadbackGLSTBI::readPixels(const Request& request)
+{
+	Slot& slot = acquireSlot(request);
+
+	// With a pixel pack buffer bound, the last param is an offset in the buffer and the call returns without waiting for the GPU
+	glPixelStorei(GL_PACK_ALIGNMENT, 1); // Rows without padding, as STBI expects
+	glReadPixels(0, 0, request.width, request.height, request.imgFormat, request.HDR ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	submitSlot(slot, request);
+}
+
+void JFF::ImageReadbackGLSTBI::readTexImage(GLenum target, int mipmapLevel, const Request& request)
+{
+	Slot& slot = acquireSlot(request);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1); // Rows without padding, as STBI expects
+	glGetTexImage(target, mipmapLevel, request.imgFormat, request.HDR ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	submitSlot(slot, request);
+}
+
+void JFF::ImageReadbackGLSTBI::update()
+{
+	// Slots are completed in the order they were submitted, starting from the oldest one
+	for (int i = 0; i < RING_SIZE; ++i)
+	{
+		Slot& slot = slots[(nextSlot + i) % RING_SIZE];
+		if (slot.fence && isSlotReady(slot, /* wait = */ false))
+			completeSlot(slot);
+	}
+
+	logFailedWrites();
+}
+
+void JFF::ImageReadbackGLSTBI::flush()
+{
+	for (int i = 0; i < RING_SIZE; ++i)
+	{
+		Slot& slot = slots[(nextSlot + i) % RING_SIZE];
+		if (slot.fence && isSlotReady(slot, /* wait = */ true))
+			completeSlot(slot);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		jobsFinished.wait(lock, [this]() { return numUnfinishedJobs == 0u; });
+	}
+
+	logFailedWrites();
+}
+
+void JFF::ImageReadbackGLSTBI::destroy()
+{
+	flush();
+
+	for (Slot& slot : slots)
+	{
+		if (slot.pbo)
+			glDeleteBuffers(1, &slot.pbo);
+
+		slot.pbo = 0;
+		slot.capacity = 0u;
+	}
+}
+
+void JFF::ImageReadbackGLSTBI::workerLoop()
+{
+	while (true)
+	{
+		EncodeJob job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobsAvailable.wait(lock, [this]() { return stopWorker || !jobs.empty(); });
+			if (jobs.empty())
+				return; // Stop requested and nothing left to encode
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		encode(job);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			--numUnfinishedJobs;
+		}
+		jobsFinished.notify_all();
+	}
+}
+
+inline JFF::ImageReadbackGLSTBI::Slot& JFF::ImageReadbackGLSTBI::acquireSlot(const Request& request)
+{
+	Slot& slot = slots[nextSlot];
+	nextSlot = (nextSlot + 1) % RING_SIZE;
+
+	// The ring is full. Wait for the oldest request, which is the one in this slot
+	if (slot.fence)
+	{
+		JFF_LOG_WARNING("Image readback ring is full. Waiting for the oldest image")
+		if (isSlotReady(slot, /* wait = */ true))
+			completeSlot(slot);
+	}
+
+	if (!slot.pbo)
+		glGenBuffers(1, &slot.pbo);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+
+	// Buffers only grow, so capturing images of the same size never allocates again
+	size_t size = getRequestSize(request);
+	if (slot.capacity < size)
+	{
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+		slot.capacity = size;
+	}
+
+	return slot;
+}
+
+inline void JFF::ImageReadbackGLSTBI::submitSlot(Slot& slot, const Request& request)
+{
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.request = request;
+}
+
+inline bool JFF::ImageReadbackGLSTBI::isSlotReady(Slot& slot, bool wait)
+{
+	// Flushing makes sure the fence reaches the GPU, otherwise waiting on it could never end
+	GLuint64 timeoutNanoseconds = wait ? 1000000000ull : 0ull;
+	GLenum result;
+	do
+	{
+		result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanoseconds);
+	} while (wait && result == GL_TIMEOUT_EXPIRED);
+
+	if (result == GL_WAIT_FAILED)
+	{
+		JFF_LOG_ERROR("Couldn't wait for image readback. Image discarded: " << slot.request.filePath)
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+		return false;
+	}
+
+	return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+inline void JFF::ImageReadbackGLSTBI::completeSlot(Slot& slot)
+{
+	size_t size = getRequestSize(slot.request);
+
+	EncodeJob job;
+	job.request = slot.request;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+	if (pixels)
+	{
+		job.pixels.resize(size);
+		std::memcpy(job.pixels.data(), pixels, size);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	glDeleteSync(slot.fence);
+	slot.fence = nullptr;
+
+	if (!pixels)
+	{
+		JFF_LOG_ERROR("Couldn't map image readback buffer. Image discarded: " << slot.request.filePath)
+		return;
+	}
+
+	// Encoding is slow, so it's done by the worker thread
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+		++numUnfinishedJobs;
+
+		if (!worker.joinable())
+			worker = std::thread(&ImageReadbackGLSTBI::workerLoop, this);
+	}
+	jobsAvailable.notify_one();
+}
+
+inline void JFF::ImageReadbackGLSTBI::logFailedWrites()
+{
+	std::vector<std::string> failed;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		failed.swap(failedWrites);
+	}
+
+#if defined(_DEBUG) && defined(_WIN64) // Same condition as Log.h. Failed paths are only drained in release
+	for (const std::string& filePath : failed)
+	{
+		JFF_LOG_ERROR("Couldn't write image to disk: " << filePath)
+	}
+#endif
+}
+
+inline void JFF::ImageReadbackGLSTBI::encode(const EncodeJob& job)
+{
+	const Request& request = job.request;
+
+	int result = 0;
+	if (request.HDR)
+	{
+		// HDR have .hdr extension
+		std::string fullPath = request.filePath + ".hdr";
+		result = stbi_write_hdr(fullPath.c_str(), request.width, request.height, request.numChannels,
+			reinterpret_cast<const float*>(job.pixels.data()));
+	}
+	else
+	{
+		// Non HDR have .png extension
+		std::string fullPath = request.filePath + ".png";
+		result = stbi_write_png(fullPath.c_str(), request.width, request.height, request.numChannels,
+			job.pixels.data(), /* Stride between rows */ 0);
+	}
+
+	// Log isn't thread safe, so failures are logged by the main thread
+	if (!result)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		failedWrites.push_back(request.filePath);
+	}
+}
+
+inline size_t JFF::ImageReadbackGLSTBI::getRequestSize(const Request& request) const
+{
+	size_t bytesPerChannel = request.HDR ? sizeof(float) : sizeof(unsigned char);
+	return (size_t)request.width * request.height * request.numChannels * bytesPerChannel;
+}
@@ -0,0 +1,115 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#define GLEW_STATIC // Used when linked against GLEW static library
+#include "GL/glew.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace JFF
+{
+	/*
+	* Writes images read from the GPU to disk without stalling the render loop. Pixels are copied to a ring of pixel buffer
+	* objects, which are mapped when their fence is signaled (usually one or two frames later). Then, a worker thread
+	* encodes them with STBI (PNG or HDR).
+	* Renderer calls update() once per frame and destroy() before the graphics context is destroyed
+	*/
+	class ImageReadbackGLSTBI final
+	{
+	public:
+		struct Request
+		{
+			std::string filePath; // Without extension. It's .hdr if HDR is true and .png otherwise
+			int width;
+			int height;
+			int numChannels;
+			bool HDR;			// Pixels are read as floats instead of bytes
+			GLenum imgFormat;	// Image format used to read the pixels (e.g. GL_RGBA)
+		};
+
+	public:
+		static ImageReadbackGLSTBI& getInstance();
+
+		// Copy ctor and copy assignment
+		ImageReadbackGLSTBI(const ImageReadbackGLSTBI& other) = delete;
+		ImageReadbackGLSTBI& operator=(const ImageReadbackGLSTBI& other) = delete;
+
+		// Move ctor and assignment
+		ImageReadbackGLSTBI(ImageReadbackGLSTBI&& other) = delete;
+		ImageReadbackGLSTBI operator=(ImageReadbackGLSTBI&& other) = delete;
+
+		// Queues a copy of the color buffer selected with glReadBuffer() in the framebuffer bound for reading
+		void readPixels(const Request& request);
+
+		// Queues a copy of a mip level of the texture bound to target in the active texture unit
+		void readTexImage(GLenum target, int mipmapLevel, const Request& request);
+
+		// Maps the pixel buffers that the GPU finished and sends their pixels to the worker thread. Call once per frame
+		void update();
+
+		// Waits until all queued images are written to disk
+		void flush();
+
+		// Flushes queued images, frees the pixel buffers and stops the worker thread
+		void destroy();
+
+	private:
+		// Ctor & Dtor
+		ImageReadbackGLSTBI();
+		~ImageReadbackGLSTBI();
+
+		struct Slot
+		{
+			GLuint pbo;
+			size_t capacity; // Size in bytes of the pixel buffer
+			GLsync fence; // nullptr if the slot is free
+			Request request;
+		};
+
+		struct EncodeJob
+		{
+			Request request;
+			std::vector<unsigned char> pixels;
+		};
+
+		inline Slot& acquireSlot(const Request& request);
+		inline void submitSlot(Slot& slot, const Request& request);
+		inline bool isSlotReady(Slot& slot, bool wait);
+		inline void completeSlot(Slot& slot);
+		inline void logFailedWrites();
+		inline void encode(const EncodeJob& job);
+		inline size_t getRequestSize(const Request& request) const;
+
+		void workerLoop();
+
+	private:
+		static const int RING_SIZE = 4; // If all slots are in use, the oldest one is waited for
+
+		Slot slots[RING_SIZE];
+		int nextSlot; // The oldest slot when the ring is full
+
+		// Worker thread. Jobs and counters are shared with it, so they're guarded by the mutex
+		std::thread worker;
+		std::mutex mutex;
+		std::condition_variable jobsAvailable;
+		std::condition_variable jobsFinished;
+		std::deque<EncodeJob> jobs;
+		size_t numUnfinishedJobs;
+		std::vector<std::string> failedWrites; // Logged from the main thread
+		bool stopWorker;
+	};
+}
@@ -3,13 +3,14 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "InputBindingAxesGLFW.h"
 #include "ContextGLFW.h"
+#include "MathFunctions.h"
 
 #include <sstream>
 
@@ -346,7 +347,7 @@ inline JFF::InputGLFW::MouseScrollCallback JFF::InputBindingAxesGLFW::createMous
 		}
 		else if (inputMapping == Mapping::MOUSE_SCROLL_DOWN)
 		{
-			Vec2 output(yoffset < 0.0 ? engine->math.lock()->abs(static_cast<float>(yoffset)) : 0.0f, 0.0f);
+			Vec2 output(yoffset < 0.0 ? JFF::abs(static_cast<float>(yoffset)) : 0.0f, 0.0f);
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -355,7 +356,7 @@ inline JFF::InputGLFW::MouseScrollCallback JFF::InputBindingAxesGLFW::createMous
 		}
 		else if (inputMapping == Mapping::MOUSE_SCROLL_LEFT)
 		{
-			Vec2 output(xoffset > 0.0 ? engine->math.lock()->abs(static_cast<float>(xoffset)) : 0.0f, 0.0f);
+			Vec2 output(xoffset > 0.0 ? JFF::abs(static_cast<float>(xoffset)) : 0.0f, 0.0f);
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -3,13 +3,14 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "InputBindingButtonGLFW.h"
 #include "ContextGLFW.h"
+#include "MathFunctions.h"
 
 #include <sstream>
 
@@ -260,7 +261,7 @@ inline JFF::InputGLFW::MousePosCallback JFF::InputBindingButtonGLFW::createMouse
 		if (inputMapping == Mapping::MOUSE_POSITION)
 		{
 			Vec2 mousePos(static_cast<float>(xpos), static_cast<float>(ypos));
-			bool output = engine->math.lock()->length(mousePos) > 0.0f;
+			bool output = JFF::length(mousePos) > 0.0f;
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -283,7 +284,7 @@ inline JFF::InputGLFW::MousePosCallback JFF::InputBindingButtonGLFW::createMouse
 				mouseDeltaAccum += newPos - lastMousePos; // Delta mouse accumulated
 				lastMousePos = newPos;
 
-				bool output = engine->math.lock()->length(mouseDeltaAccum) > 0.0f;
+				bool output = JFF::length(mouseDeltaAccum) > 0.0f;
 				output = applyProcessors(output); // Check processors
 				if (behavior) // Check behavior (press, release, hold, double hit, ...)
 					setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -333,7 +334,7 @@ inline JFF::InputGLFW::MouseScrollCallback JFF::InputBindingButtonGLFW::createMo
 		{
 			Vec2 scrollDir(static_cast<float>(xoffset), static_cast<float>(yoffset));
 
-			bool output = engine->math.lock()->length(scrollDir) > 0.0f;
+			bool output = JFF::length(scrollDir) > 0.0f;
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -465,7 +466,7 @@ inline JFF::InputGLFW::GamepadAxesCallback JFF::InputBindingButtonGLFW::createGa
 		{
 			Vec2 stickDir(gamepadState.axes[GLFW_GAMEPAD_AXIS_LEFT_X], gamepadState.axes[GLFW_GAMEPAD_AXIS_LEFT_Y]);
 
-			bool output = engine->math.lock()->length(stickDir) > 0.0f;
+			bool output = JFF::length(stickDir) > 0.0f;
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::GAMEPAD);
@@ -476,7 +477,7 @@ inline JFF::InputGLFW::GamepadAxesCallback JFF::InputBindingButtonGLFW::createGa
 		{
 			Vec2 stickDir(gamepadState.axes[GLFW_GAMEPAD_AXIS_RIGHT_X], gamepadState.axes[GLFW_GAMEPAD_AXIS_RIGHT_Y]);
 
-			bool output = engine->math.lock()->length(stickDir) > 0.0f;
+			bool output = JFF::length(stickDir) > 0.0f;
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::GAMEPAD);
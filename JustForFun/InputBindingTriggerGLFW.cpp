@@ -3,13 +3,14 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "InputBindingTriggerGLFW.h"
 #include "ContextGLFW.h"
+#include "MathFunctions.h"
 
 #include <sstream>
 
@@ -261,7 +262,7 @@ inline JFF::InputGLFW::MousePosCallback JFF::InputBindingTriggerGLFW::createMous
 		{
 			Vec2 mousePos(static_cast<float>(xpos), static_cast<float>(ypos));
 
-			float output = engine->math.lock()->length(mousePos);
+			float output = JFF::length(mousePos);
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -284,7 +285,7 @@ inline JFF::InputGLFW::MousePosCallback JFF::InputBindingTriggerGLFW::createMous
 				mouseDeltaAccum += newPos - lastMousePos; // Delta mouse accumulated
 				lastMousePos = newPos;
 
-				float output = engine->math.lock()->length(mouseDeltaAccum);
+				float output = JFF::length(mouseDeltaAccum);
 				output = applyProcessors(output); // Check processors
 				if (behavior) // Check behavior (press, release, hold, double hit, ...)
 					setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -334,7 +335,7 @@ inline JFF::InputGLFW::MouseScrollCallback JFF::InputBindingTriggerGLFW::createM
 		{
 			Vec2 scrollDir(static_cast<float>(xoffset), static_cast<float>(yoffset));
 
-			float output = engine->math.lock()->length(scrollDir);
+			float output = JFF::length(scrollDir);
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -354,7 +355,7 @@ inline JFF::InputGLFW::MouseScrollCallback JFF::InputBindingTriggerGLFW::createM
 		}
 		else if (inputMapping == Mapping::MOUSE_SCROLL_DOWN)
 		{
-			float output = yoffset < 0.0 ? engine->math.lock()->abs(static_cast<float>(yoffset)) : 0.0f;
+			float output = yoffset < 0.0 ? JFF::abs(static_cast<float>(yoffset)) : 0.0f;
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -363,7 +364,7 @@ inline JFF::InputGLFW::MouseScrollCallback JFF::InputBindingTriggerGLFW::createM
 		}
 		else if (inputMapping == Mapping::MOUSE_SCROLL_LEFT)
 		{
-			float output = xoffset > 0.0 ? engine->math.lock()->abs(static_cast<float>(xoffset)) : 0.0f;
+			float output = xoffset > 0.0 ? JFF::abs(static_cast<float>(xoffset)) : 0.0f;
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::MOUSE);
@@ -465,7 +466,7 @@ inline JFF::InputGLFW::GamepadAxesCallback JFF::InputBindingTriggerGLFW::createG
 		{
 			Vec2 stickDir(gamepadState.axes[GLFW_GAMEPAD_AXIS_LEFT_X], gamepadState.axes[GLFW_GAMEPAD_AXIS_LEFT_Y]);
 
-			float output = engine->math.lock()->length(stickDir);
+			float output = JFF::length(stickDir);
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::GAMEPAD);
@@ -476,7 +477,7 @@ inline JFF::InputGLFW::GamepadAxesCallback JFF::InputBindingTriggerGLFW::createG
 		{
 			Vec2 stickDir(gamepadState.axes[GLFW_GAMEPAD_AXIS_RIGHT_X], gamepadState.axes[GLFW_GAMEPAD_AXIS_RIGHT_Y]);
 
-			float output = engine->math.lock()->length(stickDir);
+			float output = JFF::length(stickDir);
 			output = applyProcessors(output); // Check processors
 			if (behavior) // Check behavior (press, release, hold, double hit, ...)
 				setActionValueCheckingBehavior(output, Input::Hardware::GAMEPAD);
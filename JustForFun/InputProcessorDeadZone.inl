@@ -3,12 +3,13 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "InputProcessorDeadZone.h"
+#include "MathFunctions.h"
 
 template<typename _Ret>
 inline JFF::InputProcessorDeadZone<_Ret>::InputProcessorDeadZone(Engine* const engine, float minValue, float maxValue) :
@@ -40,13 +41,11 @@ inline _Ret JFF::InputProcessorDeadZone<_Ret>::process(const _Ret& inputValue) c
 template<>
 inline JFF::Vec2 JFF::InputProcessorDeadZone<JFF::Vec2>::process(const JFF::Vec2& inputValue) const
 {
-	auto math = engine->math.lock();
-
 	// Split sign from value
 	float signX = inputValue.x >= 0.0f ? 1.0f : -1.0f;
 	float signY = inputValue.y >= 0.0f ? 1.0f : -1.0f;
-	float valueAbsX = math->abs(inputValue.x);
-	float valueAbsY = math->abs(inputValue.y);
+	float valueAbsX = JFF::abs(inputValue.x);
+	float valueAbsY = JFF::abs(inputValue.y);
 
 	// Transform X axis using transference function
 	float outputX;
@@ -66,5 +65,5 @@ inline JFF::Vec2 JFF::InputProcessorDeadZone<JFF::Vec2>::process(const JFF::Vec2
 	else
 		outputY = signY * (lineSlope * (valueAbsY + lineOffset)); // Use the Line function (y = ax + b) to renormalize values between 0 and 1
 
-	return Vec2(math->clamp(outputX, -1.0f, 1.0f), math->clamp(outputY, -1.0f, 1.0f));
+	return Vec2(JFF::clamp(outputX, -1.0f, 1.0f), JFF::clamp(outputY, -1.0f, 1.0f));
 }
\ No newline at end of file
@@ -3,12 +3,13 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "InputProcessorNormalizer.h"
+#include "MathFunctions.h"
 
 template<typename _Ret>
 inline JFF::InputProcessorNormalizer<_Ret>::InputProcessorNormalizer(Engine* const engine) :
@@ -34,6 +35,6 @@ inline _Ret JFF::InputProcessorNormalizer<_Ret>::process(const _Ret& inputValue)
 template<>
 inline JFF::Vec2 JFF::InputProcessorNormalizer<JFF::Vec2>::process(const JFF::Vec2& inputValue) const
 {
-	return engine->math.lock()->normalize(inputValue);
+	return JFF::normalize(inputValue);
 }
 
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -46,6 +46,15 @@ namespace JFF
 		virtual void enableShadowMapFramebuffer() = 0;
 		virtual void disableShadowMapFramebuffer() = 0;
 
+		// Returns true if this light caches the shadows of static casters in a second shadow map
+		virtual bool hasStaticShadowMap() const = 0;
+
+		// Use this light's static shadow map to be target of shadow rendering. Only static casters are rendered on it
+		virtual void enableStaticShadowMapFramebuffer() = 0;
+
+		// Copies the static shadow map to the shadow map used for lighting and makes the latter the target of shadow rendering
+		virtual void restoreStaticShadowMap() = 0;
+
 		// gets the size of the internal shadow map buffer if this light component casts shadows. Otherwise, this function returns Vec2::ZERO
 		virtual void getShadowMapSizePixels(unsigned int& outWidth, unsigned int& outHeight) const = 0;
 
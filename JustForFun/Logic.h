@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -78,5 +78,12 @@ namespace JFF
 		* If no GameObject was found, the list will be empty
 		**/
 		virtual std::vector<std::weak_ptr<GameObject>> findGameObjectsByName(const std::string& objName) const = 0;
+
+		/*
+		* Find all objects that have a specified tag (Check GameObject::setTag()).
+		* The search will include disabled GameObjects.
+		* If no GameObject was found, the list will be empty
+		**/
+		virtual std::vector<std::weak_ptr<GameObject>> findGameObjectsByTag(const std::string& tag) const = 0;
 	};
 }
\ No newline at end of file
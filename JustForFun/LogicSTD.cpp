@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,16 +11,13 @@
 #include "LogicSTD.h"
 
 #include "Log.h"
-#include "DFSAlgorithm.h"
+#include "Engine.h"
 
 JFF::LogicSTD::LogicSTD() : 
 	engine(nullptr),
 	activeScene(nullptr)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor subsystem: LogicSTD")
-
-	auto updateGameObjects = [](const std::weak_ptr<GameObject>& gameObj) { gameObj.lock()->executeComponents(); };
-	updateGameObjectsAlgorithm = std::make_shared<DFSAlgorithm<Scene, GameObject, EdgeBase<GameObject>>>(updateGameObjects);
 }
 
 JFF::LogicSTD::~LogicSTD()
@@ -100,7 +97,7 @@ std::weak_ptr<JFF::GameObject> JFF::LogicSTD::spawnGameObject(
 		activeScene->add(obj); // Adds the created object to the scene
 	};
 	auto spawnGameObjectFn = std::bind(spawnGameObjectLambda, obj);
-	delayLoadedGameObjects.push_back(spawnGameObjectFn);
+	delayLoadedGameObjects.push(engine->frameAllocator, std::move(spawnGameObjectFn));
 
 	// Return a weak ptr of created object
 	return obj;
@@ -129,7 +126,7 @@ std::weak_ptr<JFF::GameObject> JFF::LogicSTD::spawnGameObject(
 		activeScene->attach(parent, obj); // Attaches the created object to the parent
 	};
 	auto spawnGameObjectFn = std::bind(spawnGameObjectLambda, parent.lock(), obj);
-	delayLoadedGameObjects.push_back(spawnGameObjectFn);
+	delayLoadedGameObjects.push(engine->frameAllocator, std::move(spawnGameObjectFn));
 
 	// Return a weak ptr of created object
 	return obj;
@@ -142,22 +139,24 @@ void JFF::LogicSTD::setGameObjectEnabled(const std::weak_ptr<GameObject>& obj, b
 		obj->setEnabled(enabled, applyRecursively);
 	};
 	auto setStateFn = std::bind(setStateLambda, obj.lock(), enabled, applyRecursively);
-	delaySetStateGameObjects.push_back(setStateFn);
+	delaySetStateGameObjects.push(engine->frameAllocator, std::move(setStateFn));
 }
 
 std::vector<std::weak_ptr<JFF::GameObject>> JFF::LogicSTD::findGameObjectsByName(const std::string& objName) const
 {
-	std::vector<std::weak_ptr<GameObject>> searchResult;
+	if (!activeScene.get())
+		return std::vector<std::weak_ptr<GameObject>>();
 
-	auto lambda = [&searchResult, &objName](const std::weak_ptr<GameObject>& gameObj)
-	{
-		if (gameObj.lock()->getName() == objName)
-			searchResult.push_back(gameObj);
-	};
-	auto searchAlgorithm = std::make_shared<DFSAlgorithm<Scene, GameObject, EdgeBase<GameObject>>>(lambda, /* ignore disabled GameObjects = */ false);
-	activeScene->visitFromRoot<Scene, void>(searchAlgorithm);
+	// The scene storage keeps an index by name, updated on add, remove and rename
+	return activeScene->getStorage().findByName(objName);
+}
+
+std::vector<std::weak_ptr<JFF::GameObject>> JFF::LogicSTD::findGameObjectsByTag(const std::string& tag) const
+{
+	if (!activeScene.get())
+		return std::vector<std::weak_ptr<GameObject>>();
 
-	return searchResult;
+	return activeScene->getStorage().findByTag(tag);
 }
 
 inline void JFF::LogicSTD::dispatchLoadSceneRequests()
@@ -181,22 +180,19 @@ inline void JFF::LogicSTD::autoLoadSceneIfEmpty()
 inline void JFF::LogicSTD::dispatchSpawnGameObjectRequests()
 {
 	if (!delayLoadedGameObjects.empty())
-	{
-		std::for_each(delayLoadedGameObjects.begin(), delayLoadedGameObjects.end(), [](const std::function<void()>& fn) { fn(); });
-		delayLoadedGameObjects.clear();
-	}
+		delayLoadedGameObjects.dispatch();
 }
 
 inline void JFF::LogicSTD::dispatchSetGameObjectStateRequests()
 {
 	if (!delaySetStateGameObjects.empty())
-	{
-		std::for_each(delaySetStateGameObjects.begin(), delaySetStateGameObjects.end(), [](const std::function<void()>& fn) { fn(); });
-		delaySetStateGameObjects.clear();
-	}
+		delaySetStateGameObjects.dispatch();
 }
 
 inline void JFF::LogicSTD::updateGameObjects()
 {
-	activeScene->visitFromRoot<Scene, void>(updateGameObjectsAlgorithm);
+	// Linear passes over the scene storage instead of a graph traversal
+	SceneStorage& storage = activeScene->getStorage();
+	storage.executeEnabledGameObjects();
+	storage.updateTransforms(); // World matrices are ready for the renderer
 }
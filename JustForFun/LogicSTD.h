@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,6 +13,7 @@
 #include "Logic.h"
 #include "Scene.h"
 #include "GraphAlgorithm.h"
+#include "FrameAllocator.h"
 
 namespace JFF
 {
@@ -89,6 +90,13 @@ namespace JFF
 		**/
 		virtual std::vector<std::weak_ptr<GameObject>> findGameObjectsByName(const std::string& objName) const override;
 
+		/*
+		* Find all objects that have a specified tag (Check GameObject::setTag()).
+		* The search will include disabled GameObjects.
+		* If no GameObject was found, the list will be empty
+		**/
+		virtual std::vector<std::weak_ptr<GameObject>> findGameObjectsByTag(const std::string& tag) const override;
+
 	protected: // Helper functions
 		inline void dispatchLoadSceneRequests();
 		inline void autoLoadSceneIfEmpty();
@@ -100,12 +108,11 @@ namespace JFF
 		Engine* engine;
 
 		std::shared_ptr<Scene> activeScene;
-		std::shared_ptr<GraphAlgorithm<Scene, GameObject, EdgeBase<GameObject>, void>> updateGameObjectsAlgorithm;
 
-		// Delay loaded lists
+		// Delay loaded lists. Per-frame requests are stored in frame memory, they are dispatched on next execute()
 		std::vector<std::function<void()>> delayLoadedScenes;
-		std::vector<std::function<void()>> delayLoadedGameObjects;
-		std::vector<std::function<void()>> delaySetStateGameObjects;
+		FrameCommandQueue delayLoadedGameObjects;
+		FrameCommandQueue delaySetStateGameObjects;
 
 	};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -32,7 +32,6 @@
 //#include "Vec.h"
 //#include "Mat.h"
 //#include "Log.h"
-//#include "DFSAlgorithm.h"
 //#include "Node.h"
 //#include "DirectedNode.h"
 //#include "SimpleGraph.h"
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,6 +13,8 @@
 #include "MatSetup.h"
 #include "Vec.h"
 
+#include <type_traits>
+
 namespace JFF
 {
 	template<int _Dim>
@@ -23,15 +25,13 @@ namespace JFF
 	public:
 		explicit MatBase(float diagonalValue = 1.0f);
 		MatBase(JFF_MAT_IMPL_DEPENDENT_FUNC_PARAMS(_Dim));
-		~MatBase();
-
-		// Copy ctor and copy assignment
-		MatBase(const MatBase& other);
-		MatBase& operator=(const MatBase& other);
 
-		// Move ctor and assignment
-		MatBase(MatBase&& other) noexcept;
-		MatBase& operator=(MatBase&& other) noexcept;
+		// Copy, move and destruction are trivial, so matrices can be memcpy'd to GPU buffers as they are
+		MatBase(const MatBase& other) = default;
+		MatBase& operator=(const MatBase& other) = default;
+		MatBase(MatBase&& other) noexcept = default;
+		MatBase& operator=(MatBase&& other) noexcept = default;
+		~MatBase() = default;
 
 		// Matrix raw data
 		const float* operator*() const;
@@ -46,6 +46,8 @@ namespace JFF
 	using Mat3 = MatBase<3>;
 	using Mat4 = MatBase<4>;
 
+	static_assert(std::is_trivially_copyable<Mat4>::value && sizeof(Mat4) == 16 * sizeof(float), "Mat4 must be 16 tightly packed floats");
+
 	JFF_MAT_GLOBAL_FUNCTIONS
 }
 
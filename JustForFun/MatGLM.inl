@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,6 +11,7 @@
 #include "Mat.h"
 
 #include "Log.h"
+#include "GLM/gtc/matrix_transform.hpp"
 
 #pragma region Mat
 
@@ -28,42 +29,6 @@ inline JFF::MatBase<_Dim>::MatBase(JFF_MAT_IMPL_DEPENDENT_FUNC_PARAMS(_Dim)) :
 	JFF_LOG_INFO_LOW_PRIORITY("Platform dependant Ctor Mat")
 }
 
-template<int _Dim>
-inline JFF::MatBase<_Dim>::~MatBase()
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Dtor Mat")
-}
-
-template<int _Dim>
-inline JFF::MatBase<_Dim>::MatBase(const MatBase& other) :
-	_mat(other._mat)
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Copy Ctor Mat")
-}
-
-template<int _Dim>
-inline JFF::MatBase<_Dim>& JFF::MatBase<_Dim>::operator=(const MatBase& other)
-{
-	_mat = other._mat;
-	return *this;
-}
-
-template<int _Dim>
-inline JFF::MatBase<_Dim>::MatBase(MatBase&& other) noexcept :
-	_mat(other._mat)
-{
-	other._mat = glm::mat<_Dim, _Dim, float, glm::qualifier::defaultp>(0.0f);
-	JFF_LOG_INFO_LOW_PRIORITY("Move Ctor Mat")
-}
-
-template<int _Dim>
-inline JFF::MatBase<_Dim>& JFF::MatBase<_Dim>::operator=(MatBase&& other) noexcept
-{
-	_mat = other._mat;
-	other._mat = glm::mat<_Dim, _Dim, float, glm::qualifier::defaultp>(0.0f);
-	return *this;
-}
-
 template<int _Dim>
 inline const float* JFF::MatBase<_Dim>::operator*() const
 {
@@ -95,9 +60,50 @@ JFF::MatBase<_Dim> JFF::operator*(const MatBase<_Dim>& m1, const MatBase<_Dim>&
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::operator*(const MatBase<_Dim>& m, const VecBase<_Dim>& v)
 {
-	return m._mat * v._vec;
+	return m._mat * v._vec();
+}
+
+#ifdef JFF_MAT_SSE
+// 4x4 products are the hottest matrix operations (transform hierarchies, view-projection). Columns are combined with SSE
+template<>
+inline JFF::MatBase<4> JFF::operator*(const MatBase<4>& m1, const MatBase<4>& m2)
+{
+	const float* a = glm::value_ptr(m1._mat);
+	const float* b = glm::value_ptr(m2._mat);
+	__m128 a0 = _mm_loadu_ps(a);
+	__m128 a1 = _mm_loadu_ps(a + 4);
+	__m128 a2 = _mm_loadu_ps(a + 8);
+	__m128 a3 = _mm_loadu_ps(a + 12);
+
+	JFF_MAT_IMPL_DEPENDENT_TYPE(4) result;
+	float* r = glm::value_ptr(result);
+	for (int col = 0; col < 4; ++col)
+	{
+		const float* bCol = b + col * 4;
+		__m128 rCol = _mm_mul_ps(a0, _mm_set1_ps(bCol[0]));
+		rCol = _mm_add_ps(rCol, _mm_mul_ps(a1, _mm_set1_ps(bCol[1])));
+		rCol = _mm_add_ps(rCol, _mm_mul_ps(a2, _mm_set1_ps(bCol[2])));
+		rCol = _mm_add_ps(rCol, _mm_mul_ps(a3, _mm_set1_ps(bCol[3])));
+		_mm_storeu_ps(r + col * 4, rCol);
+	}
+	return result;
 }
 
+template<>
+inline JFF::VecBase<4> JFF::operator*(const MatBase<4>& m, const VecBase<4>& v)
+{
+	const float* a = glm::value_ptr(m._mat);
+	__m128 result = _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(v.x));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(a + 4), _mm_set1_ps(v.y)));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(a + 8), _mm_set1_ps(v.z)));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(a + 12), _mm_set1_ps(v.w)));
+
+	JFF_VEC_IMPL_DEPENDANT_TYPE(4) vec;
+	_mm_storeu_ps(glm::value_ptr(vec), result);
+	return vec;
+}
+#endif
+
 template<int _Dim>
 JFF::MatBase<_Dim> JFF::operator+(const MatBase<_Dim>& m)
 {
@@ -171,4 +177,45 @@ JFF::MatBase<_Dim> JFF::reduceOrder(const JFF::MatBase<_DimHigher>& m)
 	return JFF::MatBase<_Dim>(mReduced);
 }
 
+#pragma endregion
+
+#pragma region Mat4 transformations
+// Only 4x4 matrices can represent these transformations. Specializations are inline so they can be optimized at call site
+
+template<>
+inline JFF::MatBase<4> JFF::translate(const MatBase<4>& m, const Vec3& v)
+{
+	return glm::translate(m._mat, v._vec());
+}
+
+template<>
+inline JFF::MatBase<4> JFF::rotate(const MatBase<4>& m, float angleRadians, const Vec3& axisNormalized)
+{
+	return glm::rotate(m._mat, angleRadians, axisNormalized._vec());
+}
+
+template<>
+inline JFF::MatBase<4> JFF::scale(const MatBase<4>& m, const Vec3& v)
+{
+	return glm::scale(m._mat, v._vec());
+}
+
+template<>
+inline JFF::MatBase<4> JFF::lookAt(const Vec3& eye, const Vec3& center, const Vec3& up)
+{
+	return glm::lookAt(eye._vec(), center._vec(), up._vec());
+}
+
+template<>
+inline JFF::MatBase<4> JFF::ortho(float left, float right, float bottom, float top, float zNear, float zFar)
+{
+	return glm::ortho(left, right, bottom, top, zNear, zFar);
+}
+
+template<>
+inline JFF::MatBase<4> JFF::perspective(float fovyRad, float aspect, float zNear, float zFar)
+{
+	return glm::perspective(fovyRad, aspect, zNear, zFar);
+}
+
 #pragma endregion
\ No newline at end of file
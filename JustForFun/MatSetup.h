@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,19 +12,30 @@
 
 // Library dependant macros
 #if defined(JFF_GL) && defined(JFF_GLM)
+#	ifndef GLM_FORCE_INLINE
+#		define GLM_FORCE_INLINE // Vector and matrix functions are on the hottest paths of the engine
+#	endif
 #	include "GLM/glm.hpp"
 #	include "GLM/gtc/type_ptr.hpp"
 #	define JFF_MAT_IMPL_DEPENDENT_TYPE(_Dim) glm::mat<_Dim, _Dim, float, glm::qualifier::defaultp>
 #	define JFF_MAT_IMPL_DEPENDENT_ATTRS(_Dim) JFF_MAT_IMPL_DEPENDENT_TYPE(_Dim) _mat;
 #	define JFF_MAT_IMPL_DEPENDENT_FUNC_PARAMS(_Dim) const JFF_MAT_IMPL_DEPENDENT_TYPE(_Dim) & mat
 #	define JFF_MAT_IMPL_DEPENDENT_INLINES "MatGLM.inl"
+#	define JFF_QUAT_IMPL_DEPENDENT_INLINES "QuatGLM.inl"
 #else
 #	define JFF_MAT_IMPL_DEPENDENT_ATTRS
 #	define JFF_MAT_IMPL_DEPENDENT_FUNC_PARAMS(_Dim)
 #	define JFF_MAT_IMPL_DEPENDENT_INLINES "Mat.h" // Placeholder include header
+#	define JFF_QUAT_IMPL_DEPENDENT_INLINES "Quat.h" // Placeholder include header
 #	error No API defined for Mat
 #endif
 
+// SIMD fast paths for 4x4 matrices. SSE2 is always present on x64
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define JFF_MAT_SSE
+#	include <xmmintrin.h>
+#endif
+
 // Library independent macros
 #define _JFF_MAT_OPS(FRIEND_TEMPLATE)																\
 	FRIEND_TEMPLATE MatBase<_Dim> operator+(const MatBase<_Dim>& m1, const MatBase<_Dim>& m2);		\
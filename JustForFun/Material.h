@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -53,6 +53,10 @@ namespace JFF
 
 			// Post-process FX
 			SSAO,
+			SSAO_BILATERAL_BLUR,
+			SSAO_BILATERAL_UPSAMPLE,
+			BLOOM_DOWNSAMPLE,
+			BLOOM_UPSAMPLE,
 
 			// Helper shader domain
 			GAUSSIAN_BLUR_HORIZONTAL,
@@ -106,6 +110,7 @@ namespace JFF
 			unsigned int SSAONumSamples;
 			float SSAOSampleHemisphereRadius;
 			unsigned int SSAONumBlurSteps;
+			unsigned int SSAOResolutionDivisor; // 1: full resolution, 2: half resolution, 4: quarter resolution
 
 			// TODO: more post process params here
 		};
@@ -175,6 +180,20 @@ namespace JFF
 		*/ 
 		virtual void addTexture(const std::shared_ptr<Texture>& texture) = 0;
 
+		/**
+		* Adds an external pre-loaded texture to the shader, bound to the given sampler name instead of the texture's name.
+		* Materials using the same sampler names generate the same shader code and share a single program.
+		* Cannot add a new texture after this material is cooked
+		*/
+		virtual void addTexture(const std::shared_ptr<Texture>& texture, const std::string& samplerName) = 0;
+
+		/**
+		* Sets a vec4 parameter of this material instance. It's sent to the uniform with the given name every time
+		* this material is used, so materials sharing the same program can use different values.
+		* Parameters can be set before or after cooking
+		*/
+		virtual void setParameter(const char* variableName, const Vec4& value) = 0;
+
 		// TODO: Add cubemap ??
 
 		/**
@@ -186,6 +205,12 @@ namespace JFF
 
 		// --------------- POST-COOK FUNCTIONS --------------- //
 
+		/*
+		* Returns true if this material's shaders finished compiling and linking. Cooking only submits the compilation,
+		* so renderables should be skipped until their material is ready. This function never blocks
+		*/
+		virtual bool isReady() = 0;
+
 		// Enables the internal shader and its associated textures. Material must be cooked for this function to work
 		virtual void use() = 0;
 
@@ -215,6 +240,12 @@ namespace JFF
 		*/
 		virtual void sendVec3(const char* variableName, const Vec3& vec) = 0;
 
+		/*
+		* Send an array of count vec3 to active material with a single call and attach it to the array variable name.
+		* The variable name must be a valid uniform array included in material's shader code
+		*/
+		virtual void sendVec3Array(const char* variableName, const Vec3* vecs, int count) = 0;
+
 		/*
 		* Send a vec4 to active material and attach it to the variable name.
 		* The variable name must be a valid uniform included in material's shader code
@@ -245,10 +276,10 @@ namespace JFF
 			const std::shared_ptr<Texture>& BRDFIntegrationMap = nullptr) = 0;
 
 		/* 
-		* Send a directional light's shadowmap texture to this material located at given index. 
+		* Send the shadow atlas, which holds the shadowmap of the directional light located at given index, to this material.
 		* Index must be in range [0, Renderer::getMaxDirectionalLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important 
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendDirLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer> shadowMapFBO = std::weak_ptr<Framebuffer>()) = 0;
 
@@ -261,10 +292,10 @@ namespace JFF
 		virtual void sendPointLightShadowCubemap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowCubemapFBO = std::weak_ptr<Framebuffer>()) = 0;
 
 		/*
-		* Send a spot light's shadowmap texture to this material located at given index.
+		* Send the shadow atlas, which holds the shadowmap of the spot light located at given index, to this material.
 		* Index must be in range [0, Renderer::getMaxSpotLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendSpotLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer> shadowMapFBO = std::weak_ptr<Framebuffer>()) = 0;
 
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,6 +12,8 @@
 
 #include "Vec.h"
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace JFF
 {
@@ -124,6 +126,11 @@ namespace JFF
 			std::ostringstream lineClearCoat;
 			std::ostringstream lineTransmission;
 
+			// ----------------- CONSTANT UNIFORMS ----------------- //
+
+			// Uniform name and value of each constant line. Constants are sent by material instances instead of being hardcoded
+			std::vector<std::pair<std::string, Vec4>> constants;
+
 			// ----------------- materialOverrides() FUNCTION CODE ----------------- //
 
 			std::string materialOverridesCode;
@@ -155,6 +162,9 @@ namespace JFF
 		// Adds a constant line to params
 		virtual void addConstantLine(const Vec4& value, Aplication texApplication) = 0;
 
+		// Gets the uniforms that replace constant lines and their values. Material instances must send them
+		virtual const std::vector<std::pair<std::string, Vec4>>& getConstants() const = 0;
+
 		// Adds an additional function called materialOverrides() function below material() function definition
 		virtual void addMaterialOverrideFunction(const std::string& fn) = 0;
 
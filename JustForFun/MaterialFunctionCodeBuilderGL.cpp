@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,6 +13,10 @@
 #include "Log.h"
 #include "ShaderCodeBuilder.h"
 
+#include <algorithm>
+
+const std::string JFF::MaterialFunctionCodeBuilderGL::CONSTANT_UNIFORM_SUFFIX("Constant");
+
 JFF::MaterialFunctionCodeBuilderGL::MaterialFunctionCodeBuilderGL() : 
 	params()
 {
@@ -106,64 +110,64 @@ void JFF::MaterialFunctionCodeBuilderGL::addConstantLine(const Vec4& value, Apli
 	switch (texApplication)
 	{
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_DIFFUSE:
-		setConstantLine(&params.lineDiffuse, value);
+		setConstantLine(&params.lineDiffuse, ShaderCodeBuilder::DIFFUSE, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_SPECULAR:
-		setConstantLine(&params.lineSpecular, value);
+		setConstantLine(&params.lineSpecular, ShaderCodeBuilder::SPECULAR, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_AMBIENT:
-		setConstantLine(&params.lineAmbient, value);
+		setConstantLine(&params.lineAmbient, ShaderCodeBuilder::AMBIENT, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_EMISSIVE:
-		setConstantLine(&params.lineEmissive, value);
+		setConstantLine(&params.lineEmissive, ShaderCodeBuilder::EMISSIVE, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_HEIGHT:
 		setConstantHeightLine(value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_NORMAL:
-		setConstantLine(&params.lineNormal, value);
+		setConstantLine(&params.lineNormal, ShaderCodeBuilder::NORMAL, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_SHININESS:
-		setConstantLine(&params.lineShininess, value);
+		setConstantLine(&params.lineShininess, ShaderCodeBuilder::SHININESS, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_OPACITY:
-		setConstantLine(&params.lineOpacity, value);
+		setConstantLine(&params.lineOpacity, ShaderCodeBuilder::OPACITY, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_DISPLACEMENT:
 		setConstantDisplacementLine(value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_LIGHTMAP:
-		setConstantLine(&params.lineLightmap, value);
+		setConstantLine(&params.lineLightmap, ShaderCodeBuilder::LIGHTMAP, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PHONG_REFLECTION:
-		setConstantLine(&params.lineReflection, value);
+		setConstantLine(&params.lineReflection, ShaderCodeBuilder::REFLECTION, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_BASE_COLOR:
-		setConstantLine(&params.lineBaseColor, value);
+		setConstantLine(&params.lineBaseColor, ShaderCodeBuilder::BASE_COLOR, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_NORMAL_CAMERA:
-		setConstantLine(&params.lineNormalCamera, value);
+		setConstantLine(&params.lineNormalCamera, ShaderCodeBuilder::NORMAL_CAMERA, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_EMISSION_COLOR:
-		setConstantLine(&params.lineEmissionColor, value);
+		setConstantLine(&params.lineEmissionColor, ShaderCodeBuilder::EMISSION_COLOR, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_METALNESS:
-		setConstantLine(&params.lineMetalness, value);
+		setConstantLine(&params.lineMetalness, ShaderCodeBuilder::METALNESS, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_DIFFUSE_ROUGHNESS:
-		setConstantLine(&params.lineDiffuseRoughness, value);
+		setConstantLine(&params.lineDiffuseRoughness, ShaderCodeBuilder::DIFFUSE_ROUGHNESS, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_AMBIENT_OCCLUSION:
-		setConstantLine(&params.lineAmbientOcclusion, value);
+		setConstantLine(&params.lineAmbientOcclusion, ShaderCodeBuilder::AMBIENT_OCCLUSION, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_SHEEN:
-		setConstantLine(&params.lineSheen, value);
+		setConstantLine(&params.lineSheen, ShaderCodeBuilder::SHEEN, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_CLEARCOAT:
-		setConstantLine(&params.lineClearCoat, value);
+		setConstantLine(&params.lineClearCoat, ShaderCodeBuilder::CLEAR_COAT, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::PBR_TRANSMISSION:
-		setConstantLine(&params.lineTransmission, value);
+		setConstantLine(&params.lineTransmission, ShaderCodeBuilder::TRANSMISSION, value);
 		return;
 	case JFF::MaterialFunctionCodeBuilder::Aplication::NO_APPLICATION:
 	default:
@@ -177,9 +181,20 @@ void JFF::MaterialFunctionCodeBuilderGL::addMaterialOverrideFunction(const std::
 	params.materialOverridesCode = fn;
 }
 
+const std::vector<std::pair<std::string, JFF::Vec4>>& JFF::MaterialFunctionCodeBuilderGL::getConstants() const
+{
+	return params.constants;
+}
+
 void JFF::MaterialFunctionCodeBuilderGL::generateCode(std::string& outMaterialFunctionCode, bool useParallaxFunction, bool isPBR)
 {
 	std::ostringstream oss;
+
+	// Constant uniforms declaration
+	for (const auto& constant : params.constants)
+		oss << "\n\t\t\tuniform vec4 " << constant.first << ";";
+	oss << "\n";
+
 	oss << ShaderCodeBuilder::MATERIAL_FUNCTION_HEADER;
 
 	// Parallax mapping lines
@@ -367,15 +382,28 @@ inline void JFF::MaterialFunctionCodeBuilderGL::setTextureDisplacementLine(
 	params.lineParallaxFunctionCall << "parallaxMappingDisplacement(" << texName << ")";
 }
 
-inline void JFF::MaterialFunctionCodeBuilderGL::setConstantLine(std::ostringstream* lineStream, const Vec4& value)
+inline void JFF::MaterialFunctionCodeBuilderGL::setConstantLine(std::ostringstream* lineStream, const std::string& channelName, const Vec4& value)
 {
+	/*
+	* Constants aren't written as literals but as uniforms, so materials with the same channel layout 
+	* generate the same code and share a program. The value is sent by each material instance
+	*/
+	std::string uniformName = channelName + CONSTANT_UNIFORM_SUFFIX;
+
 	lineStream->str("");
-	(*lineStream) << "vec4(" << value.r << "," << value.g << "," << value.b << "," << value.a << ")";
+	(*lineStream) << uniformName;
+
+	auto predicate = [&uniformName](const std::pair<std::string, Vec4>& constant) { return constant.first == uniformName; };
+	auto iter = std::find_if(params.constants.begin(), params.constants.end(), predicate);
+	if (iter != params.constants.end())
+		iter->second = value;
+	else
+		params.constants.push_back(std::pair<std::string, Vec4>(uniformName, value));
 }
 
 inline void JFF::MaterialFunctionCodeBuilderGL::setConstantHeightLine(const Vec4& value)
 {
-	setConstantLine(&params.lineHeight, value);
+	setConstantLine(&params.lineHeight, ShaderCodeBuilder::HEIGHT, value);
 
 	if (params.lineParallaxIntensity.tellp() == 0)
 		params.lineParallaxIntensity << "0.02";
@@ -386,7 +414,7 @@ inline void JFF::MaterialFunctionCodeBuilderGL::setConstantHeightLine(const Vec4
 
 inline void JFF::MaterialFunctionCodeBuilderGL::setConstantDisplacementLine(const Vec4& value)
 {
-	setConstantLine(&params.lineDisplacement, value);
+	setConstantLine(&params.lineDisplacement, ShaderCodeBuilder::DISPLACEMENT, value);
 
 	if (params.lineParallaxIntensity.tellp() == 0)
 		params.lineParallaxIntensity << "0.02";
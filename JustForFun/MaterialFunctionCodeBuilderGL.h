@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -43,6 +43,9 @@ namespace JFF
 		// Adds a constant line to params
 		virtual void addConstantLine(const Vec4& value, Aplication texApplication) override;
 
+		// Gets the uniforms that replace constant lines and their values. Material instances must send them
+		virtual const std::vector<std::pair<std::string, Vec4>>& getConstants() const override;
+
 		// Adds an additional function called materialOverrides() function below material() function definition
 		virtual void addMaterialOverrideFunction(const std::string& fn) override;
 
@@ -71,12 +74,16 @@ namespace JFF
 			const std::string& uvVariableNameUsed);
 
 		// Generic helper for addConstantLine() function
-		inline void setConstantLine(std::ostringstream* lineStream, const Vec4& value);
+		inline void setConstantLine(std::ostringstream* lineStream, const std::string& channelName, const Vec4& value);
 
 		// Concrete helper for height and displacement channel in addConstantLine() function
 		inline void setConstantHeightLine(const Vec4& value);
 		inline void setConstantDisplacementLine(const Vec4& value);
 
+	public:
+		// Suffix appended to the channel name to build the uniform name of a constant (e.g. diffuseConstant)
+		static const std::string CONSTANT_UNIFORM_SUFFIX;
+
 	protected:
 		Params params;
 	};
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -14,11 +14,11 @@
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
 #include "FileSystemSetup.h"
+#include "MaterialTemplateGL.h"
 
 #include <stdexcept>
 #include <memory>
 #include <sstream>
-#include <regex>
 #include <algorithm>
 
 extern std::shared_ptr<JFF::Texture> createTexture(JFF::Engine* const engine, const char* name, const char* assetFilePath);
@@ -32,6 +32,7 @@ JFF::MaterialGL::MaterialGL(JFF::Engine* const engine, const char* name, const c
 	isDestroyed(false),
 
 	name(name),
+	materialTemplate(),
 	program(0u),
 	domain(MaterialDomain::SURFACE),
 	lightModel(LightModel::GOURAUD),
@@ -50,6 +51,7 @@ JFF::MaterialGL::MaterialGL(JFF::Engine* const engine, const char* name, const c
 	directionalLightShadowMaps(),
 	pointLightShadowCubemaps(),
 	spotLightShadowMaps(),
+	parameters(),
 	customCode(),
 	textureUnit(0)
 {
@@ -71,6 +73,7 @@ JFF::MaterialGL::MaterialGL(JFF::Engine* const engine, const char* name) :
 	isDestroyed(false),
 
 	name(name),
+	materialTemplate(),
 	program(0u),
 	domain(MaterialDomain::SURFACE),
 	lightModel(LightModel::GOURAUD),
@@ -89,6 +92,7 @@ JFF::MaterialGL::MaterialGL(JFF::Engine* const engine, const char* name) :
 	directionalLightShadowMaps(),
 	pointLightShadowCubemaps(),
 	spotLightShadowMaps(),
+	parameters(),
 	customCode(),
 	textureUnit(0)
 {
@@ -189,6 +193,44 @@ void JFF::MaterialGL::addTexture(const std::shared_ptr<Texture>& texture)
 	++textureUnit;
 }
 
+void JFF::MaterialGL::addTexture(const std::shared_ptr<Texture>& texture, const std::string& samplerName)
+{
+	if (cooked)
+	{
+		JFF_LOG_WARNING("Cannot add new textures in a cooked material. Aborted")
+		return;
+	}
+
+	// Don't add a repeated sampler
+	auto predicate = [&samplerName](std::tuple<int, std::string, std::shared_ptr<Texture>>& tuple)
+	{
+		return std::get<1>(tuple) == samplerName;
+	};
+	if (std::find_if(textures.begin(), textures.end(), predicate) != textures.end())
+		return;
+
+	// Add the texture to texture list using the given sampler name
+	textures.push_back(std::tuple<int, std::string, std::shared_ptr<Texture>>(textureUnit, samplerName, texture));
+	++textureUnit;
+}
+
+void JFF::MaterialGL::setParameter(const char* variableName, const Vec4& value)
+{
+	// Overwrite the parameter if it already exists
+	auto predicate = [&variableName](std::pair<std::string, Vec4>& parameter)
+	{
+		return parameter.first == variableName;
+	};
+	auto iter = std::find_if(parameters.begin(), parameters.end(), predicate);
+	if (iter != parameters.end())
+	{
+		iter->second = value;
+		return;
+	}
+
+	parameters.push_back(std::pair<std::string, Vec4>(variableName, value));
+}
+
 void JFF::MaterialGL::cook(const std::string& externalCustomCode)
 {
 	if (cooked)
@@ -265,56 +307,26 @@ void JFF::MaterialGL::cook(const std::string& externalCustomCode)
 	std::string fragmentShaderCode;
 	shaderCodeBuilder->generateCode(shaderCodeParams, vertexShaderCode, geometryShaderCode, fragmentShaderCode);
 
-	const char* vertexShaderCode_c_str = vertexShaderCode.c_str();
-	const char* geometryShaderCode_c_str = geometryShaderCode.c_str();
-	const char* fragmentShaderCode_c_str = fragmentShaderCode.c_str();
+	// ------------------------------------- PROGRAM (TEMPLATE) SHARING ------------------------------------- //
 
-	// ------------------------------------- SHADER COMPILATION ------------------------------------- //
-
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	//glShaderSource(vertexShader, (GLsizei) vertexSrc.size(), vertexSrc.data(), nullptr); // Alternative using arrays
-	glShaderSource(vertexShader, 1, &vertexShaderCode_c_str, NULL);
-	glCompileShader(vertexShader);
-	checkShaderCompilation(vertexShader);
-
-	// Geometry shader (Optional)
-	GLuint geometryShader = 0;
-	if (!geometryShaderCode.empty())
+	/*
+	* Materials with the same generated code (e.g. meshes of an imported model with the same channel layout)
+	* share one compiled program. Only the first one compiles and links it, the rest take it from the cache
+	*/
+	auto cache = engine->cache.lock();
+	std::string templateCacheName;
+	materialTemplate = MaterialTemplateGL::findCachedTemplate(*cache, vertexShaderCode, geometryShaderCode, fragmentShaderCode, templateCacheName);
+	if (!materialTemplate)
 	{
-		geometryShader = glCreateShader(GL_GEOMETRY_SHADER);
-		glShaderSource(geometryShader, 1, &geometryShaderCode_c_str, NULL);
-		glCompileShader(geometryShader);
-		checkShaderCompilation(geometryShader);
+		// Only submits the compilation. Program status is checked later, when the program is ready (see isReady())
+		materialTemplate = std::make_shared<MaterialTemplateGL>(templateCacheName, 
+			vertexShaderCode, geometryShaderCode, fragmentShaderCode, renderer->getFrameCount());
+		cache->addCacheItem(materialTemplate);
 	}
 
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	//glShaderSource(fragmentShader, (GLsizei) fragmentSrc.size(), fragmentSrc.data(), nullptr); // Alternative using arrays
-	glShaderSource(fragmentShader, 1, &fragmentShaderCode_c_str, NULL);
-	glCompileShader(fragmentShader);
-	checkShaderCompilation(fragmentShader);
-
-	// Program link
-	program = glCreateProgram();
-	glAttachShader(program, vertexShader);
-	if (!geometryShaderCode.empty()) glAttachShader(program, geometryShader);
-	glAttachShader(program, fragmentShader);
-	glLinkProgram(program);
-	checkProgramLinkStatus(program);
-
-	// Flag shaders for deletion when program is destroyed
-	glDeleteShader(vertexShader);
-	if (!geometryShaderCode.empty()) glDeleteShader(geometryShader);
-	glDeleteShader(fragmentShader);
-
-	// Link CameraParams uniform block to the corresponding binding point
-	GLuint cameraParamsBindingPoint = 0u; // Check CameraComponentGL to ensure cameras use the same binding point for camera params
-	GLuint cameraParamsUniformBlockIndex = glGetUniformBlockIndex(program, "CameraParams");
-	if (cameraParamsUniformBlockIndex != GL_INVALID_INDEX)
-	{
-		glUniformBlockBinding(program, cameraParamsUniformBlockIndex, cameraParamsBindingPoint);
-	}
+	// Save this variant in the manifest, so next runs compile it while loading. Also if it was pre-compiled from the manifest
+	renderer->recordShaderVariant(domain, lightModel, shaderCodeParams);
+	program = materialTemplate->getProgram();
 
 	// Clean temp attributes
 	customCode.clear(); 
@@ -323,8 +335,24 @@ void JFF::MaterialGL::cook(const std::string& externalCustomCode)
 	cooked = true;
 }
 
+bool JFF::MaterialGL::isReady()
+{
+	if (!cooked || !materialTemplate)
+		return false;
+
+	// The renderer is only looked up while the program is still compiling
+	if (materialTemplate->isFinished())
+		return true;
+
+	return materialTemplate->isReady(engine->renderer.lock()->getFrameCount());
+}
+
 void JFF::MaterialGL::use()
 {
+	// Ensure the program is finished. This waits for the compiler if isReady() wasn't checked before
+	if (materialTemplate)
+		materialTemplate->finalize();
+
 	// Enables the program
 	glUseProgram(program);
 
@@ -349,11 +377,15 @@ void JFF::MaterialGL::use()
 			cubemap->use(texUnit);
 			sendTexture(cubemapName.c_str(), texUnit);
 		});
+
+	// Send this instance's parameter block. The program may be shared, so uniforms set by other instances are overwritten
+	for (const auto& parameter : parameters)
+		sendVec4(parameter.first.c_str(), parameter.second);
 }
 
 void JFF::MaterialGL::sendMat4(const char* variableName, const Mat4& matrix)
 {
-	GLint location = glGetUniformLocation(program, variableName);
+	GLint location = getUniformLocation(variableName);
 	GLsizei numMatricesSent = 1;
 	GLboolean shouldTranspose = GL_FALSE;
 	glUniformMatrix4fv(location, numMatricesSent, shouldTranspose, *matrix);
@@ -361,7 +393,7 @@ void JFF::MaterialGL::sendMat4(const char* variableName, const Mat4& matrix)
 
 void JFF::MaterialGL::sendMat3(const char* variableName, const Mat3& matrix)
 {
-	GLint location = glGetUniformLocation(program, variableName);
+	GLint location = getUniformLocation(variableName);
 	GLsizei numMatricesSent = 1;
 	GLboolean shouldTranspose = GL_FALSE;
 	glUniformMatrix3fv(location, numMatricesSent, shouldTranspose, *matrix);
@@ -369,34 +401,40 @@ void JFF::MaterialGL::sendMat3(const char* variableName, const Mat3& matrix)
 
 void JFF::MaterialGL::sendVec2(const char* variableName, const Vec2& vec)
 {
-	GLint location = glGetUniformLocation(program, variableName);
+	GLint location = getUniformLocation(variableName);
 	GLsizei numVectorsSent = 1;
 	glUniform2fv(location, numVectorsSent, *vec);
 }
 
 void JFF::MaterialGL::sendVec3(const char* variableName, const Vec3& vec)
 {
-	GLint location = glGetUniformLocation(program, variableName);
+	GLint location = getUniformLocation(variableName);
 	GLsizei numVectorsSent = 1;
 	glUniform3fv(location, numVectorsSent, *vec);
 }
 
+void JFF::MaterialGL::sendVec3Array(const char* variableName, const Vec3* vecs, int count)
+{
+	GLint location = getUniformLocation(variableName);
+	glUniform3fv(location, count, *vecs[0]); // Vec3 are tightly packed floats, so the array is sent as is
+}
+
 void JFF::MaterialGL::sendVec4(const char* variableName, const Vec4& vec)
 {
-	GLint location = glGetUniformLocation(program, variableName);
+	GLint location = getUniformLocation(variableName);
 	GLsizei numVectorsSent = 1;
 	glUniform4fv(location, numVectorsSent, *vec);
 }
 
 void JFF::MaterialGL::sendFloat(const char* variableName, float f)
 {
-	GLint location = glGetUniformLocation(program, variableName);
+	GLint location = getUniformLocation(variableName);
 	glUniform1f(location, f);
 }
 
 void JFF::MaterialGL::sendInt(const char* variableName, int i)
 {
-	GLint location = glGetUniformLocation(program, variableName);
+	GLint location = getUniformLocation(variableName);
 	glUniform1i(location, i);
 }
 
@@ -547,16 +585,9 @@ void JFF::MaterialGL::sendDirLightShadowMap(unsigned int index, const std::weak_
 				std::string shadowMapName = std::get<1>(tuple);
 				Framebuffer::AttachmentPoint attachmentPoint = std::get<2>(tuple);
 
-				// Send texture to shader
-				if (shadowMapFBO.expired())
-				{
-					glActiveTexture(GL_TEXTURE0 + texUnit);
-					glBindTexture(GL_TEXTURE_2D, 0); // Bind default texture // TODO: check
-				}
-				else
-				{
+				// Send texture to shader. The atlas is shared by all directional and spot lights, so empty shadow maps must not unbind it
+				if (!shadowMapFBO.expired())
 					shadowMapFBO.lock()->useTexture(attachmentPoint, texUnit);
-				}
 				sendTexture(shadowMapName.c_str(), texUnit);							
 			}
 			break;
@@ -574,16 +605,9 @@ void JFF::MaterialGL::sendDirLightShadowMap(unsigned int index, const std::weak_
 			std::string shadowMapName = std::get<1>(tuple);
 			Framebuffer::AttachmentPoint attachmentPoint = std::get<2>(tuple);
 
-			// Send texture to shader
-			if (shadowMapFBO.expired())
-			{
-				glActiveTexture(GL_TEXTURE0 + texUnit);
-				glBindTexture(GL_TEXTURE_2D, 0); // Bind default texture // TODO: check
-			}
-			else
-			{
+			// Send texture to shader. The atlas is shared by all directional and spot lights, so empty shadow maps must not unbind it
+			if (!shadowMapFBO.expired())
 				shadowMapFBO.lock()->useTexture(attachmentPoint, texUnit);
-			}
 			sendTexture(shadowMapName.c_str(), texUnit);
 		}
 		break;
@@ -677,16 +701,9 @@ void JFF::MaterialGL::sendSpotLightShadowMap(unsigned int index, const std::weak
 				std::string shadowMapName = std::get<1>(tuple);
 				Framebuffer::AttachmentPoint attachmentPoint = std::get<2>(tuple);
 
-				// Send texture to shader
-				if (shadowMapFBO.expired())
-				{
-					glActiveTexture(GL_TEXTURE0 + texUnit);
-					glBindTexture(GL_TEXTURE_2D, 0); // Bind default texture // TODO: check
-				}
-				else
-				{
+				// Send texture to shader. The atlas is shared by all directional and spot lights, so empty shadow maps must not unbind it
+				if (!shadowMapFBO.expired())
 					shadowMapFBO.lock()->useTexture(attachmentPoint, texUnit);
-				}
 				sendTexture(shadowMapName.c_str(), texUnit);				
 			}
 			break;
@@ -704,16 +721,9 @@ void JFF::MaterialGL::sendSpotLightShadowMap(unsigned int index, const std::weak
 			std::string shadowMapName = std::get<1>(tuple);
 			Framebuffer::AttachmentPoint attachmentPoint = std::get<2>(tuple);
 
-			// Send texture to shader
-			if (shadowMapFBO.expired())
-			{
-				glActiveTexture(GL_TEXTURE0 + texUnit);
-				glBindTexture(GL_TEXTURE_2D, 0); // Bind default texture // TODO: check
-			}
-			else
-			{
+			// Send texture to shader. The atlas is shared by all directional and spot lights, so empty shadow maps must not unbind it
+			if (!shadowMapFBO.expired())
 				shadowMapFBO.lock()->useTexture(attachmentPoint, texUnit);
-			}
 			sendTexture(shadowMapName.c_str(), texUnit);
 		}
 		break;
@@ -742,67 +752,57 @@ void JFF::MaterialGL::sendPostProcessingTextures(const std::weak_ptr<Framebuffer
 
 void JFF::MaterialGL::destroy()
 {
-	// Delete program from memory. Because shaders were deleted before, this effectively deletes linked shaders too
-	glDeleteProgram(program);
+	/*
+	* Program, textures and cubemaps are cached and may be shared with other materials, so they aren't destroyed here.
+	* This material drops its references and lets the cache free them when nobody else is using them
+	*/
+	auto cache = engine->cache.lock();
+
+	// Release program
+	if (materialTemplate)
+	{
+		std::string cacheName = materialTemplate->getCacheName();
+		materialTemplate.reset();
+		program = 0u;
+		if (cache)
+			cache->releaseCacheItem(cacheName);
+	}
 
-	// Destroy textures
-	std::for_each(textures.begin(), textures.end(), [this](const auto& tuple) 
+	// Release textures
+	std::for_each(textures.begin(), textures.end(), [&cache](auto& tuple) 
 		{
-			std::shared_ptr<Texture> texture = std::get<2>(tuple);
-			texture->destroy(); // TODO: Careful trying to destroy a cached texture
+			std::shared_ptr<Texture>& texture = std::get<2>(tuple);
+			std::string cacheName = texture->getCacheName();
+			texture.reset();
+			if (cache)
+				cache->releaseCacheItem(cacheName);
 		});
 
-	// Destroy cubemaps
-	std::for_each(cubemaps.begin(), cubemaps.end(), [this](const auto& tuple)
+	// Release cubemaps
+	std::for_each(cubemaps.begin(), cubemaps.end(), [&cache](auto& tuple)
 		{
-			std::shared_ptr<Cubemap> cubemap = std::get<2>(tuple);
-			cubemap->destroy();  // TODO: Careful trying to destroy a cached cubemap
+			std::shared_ptr<Cubemap>& cubemap = std::get<2>(tuple);
+			std::string cacheName = cubemap->getCacheName();
+			cubemap.reset();
+			if (cache)
+				cache->releaseCacheItem(cacheName);
 		});
 
 	isDestroyed = true;
 }
 
-inline bool JFF::MaterialGL::checkShaderCompilation(GLuint shader)
-{
-	int shaderSuccess;
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &shaderSuccess);
-
-	int infoStringLength;
-	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoStringLength);
-	std::vector<char> shaderInfoLog(infoStringLength, '\0');
-
-	if (!shaderSuccess)
-	{
-		glGetShaderInfoLog(shader, (GLsizei) shaderInfoLog.size(), nullptr, shaderInfoLog.data());
-		JFF_LOG_ERROR("Shader compilation failed: " << shaderInfoLog.data())
-		return false;
-	}
-
-	return true;
-}
-
-inline bool JFF::MaterialGL::checkProgramLinkStatus(GLuint program)
+inline GLint JFF::MaterialGL::getUniformLocation(const char* variableName)
 {
-	int programLinkSuccess;
-	glGetProgramiv(program, GL_LINK_STATUS, &programLinkSuccess);
-	
-	int infoStringLength;
-	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoStringLength);
-	std::vector<char> programLinkInfoLog(infoStringLength, '\0');
-
-	if (!programLinkSuccess)
-	{
-		glGetProgramInfoLog(program, (GLsizei) programLinkInfoLog.size(), nullptr, programLinkInfoLog.data());
-		JFF_LOG_ERROR("Program link failed: " << programLinkInfoLog.data())
-		return false;
-	}
+	// A material that isn't cooked (or was destroyed) has no program. Location -1 is silently ignored by glUniform*()
+	if (!materialTemplate)
+		return -1;
 
-	return true;
+	return materialTemplate->getUniformLocation(variableName);
 }
 
 void JFF::MaterialGL::sendTexture(const char* variableName, int textureUnit)
 {
-	GLint uniformLocation = glGetUniformLocation(program, variableName);
+	GLint uniformLocation = getUniformLocation(variableName);
 	glUniform1i(uniformLocation, textureUnit); // Uses currently active program. Remember to call glUseProgram() first
 }
 
@@ -904,6 +904,8 @@ inline void JFF::MaterialGL::extractPostProcessOptionsFromFile(const std::shared
 	if (domain != MaterialDomain::POST_PROCESS)
 		return;
 
+	postProcessParams.SSAOResolutionDivisor = 2; // Half resolution unless the file says otherwise
+
 	if (iniFile->has("post-process", "bloom"))
 		extractBloomEnabled(iniFile->getString("post-process", "bloom"));
 
@@ -928,6 +930,9 @@ inline void JFF::MaterialGL::extractPostProcessOptionsFromFile(const std::shared
 
 	if (iniFile->has("post-process", "ssao-num-blur-steps"))
 		extractSSAONumBlurSteps(iniFile->getInt("post-process", "ssao-num-blur-steps"));
+
+	if (iniFile->has("post-process", "ssao-resolution"))
+		extractSSAOResolution(iniFile->getString("post-process", "ssao-resolution"));
 }
 
 inline void JFF::MaterialGL::extractBloomEnabled(const std::string& option)
@@ -994,13 +999,29 @@ inline void JFF::MaterialGL::extractSSAONumBlurSteps(int option)
 	postProcessParams.SSAONumBlurSteps = (unsigned int)option;
 }
 
+inline void JFF::MaterialGL::extractSSAOResolution(const std::string& option)
+{
+	if (option == "FULL")
+		postProcessParams.SSAOResolutionDivisor = 1;
+	else if (option == "HALF")
+		postProcessParams.SSAOResolutionDivisor = 2;
+	else if (option == "QUARTER")
+		postProcessParams.SSAOResolutionDivisor = 4;
+	else
+	{
+		JFF_LOG_WARNING("Invalid ssao-resolution value. Options are: FULL, HALF, QUARTER")
+	}
+}
+
 inline void JFF::MaterialGL::loadTexturesFromFile(const std::shared_ptr<INIFile>& iniFile, Engine* const engine)
 {
 	iniFile->visitKeyValuePairs("textures", [this, &engine](const std::pair<std::string, std::string>& pair)
 		{
-			std::string assetFullPath = std::regex_replace(pair.second, std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+			std::string assetFullPath = toPlatformPath(pair.second);
 			std::shared_ptr<Texture> texture = createTexture(engine, pair.first.c_str(), assetFullPath.c_str());
-			textures.push_back(std::tuple<int, std::string, std::shared_ptr<Texture>>(textureUnit, texture->getName(), texture));
+
+			// Use the sampler name from this file. A cached texture keeps the name of the first material that loaded it
+			textures.push_back(std::tuple<int, std::string, std::shared_ptr<Texture>>(textureUnit, pair.first, texture));
 			++textureUnit;
 		});
 }
@@ -1009,9 +1030,11 @@ inline void JFF::MaterialGL::loadCubemapsFromFile(const std::shared_ptr<INIFile>
 {
 	iniFile->visitKeyValuePairs("cubemaps", [this, &engine](const std::pair<std::string, std::string>& pair)
 		{
-			std::string assetFullPath = std::regex_replace(pair.second, std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+			std::string assetFullPath = toPlatformPath(pair.second);
 			std::shared_ptr<Cubemap> cubemap = createCubemap(engine, pair.first.c_str(), assetFullPath.c_str());
-			cubemaps.push_back(std::tuple<int, std::string, std::shared_ptr<Cubemap>>(textureUnit, cubemap->getName(), cubemap));
+
+			// Use the sampler name from this file. A cached cubemap keeps the name of the first material that loaded it
+			cubemaps.push_back(std::tuple<int, std::string, std::shared_ptr<Cubemap>>(textureUnit, pair.first, cubemap));
 			++textureUnit;
 		});
 }
@@ -1035,6 +1058,8 @@ inline void JFF::MaterialGL::extractPostProcessingTextures()
 	case JFF::Material::MaterialDomain::GAUSSIAN_BLUR_HORIZONTAL:
 	case JFF::Material::MaterialDomain::GAUSSIAN_BLUR_VERTICAL:
 	case JFF::Material::MaterialDomain::HIGH_PASS_FILTER:
+	case JFF::Material::MaterialDomain::BLOOM_DOWNSAMPLE:
+	case JFF::Material::MaterialDomain::BLOOM_UPSAMPLE:
 	case JFF::Material::MaterialDomain::COLOR_COPY:
 	case JFF::Material::MaterialDomain::RENDER_TO_SCREEN:
 		{
@@ -1062,6 +1087,22 @@ inline void JFF::MaterialGL::extractPostProcessingTextures()
 			++textureUnit;
 		}
 		break;
+	case JFF::Material::MaterialDomain::SSAO_BILATERAL_BLUR:
+	case JFF::Material::MaterialDomain::SSAO_BILATERAL_UPSAMPLE:
+		{
+			auto ppTexOcclusion = std::tuple<int, std::string, Framebuffer::AttachmentPoint, int>(
+				textureUnit, ShaderCodeBuilder::POST_PROCESSING_OUTPUT_COLOR,
+				Framebuffer::AttachmentPoint::COLOR_0, /* Using Framebuffer 0 */ 0);
+			postProcessingTextures.push_back(ppTexOcclusion);
+			++textureUnit;
+
+			auto ppTexWorldPositions = std::tuple<int, std::string, Framebuffer::AttachmentPoint, int>(
+				textureUnit, ShaderCodeBuilder::POST_PROCESSING_FRAGMENT_WORLD_POS,
+				Framebuffer::AttachmentPoint::COLOR_0, /* Using Framebuffer 1 */ 1);
+			postProcessingTextures.push_back(ppTexWorldPositions);
+			++textureUnit;
+		}
+		break;
 	case JFF::Material::MaterialDomain::COLOR_ADDITION:
 		{
 			auto ppTex0 = std::tuple<int, std::string, Framebuffer::AttachmentPoint, int>(
@@ -1178,14 +1219,11 @@ inline void JFF::MaterialGL::extractShadowMaps()
 		case JFF::Material::LightModel::PHONG:
 		case JFF::Material::LightModel::BLINN_PHONG:
 		case JFF::Material::LightModel::PBR:
-			for (int i = 0; i < engine->renderer.lock()->getForwardShadingMaxDirectionalLights(); ++i)
 			{
-				std::string emptyString;
-				std::ostringstream ss(emptyString);
-				ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY << "[" << i << "]." << ShaderCodeBuilder::DIR_LIGHT_SHADOW_MAP;
-
-				auto shadowTuple = std::tuple<int, std::string, Framebuffer::AttachmentPoint>(textureUnit, ss.str(), Framebuffer::AttachmentPoint::DEPTH);
-				directionalLightShadowMaps.push_back(shadowTuple);
+				// Directional and spot lights share the shadow atlas, which uses a single texture unit
+				auto atlasTuple = std::tuple<int, std::string, Framebuffer::AttachmentPoint>(textureUnit, ShaderCodeBuilder::SHADOW_ATLAS, Framebuffer::AttachmentPoint::DEPTH);
+				directionalLightShadowMaps.assign(engine->renderer.lock()->getForwardShadingMaxDirectionalLights(), atlasTuple);
+				spotLightShadowMaps.assign(engine->renderer.lock()->getForwardShadingMaxSpotLights(), atlasTuple);
 				++textureUnit;
 			}
 
@@ -1199,17 +1237,6 @@ inline void JFF::MaterialGL::extractShadowMaps()
 				pointLightShadowCubemaps.push_back(shadowTuple);
 				++textureUnit;
 			}
-
-			for (int i = 0; i < engine->renderer.lock()->getForwardShadingMaxSpotLights(); ++i)
-			{
-				std::string emptyString;
-				std::ostringstream ss(emptyString);
-				ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << i << "]." << ShaderCodeBuilder::SPOT_LIGHT_SHADOW_MAP;
-
-				auto shadowTuple = std::tuple<int, std::string, Framebuffer::AttachmentPoint>(textureUnit, ss.str(), Framebuffer::AttachmentPoint::DEPTH);
-				spotLightShadowMaps.push_back(shadowTuple);
-				++textureUnit;
-			}
 			break;
 		case JFF::Material::LightModel::UNLIT:
 		default:
@@ -1218,11 +1245,7 @@ inline void JFF::MaterialGL::extractShadowMaps()
 		break;
 	case JFF::Material::MaterialDomain::DIRECTIONAL_LIGHTING_DEFERRED:
 		{
-			std::string emptyString;
-			std::ostringstream ss(emptyString);
-			ss << ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT << "." << ShaderCodeBuilder::DIR_LIGHT_SHADOW_MAP;
-
-			auto shadowTuple = std::tuple<int, std::string, Framebuffer::AttachmentPoint>(textureUnit, ss.str(), Framebuffer::AttachmentPoint::DEPTH);
+			auto shadowTuple = std::tuple<int, std::string, Framebuffer::AttachmentPoint>(textureUnit, ShaderCodeBuilder::SHADOW_ATLAS, Framebuffer::AttachmentPoint::DEPTH);
 			directionalLightShadowMaps.push_back(shadowTuple);
 			++textureUnit;
 		}
@@ -1240,11 +1263,7 @@ inline void JFF::MaterialGL::extractShadowMaps()
 		break;
 	case JFF::Material::MaterialDomain::SPOT_LIGHTING_DEFERRED:
 		{
-			std::string emptyString;
-			std::ostringstream ss(emptyString);
-			ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_SHADOW_MAP;
-
-			auto shadowTuple = std::tuple<int, std::string, Framebuffer::AttachmentPoint>(textureUnit, ss.str(), Framebuffer::AttachmentPoint::DEPTH);
+			auto shadowTuple = std::tuple<int, std::string, Framebuffer::AttachmentPoint>(textureUnit, ShaderCodeBuilder::SHADOW_ATLAS, Framebuffer::AttachmentPoint::DEPTH);
 			spotLightShadowMaps.push_back(shadowTuple);
 			++textureUnit;
 		}
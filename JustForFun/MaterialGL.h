@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -18,6 +18,7 @@
 #include "Texture.h"
 #include "Cubemap.h"
 #include "Framebuffer.h"
+#include "MaterialTemplateGL.h"
 
 #include <vector>
 #include <tuple>
@@ -97,12 +98,25 @@ namespace JFF
 		*/
 		virtual void addTexture(const std::shared_ptr<Texture>& texture) override;
 
+		/**
+		* Adds an external pre-loaded texture to the shader, bound to the given sampler name instead of the texture's name.
+		* Cannot add a new texture after this material is cooked
+		*/
+		virtual void addTexture(const std::shared_ptr<Texture>& texture, const std::string& samplerName) override;
+
+		// Sets a vec4 parameter of this material instance. It's sent every time this material is used
+		virtual void setParameter(const char* variableName, const Vec4& value) override;
+
 		/**
 		* Compile and link shaders generated from provided infoand makes this material operative for rendering.
+		* If another material already generated the same shader code, its program (template) is shared instead.
 		* A Material can only be cooked once
 		*/
 		virtual void cook(const std::string& externalCustomCode = "") override;
 
+		// Returns true if this material's program finished compiling and linking. It never blocks
+		virtual bool isReady() override;
+
 		// Enables the internal shader and its associated textures
 		virtual void use() override;
 
@@ -132,6 +146,12 @@ namespace JFF
 		*/
 		virtual void sendVec3(const char* variableName, const Vec3& vec) override;
 
+		/*
+		* Send an array of count vec3 to active material with a single call and attachs it to the array variable name.
+		* The variable name must be a valid uniform array included in material's shader code
+		*/
+		virtual void sendVec3Array(const char* variableName, const Vec3* vecs, int count) override;
+
 		/*
 		* Send a vec4 to active material and attachs it to the variable name.
 		* The variable name must be a valid uniform included in material's shader code
@@ -162,10 +182,10 @@ namespace JFF
 			const std::shared_ptr<Texture>& BRDFIntegrationMap = nullptr) override;
 
 		/*
-		* Send a directional light's shadowmap texture to this material located at given index.
+		* Send the shadow atlas, which holds the shadowmap of the directional light located at given index, to this material.
 		* Index must be in range [0, Renderer::getForwardShadingMaxDirectionalLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendDirLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer> shadowMapFBO = std::weak_ptr<Framebuffer>()) override;
 
@@ -178,10 +198,10 @@ namespace JFF
 		virtual void sendPointLightShadowCubemap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowCubemapFBO = std::weak_ptr<Framebuffer>()) override;
 
 		/*
-		* Send a spot light's shadowmap texture to this material located at given index.
+		* Send the shadow atlas, which holds the shadowmap of the spot light located at given index, to this material.
 		* Index must be in range [0, Renderer::getForwardShadingMaxSpotLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendSpotLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer> shadowMapFBO = std::weak_ptr<Framebuffer>()) override;
 
@@ -194,9 +214,8 @@ namespace JFF
 		virtual void destroy() override;
 
 	private: // Aux functions
-		// Shader compilation status
-		inline bool checkShaderCompilation(GLuint shader);
-		inline bool checkProgramLinkStatus(GLuint program);
+		// Uniform location in the shared program (cached by the template)
+		inline GLint getUniformLocation(const char* variableName);
 
 		// Internal command to send textures to shader code as uniforms
 		void sendTexture(const char* variableName, int textureUnit);
@@ -224,6 +243,7 @@ namespace JFF
 			inline void extractSSAONumSamples(int option);
 			inline void extractSSAOSampleHemisphereRadius(float option);
 			inline void extractSSAONumBlurSteps(int option);
+			inline void extractSSAOResolution(const std::string& option);
 
 		// Load textures associated with this material (in files)
 		inline void loadTexturesFromFile(const std::shared_ptr<INIFile>& iniFile, Engine* const engine);
@@ -243,6 +263,7 @@ namespace JFF
 		bool isDestroyed;
 
 		std::string name;
+		std::shared_ptr<MaterialTemplateGL> materialTemplate; // Shared program. This material is an instance of it
 		GLuint program;
 		MaterialDomain domain;
 		LightModel lightModel;
@@ -256,10 +277,10 @@ namespace JFF
 		// Post process options
 		PostProcessParams postProcessParams;
 
-		// 1-> Texture unit 
-		// 2-> Shader sampler name 
-		// 3-> Texture object or texture attachment point inside a framebuffer
-		// 4-> Framebuffer used: 0-> ppFBO | 1-> ppFBO2
+		// 1º-> Texture unit 
+		// 2º-> Shader sampler name 
+		// 3º-> Texture object or texture attachment point inside a framebuffer
+		// 4º-> Framebuffer used: 0-> ppFBO | 1-> ppFBO2
 		std::vector<std::tuple<int, std::string>> environmentMaps;
 		std::vector<std::tuple<int, std::string, std::shared_ptr<Texture>>> textures;
 		std::vector<std::tuple<int, std::string, std::shared_ptr<Cubemap>>> cubemaps;
@@ -267,6 +288,10 @@ namespace JFF
 		std::vector<std::tuple<int, std::string, Framebuffer::AttachmentPoint>> directionalLightShadowMaps;
 		std::vector<std::tuple<int, std::string, Framebuffer::AttachmentPoint>> pointLightShadowCubemaps;
 		std::vector<std::tuple<int, std::string, Framebuffer::AttachmentPoint>> spotLightShadowMaps;
+
+		// Per-instance parameter block: uniform name and value
+		std::vector<std::pair<std::string, Vec4>> parameters;
+
 		std::ostringstream customCode;
 		int textureUnit;
 	};
@@ -0,0 +1,280 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "MaterialTemplateGL.h"
+
+#include "Log.h"
+
+#include <vector>
+#include <sstream>
+#include <functional>
+
+const unsigned long long int JFF::MaterialTemplateGL::UNIFORM_NAME_HASH_OFFSET_BASIS	= 14695981039346656037ull;
+const unsigned long long int JFF::MaterialTemplateGL::UNIFORM_NAME_HASH_PRIME			= 1099511628211ull;
+
+JFF::MaterialTemplateGL::MaterialTemplateGL(const std::string& cacheName,
+	const std::string& vertexShaderCode,
+	const std::string& geometryShaderCode,
+	const std::string& fragmentShaderCode,
+	unsigned long long int submitFrame) :
+	isDestroyed(false),
+	isFinalized(false),
+
+	cacheName(cacheName),
+	program(0u),
+	vertexShader(0u),
+	geometryShader(0u),
+	fragmentShader(0u),
+	submitFrame(submitFrame),
+	vertexShaderCode(vertexShaderCode),
+	geometryShaderCode(geometryShaderCode),
+	fragmentShaderCode(fragmentShaderCode),
+	uniformLocations()
+{
+	JFF_LOG_INFO("Ctor MaterialTemplateGL")
+
+	const char* vertexShaderCode_c_str = vertexShaderCode.c_str();
+	const char* geometryShaderCode_c_str = geometryShaderCode.c_str();
+	const char* fragmentShaderCode_c_str = fragmentShaderCode.c_str();
+
+	// ------------------------------ SHADER COMPILATION AND LINK SUBMISSION ------------------------------ //
+
+	// NOTE: No status is queried here. Any query would wait for the compiler. Check finalize()
+
+	// Vertex shader
+	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderCode_c_str, NULL);
+	glCompileShader(vertexShader);
+
+	// Geometry shader (Optional)
+	if (!geometryShaderCode.empty())
+	{
+		geometryShader = glCreateShader(GL_GEOMETRY_SHADER);
+		glShaderSource(geometryShader, 1, &geometryShaderCode_c_str, NULL);
+		glCompileShader(geometryShader);
+	}
+
+	// Fragment shader
+	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderCode_c_str, NULL);
+	glCompileShader(fragmentShader);
+
+	// Program link
+	program = glCreateProgram();
+	glAttachShader(program, vertexShader);
+	if (geometryShader) glAttachShader(program, geometryShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+}
+
+JFF::MaterialTemplateGL::~MaterialTemplateGL()
+{
+	JFF_LOG_INFO("Dtor MaterialTemplateGL")
+
+	// Cached templates are released by the cache, so the program is freed here
+	if (!isDestroyed)
+	{
+		destroy();
+	}
+}
+
+std::string JFF::MaterialTemplateGL::getCacheName() const
+{
+	return cacheName;
+}
+
+std::string JFF::MaterialTemplateGL::generateCacheName(const std::string& vertexShaderCode,
+	const std::string& geometryShaderCode,
+	const std::string& fragmentShaderCode)
+{
+	std::hash<std::string> hasher;
+
+	std::ostringstream ss;
+	ss << "MaterialTemplate://";
+	ss << hasher(vertexShaderCode) << '.' << hasher(geometryShaderCode) << '.' << hasher(fragmentShaderCode);
+	ss << '.' << fragmentShaderCode.size();
+
+	return ss.str();
+}
+
+std::shared_ptr<JFF::MaterialTemplateGL> JFF::MaterialTemplateGL::findCachedTemplate(Cache& cache,
+	const std::string& vertexShaderCode,
+	const std::string& geometryShaderCode,
+	const std::string& fragmentShaderCode,
+	std::string& outCacheName)
+{
+	std::string baseCacheName = generateCacheName(vertexShaderCode, geometryShaderCode, fragmentShaderCode);
+	outCacheName = baseCacheName;
+
+	// Probe the base name and then the suffixed ones, until a template with the same code or a free name is found
+	for (unsigned int collisions = 1u; ; ++collisions)
+	{
+		std::shared_ptr<Cacheable> cacheItem = cache.getCachedItem(outCacheName);
+		if (!cacheItem)
+			return nullptr;
+
+		auto cachedTemplate = std::dynamic_pointer_cast<MaterialTemplateGL>(cacheItem);
+		if (cachedTemplate && cachedTemplate->hasShaderCode(vertexShaderCode, geometryShaderCode, fragmentShaderCode))
+			return cachedTemplate;
+
+		JFF_LOG_WARNING("Material template cache name collision: " << outCacheName)
+		outCacheName = baseCacheName + '#' + std::to_string(collisions);
+	}
+}
+
+bool JFF::MaterialTemplateGL::hasShaderCode(const std::string& vertexShaderCode,
+	const std::string& geometryShaderCode,
+	const std::string& fragmentShaderCode) const
+{
+	return this->vertexShaderCode == vertexShaderCode &&
+		this->geometryShaderCode == geometryShaderCode &&
+		this->fragmentShaderCode == fragmentShaderCode;
+}
+
+bool JFF::MaterialTemplateGL::isReady(unsigned long long int currentFrame)
+{
+	if (isFinalized)
+		return true;
+
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		// Ask the driver if compilation and link are done. This query doesn't block
+		GLint completed = GL_FALSE;
+		glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+		if (completed == GL_FALSE)
+			return false;
+	}
+	else if (currentFrame <= submitFrame)
+	{
+		// Without the extension, status queries are deferred to the next frame to give the driver time to finish
+		return false;
+	}
+
+	finalize();
+	return true;
+}
+
+void JFF::MaterialTemplateGL::finalize()
+{
+	if (isFinalized)
+		return;
+
+	// Check compilation and link status
+	checkShaderCompilation(vertexShader);
+	if (geometryShader) checkShaderCompilation(geometryShader);
+	checkShaderCompilation(fragmentShader);
+	checkProgramLinkStatus(program);
+
+	// Flag shaders for deletion when program is destroyed
+	glDeleteShader(vertexShader);
+	if (geometryShader) glDeleteShader(geometryShader);
+	glDeleteShader(fragmentShader);
+	vertexShader = geometryShader = fragmentShader = 0u;
+
+	// Link CameraParams uniform block to the corresponding binding point
+	GLuint cameraParamsBindingPoint = 0u; // Check CameraComponentGL to ensure cameras use the same binding point for camera params
+	GLuint cameraParamsUniformBlockIndex = glGetUniformBlockIndex(program, "CameraParams");
+	if (cameraParamsUniformBlockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, cameraParamsUniformBlockIndex, cameraParamsBindingPoint);
+	}
+
+	isFinalized = true;
+}
+
+GLint JFF::MaterialTemplateGL::getUniformLocation(const char* variableName)
+{
+	// Locations are only valid once the program is linked
+	if (!isFinalized)
+		finalize();
+
+	unsigned long long int nameHash = hashUniformName(variableName);
+	auto iter = uniformLocations.find(nameHash);
+	if (iter != uniformLocations.end())
+	{
+		// Comparing std::string with const char* doesn't build a temporary string
+		if (iter->second.variableName == variableName)
+			return iter->second.location;
+
+		// Hash collision. The name cached first keeps the entry and this one is always queried to GL
+		return glGetUniformLocation(program, variableName);
+	}
+
+	GLint location = glGetUniformLocation(program, variableName);
+	uniformLocations[nameHash] = { variableName, location };
+	return location;
+}
+
+void JFF::MaterialTemplateGL::destroy()
+{
+	// Shaders are still alive if this template was never finalized
+	if (!isFinalized)
+	{
+		glDeleteShader(vertexShader);
+		if (geometryShader) glDeleteShader(geometryShader);
+		glDeleteShader(fragmentShader);
+	}
+
+	// Delete program from memory. Because shaders were deleted before, this effectively deletes linked shaders too
+	glDeleteProgram(program);
+	uniformLocations.clear();
+
+	isDestroyed = true;
+}
+
+inline bool JFF::MaterialTemplateGL::checkShaderCompilation(GLuint shader)
+{
+	int shaderSuccess;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &shaderSuccess);
+
+	int infoStringLength;
+	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoStringLength);
+	std::vector<char> shaderInfoLog(infoStringLength, '\0');
+
+	if (!shaderSuccess)
+	{
+		glGetShaderInfoLog(shader, (GLsizei) shaderInfoLog.size(), nullptr, shaderInfoLog.data());
+		JFF_LOG_ERROR("Shader compilation failed: " << shaderInfoLog.data())
+		return false;
+	}
+
+	return true;
+}
+
+inline bool JFF::MaterialTemplateGL::checkProgramLinkStatus(GLuint program)
+{
+	int programLinkSuccess;
+	glGetProgramiv(program, GL_LINK_STATUS, &programLinkSuccess);
+
+	int infoStringLength;
+	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoStringLength);
+	std::vector<char> programLinkInfoLog(infoStringLength, '\0');
+
+	if (!programLinkSuccess)
+	{
+		glGetProgramInfoLog(program, (GLsizei) programLinkInfoLog.size(), nullptr, programLinkInfoLog.data());
+		JFF_LOG_ERROR("Program link failed: " << programLinkInfoLog.data())
+		return false;
+	}
+
+	return true;
+}
+
+inline unsigned long long int JFF::MaterialTemplateGL::hashUniformName(const char* variableName)
+{
+	unsigned long long int hash = UNIFORM_NAME_HASH_OFFSET_BASIS;
+	for (const char* c = variableName; *c != '\0'; ++c)
+	{
+		hash ^= (unsigned char)*c;
+		hash *= UNIFORM_NAME_HASH_PRIME;
+	}
+
+	return hash;
+}
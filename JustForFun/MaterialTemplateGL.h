@@ -0,0 +1,145 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Cacheable.h"
+#include "Cache.h"
+
+#define GLEW_STATIC // Used when linked against GLEW static library
+#include "GL/glew.h"
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+
+namespace JFF
+{
+	/*
+	* Compiled and linked GL program shared by every MaterialGL whose generated shader code is identical.
+	* A template owns the program and its uniform locations. Materials using it (instances) only own their
+	* textures and parameter values, which are sent each time they are used.
+	* Templates are stored in the Cache, keyed by a hash of the generated shader code. Each template keeps its code,
+	* so a template is only shared when the code matches (see findCachedTemplate()).
+	*
+	* Creating a template only submits the compile and link commands. Status queries are postponed until
+	* the program is finished (GL_KHR_parallel_shader_compile) or, if that extension isn't present, until the next frame.
+	* This way the driver can compile all programs of a frame together instead of stalling on each one
+	*/
+	class MaterialTemplateGL : public Cacheable
+	{
+	public:
+		// Ctor & Dtor
+		MaterialTemplateGL(const std::string& cacheName,
+			const std::string& vertexShaderCode,
+			const std::string& geometryShaderCode,
+			const std::string& fragmentShaderCode,
+			unsigned long long int submitFrame);
+		virtual ~MaterialTemplateGL();
+
+		// Copy ctor and copy assignment
+		MaterialTemplateGL(const MaterialTemplateGL& other) = delete;
+		MaterialTemplateGL& operator=(const MaterialTemplateGL& other) = delete;
+
+		// Move ctor and assignment
+		MaterialTemplateGL(MaterialTemplateGL&& other) = delete;
+		MaterialTemplateGL operator=(MaterialTemplateGL&& other) = delete;
+
+		// -------------------------------- CACHEABLE INTERFACE -------------------------------- //
+
+		virtual std::string getCacheName() const override;
+
+		// -------------------------------- MATERIAL TEMPLATE -------------------------------- //
+
+		// Generates the cache name of the template that compiles the given shader code
+		static std::string generateCacheName(const std::string& vertexShaderCode,
+			const std::string& geometryShaderCode,
+			const std::string& fragmentShaderCode);
+
+		/*
+		* Finds the cached template that compiles exactly the given shader code. If there isn't any, returns nullptr and
+		* outCacheName is a free cache name to store the new template with. Names of templates whose code hashes collide
+		* are told apart by a numeric suffix
+		*/
+		static std::shared_ptr<MaterialTemplateGL> findCachedTemplate(Cache& cache,
+			const std::string& vertexShaderCode,
+			const std::string& geometryShaderCode,
+			const std::string& fragmentShaderCode,
+			std::string& outCacheName);
+
+		// Returns true if this template was created from the given shader code
+		bool hasShaderCode(const std::string& vertexShaderCode,
+			const std::string& geometryShaderCode,
+			const std::string& fragmentShaderCode) const;
+
+		// Gets the GL program. It may still be compiling, check isReady() before drawing with it
+		GLuint getProgram() const { return program; }
+
+		/*
+		* Returns true if the program is compiled and linked. It never blocks: it polls GL_COMPLETION_STATUS_KHR
+		* if available or, otherwise, waits until a later frame than the submit one. Finalizes the program when ready
+		*/
+		bool isReady(unsigned long long int currentFrame);
+
+		// Returns true once the program has been finalized. Unlike isReady(), it doesn't need the current frame
+		bool isFinished() const { return isFinalized; }
+
+		/*
+		* Checks compile and link status, releases shader objects and binds uniform blocks.
+		* If the program isn't finished yet, this waits for it. Called automatically by isReady()
+		*/
+		void finalize();
+
+		/*
+		* Gets the location of a uniform. Locations are queried to GL only once per variable name.
+		* Cached locations are keyed by a hash of the name, so lookups never allocate
+		*/
+		GLint getUniformLocation(const char* variableName);
+
+		// Releases the GL program. Don't call this on a cached template, use Cache::releaseCacheItem() instead
+		void destroy();
+
+	private: // Aux functions
+		// Shader compilation status
+		inline bool checkShaderCompilation(GLuint shader);
+		inline bool checkProgramLinkStatus(GLuint program);
+
+		// FNV-1a hash of a null terminated uniform name
+		inline static unsigned long long int hashUniformName(const char* variableName);
+
+	private:
+		static const unsigned long long int UNIFORM_NAME_HASH_OFFSET_BASIS;
+		static const unsigned long long int UNIFORM_NAME_HASH_PRIME;
+
+	protected:
+		bool isDestroyed;
+		bool isFinalized;
+
+		std::string cacheName;
+		GLuint program;
+		GLuint vertexShader;
+		GLuint geometryShader;
+		GLuint fragmentShader;
+		unsigned long long int submitFrame;
+
+		// Source code. Kept to discard cache name collisions
+		std::string vertexShaderCode;
+		std::string geometryShaderCode;
+		std::string fragmentShaderCode;
+
+		// Uniform locations keyed by hashUniformName(). The name is kept to discard hash collisions
+		struct UniformLocation
+		{
+			std::string variableName;
+			GLint location;
+		};
+		std::unordered_map<unsigned long long int, UniformLocation> uniformLocations;
+	};
+}
\ No newline at end of file
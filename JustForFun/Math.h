@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -15,6 +15,10 @@
 
 namespace JFF
 {
+	/*
+	* Math subsystem. Every call goes through a virtual function, so engine code uses the inline functions
+	* of MathFunctions.h instead. This interface remains for scripts that reach math through the Engine
+	*/
 	class Math : public Subsystem
 	{
 	public:
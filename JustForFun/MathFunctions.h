@@ -0,0 +1,44 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Mat.h" // Includes Vec.h inside
+#include "Quat.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace JFF
+{
+	/*
+	* Header-only math layer. Engine code must use these functions (and the global functions of Vec, Mat and Quat)
+	* directly, because they are inlined at call site. The Math subsystem wraps the same operations behind virtual calls
+	* and is kept for scripts that access math through the Engine
+	*/
+
+	// Common ops
+	inline float abs(float n) { return std::fabs(n); }
+	inline int abs(int n) { return n < 0 ? -n : n; }
+	inline float pow(float base, float exp) { return std::pow(base, exp); }
+	inline float clamp(float value, float min, float max) { return std::min(std::max(value, min), max); }
+	inline int clamp(int value, int min, int max) { return std::min(std::max(value, min), max); }
+	inline float lerp(float x, float y, float a) { return x + a * (y - x); }
+
+	// Trigonometry
+	inline float radians(float degrees) { return degrees * 0.01745329251994329577f; }
+	inline float degrees(float radians) { return radians * 57.2957795130823208768f; }
+	inline float sin(float angleRad) { return std::sin(angleRad); }
+	inline float cos(float angleRad) { return std::cos(angleRad); }
+	inline float tan(float angleRad) { return std::tan(angleRad); }
+	inline float asin(float value) { return std::asin(value); }
+	inline float acos(float value) { return std::acos(value); }
+	inline float atan(float value) { return std::atan(value); }
+}
\ No newline at end of file
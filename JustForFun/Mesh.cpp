@@ -3,12 +3,13 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "Mesh.h"
+#include "MathFunctions.h"
 
 #include "Engine.h"
 #include "Log.h"
@@ -102,8 +103,6 @@ JFF::MeshSphere::MeshSphere(Engine* const engine, unsigned int meridians, unsign
 
 	// -------------- Add meridian and parallel vertices, including north and south pole. Build from buttom up -------------- //
 
-	auto math = engine->math.lock();
-
 	meridians += 2; // Add two more meridians: One for north pole and another for the south pole
 	for (unsigned int meridian = 0; meridian < meridians; ++meridian)
 	{
@@ -113,7 +112,7 @@ JFF::MeshSphere::MeshSphere(Engine* const engine, unsigned int meridians, unsign
 		unsigned int meridianIndexBitangent	= meridian * (parallels + 1) * componentsPerBitangent;
 		unsigned int meridianIndexUV		= meridian * (parallels + 1) * componentsPerUV;
 
-		float pitchRad = math->radians(-90.0f + interMeridianAngle * meridian);
+		float pitchRad = JFF::radians(-90.0f + interMeridianAngle * meridian);
 		for (unsigned int parallel = 0; parallel < parallels; ++parallel)
 		{
 			unsigned int parallelIndexVertex	= parallel * componentsPerVertex;
@@ -122,21 +121,21 @@ JFF::MeshSphere::MeshSphere(Engine* const engine, unsigned int meridians, unsign
 			unsigned int parallelIndexBitangent = parallel * componentsPerBitangent;
 			unsigned int parallelIndexUV		= parallel * componentsPerUV;
 
-			float yawRad = -math->radians(interParallelAngle * parallel); // Negative angle to correct winding order
+			float yawRad = -JFF::radians(interParallelAngle * parallel); // Negative angle to correct winding order
 
 			// Polar coordinates (useful for vertex position and normals)
-			float x = math->cos(pitchRad) * math->cos(yawRad);
-			float y = math->sin(pitchRad);
-			float z = math->cos(pitchRad) * math->sin(yawRad);
+			float x = JFF::cos(pitchRad) * JFF::cos(yawRad);
+			float y = JFF::sin(pitchRad);
+			float z = JFF::cos(pitchRad) * JFF::sin(yawRad);
 
-			// Tangents (90 degrees from normal on XZ plane). Note that pitch isn't part of the formulas
-			float yawOrthogonalRad = yawRad - math->radians(90.0f); // Negative angle to correct winding order
-			float tanX = math->cos(yawOrthogonalRad);
+			// Tangents (90º degrees from normal on XZ plane). Note that pitch isn't part of the formulas
+			float yawOrthogonalRad = yawRad - JFF::radians(90.0f); // Negative angle to correct winding order
+			float tanX = JFF::cos(yawOrthogonalRad);
 			float tanY = 0.0f;
-			float tanZ = math->sin(yawOrthogonalRad);
+			float tanZ = JFF::sin(yawOrthogonalRad);
 
 			// Bitangents (orthogonal to normal and bitangent)
-			Vec3 bitangent = math->cross(Vec3(x, y, z), Vec3(tanX, tanY, tanZ)); // cross(Normal,Tangent)
+			Vec3 bitangent = JFF::cross(Vec3(x, y, z), Vec3(tanX, tanY, tanZ)); // cross(Normal,Tangent)
 
 			// UV coordinates
 			float u = UVChunkX * parallel;
@@ -174,18 +173,18 @@ JFF::MeshSphere::MeshSphere(Engine* const engine, unsigned int meridians, unsign
 		// Add a last parallel point that matches the first one, but with different UV
 		float yawRad = 0;
 
-		float x = math->cos(pitchRad) * math->cos(yawRad);
-		float y = math->sin(pitchRad);
-		float z = math->cos(pitchRad) * math->sin(yawRad);
+		float x = JFF::cos(pitchRad) * JFF::cos(yawRad);
+		float y = JFF::sin(pitchRad);
+		float z = JFF::cos(pitchRad) * JFF::sin(yawRad);
 
-		// Tangents (90 degrees from normal on XZ plane). Note that pitch isn't part of the formulas
-		float yawOrthogonalRad = yawRad - math->radians(90.0f); // Negative angle to correct winding order
-		float tanX = math->cos(yawOrthogonalRad);
+		// Tangents (90º degrees from normal on XZ plane). Note that pitch isn't part of the formulas
+		float yawOrthogonalRad = yawRad - JFF::radians(90.0f); // Negative angle to correct winding order
+		float tanX = JFF::cos(yawOrthogonalRad);
 		float tanY = 0.0f;
-		float tanZ = math->sin(yawOrthogonalRad);
+		float tanZ = JFF::sin(yawOrthogonalRad);
 
 		// Bitangents (orthogonal to normal and bitangent)
-		Vec3 bitangent = math->cross(Vec3(x, y, z), Vec3(tanX, tanY, tanZ)); // cross(Normal,Tangent)
+		Vec3 bitangent = JFF::cross(Vec3(x, y, z), Vec3(tanX, tanY, tanZ)); // cross(Normal,Tangent)
 
 		float u = 1.0f;
 		float v = UVChunkY * meridian;
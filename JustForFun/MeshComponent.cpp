@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -59,3 +59,8 @@ void JFF::MeshComponent::draw()
 {
 	mesh->draw();
 }
+
+JFF::AABB JFF::MeshComponent::getLocalBounds() const
+{
+	return mesh->getLocalBounds();
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -45,6 +45,9 @@ namespace JFF
 		// Enables the GPU buffer where the vertex data of this mesh is stored and execute a draw call
 		virtual void draw();
 
+		// Gets the AABB that contains all vertex positions, in model space
+		virtual AABB getLocalBounds() const;
+
 	protected:
 		std::shared_ptr<JFF::MeshObject> mesh;
 	};
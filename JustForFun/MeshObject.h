@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "Mesh.h"
+#include "Bounds.h"
 #include <memory>
 
 namespace JFF
@@ -68,5 +69,8 @@ namespace JFF
 
 		// Enables the GPU buffer where the vertex data of this mesh is stored and execute a draw call
 		virtual void draw() = 0;
+
+		// Gets the AABB that contains all vertex positions, in model space. Available before and after cooking
+		virtual AABB getLocalBounds() const = 0;
 	};
 }
\ No newline at end of file
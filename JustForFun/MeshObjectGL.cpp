@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -17,16 +17,20 @@ JFF::MeshObjectGL::MeshObjectGL(JFF::Engine* const engine, const std::shared_ptr
 	engine(engine),
 	mesh(mesh),
 	vao(0u),
-	drawData()
+	drawData(),
+	localBounds()
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor MeshObjectGL")
+
+	calculateLocalBounds();
 }
 
 JFF::MeshObjectGL::MeshObjectGL(JFF::Engine* const engine, const BasicMesh& predefinedShape) :
 	engine(engine),
 	mesh(),
 	vao(0u),
-	drawData()
+	drawData(),
+	localBounds()
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor MeshObjectGL")
 
@@ -42,6 +46,8 @@ JFF::MeshObjectGL::MeshObjectGL(JFF::Engine* const engine, const BasicMesh& pred
 		mesh = std::make_shared<MeshPlane>();
 		break;
 	}
+
+	calculateLocalBounds();
 }
 
 JFF::MeshObjectGL::~MeshObjectGL()
@@ -113,6 +119,11 @@ void JFF::MeshObjectGL::draw()
 	}
 }
 
+JFF::AABB JFF::MeshObjectGL::getLocalBounds() const
+{
+	return localBounds;
+}
+
 inline GLuint JFF::MeshObjectGL::genVBO()
 {
 	// Vertex buffer object
@@ -370,3 +381,35 @@ inline GLenum JFF::MeshObjectGL::translatePrimitiveMethodToOpenGL(const Mesh::Pr
 		return GL_TRIANGLES;
 	}
 }
+
+inline void JFF::MeshObjectGL::calculateLocalBounds()
+{
+	if (!mesh || !mesh->vertices || mesh->verticesSize == 0)
+	{
+		JFF_LOG_WARNING("Cannot calculate bounds of a mesh without vertices")
+		return;
+	}
+
+	// If data is collapsed, positions are interleaved with the rest of vertex attributes
+	size_t stride = (size_t)mesh->componentsPerVertex;
+	if (mesh->isDataCollapsed)
+	{
+		stride += mesh->useNormals ? (size_t)mesh->componentsPerNormal : 0u;
+		stride += mesh->useTangents ? (size_t)mesh->componentsPerTangent : 0u;
+		stride += mesh->useBitangents ? (size_t)mesh->componentsPerBitangent : 0u;
+		stride += mesh->useUV ? (size_t)mesh->componentsPerUV : 0u;
+	}
+
+	size_t positionComponents = std::min((size_t)mesh->componentsPerVertex, (size_t)3u);
+	for (size_t j = 0; j < positionComponents; ++j)
+		localBounds.min[j] = localBounds.max[j] = mesh->vertices[j];
+
+	for (size_t i = stride; i + positionComponents <= mesh->verticesSize; i += stride)
+	{
+		for (size_t j = 0; j < positionComponents; ++j)
+		{
+			localBounds.min[j] = std::min(localBounds.min[j], mesh->vertices[i + j]);
+			localBounds.max[j] = std::max(localBounds.max[j], mesh->vertices[i + j]);
+		}
+	}
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -41,7 +41,11 @@ namespace JFF
 		// Enables the GPU buffer where the vertex data of this mesh is stored and execute a draw call
 		virtual void draw() override;
 
+		// Gets the AABB that contains all vertex positions, in model space. Available before and after cooking
+		virtual AABB getLocalBounds() const override;
+
 	private: // Helper functions
+		inline void calculateLocalBounds();
 		inline GLuint genVBO();
 		inline GLuint genEBO();
 		inline void setVertexPointers();
@@ -56,5 +60,6 @@ namespace JFF
 
 		GLuint vao;
 		DrawData drawData;
+		AABB localBounds; // Calculated on construction, because vertex data is removed from CPU after cooking
 	};
 }
\ No newline at end of file
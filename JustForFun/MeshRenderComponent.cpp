@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,7 +12,6 @@
 
 #include "Engine.h"
 #include "FileSystemSetup.h"
-#include <regex>
 
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name, const char* assetFilePath);
 
@@ -52,7 +51,7 @@ void JFF::MeshRenderComponent::onStart()
 	// Load material from file if it's null
 	if (!material)
 	{
-		std::string assetFullPath = std::regex_replace(materialAssetFilepath, std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+		std::string assetFullPath = toPlatformPath(materialAssetFilepath);
 		material = createMaterial(gameObject->engine, materialAssetFilepath.c_str(), assetFullPath.c_str());
 	}
 
@@ -64,6 +63,14 @@ void JFF::MeshRenderComponent::onStart()
 		return;
 	}
 
+	// Register mesh bounds in Spatial subsystem so Renderer can cull this RenderComponent
+	std::shared_ptr<Spatial> spatial = gameObject->engine->spatial.lock();
+	Material::MaterialDomain domain = getMaterialDomain();
+	if (spatial && (domain == Material::MaterialDomain::SURFACE || domain == Material::MaterialDomain::TRANSLUCENT))
+	{
+		spatialProxy = spatial->createProxy(this, mesh.lock()->getLocalBounds(), Spatial::RENDERABLE);
+	}
+
 	// Send this RenderComponent to Renderer
 	gameObject->engine->renderer.lock()->addRenderable(this);
 }
@@ -75,6 +82,14 @@ void JFF::MeshRenderComponent::onDestroy() noexcept
 
 	// Remove this RenderComponent from Renderer
 	gameObject->engine->renderer.lock()->removeRenderable(this);
+
+	// Remove its bounds from Spatial subsystem
+	std::shared_ptr<Spatial> spatial = gameObject->engine->spatial.lock();
+	if (spatial && spatialProxy != Spatial::INVALID_PROXY)
+	{
+		spatial->destroyProxy(spatialProxy);
+		spatialProxy = Spatial::INVALID_PROXY;
+	}
 }
 
 JFF::Material::MaterialDomain JFF::MeshRenderComponent::getMaterialDomain() const
@@ -97,6 +112,11 @@ JFF::Material::DebugDisplay JFF::MeshRenderComponent::getDebugDisplay() const
 	return material->getDebugDisplay();
 }
 
+bool JFF::MeshRenderComponent::isMaterialReady()
+{
+	return material->isReady();
+}
+
 void JFF::MeshRenderComponent::useMaterial()
 {
 	material->use();
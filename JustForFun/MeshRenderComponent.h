@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -60,6 +60,9 @@ namespace JFF
 		// Gets debug display option if applicable
 		virtual Material::DebugDisplay getDebugDisplay() const override;
 
+		// Returns true if the material's shaders finished compiling
+		virtual bool isMaterialReady() override;
+
 		// Enables the internal shader and its associated textures
 		virtual void useMaterial() override;
 
@@ -105,10 +108,10 @@ namespace JFF
 			const std::shared_ptr<Texture>& BRDFIntegrationMap = nullptr) override;
 
 		/*
-		* Send a directional light's shadowmap texture to this material located at given index.
+		* Send the shadow atlas, which holds the shadowmap of the directional light located at given index, to this material.
 		* Index must be in range [0, Renderer::getForwardShadingMaxDirectionalLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendDirLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowMapFBO = std::weak_ptr<Framebuffer>()) override;
 
@@ -121,10 +124,10 @@ namespace JFF
 		virtual void sendPointLightShadowCubemap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowCubemapFBO = std::weak_ptr<Framebuffer>()) override;
 
 		/*
-		* Send a spot light's shadowmap texture to this material located at given index.
+		* Send the shadow atlas, which holds the shadowmap of the spot light located at given index, to this material.
 		* Index must be in range [0, Renderer::getForwardShadingMaxSpotLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendSpotLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowMapFBO = std::weak_ptr<Framebuffer>()) override;
 
@@ -3,13 +3,14 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "ModelAssimp.h"
 #include "FileSystemSetup.h"
+#include "MathFunctions.h"
 
 #include "Engine.h"
 #include "Log.h"
@@ -20,7 +21,6 @@
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 
-#include <regex>
 #include <sstream>
 #include <algorithm>
 #include <cctype> // Used isalnum() function
@@ -55,6 +55,7 @@ JFF::ModelAssimp::ModelAssimp(const char* assetFilePath, Engine* const engine, c
 	extractModelConfigUseParallaxMapFromFile(iniFile);
 	extractModelConfigTranslucentFromFile(iniFile);
 	extractModelConfigRenderBackFacesFromFile(iniFile);
+	extractModelConfigStaticShadowCasterFromFile(iniFile);
 	extractModelConfigLightModelFromFile(iniFile);
 	extractModelConfigPBRWorkflowFromFile(iniFile);
 
@@ -99,7 +100,7 @@ std::weak_ptr<JFF::GameObject> JFF::ModelAssimp::getGameObject() const
 
 inline std::string JFF::ModelAssimp::extractModelRelativePathFromFile(const std::shared_ptr<INIFile>& iniFile) const
 {
-	std::string path = std::regex_replace(iniFile->getString("model", "path"), std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+	std::string path = toPlatformPath(iniFile->getString("model", "path"));
 	return path;
 }
 
@@ -174,6 +175,11 @@ inline void JFF::ModelAssimp::extractModelConfigRenderBackFacesFromFile(const st
 	renderBackfaces = iniFile->has("config", "render-back-faces") && iniFile->getString("config", "render-back-faces") == "true";
 }
 
+inline void JFF::ModelAssimp::extractModelConfigStaticShadowCasterFromFile(const std::shared_ptr<INIFile>& iniFile)
+{
+	staticShadowCaster = iniFile->has("config", "static-shadow-caster") && iniFile->getString("config", "static-shadow-caster") == "true";
+}
+
 inline void JFF::ModelAssimp::extractModelConfigLightModelFromFile(const std::shared_ptr<INIFile>& iniFile)
 {
 	isPBR = iniFile->has("config", "light-model") && iniFile->getString("config", "light-model") == "PBR";
@@ -188,7 +194,7 @@ inline void JFF::ModelAssimp::loadTexturesFromFile(const std::shared_ptr<INIFile
 {
 	iniFile->visitKeyValuePairs("textures", [this](const std::pair<std::string, std::string>& pair)
 		{
-			std::string path = std::regex_replace(pair.second, std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+			std::string path = toPlatformPath(pair.second);
 			std::shared_ptr<Texture> texture = createTexture(engine, pair.first.c_str(), path.c_str());
 			externalTextures.push_back(texture);
 		});
@@ -213,35 +219,36 @@ inline void JFF::ModelAssimp::extractModelMaterialOverrideFunctionFromFile(const
 	materialOverrideFunction = oss.str();
 }
 
-void JFF::ModelAssimp::extractLocalTransform(aiNode* node, Vec3& localPos, Vec3& localRot, Vec3& localScale)
+void JFF::ModelAssimp::extractLocalTransform(aiNode* node, Vec3& localPos, Quat& localRot, Vec3& localScale)
 {
-	// Extract Assimp's trasform components
-	aiVector3D aiLocalPos, aiLocalRot, aiLocalScale;
+	// Extract Assimp's trasform components. Rotation is extracted as a quaternion, the same way transforms store it
+	aiVector3D aiLocalPos, aiLocalScale;
+	aiQuaternion aiLocalRot;
 	node->mTransformation.Decompose(aiLocalScale, aiLocalRot, aiLocalPos);
 
 	// Set JFF transform components from extracted Assimp components
-	// NOTE: Assimp uses radians in their rotations, but JFF unit is degrees
-	auto math = engine->math.lock();
 	localPos = Vec3(aiLocalPos.x, aiLocalPos.y, aiLocalPos.z);
-	localRot = Vec3(math->degrees(aiLocalRot.x), math->degrees(aiLocalRot.y), math->degrees(aiLocalRot.z));
+	localRot = Quat(aiLocalRot.w, aiLocalRot.x, aiLocalRot.y, aiLocalRot.z);
 	localScale = Vec3(aiLocalScale.x, aiLocalScale.y, aiLocalScale.z);
 }
 
 void JFF::ModelAssimp::processRootNode(aiNode* node, const aiScene* scene)
 {
 	// Extract position, rotation and scale from this node
-	Vec3 localPos, localRot, localScale;
+	Vec3 localPos, localScale;
+	Quat localRot;
 	extractLocalTransform(node, localPos, localRot, localScale);
 
 	// Spawn an initially disabled GameObject
 	if (parentObj.expired()) // No parent defined
 	{
-		loadedModel = engine->logic.lock()->spawnGameObject(modelName.c_str(), localPos, localRot, localScale, false);
+		loadedModel = engine->logic.lock()->spawnGameObject(modelName.c_str(), localPos, Vec3::ZERO, localScale, false);
 	}
 	else
 	{
-		loadedModel = engine->logic.lock()->spawnGameObject(modelName.c_str(), parentObj, localPos, localRot, localScale, false);
+		loadedModel = engine->logic.lock()->spawnGameObject(modelName.c_str(), parentObj, localPos, Vec3::ZERO, localScale, false);
 	}
+	loadedModel.lock()->transform.setLocalRotation(localRot);
 
 	// Load meshes
 	for (unsigned int i = 0; i < node->mNumMeshes; ++i)
@@ -255,12 +262,14 @@ void JFF::ModelAssimp::processRootNode(aiNode* node, const aiScene* scene)
 void JFF::ModelAssimp::processNode(aiNode* node, const aiScene* scene, const std::weak_ptr<GameObject>& parentGameObject)
 {
 	// Extract position, rotation and scale from this node
-	Vec3 localPos, localRot, localScale;
+	Vec3 localPos, localScale;
+	Quat localRot;
 	extractLocalTransform(node, localPos, localRot, localScale);
 	
 	// Create an empty GameObject node 
 	std::string nodeObjName = parentGameObject.lock()->getName().append(".node-").append(node->mName.C_Str());
-	auto nodeObj = engine->logic.lock()->spawnGameObject(nodeObjName.c_str(), parentGameObject, localPos, localRot, localScale);
+	auto nodeObj = engine->logic.lock()->spawnGameObject(nodeObjName.c_str(), parentGameObject, localPos, Vec3::ZERO, localScale);
+	nodeObj.lock()->transform.setLocalRotation(localRot);
 
 	// Load meshes
 	for (unsigned int i = 0; i < node->mNumMeshes; ++i)
@@ -286,7 +295,8 @@ void JFF::ModelAssimp::processMesh(aiMesh* mesh, const aiScene* scene, const std
 	// Create mesh render component from mesh' material data
 	std::string meshRenderName = meshObjName + ".renderComp";
 	std::shared_ptr<Material> material = generateMaterial(scene, mesh, meshObjName);
-	meshObjHandler->addComponent<MeshRenderComponent>(meshRenderName.c_str(), true, material);
+	auto meshRenderComp = meshObjHandler->addComponent<MeshRenderComponent>(meshRenderName.c_str(), true, material);
+	meshRenderComp.lock()->setStaticShadowCaster(staticShadowCaster);
 
 	// If valid, generate a MeshRenderComponent with debug info
 	if (!debugMaterialName.empty())
@@ -439,6 +449,10 @@ inline std::shared_ptr<JFF::Material> JFF::ModelAssimp::generateMaterial(const a
 	std::string materialFunctionCode;
 	matFuncBuilder->generateCode(materialFunctionCode, useParallaxMap, isPBR);
 
+	// Constant channels are uniforms in material() function. Their values belong to this material instance
+	for (const auto& constant : matFuncBuilder->getConstants())
+		material->setParameter(constant.first.c_str(), constant.second);
+
 	// Decide if normals from normal maps will be used
 	bool finalUseNormalMap = false;
 	switch (useNormalMap)
@@ -509,11 +523,19 @@ inline bool JFF::ModelAssimp::fillMaterialWithTexturesOfType(aiTextureType texTy
 		adaptTextureBlendFactor(blend, blendFactor);
 		adaptTextureOp(texOp, textureOp);
 
+		/*
+		* Sampler names depend on the texture slot (channel and index), not on the texture itself. This way, meshes 
+		* with the same channel layout generate the same code and share one program, using different textures
+		*/
+		std::ostringstream samplerNameSS;
+		samplerNameSS << "materialTex" << static_cast<int>(texType) << "_" << i;
+		std::string samplerName = samplerNameSS.str();
+
 		// Add texture to material
-		material->addTexture(texture);
+		material->addTexture(texture, samplerName);
 
 		// Add texture to material() function
-		materialFunctionCodeBuilder->addTextureLine(texture->getName(), texApplication, textureMapping, uvVariableNameUsed, blendFactor, textureOp);
+		materialFunctionCodeBuilder->addTextureLine(samplerName, texApplication, textureMapping, uvVariableNameUsed, blendFactor, textureOp);
 	}
 
 	return texCount;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -16,6 +16,7 @@
 #include "MaterialFunctionCodeBuilder.h"
 #include "Texture.h"
 #include "Vec.h"
+#include "Quat.h"
 
 #include <string>
 
@@ -61,13 +62,14 @@ namespace JFF
 		inline void extractModelConfigUseParallaxMapFromFile(const std::shared_ptr<INIFile>& iniFile);
 		inline void extractModelConfigTranslucentFromFile(const std::shared_ptr<INIFile>& iniFile);
 		inline void extractModelConfigRenderBackFacesFromFile(const std::shared_ptr<INIFile>& iniFile);
+		inline void extractModelConfigStaticShadowCasterFromFile(const std::shared_ptr<INIFile>& iniFile);
 		inline void extractModelConfigLightModelFromFile(const std::shared_ptr<INIFile>& iniFile);
 		inline void extractModelConfigPBRWorkflowFromFile(const std::shared_ptr<INIFile>& iniFile);
 		inline void loadTexturesFromFile(const std::shared_ptr<INIFile>& iniFile);
 		inline void extractModelDebugMaterialFromFile(const std::shared_ptr<INIFile>& iniFile);
 		inline void extractModelMaterialOverrideFunctionFromFile(const std::shared_ptr<INIFile>& iniFile);
 
-		inline void extractLocalTransform(aiNode* node, Vec3& localPos, Vec3& localRot, Vec3& localScale);
+		inline void extractLocalTransform(aiNode* node, Vec3& localPos, Quat& localRot, Vec3& localScale);
 		inline void processRootNode(aiNode* node, const aiScene* scene);
 		void processNode(aiNode* node, const aiScene* scene, const std::weak_ptr<GameObject>& parentGameObject); // Not inline because it's recursive
 		inline void processMesh(aiMesh* mesh, const aiScene* scene, const std::weak_ptr<GameObject>& parentGameObject);
@@ -110,6 +112,7 @@ namespace JFF
 		bool useParallaxMap;
 		bool enableTranslucency;
 		bool renderBackfaces;
+		bool staticShadowCaster;
 		bool isPBR;
 		bool PBRMetallicWorkflow; // True: Metallic workflow. False: Specular workflow
 		std::vector<std::shared_ptr<Texture>> externalTextures;
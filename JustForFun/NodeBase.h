@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,6 +13,7 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
 namespace JFF
 {
@@ -34,7 +35,7 @@ namespace JFF
 
 		// -------------------------------------------- Virtual methods -------------------------------------------- //
 
-		// Connect with edge. This node doesn't allow edge repetition. Expensive operation
+		// Connect with edge. This node doesn't allow edge repetition. O(1) expected
 		virtual void operator<<(const std::weak_ptr<_E>& edge);
 		virtual void operator>>(const std::weak_ptr<_E>& edge);
 
@@ -56,10 +57,16 @@ namespace JFF
 		size_t numEdges() const { return edges.size(); }
 
 	protected:
+		using EdgeSlots = std::unordered_map<const _E*, size_t>; // Edge -> index in its edge list
+
 		inline bool addUniqueEdge(const std::weak_ptr<_E>& edge);
 
+		// O(1) insertion on an edge list indexed by its slot map
+		static inline void insertEdge(std::vector<std::weak_ptr<_E>>& list, EdgeSlots& slots, const std::weak_ptr<_E>& edge);
+
 	protected:
 		std::vector<std::weak_ptr<_E>> edges;
+		EdgeSlots edgeSlots;
 	};
 }
 
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -14,7 +14,9 @@
 #include <algorithm>
 
 template<typename _E>
-JFF::NodeBase<_E>::NodeBase()
+JFF::NodeBase<_E>::NodeBase() :
+	edges(),
+	edgeSlots()
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor NodeBase")
 }
@@ -66,15 +68,21 @@ inline bool JFF::NodeBase<_E>::addUniqueEdge(const std::weak_ptr<_E>& edge)
 {
 	// NOTE: This function was separated from operator<< to make it useful for children of this class
 
-	auto predicate = [&edge](const std::weak_ptr<_E>& e) { return *(edge.lock()) == e; };
-	if (std::find_if(edges.begin(), edges.end(), predicate) != edges.end())
+	if (edgeSlots.find(edge.lock().get()) != edgeSlots.end())
 	{
 		JFF_LOG_WARNING("Edge is already connected to node. Operation aborted.")
 		return false;
 	}
 	else
 	{
-		edges.push_back(edge);
+		insertEdge(edges, edgeSlots, edge);
 		return true;
 	}
 }
+
+template<typename _E>
+inline void JFF::NodeBase<_E>::insertEdge(std::vector<std::weak_ptr<_E>>& list, EdgeSlots& slots, const std::weak_ptr<_E>& edge)
+{
+	slots[edge.lock().get()] = list.size();
+	list.push_back(edge);
+}
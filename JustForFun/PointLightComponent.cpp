@@ -3,19 +3,18 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "PointLightComponent.h"
+#include "MathFunctions.h"
 
 #include "Log.h"
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
 
-#include <sstream>
-
 extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(JFF::Framebuffer::PrefabFramebuffer fboType,
 	unsigned int width, unsigned int height, unsigned int samplesPerPixel = 0);
 
@@ -36,6 +35,7 @@ JFF::PointLightComponent::PointLightComponent(GameObject* const gameObject, cons
 	viewMatrixFar(),
 
 	shadowCubemapFBO(),
+	staticShadowCubemapFBO(),
 	shadowCastMaterial()
 {
 	JFF_LOG_INFO("Ctor PointLightComponent")
@@ -55,6 +55,12 @@ void JFF::PointLightComponent::onStart()
 	{
 		shadowCubemapFBO = createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_SHADOW_CUBEMAP, 
 			params.shadowCubemapFaceWidth, params.shadowCubemapFaceHeight);
+
+		if (engine->renderer.lock()->isShadowStaticCacheEnabled())
+		{
+			staticShadowCubemapFBO = createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_SHADOW_CUBEMAP,
+				params.shadowCubemapFaceWidth, params.shadowCubemapFaceHeight);
+		}
 			
 		shadowCastMaterial = createMaterial(engine, "Point light material");
 		shadowCastMaterial->setDomain(Material::MaterialDomain::OMNIDIRECTIONAL_SHADOW_CAST);
@@ -74,46 +80,36 @@ void JFF::PointLightComponent::onDestroy() noexcept
 	if (shadowCubemapFBO)
 		shadowCubemapFBO->destroy();
 
+	if (staticShadowCubemapFBO)
+		staticShadowCubemapFBO->destroy();
+
 	if (shadowCastMaterial)
 		shadowCastMaterial->destroy();
 }
 
 void JFF::PointLightComponent::sendLightParams(RenderComponent* const renderComponent, int lightIndex)
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
 
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::POINT_LIGHT_POSITION;
 	auto lightWorldPos = gameObject->transform.getModelMatrix() * Vec4(0.0f, 0.0f, 0.0f, 1.0f);
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
+	renderComponent->sendVec3(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::POINT_LIGHT_POSITION.c_str()), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::POINT_LIGHT_COLOR;
-	renderComponent->sendVec3(ss.str().c_str(), params.color);
+	renderComponent->sendVec3(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::POINT_LIGHT_COLOR.c_str()), params.color);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::POINT_LIGHT_INTENSITY;
-	renderComponent->sendFloat(ss.str().c_str(), params.intensity);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::POINT_LIGHT_INTENSITY.c_str()), params.intensity);
 	
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::POINT_LIGHT_LINEAR_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.linearAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::POINT_LIGHT_LINEAR_ATTENUATION_FACTOR.c_str()), params.linearAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::POINT_LIGHT_QUADRATIC_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.quadraticAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::POINT_LIGHT_QUADRATIC_ATTENUATION_FACTOR.c_str()), params.quadraticAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::POINT_LIGHT_CAST_SHADOWS;
-	renderComponent->sendFloat(ss.str().c_str(), params.castShadows ? 1.0f : 0.0f);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::POINT_LIGHT_CAST_SHADOWS.c_str()), params.castShadows ? 1.0f : 0.0f);
 
 	if (params.castShadows)
 	{
 		renderComponent->sendPointLightShadowCubemap(lightIndex, shadowCubemapFBO);
 
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::POINT_LIGHT_FAR_PLANE;
-		renderComponent->sendFloat(ss.str().c_str(), params.zFar);
+		renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::POINT_LIGHT_FAR_PLANE.c_str()), params.zFar);
 	}
 	else
 	{
@@ -123,40 +119,27 @@ void JFF::PointLightComponent::sendLightParams(RenderComponent* const renderComp
 
 void JFF::PointLightComponent::sendLightParams(RenderComponent* const renderComponent)
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
 
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT << "." << ShaderCodeBuilder::POINT_LIGHT_POSITION;
 	auto lightWorldPos = gameObject->transform.getModelMatrix() * Vec4(0.0f, 0.0f, 0.0f, 1.0f);
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
+	renderComponent->sendVec3(frameAllocator.format("%s.%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::POINT_LIGHT_POSITION.c_str()), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT << "." << ShaderCodeBuilder::POINT_LIGHT_COLOR;
-	renderComponent->sendVec3(ss.str().c_str(), params.color);
+	renderComponent->sendVec3(frameAllocator.format("%s.%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::POINT_LIGHT_COLOR.c_str()), params.color);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT << "." << ShaderCodeBuilder::POINT_LIGHT_INTENSITY;
-	renderComponent->sendFloat(ss.str().c_str(), params.intensity);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::POINT_LIGHT_INTENSITY.c_str()), params.intensity);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT << "." << ShaderCodeBuilder::POINT_LIGHT_LINEAR_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.linearAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::POINT_LIGHT_LINEAR_ATTENUATION_FACTOR.c_str()), params.linearAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT << "." << ShaderCodeBuilder::POINT_LIGHT_QUADRATIC_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.quadraticAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::POINT_LIGHT_QUADRATIC_ATTENUATION_FACTOR.c_str()), params.quadraticAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT << "." << ShaderCodeBuilder::POINT_LIGHT_CAST_SHADOWS;
-	renderComponent->sendFloat(ss.str().c_str(), params.castShadows ? 1.0f : 0.0f);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::POINT_LIGHT_CAST_SHADOWS.c_str()), params.castShadows ? 1.0f : 0.0f);
 
 	if (params.castShadows)
 	{
 		renderComponent->sendPointLightShadowCubemap(0, shadowCubemapFBO);
 
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::POINT_LIGHT_STRUCT << "." << ShaderCodeBuilder::POINT_LIGHT_FAR_PLANE;
-		renderComponent->sendFloat(ss.str().c_str(), params.zFar);
+		renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::POINT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::POINT_LIGHT_FAR_PLANE.c_str()), params.zFar);
 	}
 	else
 	{
@@ -174,6 +157,24 @@ void JFF::PointLightComponent::disableShadowMapFramebuffer()
 	shadowCubemapFBO->disable();
 }
 
+bool JFF::PointLightComponent::hasStaticShadowMap() const
+{
+	return (bool)staticShadowCubemapFBO;
+}
+
+void JFF::PointLightComponent::enableStaticShadowMapFramebuffer()
+{
+	staticShadowCubemapFBO->enable();
+}
+
+void JFF::PointLightComponent::restoreStaticShadowMap()
+{
+	shadowCubemapFBO->copyBuffer(Framebuffer::AttachmentPoint::DEPTH, Framebuffer::AttachmentPoint::DEPTH, staticShadowCubemapFBO);
+
+	// Copies change bound framebuffers. Don't clear the copied depth
+	shadowCubemapFBO->enable(false);
+}
+
 void JFF::PointLightComponent::getShadowMapSizePixels(unsigned int& outWidth, unsigned int& outHeight) const
 {
 	outWidth = params.shadowCubemapFaceWidth;
@@ -240,8 +241,6 @@ void JFF::PointLightComponent::setQuadraticAttenuationFactor(float newFactor)
 
 void JFF::PointLightComponent::setPointLightImportanceVolume(float zNear, float zFar)
 {
-	auto math = engine->math.lock();
-
 	params.zNear = zNear;
 	params.zFar = zFar;
 
@@ -256,19 +255,19 @@ void JFF::PointLightComponent::setPointLightImportanceVolume(float zNear, float
 	// Get world position of the light
 	Vec3 lightPos = gameObject->transform.getWorldPos();
 
-	viewMatrixRight		= math->lookAt(lightPos, lightPos + Vec3::RIGHT, Vec3::DOWN);
-	viewMatrixLeft		= math->lookAt(lightPos, lightPos + Vec3::LEFT, Vec3::DOWN);
-	viewMatrixTop		= math->lookAt(lightPos, lightPos + Vec3::UP, Vec3::BACKWARD);
-	viewMatrixBottom	= math->lookAt(lightPos, lightPos + Vec3::DOWN, Vec3::FORWARD);
-	viewMatrixNear		= math->lookAt(lightPos, lightPos + Vec3::BACKWARD, Vec3::DOWN);
-	viewMatrixFar		= math->lookAt(lightPos, lightPos + Vec3::FORWARD, Vec3::DOWN);
+	viewMatrixRight		= JFF::lookAt<4>(lightPos, lightPos + Vec3::RIGHT, Vec3::DOWN);
+	viewMatrixLeft		= JFF::lookAt<4>(lightPos, lightPos + Vec3::LEFT, Vec3::DOWN);
+	viewMatrixTop		= JFF::lookAt<4>(lightPos, lightPos + Vec3::UP, Vec3::BACKWARD);
+	viewMatrixBottom	= JFF::lookAt<4>(lightPos, lightPos + Vec3::DOWN, Vec3::FORWARD);
+	viewMatrixNear		= JFF::lookAt<4>(lightPos, lightPos + Vec3::BACKWARD, Vec3::DOWN);
+	viewMatrixFar		= JFF::lookAt<4>(lightPos, lightPos + Vec3::FORWARD, Vec3::DOWN);
 
 	// --------------------------- BUILD PROJECTION MATRIX --------------------------- //
 
-	float fovyRad = math->radians(90.0f); // 90 degrees takes exactly one face of the cubemap
+	float fovyRad = JFF::radians(90.0f); // 90 degrees takes exactly one face of the cubemap
 	float aspect = (float)params.shadowCubemapFaceWidth / (float)params.shadowCubemapFaceHeight;
 
-	shadowProjectionMatrix = math->perspective(fovyRad, aspect, zNear, zFar);
+	shadowProjectionMatrix = JFF::perspective<4>(fovyRad, aspect, zNear, zFar);
 }
 
 JFF::Vec3 JFF::PointLightComponent::getColor() const
@@ -299,15 +298,29 @@ void JFF::PointLightComponent::getPointLightImportanceVolume(float& outZNear, fl
 
 void JFF::PointLightComponent::sendCubemapViewMatrices()
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
 
 	// The order of layer:cubemap-face is: 0:right 1:left 2:top 3:bottom 4:near 5:far, so each layer must match its corresponding cubemap face
 	Mat4 viewMatrices[] = { viewMatrixRight, viewMatrixLeft, viewMatrixTop, viewMatrixBottom, viewMatrixNear, viewMatrixFar };
 	for (int layer = 0; layer < 6; ++layer)
 	{
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::CUBEMAP_VIEW_MATRICES << "[" << layer << "]";
-		sendMat4(ss.str().c_str(), viewMatrices[layer]);
+		sendMat4(frameAllocator.format("%s[%d]", ShaderCodeBuilder::CUBEMAP_VIEW_MATRICES.c_str(), layer), viewMatrices[layer]);
 	}
 }
+
+JFF::Mat4 JFF::PointLightComponent::getCubemapViewMatrix(unsigned int face) const
+{
+	switch (face)
+	{
+	case 0: return viewMatrixRight;
+	case 1: return viewMatrixLeft;
+	case 2: return viewMatrixTop;
+	case 3: return viewMatrixBottom;
+	case 4: return viewMatrixNear;
+	case 5: return viewMatrixFar;
+	default:
+		JFF_LOG_WARNING("Invalid cubemap face " << face << ". Returning identity matrix")
+		return Mat4();
+	}
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -85,6 +85,9 @@ namespace JFF
 		virtual bool castShadows() const override { return params.castShadows; }
 		virtual void enableShadowMapFramebuffer() override;
 		virtual void disableShadowMapFramebuffer() override;
+		virtual bool hasStaticShadowMap() const override;
+		virtual void enableStaticShadowMapFramebuffer() override;
+		virtual void restoreStaticShadowMap() override;
 		virtual void getShadowMapSizePixels(unsigned int& outWidth, unsigned int& outHeight) const override;
 		virtual void useMaterial() override;
 		virtual void sendMat4(const char* variableName, const Mat4& matrix) override;
@@ -110,6 +113,9 @@ namespace JFF
 
 		virtual void sendCubemapViewMatrices();
 
+		// Gets the view matrix of a cubemap face. The order of faces is: 0:right 1:left 2:top 3:bottom 4:near 5:far
+		virtual Mat4 getCubemapViewMatrix(unsigned int face) const;
+
 	protected:
 		Engine* engine;
 
@@ -120,6 +126,7 @@ namespace JFF
 		Mat4 viewMatrixRight, viewMatrixLeft, viewMatrixTop, viewMatrixBottom, viewMatrixNear, viewMatrixFar;
 
 		std::shared_ptr<Framebuffer> shadowCubemapFBO;
+		std::shared_ptr<Framebuffer> staticShadowCubemapFBO; // Shadows of static casters. nullptr if static cache is disabled
 		std::shared_ptr<Material> shadowCastMaterial;
 	};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,8 +13,11 @@
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
 
+#include <algorithm>
+
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name);
-extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(const JFF::Framebuffer::Params& params);
+
+const unsigned int JFF::PostProcessFXBloom::MIN_MIP_SIZE = 8u;
 
 JFF::PostProcessFXBloom::PostProcessFXBloom(Engine* const engine, int bufferWidth, int bufferHeight, float threshold, float intensity) :
 	engine(engine),
@@ -24,16 +27,11 @@ JFF::PostProcessFXBloom::PostProcessFXBloom(Engine* const engine, int bufferWidt
 
 	colorCopyMaterial(),
 	highPassFilterMaterial(),
-	gaussianBlurHorizontalMaterial(),
-	gaussianBlurVerticalMaterial(),
-	colorAdditionMaterial(),
-
-	highPassFilterFBO(),
-	bloomResultFBO(),
+	downsampleMaterial(),
+	upsampleMaterial(),
 
-	bloomNumPasses(0u),
-	gaussianBlurHorizontalFBOs(),
-	gaussianBlurVerticalFBOs()
+	bloomParams(),
+	numMipLevels(1u)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor PostProcessFXBloom")
 
@@ -47,63 +45,37 @@ JFF::PostProcessFXBloom::PostProcessFXBloom(Engine* const engine, int bufferWidt
 	highPassFilterMaterial->setDomain(Material::MaterialDomain::HIGH_PASS_FILTER);
 	highPassFilterMaterial->cook();
 
-	gaussianBlurHorizontalMaterial = createMaterial(engine, "Gaussian blur horizontal material");
-	gaussianBlurHorizontalMaterial->setDomain(Material::MaterialDomain::GAUSSIAN_BLUR_HORIZONTAL);
-	gaussianBlurHorizontalMaterial->cook();
+	downsampleMaterial = createMaterial(engine, "Bloom downsample material");
+	downsampleMaterial->setDomain(Material::MaterialDomain::BLOOM_DOWNSAMPLE);
+	downsampleMaterial->cook();
 
-	gaussianBlurVerticalMaterial = createMaterial(engine, "Gaussian blur vertical material");
-	gaussianBlurVerticalMaterial->setDomain(Material::MaterialDomain::GAUSSIAN_BLUR_VERTICAL);
-	gaussianBlurVerticalMaterial->cook();
+	upsampleMaterial = createMaterial(engine, "Bloom upsample material");
+	upsampleMaterial->setDomain(Material::MaterialDomain::BLOOM_UPSAMPLE);
+	upsampleMaterial->cook();
 
-	colorAdditionMaterial = createMaterial(engine, "Color addition material");
-	colorAdditionMaterial->setDomain(Material::MaterialDomain::COLOR_ADDITION);
-	colorAdditionMaterial->cook();
+	// ------------------------------ BUILD BLOOM FBO PARAMS ------------------------------ //
 
-	// ------------------------------ BUILD FRAMEBUFFER PARAMS ------------------------------ //
-
-	// TODO: Modify createFramebuffer() to allow create one single texture and use all its mipmaps as attachment points
+	unsigned int width = std::max(1, bufferWidth / 2);
+	unsigned int height = std::max(1, bufferHeight / 2);
 
 	Framebuffer::AttachmentData textureData;
-	textureData.width = bufferWidth;
-	textureData.height = bufferHeight;
+	textureData.width = width;
+	textureData.height = height;
 	textureData.renderBuffer = false;
 	textureData.texType = Framebuffer::TextureType::TEXTURE_2D;
 	textureData.wrapMode = { Framebuffer::Wrap::CLAMP_TO_EDGE, Framebuffer::Wrap::CLAMP_TO_EDGE, Framebuffer::Wrap::CLAMP_TO_EDGE };
-	// IMPORTANT: Textures that doesn't have mipmaps should never use mip filters. Otherwise, sampling to it will result in black screen
-	// IMPORTANT: In order to sample to mipmaps in a texture, it's essential to set minification filter to one that uses mipmaps
-	textureData.filterMode = { Framebuffer::MinificationFilter::LINEAR_NEAREST_MIP, Framebuffer::MagnificationFilter::NEAREST };
+	// Bilinear filtering inside each level is used by the downsample and upsample taps, and by the final upscale to the input buffer
+	textureData.filterMode = { Framebuffer::MinificationFilter::LINEAR_NEAREST_MIP, Framebuffer::MagnificationFilter::LINEAR };
 	textureData.HDR = true;
 	textureData.numColorChannels = 4;
 	textureData.mipmapLevel = 0;
+	textureData.mipmaps = true; // Downsample and upsample passes render to each level of the chain
 
-	Framebuffer::Params params;
-	params.samplesPerPixel = 0u;
-	params.attachments[Framebuffer::AttachmentPoint::COLOR_0] = textureData; // Final color channel
-
-	// ------------------------------ BUILD HIGH PASS FILTER AND COLOR RESULT FBO ------------------------------ //
-
-	// Select mipmap level halving the size of original FBO size
-	params.attachments[Framebuffer::AttachmentPoint::COLOR_0].mipmapLevel = 1;
-
-	highPassFilterFBO = createFramebuffer(params);
-	bloomResultFBO = createFramebuffer(params); // This has the same mipmap level than high pass filter
-
-	// ------------------------------ BUILD GAUSSIAN BLUR FBOs ------------------------------ //
-
-	bloomNumPasses = 6; // TODO: glTexStorage2D guarantees the number of mipmaps
-	for (unsigned int i = 0; i < bloomNumPasses; ++i)
-	{
-		// Increase mipmap level progresively on each pass to get lower res framebuffers on each step
-		params.attachments[Framebuffer::AttachmentPoint::COLOR_0].mipmapLevel++;
-
-		// Horizontal blur FBOs
-		auto horizontalFBO = createFramebuffer(params);
-		gaussianBlurHorizontalFBOs.push_back(horizontalFBO);
+	// The framebuffer is only needed while this FX executes, so it's taken from the render target pool
+	bloomParams.samplesPerPixel = 0u;
+	bloomParams.attachments[Framebuffer::AttachmentPoint::COLOR_0] = textureData;
 
-		// Vertical blur FBO
-		auto verticalFBO = createFramebuffer(params);
-		gaussianBlurVerticalFBOs.push_back(verticalFBO);
-	}
+	updateNumMipLevels(width, height);
 }
 
 JFF::PostProcessFXBloom::~PostProcessFXBloom()
@@ -112,18 +84,8 @@ JFF::PostProcessFXBloom::~PostProcessFXBloom()
 
 	colorCopyMaterial->destroy();
 	highPassFilterMaterial->destroy();
-	gaussianBlurHorizontalMaterial->destroy();
-	gaussianBlurVerticalMaterial->destroy();
-	colorAdditionMaterial->destroy();
-
-	highPassFilterFBO->destroy();
-	bloomResultFBO->destroy();
-
-	for (int i = 0; i < gaussianBlurHorizontalFBOs.size(); ++i)
-	{
-		gaussianBlurHorizontalFBOs[i]->destroy();
-		gaussianBlurVerticalFBOs[i]->destroy();
-	}
+	downsampleMaterial->destroy();
+	upsampleMaterial->destroy();
 }
 
 void JFF::PostProcessFXBloom::execute(
@@ -134,95 +96,59 @@ void JFF::PostProcessFXBloom::execute(
 	auto renderer = engine->renderer.lock();
 	auto mesh = planeMesh.lock();
 	auto inputFBO = ppFBO.lock();
+	auto renderTargetPool = renderer->getRenderTargetPool().lock();
+
+	auto bloomFBO = renderTargetPool->acquire(bloomParams);
 
 	unsigned int width = 0;
 	unsigned int height = 0;
-	int mipLevel = 0;
 
-	// Execute a high pass filter because bloom affects fragments beyond a certain threshold
-	highPassFilterFBO->enable();
+	// Execute a high pass filter because bloom affects fragments beyond a certain threshold. Result goes to the top mip level
+	bloomFBO->setRenderMipLevel(Framebuffer::AttachmentPoint::COLOR_0, 0);
+	bloomFBO->enable();
 
-	highPassFilterFBO->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
+	bloomFBO->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
 	renderer->setViewport(0, 0, width, height);
 
 	highPassFilterMaterial->use();
 	highPassFilterMaterial->sendPostProcessingTextures(ppFBO);
-	highPassFilterMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), (float)mipLevel);
+	highPassFilterMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), 0.0f);
 	highPassFilterMaterial->sendFloat(ShaderCodeBuilder::THRESHOLD.c_str(), threshold);
 	mesh->draw();
 
-	mipLevel++;
+	// Downsample progressively: each mip level is filtered from the previous one, so it only reads the level above it
+	downsampleMaterial->use();
 
-	// Execute blur (horizontally and vertically) on downsampled versions of filtered FBO
-	for (unsigned int i = 0; i < bloomNumPasses; ++i)
+	for (unsigned int level = 1; level < numMipLevels; ++level)
 	{
-		// Render horizontal gaussian blur
-		gaussianBlurHorizontalFBOs[i]->enable();
+		bloomFBO->setSampledMipLevel(Framebuffer::AttachmentPoint::COLOR_0, level - 1);
+		bloomFBO->setRenderMipLevel(Framebuffer::AttachmentPoint::COLOR_0, level); // Every pixel is written. No need to clear
 
-		gaussianBlurHorizontalFBOs[i]->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
+		bloomFBO->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
 		renderer->setViewport(0, 0, width, height);
 
-		gaussianBlurHorizontalMaterial->use();
-		gaussianBlurHorizontalMaterial->sendPostProcessingTextures(
-			i == 0 ? highPassFilterFBO : gaussianBlurVerticalFBOs[i - 1]);
-		gaussianBlurHorizontalMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), (float)mipLevel);
-		mesh->draw();
-
-		mipLevel++;
-
-		// Render vertical gaussian blur
-		gaussianBlurVerticalFBOs[i]->enable();
-
-		gaussianBlurVerticalFBOs[i]->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
-		renderer->setViewport(0, 0, width, height);
-
-		gaussianBlurVerticalMaterial->use();
-		gaussianBlurVerticalMaterial->sendPostProcessingTextures(gaussianBlurHorizontalFBOs[i]);
-		gaussianBlurVerticalMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), (float)mipLevel);
+		downsampleMaterial->sendPostProcessingTextures(bloomFBO);
 		mesh->draw();
 	}
 
-	// Rejoin blurred buffers from low to high resolution. Recycle gaussianBlurHorizontalFBOs to store results
-	colorAdditionMaterial->use(); // Use this material for next passes
-
-	std::shared_ptr<Framebuffer> currentLowerResBlurredFBO = gaussianBlurVerticalFBOs[gaussianBlurVerticalFBOs.size() - 1];
-	std::shared_ptr<Framebuffer> currentHigherResBlurredFBO = gaussianBlurVerticalFBOs[gaussianBlurVerticalFBOs.size() - 2];
-	std::shared_ptr<Framebuffer> currentResultFBO = gaussianBlurHorizontalFBOs[gaussianBlurHorizontalFBOs.size() - 2];
+	// Upsample progressively from the lowest level, adding each result to the level above it
+	upsampleMaterial->use();
+	renderer->enableBlending(Renderer::BlendOp::ADDITIVE);
 
-	for (int i = bloomNumPasses - 2; i >= 0; --i)
+	for (int level = (int)numMipLevels - 2; level >= 0; --level)
 	{
-		// Combine two framebuffers into a third one using color addition material
-		currentResultFBO->enable();
+		bloomFBO->setSampledMipLevel(Framebuffer::AttachmentPoint::COLOR_0, level + 1);
+		bloomFBO->setRenderMipLevel(Framebuffer::AttachmentPoint::COLOR_0, level);
 
-		currentResultFBO->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
+		bloomFBO->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
 		renderer->setViewport(0, 0, width, height);
 
-		colorAdditionMaterial->sendPostProcessingTextures(currentHigherResBlurredFBO, currentLowerResBlurredFBO);
-		colorAdditionMaterial->sendVec2(ShaderCodeBuilder::MIPMAP_LEVELS.c_str(), Vec2((float)(mipLevel - 1), (float)mipLevel));
+		upsampleMaterial->sendPostProcessingTextures(bloomFBO);
 		mesh->draw();
-
-		mipLevel--;
-
-		// Select actors of next operation
-		if (i > 0)
-		{
-			currentLowerResBlurredFBO = currentResultFBO;
-			currentHigherResBlurredFBO = gaussianBlurVerticalFBOs[(size_t)i - 1];
-			currentResultFBO = gaussianBlurHorizontalFBOs[(size_t)i - 1];
-		}
 	}
 
-	// Combine the last blur combination result with high pass filter result
-	bloomResultFBO->enable();
-
-	bloomResultFBO->getSize(Framebuffer::AttachmentPoint::COLOR_0, width, height);
-	renderer->setViewport(0, 0, width, height);
-
-	colorAdditionMaterial->sendPostProcessingTextures(highPassFilterFBO, currentResultFBO);
-	colorAdditionMaterial->sendVec2(ShaderCodeBuilder::MIPMAP_LEVELS.c_str(), Vec2((float)(mipLevel - 1), (float)mipLevel));
-	mesh->draw();
-
-	mipLevel--;
+	renderer->disableBlending();
+	bloomFBO->setSampledMipLevel(Framebuffer::AttachmentPoint::COLOR_0, 0);
 
 	// Combine bloom result with incoming framebuffer color
 	inputFBO->enable(/* clearBuffers = */ false);
@@ -230,8 +156,8 @@ void JFF::PostProcessFXBloom::execute(
 
 	renderer->restoreViewport(); // Restore the original viewport size
 
-	colorCopyMaterial->sendPostProcessingTextures(bloomResultFBO);
-	colorCopyMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), (float)mipLevel);
+	colorCopyMaterial->sendPostProcessingTextures(bloomFBO);
+	colorCopyMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), 0.0f);
 	colorCopyMaterial->sendFloat(ShaderCodeBuilder::INTENSITY.c_str(), intensity);
 
 	renderer->disableDepthTest();
@@ -243,16 +169,27 @@ void JFF::PostProcessFXBloom::execute(
 	// An explicit call to disable FBO is important here because ppFBO could be a multisample buffer and it must 'resolve' 
 	// to an auxiliary FBO (Check Framebuffer class)
 	inputFBO->disable();
+
+	renderTargetPool->release(bloomFBO);
 }
 
 void JFF::PostProcessFXBloom::updateFramebufferSize(int width, int height)
 {
-	highPassFilterFBO->setSize(width, height);
-	bloomResultFBO->setSize(width, height);
+	unsigned int bloomWidth = std::max(1, width / 2);
+	unsigned int bloomHeight = std::max(1, height / 2);
 
-	for (int i = 0; i < gaussianBlurHorizontalFBOs.size(); ++i)
-	{
-		gaussianBlurHorizontalFBOs[i]->setSize(width, height);
-		gaussianBlurVerticalFBOs[i]->setSize(width, height);
-	}
+	// Next executions request a framebuffer of the new size. The pool destroys the old one when it stops being used
+	bloomParams.attachments[Framebuffer::AttachmentPoint::COLOR_0].width = bloomWidth;
+	bloomParams.attachments[Framebuffer::AttachmentPoint::COLOR_0].height = bloomHeight;
+	updateNumMipLevels(bloomWidth, bloomHeight);
 }
+
+inline void JFF::PostProcessFXBloom::updateNumMipLevels(unsigned int width, unsigned int height)
+{
+	// Go down the mip chain until the lowest level reaches the min size
+	unsigned int minSize = std::min(width, height);
+
+	numMipLevels = 1u;
+	while ((minSize >> numMipLevels) >= MIN_MIP_SIZE)
+		++numMipLevels;
+}
\ No newline at end of file
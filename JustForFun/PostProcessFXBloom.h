@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -19,6 +19,10 @@ namespace JFF
 
 	class PostProcessFXBloom : public PostProcessFX
 	{
+	public:
+		// Smallest size (in pixels) of the lowest mip level used by bloom
+		static const unsigned int MIN_MIP_SIZE;
+
 	public:
 		// Ctor & Dtor
 		PostProcessFXBloom(Engine* const engine, int bufferWidth, int bufferHeight, float threshold, float intensity);
@@ -43,6 +47,9 @@ namespace JFF
 		// Changes the sizes of all internal framebuffer this effect has it this makes sense for the concrete effect
 		virtual void updateFramebufferSize(int width, int height) override;
 
+	protected:
+		inline void updateNumMipLevels(unsigned int width, unsigned int height);
+
 	protected:
 		Engine* engine;
 
@@ -51,17 +58,15 @@ namespace JFF
 
 		std::shared_ptr<Material> colorCopyMaterial;
 		std::shared_ptr<Material> highPassFilterMaterial;
-		std::shared_ptr<Material> gaussianBlurHorizontalMaterial;
-		std::shared_ptr<Material> gaussianBlurVerticalMaterial;
-		std::shared_ptr<Material> colorAdditionMaterial;
-
-		// Next two framebuffers have textures of mip level = 1
-		std::shared_ptr<Framebuffer> highPassFilterFBO;
-		std::shared_ptr<Framebuffer> bloomResultFBO;
+		std::shared_ptr<Material> downsampleMaterial;
+		std::shared_ptr<Material> upsampleMaterial;
 
-		// Next framebuffers have descending size mip levels, starting in 2
-		unsigned int bloomNumPasses; // Min value = 4
-		std::vector<std::shared_ptr<Framebuffer>> gaussianBlurHorizontalFBOs;
-		std::vector<std::shared_ptr<Framebuffer>> gaussianBlurVerticalFBOs;
+		/*
+		* Params of a single half resolution texture, taken from the render target pool on each execution. Its mip chain holds
+		* the progressive downsamples of the bright fragments and, after the upsample passes, each level accumulates all the
+		* lower ones. Level 0 ends up with the bloom result
+		*/
+		Framebuffer::Params bloomParams;
+		unsigned int numMipLevels; // Depends on buffer size, so bloom radius is a fixed fraction of the screen
 	};
 }
\ No newline at end of file
@@ -3,30 +3,29 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "PostProcessFXSSAO.h"
+#include "MathFunctions.h"
 
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
 #include "Texture.h"
 
 #include <algorithm>
-#include <sstream>
 #include <random>
 
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name);
-extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(const JFF::Framebuffer::Params& params);
 extern std::shared_ptr<JFF::Texture> createTexture(JFF::Engine* const engine, const JFF::Texture::Params& params);
 
 JFF::PostProcessFXSSAO::PostProcessFXSSAO(
 	Engine* const engine,
 	int bufferWidth, int bufferHeight, 
 	unsigned int numSamples, float sampleHemisphereRadius, 
-	unsigned int numBlurSteps, float intensity) :
+	unsigned int numBlurSteps, float intensity, unsigned int resolutionDivisor) :
 	engine(engine),
 
 	numHemisphereSamples(numSamples),
@@ -34,14 +33,15 @@ JFF::PostProcessFXSSAO::PostProcessFXSSAO(
 	numBlurSteps(numBlurSteps),
 	intensity(intensity),
 
+	resolutionDivisor(std::max(resolutionDivisor, 1u)),
+	bufferWidth(0),
+	bufferHeight(0),
+
 	SSAOMaterial(),
-	gaussianBlurHorizontalMaterial(),
-	gaussianBlurVerticalMaterial(),
-	colorCopyMaterial(),
+	bilateralBlurMaterial(),
+	bilateralUpsampleMaterial(),
 
-	SSAO_FBO(),
-	gaussianBlurHorizontalFBO(),
-	gaussianBlurVerticalFBO()
+	bufferParams()
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor PostProcessFXSSAO")
 
@@ -64,40 +64,33 @@ JFF::PostProcessFXSSAO::PostProcessFXSSAO(
 	SSAOMaterial->addTexture(randomTangentsTex);
 	SSAOMaterial->cook();
 
-	gaussianBlurHorizontalMaterial = createMaterial(engine, "Gaussian blur horizontal material");
-	gaussianBlurHorizontalMaterial->setDomain(Material::MaterialDomain::GAUSSIAN_BLUR_HORIZONTAL);
-	gaussianBlurHorizontalMaterial->cook();
-
-	gaussianBlurVerticalMaterial = createMaterial(engine, "Gaussian blur vertical material");
-	gaussianBlurVerticalMaterial->setDomain(Material::MaterialDomain::GAUSSIAN_BLUR_VERTICAL);
-	gaussianBlurVerticalMaterial->cook();
+	bilateralBlurMaterial = createMaterial(engine, "SSAO bilateral blur material");
+	bilateralBlurMaterial->setDomain(Material::MaterialDomain::SSAO_BILATERAL_BLUR);
+	bilateralBlurMaterial->cook();
 
-	colorCopyMaterial = createMaterial(engine, "Color copy material");
-	colorCopyMaterial->setDomain(Material::MaterialDomain::COLOR_COPY);
-	colorCopyMaterial->cook();
+	bilateralUpsampleMaterial = createMaterial(engine, "SSAO bilateral upsample material");
+	bilateralUpsampleMaterial->setDomain(Material::MaterialDomain::SSAO_BILATERAL_UPSAMPLE);
+	bilateralUpsampleMaterial->cook();
 
 	// ------------------------------ BUILD FRAMEBUFFER PARAMS ------------------------------ //
 
+	getBufferSize(bufferWidth, bufferHeight, this->bufferWidth, this->bufferHeight);
+
 	Framebuffer::AttachmentData textureData;
-	textureData.width				= bufferWidth;
-	textureData.height				= bufferHeight;
+	textureData.width				= this->bufferWidth;
+	textureData.height				= this->bufferHeight;
 	textureData.renderBuffer		= false;
 	textureData.texType				= Framebuffer::TextureType::TEXTURE_2D;
 	textureData.wrapMode			= { Framebuffer::Wrap::CLAMP_TO_EDGE, Framebuffer::Wrap::CLAMP_TO_EDGE, Framebuffer::Wrap::CLAMP_TO_EDGE };
 	textureData.filterMode			= { Framebuffer::MinificationFilter::NEAREST, Framebuffer::MagnificationFilter::NEAREST };
 	textureData.HDR					= false;
-	textureData.numColorChannels	= 4; // TODO: In SSAO, this could be 1, but the output in shaders should be changed from vec4 to float
+	textureData.numColorChannels	= 1; // Occlusion only (R8)
 	textureData.mipmapLevel			= 0;
+	textureData.mipmaps				= false;
 
-	Framebuffer::Params params;
-	params.samplesPerPixel = 0u;
-	params.attachments[Framebuffer::AttachmentPoint::COLOR_0] = textureData; // Final color channel
-
-	// ------------------------------ BUILD FBOs ------------------------------ //
-
-	SSAO_FBO					= createFramebuffer(params);
-	gaussianBlurHorizontalFBO	= createFramebuffer(params);
-	gaussianBlurVerticalFBO		= createFramebuffer(params);
+	// Framebuffers are only needed while this FX executes, so they're taken from the render target pool
+	bufferParams.samplesPerPixel = 0u;
+	bufferParams.attachments[Framebuffer::AttachmentPoint::COLOR_0] = textureData; // Final color channel
 }
 
 JFF::PostProcessFXSSAO::~PostProcessFXSSAO()
@@ -105,13 +98,8 @@ JFF::PostProcessFXSSAO::~PostProcessFXSSAO()
 	JFF_LOG_INFO_LOW_PRIORITY("Dtor PostProcessFXSSAO")
 
 	SSAOMaterial->destroy();
-	gaussianBlurHorizontalMaterial->destroy();
-	gaussianBlurVerticalMaterial->destroy();
-	colorCopyMaterial->destroy();
-
-	SSAO_FBO->destroy();
-	gaussianBlurHorizontalFBO->destroy();
-	gaussianBlurVerticalFBO->destroy();
+	bilateralBlurMaterial->destroy();
+	bilateralUpsampleMaterial->destroy();
 }
 
 void JFF::PostProcessFXSSAO::execute(
@@ -122,6 +110,13 @@ void JFF::PostProcessFXSSAO::execute(
 	auto renderer = engine->renderer.lock();
 	auto mesh = planeMesh.lock();
 	auto inputFBO = ppFBO.lock();
+	auto renderTargetPool = renderer->getRenderTargetPool().lock();
+
+	auto SSAO_FBO = renderTargetPool->acquire(bufferParams);
+	auto blurHorizontalFBO = renderTargetPool->acquire(bufferParams);
+
+	// SSAO and blur passes write to low resolution buffers
+	renderer->setViewport(0, 0, bufferWidth, bufferHeight);
 
 	// Execute SSAO draw call
 	SSAO_FBO->enable();
@@ -133,31 +128,31 @@ void JFF::PostProcessFXSSAO::execute(
 	sendHemisphereSamples();
 	mesh->draw();
 
-	// Blur the result of SSAO
+	// Blur the result of SSAO without mixing the occlusion of different surfaces. ppFBO2 has the G-buffer positions
+	bilateralBlurMaterial->use();
 	for (unsigned int i = 0; i < numBlurSteps; ++i)
 	{
-		// Horizontal gaussian blur
-		gaussianBlurHorizontalFBO->enable();
-		gaussianBlurHorizontalMaterial->use();
-		gaussianBlurHorizontalMaterial->sendPostProcessingTextures(i == 0 ? SSAO_FBO : gaussianBlurVerticalFBO);
-		gaussianBlurHorizontalMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), (float)0);
+		// Horizontal blur
+		blurHorizontalFBO->enable();
+		bilateralBlurMaterial->sendPostProcessingTextures(SSAO_FBO, ppFBO2);
+		bilateralBlurMaterial->sendVec2(ShaderCodeBuilder::BLUR_DIRECTION.c_str(), Vec2(1.0f, 0.0f));
 		mesh->draw();
 
-		// Vertical gaussian blur
-		gaussianBlurVerticalFBO->enable();
-		gaussianBlurVerticalMaterial->use();
-		gaussianBlurVerticalMaterial->sendPostProcessingTextures(gaussianBlurHorizontalFBO);
-		gaussianBlurVerticalMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), (float)0);
+		// Vertical blur. SSAO FBO has the result
+		SSAO_FBO->enable();
+		bilateralBlurMaterial->sendPostProcessingTextures(blurHorizontalFBO, ppFBO2);
+		bilateralBlurMaterial->sendVec2(ShaderCodeBuilder::BLUR_DIRECTION.c_str(), Vec2(0.0f, 1.0f));
 		mesh->draw();
 	}
 
-	// Combine SSAO result with incoming framebuffer color
-	inputFBO->enable(/* clearBuffers = */ false);
-	colorCopyMaterial->use();
+	renderTargetPool->release(blurHorizontalFBO);
 
-	colorCopyMaterial->sendPostProcessingTextures(gaussianBlurVerticalFBO); // Vertical FBO has the SSAO result
-	colorCopyMaterial->sendFloat(ShaderCodeBuilder::MIPMAP_LEVEL.c_str(), 0.0f);
-	colorCopyMaterial->sendFloat(ShaderCodeBuilder::INTENSITY.c_str(), 1.0f);
+	renderer->restoreViewport(); // Restore the original viewport size
+
+	// Upsample SSAO result and combine it with incoming framebuffer color
+	inputFBO->enable(/* clearBuffers = */ false);
+	bilateralUpsampleMaterial->use();
+	bilateralUpsampleMaterial->sendPostProcessingTextures(SSAO_FBO, ppFBO2);
 
 	renderer->disableDepthTest();
 	renderer->enableBlending(Renderer::BlendOp::MULTIPLY);
@@ -168,13 +163,17 @@ void JFF::PostProcessFXSSAO::execute(
 	// An explicit call to disable FBO is important here because ppFBO could be a multisample buffer and it must 'resolve' 
 	// to an auxiliary FBO (Check Framebuffer class)
 	inputFBO->disable();
+
+	renderTargetPool->release(SSAO_FBO);
 }
 
 void JFF::PostProcessFXSSAO::updateFramebufferSize(int width, int height)
 {
-	SSAO_FBO->setSize(width, height);
-	gaussianBlurHorizontalFBO->setSize(width, height);
-	gaussianBlurVerticalFBO->setSize(width, height);
+	getBufferSize(width, height, bufferWidth, bufferHeight);
+
+	// Next executions request framebuffers of the new size. The pool destroys the old ones when they stop being used
+	bufferParams.attachments[Framebuffer::AttachmentPoint::COLOR_0].width = bufferWidth;
+	bufferParams.attachments[Framebuffer::AttachmentPoint::COLOR_0].height = bufferHeight;
 }
 
 inline std::shared_ptr<JFF::Texture> JFF::PostProcessFXSSAO::generateRandomTangentsTexture() const
@@ -224,8 +223,6 @@ inline void JFF::PostProcessFXSSAO::generateHemisphereSamples()
 {
 	// NOTE: Samples are generated in tangent space. In shader, this sample is multiplied by TBN matrix to transform it to world space
 
-	auto math = engine->math.lock();
-
 	std::uniform_real_distribution<float> randomFloat(0.0f, 1.0f); // Generates a random float in range [0,1]
 	std::default_random_engine generator; // This is the algorithm used to generate random numbers. The defualt one is implementation-defined
 
@@ -239,18 +236,18 @@ inline void JFF::PostProcessFXSSAO::generateHemisphereSamples()
 		);
 
 		// Normalize it to keep the sample inside the hemisphere
-		sample = math->normalize(sample);
+		sample = JFF::normalize(sample);
 
 		// Previous normalize() call put all samples on the hemisphere surface. Next line re-randomize the distance to the center
 		sample *= randomFloat(generator);
 
 		/* 
-		* Currently, all samples are randomly distributed in the sample kernel, but wed rather place a
+		* Currently, all samples are randomly distributed in the sample kernel, but we’d rather place a
 		* larger weight on occlusions close to the actual fragment. We want to distribute more kernel samples
 		* closer to the origin. We can do this with an accelerating interpolation function:
 		*/
 		float scale = (float)i / numHemisphereSamples;
-		scale = math->lerp(0.1f, 1.0f, scale * scale);
+		scale = JFF::lerp(0.1f, 1.0f, scale * scale);
 		sample *= scale;
 
 		// Add it to sample list
@@ -260,13 +257,15 @@ inline void JFF::PostProcessFXSSAO::generateHemisphereSamples()
 
 inline void JFF::PostProcessFXSSAO::sendHemisphereSamples()
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	if (hemisphereSamplesTangentSpace.empty())
+		return;
 
-	for (unsigned int i = 0; i < numHemisphereSamples; ++i)
-	{
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::HEMISPHERE_SAMPLES << "[" << i << "]";
-		SSAOMaterial->sendVec3(ss.str().c_str(), hemisphereSamplesTangentSpace[i]);
-	}
+	// The whole array of samples is uploaded at once
+	SSAOMaterial->sendVec3Array(ShaderCodeBuilder::HEMISPHERE_SAMPLES.c_str(), hemisphereSamplesTangentSpace.data(), (int)numHemisphereSamples);
 }
+
+inline void JFF::PostProcessFXSSAO::getBufferSize(int width, int height, int& outWidth, int& outHeight) const
+{
+	outWidth = std::max(width / (int)resolutionDivisor, 1);
+	outHeight = std::max(height / (int)resolutionDivisor, 1);
+}
\ No newline at end of file
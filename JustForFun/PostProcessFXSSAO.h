@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -23,7 +23,7 @@ namespace JFF
 		// Ctor & Dtor
 		PostProcessFXSSAO(Engine* const engine, int bufferWidth, int bufferHeight, 
 			unsigned int numSamples = 64, float sampleHemisphereRadius = 0.5f, 
-			unsigned int numBlurSteps = 4, float intensity = 1.0f);
+			unsigned int numBlurSteps = 4, float intensity = 1.0f, unsigned int resolutionDivisor = 2);
 		virtual ~PostProcessFXSSAO();
 
 		// Copy ctor and copy assignment
@@ -49,6 +49,7 @@ namespace JFF
 		inline std::shared_ptr<Texture> generateRandomTangentsTexture() const;
 		inline void generateHemisphereSamples();
 		inline void sendHemisphereSamples();
+		inline void getBufferSize(int width, int height, int& outWidth, int& outHeight) const;
 
 	protected:
 		Engine* engine;
@@ -59,16 +60,17 @@ namespace JFF
 		unsigned int numBlurSteps; // Each pass is a horizontal followed by a vertical blur
 		float intensity;
 
+		// SSAO and blur passes run at a fraction of the screen resolution. The result is upsampled when it's combined with the screen
+		unsigned int resolutionDivisor;
+		int bufferWidth, bufferHeight;
+
 		// Materials
 		std::shared_ptr<Material> SSAOMaterial;
-		std::shared_ptr<Material> gaussianBlurHorizontalMaterial;
-		std::shared_ptr<Material> gaussianBlurVerticalMaterial;
-		std::shared_ptr<Material> colorCopyMaterial;
-
-		// Framebuffers
-		std::shared_ptr<Framebuffer> SSAO_FBO;
-		std::shared_ptr<Framebuffer> gaussianBlurHorizontalFBO;
-		std::shared_ptr<Framebuffer> gaussianBlurVerticalFBO;
+		std::shared_ptr<Material> bilateralBlurMaterial;
+		std::shared_ptr<Material> bilateralUpsampleMaterial;
+
+		// Params of the single channel framebuffers taken from the render target pool on each execution
+		Framebuffer::Params bufferParams;
 
 		// Hemisphere samples used to check if a fragment is occluded
 		std::vector<Vec3> hemisphereSamplesTangentSpace;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -17,7 +17,6 @@
 #include "PostProcessFXSSAO.h"
 
 #include "FileSystemSetup.h"
-#include <regex>
 
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name, const char* assetFilePath);
 
@@ -33,6 +32,7 @@ JFF::PostProcessRenderComponent::PostProcessRenderComponent(
 
 	materialAssetFilepath(materialAssetFilepath),
 	FBOSizeCallbackHandler(0ull),
+	renderSizeCallbackHandler(0ull),
 
 	mesh(),
 
@@ -55,6 +55,7 @@ JFF::PostProcessRenderComponent::PostProcessRenderComponent(
 
 	materialAssetFilepath(),
 	FBOSizeCallbackHandler(0ull),
+	renderSizeCallbackHandler(0ull),
 	
 	mesh(),
 
@@ -78,7 +79,7 @@ void JFF::PostProcessRenderComponent::onStart()
 	// Load material from file if it's null
 	if (!material)
 	{
-		std::string assetFullPath = std::regex_replace(materialAssetFilepath, std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+		std::string assetFullPath = toPlatformPath(materialAssetFilepath);
 		material = createMaterial(gameObject->engine, materialAssetFilepath.c_str(), assetFullPath.c_str());
 	}
 
@@ -96,24 +97,30 @@ void JFF::PostProcessRenderComponent::onStart()
 	context->getFramebufferSizeInPixels(fboWidth, fboHeight);
 	fbo = createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_POST_PROCESS, fboWidth, fboHeight);
 
-	// Build custom FXs
-	buildCustomFX(fboWidth, fboHeight);
+	// Build custom FXs. They use the render size, which may be lower than the screen size with dynamic resolution
+	auto renderer = gameObject->engine->renderer.lock();
+	int renderWidth, renderHeight;
+	renderer->getRenderSize(renderWidth, renderHeight);
+	buildCustomFX(renderWidth, renderHeight);
 
-	// Ensure its width and height adapts to window size changes
+	// Ensure its width and height adapts to window size changes. Post-process upscales the result of 3D passes to this size
 	FBOSizeCallbackHandler = context->addOnFramebufferSizeChangedListener([this](int width, int height)
 		{
 			if (width == 0 || height == 0) // Ignore request to invalid sizes
 				return;
 
 			fbo->setSize(width, height);
+		});
 
-			// Update custom FX buffers size
+	// Update custom FX buffers size when window size or resolution scale change
+	renderSizeCallbackHandler = renderer->addOnRenderSizeChangedListener([this](int width, int height)
+		{
 			std::for_each(fx.begin(), fx.end(), [width, height](auto& ppFX) { ppFX->updateFramebufferSize(width, height); });
 			std::for_each(fxPreLighting.begin(), fxPreLighting.end(), [width, height](auto& ppFX) { ppFX->updateFramebufferSize(width, height); });
 		});
 
 	// Send this RenderComponent to Renderer
-	gameObject->engine->renderer.lock()->addRenderable(this);
+	renderer->addRenderable(this);
 }
 
 void JFF::PostProcessRenderComponent::onDestroy() noexcept
@@ -123,6 +130,7 @@ void JFF::PostProcessRenderComponent::onDestroy() noexcept
 
 	// Unregister from Context's framebuffer change callback
 	gameObject->engine->context.lock()->removeOnFramebufferSizeChangedListener(FBOSizeCallbackHandler);
+	gameObject->engine->renderer.lock()->removeOnRenderSizeChangedListener(renderSizeCallbackHandler);
 
 	// Destroy the post processing FBO
 	fbo->destroy();
@@ -155,6 +163,11 @@ JFF::Material::DebugDisplay JFF::PostProcessRenderComponent::getDebugDisplay() c
 	return material->getDebugDisplay();
 }
 
+bool JFF::PostProcessRenderComponent::isMaterialReady()
+{
+	return material->isReady();
+}
+
 void JFF::PostProcessRenderComponent::useMaterial()
 {
 	material->use();
@@ -281,7 +294,8 @@ inline void JFF::PostProcessRenderComponent::buildCustomFX(int bufferWidth, int
 		auto SSAOFX = std::make_shared<PostProcessFXSSAO>(gameObject->engine, 
 			bufferWidth, bufferHeight,
 			postProcessParams.SSAONumSamples, postProcessParams.SSAOSampleHemisphereRadius, 
-			postProcessParams.SSAONumBlurSteps, postProcessParams.SSAOIntensity);
+			postProcessParams.SSAONumBlurSteps, postProcessParams.SSAOIntensity,
+			postProcessParams.SSAOResolutionDivisor);
 
 		fxPreLighting.push_back(SSAOFX);
 	}
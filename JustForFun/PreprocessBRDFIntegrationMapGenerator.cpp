@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,8 +13,6 @@
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
 
-#include <regex>
-
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name);
 extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(const JFF::Framebuffer::Params& params);
 extern std::shared_ptr<JFF::MeshObject> createMeshObject(JFF::Engine* const engine, const JFF::MeshObject::BasicMesh& predefinedShape);
@@ -48,6 +46,7 @@ JFF::PreprocessBRDFIntegrationMapGenerator::PreprocessBRDFIntegrationMapGenerato
 	textureData.HDR					= true;
 	textureData.numColorChannels	= 4;
 	textureData.mipmapLevel			= 0;
+	textureData.mipmaps				= false;
 
 	Framebuffer::Params params;
 	params.samplesPerPixel = 0u;
@@ -3,17 +3,17 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "PreprocessIrradianceGenerator.h"
+#include "MathFunctions.h"
 
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
-
-#include <regex>
+#include "FileSystemSetup.h"
 
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name);
 extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(const JFF::Framebuffer::Params& params);
@@ -60,6 +60,7 @@ JFF::PreprocessIrradianceGenerator::PreprocessIrradianceGenerator(
 	textureData.HDR					= true;
 	textureData.numColorChannels	= 4;
 	textureData.mipmapLevel			= 0;
+	textureData.mipmaps				= false;
 
 	Framebuffer::Params params;
 	params.samplesPerPixel = 0u;
@@ -82,22 +83,21 @@ JFF::PreprocessIrradianceGenerator::PreprocessIrradianceGenerator(
 	* For more info, check Cubemap class
 	*/
 
-	auto math = engine->math.lock();
 	Vec3 worldCenter; // Center of the world to lookAt inside a cubemap
 
-	viewMatrixRight		= math->lookAt(worldCenter, Vec3::RIGHT,	Vec3::DOWN);
-	viewMatrixLeft		= math->lookAt(worldCenter, Vec3::LEFT,		Vec3::DOWN);
-	viewMatrixTop		= math->lookAt(worldCenter, Vec3::UP,		Vec3::BACKWARD);
-	viewMatrixBottom	= math->lookAt(worldCenter, Vec3::DOWN,		Vec3::FORWARD);
-	viewMatrixFront		= math->lookAt(worldCenter, Vec3::FORWARD,	Vec3::DOWN);
-	viewMatrixBack		= math->lookAt(worldCenter, Vec3::BACKWARD, Vec3::DOWN);
+	viewMatrixRight		= JFF::lookAt<4>(worldCenter, Vec3::RIGHT,	Vec3::DOWN);
+	viewMatrixLeft		= JFF::lookAt<4>(worldCenter, Vec3::LEFT,		Vec3::DOWN);
+	viewMatrixTop		= JFF::lookAt<4>(worldCenter, Vec3::UP,		Vec3::BACKWARD);
+	viewMatrixBottom	= JFF::lookAt<4>(worldCenter, Vec3::DOWN,		Vec3::FORWARD);
+	viewMatrixFront		= JFF::lookAt<4>(worldCenter, Vec3::FORWARD,	Vec3::DOWN);
+	viewMatrixBack		= JFF::lookAt<4>(worldCenter, Vec3::BACKWARD, Vec3::DOWN);
 
-	float fovyRad	= math->radians(90.0f); // 90 degrees takes exactly one face of the cubemap
+	float fovyRad	= JFF::radians(90.0f); // 90 degrees takes exactly one face of the cubemap
 	float aspect	= 1.0f; // Aspect ratio: cubemapWidth / cubemapWidth
 	float zNear		= 0.1f;
 	float zFar		= 1.0f;
 
-	projectionMatrix = math->perspective(fovyRad, aspect, zNear, zFar);
+	projectionMatrix = JFF::perspective<4>(fovyRad, aspect, zNear, zFar);
 }
 
 JFF::PreprocessIrradianceGenerator::~PreprocessIrradianceGenerator()
@@ -156,7 +156,7 @@ void JFF::PreprocessIrradianceGenerator::execute()
 		renderer->restoreFaceCulling();
 
 		// Write to file
-		std::string path = std::regex_replace(cubemapFacePaths[i], std::regex(R"raw(\..*)raw"), irradianceAppendix);
+		std::string path = replaceFromFirstDot(cubemapFacePaths[i], irradianceAppendix);
 		fbo->writeToFile(path.c_str());
 	}
 
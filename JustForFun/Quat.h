@@ -0,0 +1,76 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Mat.h" // Includes Vec.h inside
+
+namespace JFF
+{
+	/*
+	* Rotation quaternion. It only stores its 4 components, so it's trivially copyable and can be stored in
+	* contiguous arrays and sent to GPU buffers as is
+	*/
+	class Quat final
+	{
+	public:
+		// Ctor: identity rotation
+		Quat() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+
+		// Ctor. Note that w (real part) goes first
+		Quat(float w, float x, float y, float z) : x(x), y(y), z(z), w(w) {}
+
+		// Quaternion raw data (x, y, z, w)
+		const float* operator*() const { return &x; }
+
+	public:
+		float x;
+		float y;
+		float z;
+		float w;
+	};
+
+	// Composes two rotations. The result applies q2 first and then q1, like matrices
+	Quat operator*(const Quat& q1, const Quat& q2);
+
+	// Rotates a vector
+	Vec3 operator*(const Quat& q, const Vec3& v);
+
+	bool operator==(const Quat& q1, const Quat& q2);
+	bool operator!=(const Quat& q1, const Quat& q2);
+
+	float dot(const Quat& q1, const Quat& q2);
+	float length(const Quat& q);
+	Quat normalize(const Quat& q);
+	Quat conjugate(const Quat& q);
+	Quat inverse(const Quat& q);
+
+	// Spherical interpolation between two rotations, following the shortest path
+	Quat slerp(const Quat& q1, const Quat& q2, float a);
+
+	// Rotation of angleRadians around axisNormalized
+	Quat angleAxis(float angleRadians, const Vec3& axisNormalized);
+
+	/*
+	* Rotation from Euler angles in radians (pitch: x, yaw: y, roll: z), applied in TransformComponent order:
+	* roll around FORWARD first, then pitch around RIGHT and yaw around UP last
+	*/
+	Quat eulerToQuat(const Vec3& eulerRadians);
+
+	// Inverse of eulerToQuat(). Pitch is in range [-PI/2, PI/2]
+	Vec3 quatToEuler(const Quat& q);
+
+	// Rotation matrices
+	Mat3 toMat3(const Quat& q);
+	Mat4 toMat4(const Quat& q);
+}
+
+// Implementation dependant inline definitions
+#include JFF_QUAT_IMPL_DEPENDENT_INLINES
\ No newline at end of file
@@ -0,0 +1,117 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "Quat.h"
+
+#include "GLM/gtc/quaternion.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace JFF
+{
+	namespace detail
+	{
+		inline glm::quat toGLM(const Quat& q) { return glm::quat(q.w, q.x, q.y, q.z); }
+		inline Quat fromGLM(const glm::quat& q) { return Quat(q.w, q.x, q.y, q.z); }
+	}
+}
+
+#pragma region Global operations
+inline JFF::Quat JFF::operator*(const Quat& q1, const Quat& q2)
+{
+	return detail::fromGLM(detail::toGLM(q1) * detail::toGLM(q2));
+}
+
+inline JFF::Vec3 JFF::operator*(const Quat& q, const Vec3& v)
+{
+	return detail::toGLM(q) * glm::vec3(v.x, v.y, v.z);
+}
+
+inline bool JFF::operator==(const Quat& q1, const Quat& q2)
+{
+	return q1.x == q2.x && q1.y == q2.y && q1.z == q2.z && q1.w == q2.w;
+}
+
+inline bool JFF::operator!=(const Quat& q1, const Quat& q2)
+{
+	return !(q1 == q2);
+}
+
+inline float JFF::dot(const Quat& q1, const Quat& q2)
+{
+	return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+inline float JFF::length(const Quat& q)
+{
+	return std::sqrt(dot(q, q));
+}
+
+inline JFF::Quat JFF::normalize(const Quat& q)
+{
+	return detail::fromGLM(glm::normalize(detail::toGLM(q)));
+}
+
+inline JFF::Quat JFF::conjugate(const Quat& q)
+{
+	return Quat(q.w, -q.x, -q.y, -q.z);
+}
+
+inline JFF::Quat JFF::inverse(const Quat& q)
+{
+	return detail::fromGLM(glm::inverse(detail::toGLM(q)));
+}
+
+inline JFF::Quat JFF::slerp(const Quat& q1, const Quat& q2, float a)
+{
+	return detail::fromGLM(glm::slerp(detail::toGLM(q1), detail::toGLM(q2), a));
+}
+
+inline JFF::Quat JFF::angleAxis(float angleRadians, const Vec3& axisNormalized)
+{
+	return detail::fromGLM(glm::angleAxis(angleRadians, glm::vec3(axisNormalized.x, axisNormalized.y, axisNormalized.z)));
+}
+
+inline JFF::Quat JFF::eulerToQuat(const Vec3& eulerRadians)
+{
+	// Same order as TransformComponent rotation matrices: yaw * pitch * roll. Roll turns around FORWARD (-Z)
+	return angleAxis(eulerRadians.yaw, Vec3::UP) * angleAxis(eulerRadians.pitch, Vec3::RIGHT) * angleAxis(eulerRadians.roll, Vec3::FORWARD);
+}
+
+inline JFF::Vec3 JFF::quatToEuler(const Quat& q)
+{
+	/*
+	* Extracted from the rotation matrix M = Ry(yaw) * Rx(pitch) * Rz(-roll), where (row, column):
+	* M(1, 2) = -sin(pitch) | M(0, 2) / M(2, 2) = tan(yaw) | M(1, 0) / M(1, 1) = tan(-roll)
+	*/
+	float m02 = 2.0f * (q.x * q.z + q.w * q.y);
+	float m22 = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+	float m12 = 2.0f * (q.y * q.z - q.w * q.x);
+	float m10 = 2.0f * (q.x * q.y + q.w * q.z);
+	float m11 = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+
+	float pitch = std::asin(-std::max(-1.0f, std::min(m12, 1.0f)));
+	float yaw = std::atan2(m02, m22);
+	float roll = -std::atan2(m10, m11);
+	return Vec3(pitch, yaw, roll);
+}
+
+inline JFF::Mat3 JFF::toMat3(const Quat& q)
+{
+	return glm::mat3_cast(detail::toGLM(q));
+}
+
+inline JFF::Mat4 JFF::toMat4(const Quat& q)
+{
+	return glm::mat4_cast(detail::toGLM(q));
+}
+
+#pragma endregion
\ No newline at end of file
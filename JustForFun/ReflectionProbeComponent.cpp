@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -19,8 +19,6 @@
 #include "PreprocessPreFilteredEnvironmentMapGenerator.h"
 #include "PreprocessBRDFIntegrationMapGenerator.h"
 
-#include <regex>
-
 extern std::shared_ptr<JFF::Cubemap> createCubemap(JFF::Engine* const engine, const char* name, const char* assetFilePath);
 extern std::shared_ptr<JFF::Cubemap> createCubemap(JFF::Engine* const engine, const JFF::Cubemap::Params& params);
 extern std::shared_ptr<JFF::Texture> createTexture(JFF::Engine* const engine, const JFF::Texture::Params& params);
@@ -51,7 +49,7 @@ JFF::ReflectionProbeComponent::~ReflectionProbeComponent()
 void JFF::ReflectionProbeComponent::onStart()
 {
 	// Load cubemap from asset 
-	std::string assetFullPath = std::regex_replace(assetFilepath, std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+	std::string assetFullPath = toPlatformPath(assetFilepath);
 	envMap = createCubemap(gameObject->engine, "Reflection probe cubemap", assetFullPath.c_str());
 
 	// TODO: Don't generate next maps if they are already generated
@@ -78,11 +76,25 @@ void JFF::ReflectionProbeComponent::onDisable() noexcept
 
 void JFF::ReflectionProbeComponent::onDestroy() noexcept
 {
-	// Destroy cubemaps
-	envMap->destroy();
-	irradianceMap->destroy();
-	preFilteredMap->destroy();
-	BRDFIntegrationMap->destroy();
+	// Cubemaps are cached and may be shared with other probes. Drop our references and let the cache free them if unused
+	std::string envMapCacheName				= envMap->getCacheName();
+	std::string irradianceMapCacheName		= irradianceMap->getCacheName();
+	std::string preFilteredMapCacheName		= preFilteredMap->getCacheName();
+	std::string BRDFIntegrationMapCacheName = BRDFIntegrationMap->getCacheName();
+
+	envMap.reset();
+	irradianceMap.reset();
+	preFilteredMap.reset();
+	BRDFIntegrationMap.reset();
+
+	auto cache = gameObject->engine->cache.lock();
+	if (cache)
+	{
+		cache->releaseCacheItem(envMapCacheName);
+		cache->releaseCacheItem(irradianceMapCacheName);
+		cache->releaseCacheItem(preFilteredMapCacheName);
+		cache->releaseCacheItem(BRDFIntegrationMapCacheName);
+	}
 }
 
 void JFF::ReflectionProbeComponent::sendEnvironmentMap(RenderComponent* const renderComponent)
@@ -104,12 +116,12 @@ inline void JFF::ReflectionProbeComponent::generateIrradianceMap()
 	std::string irradianceAppendix = "_irradiance.hdr";
 
 	Cubemap::ImageInfo envMapInfo = envMap->getImageInfo();
-	std::string imgRight	= std::regex_replace(envMapInfo.imageRightFilename,  std::regex(R"raw(\..*)raw"), irradianceAppendix);
-	std::string imgLeft		= std::regex_replace(envMapInfo.imageLeftFilename,	 std::regex(R"raw(\..*)raw"), irradianceAppendix);
-	std::string imgTop		= std::regex_replace(envMapInfo.imageTopFilename,	 std::regex(R"raw(\..*)raw"), irradianceAppendix);
-	std::string imgBottom	= std::regex_replace(envMapInfo.imageBottomFilename, std::regex(R"raw(\..*)raw"), irradianceAppendix);
-	std::string imgBack		= std::regex_replace(envMapInfo.imageBackFilename,	 std::regex(R"raw(\..*)raw"), irradianceAppendix);
-	std::string imgFront	= std::regex_replace(envMapInfo.imageFrontFilename,  std::regex(R"raw(\..*)raw"), irradianceAppendix);
+	std::string imgRight	= replaceFromFirstDot(envMapInfo.imageRightFilename,  irradianceAppendix);
+	std::string imgLeft		= replaceFromFirstDot(envMapInfo.imageLeftFilename,	 irradianceAppendix);
+	std::string imgTop		= replaceFromFirstDot(envMapInfo.imageTopFilename,	 irradianceAppendix);
+	std::string imgBottom	= replaceFromFirstDot(envMapInfo.imageBottomFilename, irradianceAppendix);
+	std::string imgBack		= replaceFromFirstDot(envMapInfo.imageBackFilename,	 irradianceAppendix);
+	std::string imgFront	= replaceFromFirstDot(envMapInfo.imageFrontFilename,  irradianceAppendix);
 
 	std::string generatedFolder = "Generated";
 
@@ -156,12 +168,12 @@ inline void JFF::ReflectionProbeComponent::generatePreFilteredEnvironmentMap()
 	std::string preFilteredAppendix = "_preFilteredEnvMap.hdr";
 
 	Cubemap::ImageInfo envMapInfo = envMap->getImageInfo();
-	std::string imgRight	= std::regex_replace(envMapInfo.imageRightFilename,  std::regex(R"raw(\..*)raw"), preFilteredAppendix);
-	std::string imgLeft		= std::regex_replace(envMapInfo.imageLeftFilename,	 std::regex(R"raw(\..*)raw"), preFilteredAppendix);
-	std::string imgTop		= std::regex_replace(envMapInfo.imageTopFilename,	 std::regex(R"raw(\..*)raw"), preFilteredAppendix);
-	std::string imgBottom	= std::regex_replace(envMapInfo.imageBottomFilename, std::regex(R"raw(\..*)raw"), preFilteredAppendix);
-	std::string imgBack		= std::regex_replace(envMapInfo.imageBackFilename,	 std::regex(R"raw(\..*)raw"), preFilteredAppendix);
-	std::string imgFront	= std::regex_replace(envMapInfo.imageFrontFilename,  std::regex(R"raw(\..*)raw"), preFilteredAppendix);
+	std::string imgRight	= replaceFromFirstDot(envMapInfo.imageRightFilename,  preFilteredAppendix);
+	std::string imgLeft		= replaceFromFirstDot(envMapInfo.imageLeftFilename,	 preFilteredAppendix);
+	std::string imgTop		= replaceFromFirstDot(envMapInfo.imageTopFilename,	 preFilteredAppendix);
+	std::string imgBottom	= replaceFromFirstDot(envMapInfo.imageBottomFilename, preFilteredAppendix);
+	std::string imgBack		= replaceFromFirstDot(envMapInfo.imageBackFilename,	 preFilteredAppendix);
+	std::string imgFront	= replaceFromFirstDot(envMapInfo.imageFrontFilename,  preFilteredAppendix);
 
 	std::string generatedFolder = "Generated";
 
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -14,6 +14,7 @@
 #include "Material.h"
 #include "Mat.h"
 #include "Cubemap.h"
+#include "Spatial.h"
 
 namespace JFF
 {
@@ -22,7 +23,11 @@ namespace JFF
 	public:
 		// Ctor & Dtor
 		RenderComponent(GameObject* const gameObject, const char* name, bool initiallyEnabled) :
-			Component(gameObject, name, initiallyEnabled)
+			Component(gameObject, name, initiallyEnabled),
+			spatialProxy(Spatial::INVALID_PROXY),
+			visibleFrame(0ull),
+			shadowCastMark(0ull),
+			staticShadowCaster(false)
 		{}
 		virtual ~RenderComponent() {}
 
@@ -48,6 +53,9 @@ namespace JFF
 		// Gets debug display option if applicable
 		virtual Material::DebugDisplay getDebugDisplay() const = 0;
 
+		// Returns true if the material's shaders finished compiling. Render passes skip this component until then
+		virtual bool isMaterialReady() = 0;
+
 		// Enables the internal shader and its associated textures
 		virtual void useMaterial() = 0;
 
@@ -93,10 +101,10 @@ namespace JFF
 			const std::shared_ptr<Texture>& BRDFIntegrationMap = nullptr) = 0;
 
 		/*
-		* Send a directional light's shadowmap texture to this material located at given index.
+		* Send the shadow atlas, which holds the shadowmap of the directional light located at given index, to this material.
 		* Index must be in range [0, Renderer::getForwardShadingMaxDirectionalLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendDirLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowMapFBO = std::weak_ptr<Framebuffer>()) = 0;
 
@@ -109,10 +117,10 @@ namespace JFF
 		virtual void sendPointLightShadowCubemap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowCubemapFBO = std::weak_ptr<Framebuffer>()) = 0;
 
 		/*
-		* Send a spot light's shadowmap texture to this material located at given index.
+		* Send the shadow atlas, which holds the shadowmap of the spot light located at given index, to this material.
 		* Index must be in range [0, Renderer::getForwardShadingMaxSpotLights())
-		* If @shadowMapFBO is invalid, this function will send the default bind texture. This is important
-		* because all texture samplers in shader must be specified
+		* If @shadowMapFBO is invalid, only the sampler is specified. The bound atlas is kept because it's shared by all
+		* directional and spot lights
 		*/
 		virtual void sendSpotLightShadowMap(unsigned int index, const std::weak_ptr<Framebuffer>& shadowMapFBO = std::weak_ptr<Framebuffer>()) = 0;
 
@@ -124,5 +132,36 @@ namespace JFF
 		// Enables the GPU buffer where the vertex data of associated mesh is stored and extecute a draw call
 		virtual void draw() = 0;
 
+		// ----------------------------- VISIBILITY ----------------------------- //
+
+		// Gets the proxy that represents this RenderComponent in the Spatial subsystem. INVALID_PROXY if it has no bounds
+		unsigned int getSpatialProxy() const { return spatialProxy; }
+
+		// Called by the Renderer when the bounds of this RenderComponent are inside the camera frustum in given frame
+		void setVisibleFrame(unsigned long long int frame) { visibleFrame = frame; }
+
+		// Returns true if this RenderComponent is outside the camera frustum in given frame. Components without bounds are never culled
+		bool isCulled(unsigned long long int frame) const { return spatialProxy != Spatial::INVALID_PROXY && visibleFrame != frame; }
+
+		// ----------------------------- SHADOWS ----------------------------- //
+
+		/*
+		* Lights cache the shadows of static casters, so they are only rendered again when the light or some static caster moves.
+		* Mark as static the components that rarely move (e.g. level geometry). The rest are rendered every frame over the cache
+		*/
+		void setStaticShadowCaster(bool isStatic) { staticShadowCaster = isStatic; }
+		bool isStaticShadowCaster() const { return staticShadowCaster; }
+
+		// Called by the shadow cast render pass when the bounds of this RenderComponent overlap the volume of the light being rendered
+		void setShadowCastMark(unsigned long long int mark) { shadowCastMark = mark; }
+
+		// Returns true if this RenderComponent is outside the volume of the light marked with given mark. Components without bounds are never culled
+		bool isShadowCulled(unsigned long long int mark) const { return spatialProxy != Spatial::INVALID_PROXY && shadowCastMark != mark; }
+
+	protected:
+		unsigned int spatialProxy;
+		unsigned long long int visibleFrame;
+		unsigned long long int shadowCastMark;
+		bool staticShadowCaster;
 	};
 }
\ No newline at end of file
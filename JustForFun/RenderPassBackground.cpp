@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -98,6 +98,10 @@ inline void JFF::RenderPassBackground::renderPass()
 			if (!renderComponent->isEnabled())
 				return; // Technically, this is a 'continue' statement on a usual for loop
 
+			// If this component's shaders are still compiling, skip it until they are ready
+			if (!renderComponent->isMaterialReady())
+				return;
+
 			// Enable component material and bind all textures
 			renderComponent->useMaterial();
 
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -80,13 +80,22 @@ void JFF::RenderPassGeometryDeferred::removeEnvironmentMap(EnvironmentMapCompone
 inline void JFF::RenderPassGeometryDeferred::renderPass()
 {
 	auto renderer = engine->renderer.lock();
+	const unsigned long long int frame = renderer->getFrameCount();
 
-	std::for_each(renderables.begin(), renderables.end(), [this, &renderer](RenderComponent* renderComponent) 
+	std::for_each(renderables.begin(), renderables.end(), [this, &renderer, frame](RenderComponent* renderComponent) 
 		{
 			// If this component is not enabled, skip its rendering
 			if (!renderComponent->isEnabled())
 				return; // Technically, this is a 'continue' statement on a usual for loop
 
+			// If this component is outside the camera frustum, skip it
+			if (renderComponent->isCulled(frame))
+				return;
+
+			// If this component's shaders are still compiling, skip it until they are ready
+			if (!renderComponent->isMaterialReady())
+				return;
+
 			// Enable component material and bind all textures
 			renderComponent->useMaterial();
 
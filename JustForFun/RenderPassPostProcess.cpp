@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -43,6 +43,7 @@ void JFF::RenderPassPostProcess::execute()
 
 	// Execute normal post-process pass
 	renderable->enablePostProcessFramebuffer();							// Use the renderComponent's fbo
+	renderer->restoreScreenViewport();									// Its fbo has screen size. This upscales the result of 3D passes
 	renderable->useMaterial();											// Enable component material and bind all textures
 	renderable->sendPostProcessingTextures(renderer->getFramebuffer(), renderer->getGeometryFramebuffer()); // Use previous fbo's texture
 	// TODO: Deferred shading path: Send lights and environment maps
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -18,16 +18,37 @@
 #include "DirectionalLightComponent.h"
 #include "PointLightComponent.h"
 #include "SpotLightComponent.h"
+#include "MathFunctions.h"
+#include "SceneStorage.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const unsigned int JFF::RenderPassShadowCast::REGION_RESIZE_HOLD_FRAMES = 30u;
 
 JFF::RenderPassShadowCast::RenderPassShadowCast(Engine* const engine) : 
 	engine(engine),
 	renderables(),
+	casterStates(),
 
 	directionalLights(),
 	pointLights(),
-	spotLights()
+	spotLights(),
+
+	regionRequests(),
+	regionResizes(),
+
+	anyDynamicCaster(false),
+	anyUnculledDynamicCaster(false),
+
+	shadowCaches(),
+	shadowUpdates(),
+	dynamicCasters(),
+
+	shadowCastMark(0ull),
+	casterQueryResults(),
+	cubemapFaceFrustums()
 {
 	JFF_LOG_INFO("Ctor RenderPassShadowCast")
 }
@@ -48,10 +69,38 @@ void JFF::RenderPassShadowCast::execute()
 	// Render depth shadows in back face to correct "peter panning" artifact
 	renderer->faceCulling(Renderer::FaceCullOp::CULL_FRONT_FACES);
 
-	// Render shadows on each type of light
-	renderLights(directionalLights);
-	renderOmnidirectionalLights();
-	renderLights(spotLights);
+	// Check if cached shadows of static casters are still valid
+	updateStaticCasters();
+
+	// Directional and spot lights render into their region of the shadow atlas. Point lights render into their own shadow cubemap
+	assignShadowAtlasRegions();
+
+	// Only the most important shadow maps are updated each frame. The rest keep the shadows of their last update
+	gatherShadowUpdates();
+	scheduleShadowUpdates();
+
+	unsigned long long int frame = renderer->getFrameCount();
+	for (const ShadowUpdate& update : shadowUpdates)
+	{
+		if (!update.scheduled)
+			continue;
+
+		switch (update.lightType)
+		{
+		case ShadowLightType::DIRECTIONAL:
+			renderDirectionalLight(update);
+			break;
+		case ShadowLightType::SPOT:
+			renderSpotLight(update);
+			break;
+		case ShadowLightType::POINT:
+		default:
+			renderOmnidirectionalLight(update);
+			break;
+		}
+
+		commitShadowCache(update, frame);
+	}
 
 	// Reset fixed pipeline options
 	renderer->restoreFaceCulling();
@@ -59,14 +108,29 @@ void JFF::RenderPassShadowCast::execute()
 
 void JFF::RenderPassShadowCast::addRenderable(RenderComponent* renderable)
 {
+	// It's taken into account as a static caster on next updateStaticCasters()
 	renderables.push_back(renderable);
+	casterStates.push_back({ false, false, 0u, AABB() });
 }
 
 void JFF::RenderPassShadowCast::removeRenderable(RenderComponent* renderable)
 {
 	// NOTE: This will remove ALL renderables that points the same memory. Do no share RenderComponent between GameObjects
-	auto iter = std::remove(renderables.begin(), renderables.end(), renderable);
-	renderables.erase(iter, renderables.end());
+	for (size_t i = 0; i < renderables.size();)
+	{
+		if (renderables[i] != renderable)
+		{
+			++i;
+			continue;
+		}
+
+		// Shadows cached with this caster are wrong now
+		if (casterStates[i].isStatic)
+			invalidateShadowCaches(casterStates[i]);
+
+		renderables.erase(renderables.begin() + i);
+		casterStates.erase(casterStates.begin() + i);
+	}
 }
 
 void JFF::RenderPassShadowCast::addLight(LightComponent* const light)
@@ -149,18 +213,27 @@ void JFF::RenderPassShadowCast::removeLight(LightComponent* const light)
 		// NOTE: This will remove ALL lights that points the same memory. Do no share LightComponent between GameObjects
 		auto iter = std::remove(directionalLights.begin(), directionalLights.end(), dirLight);
 		directionalLights.erase(iter, directionalLights.end());
+
+		engine->renderer.lock()->getShadowAtlas().lock()->releaseRegion(dirLight);
+		shadowCaches.erase(dirLight);
 	}
 	else if (PointLightComponent* pointLight = dynamic_cast<PointLightComponent*>(light))
 	{
 		// NOTE: This will remove ALL lights that points the same memory. Do no share LightComponent between GameObjects
 		auto iter = std::remove(pointLights.begin(), pointLights.end(), pointLight);
 		pointLights.erase(iter, pointLights.end());
+
+		shadowCaches.erase(pointLight);
 	}
 	else if (SpotLightComponent* spotLight = dynamic_cast<SpotLightComponent*>(light))
 	{
 		// NOTE: This will remove ALL lights that points the same memory. Do no share LightComponent between GameObjects
 		auto iter = std::remove(spotLights.begin(), spotLights.end(), spotLight);
 		spotLights.erase(iter, spotLights.end());
+
+		engine->renderer.lock()->getShadowAtlas().lock()->releaseRegion(spotLight);
+		regionResizes.erase(spotLight);
+		shadowCaches.erase(spotLight);
 	}
 	else
 	{
@@ -178,84 +251,617 @@ void JFF::RenderPassShadowCast::removeEnvironmentMap(EnvironmentMapComponent* co
 	JFF_LOG_WARNING("Cannot remove an environment map from shadow cast render pass. Operation aborted")
 }
 
-inline void JFF::RenderPassShadowCast::renderLights(const std::vector<LightComponent*>& lights)
+inline void JFF::RenderPassShadowCast::assignShadowAtlasRegions()
+{
+	auto renderer = engine->renderer.lock();
+	auto shadowAtlas = renderer->getShadowAtlas().lock();
+	float maxRegionSize = (float)shadowAtlas->getMaxRegionSize();
+	unsigned long long int frame = renderer->getFrameCount();
+
+	/*
+	* Region size depends on the fraction of the screen affected by each light. Directional lights affect all of it.
+	* Screen coverage of spot lights changes every frame the camera moves, so their new sizes must hold for a while
+	* before their regions are resized. Otherwise lights near a size threshold would render their shadows again every frame
+	*/
+	regionRequests.clear();
+	for (LightComponent* light : directionalLights)
+	{
+		unsigned int maxSize = static_cast<DirectionalLightComponent*>(light)->getShadowMapMaxSizePixels();
+		regionRequests.push_back({ light, std::min((unsigned int)maxRegionSize, maxSize) });
+	}
+	for (LightComponent* light : spotLights)
+	{
+		SpotLightComponent* spotLight = static_cast<SpotLightComponent*>(light);
+		unsigned int requestedSize = (unsigned int)(maxRegionSize * getSpotLightScreenCoverage(spotLight));
+		requestedSize = std::min(requestedSize, spotLight->getShadowMapMaxSizePixels());
+		regionRequests.push_back({ light, holdRegionSize(light, requestedSize, frame) });
+	}
+
+	// Release regions that change their size first, so the space they leave is available for all lights
+	for (const auto& request : regionRequests)
+	{
+		ShadowAtlas::Region region;
+		if (!request.first->isEnabled() || (shadowAtlas->getRegion(request.first, region) && region.size != shadowAtlas->getRegionSize(request.second)))
+			shadowAtlas->releaseRegion(request.first);
+	}
+
+	// Most important lights get their regions first, so if the atlas is full, the less important ones are degraded
+	std::stable_sort(regionRequests.begin(), regionRequests.end(), 
+		[](const std::pair<LightComponent*, unsigned int>& a, const std::pair<LightComponent*, unsigned int>& b) { return a.second > b.second; });
+
+	for (const auto& request : regionRequests)
+	{
+		if (request.first->isEnabled())
+			shadowAtlas->assignRegion(request.first, request.second);
+	}
+}
+
+inline unsigned int JFF::RenderPassShadowCast::holdRegionSize(const LightComponent* light, unsigned int requestedSize, unsigned long long int frame)
+{
+	auto shadowAtlas = engine->renderer.lock()->getShadowAtlas().lock();
+
+	// Lights without region, or whose region already has the requested size, get it right away
+	ShadowAtlas::Region region;
+	if (!shadowAtlas->getRegion(light, region) || shadowAtlas->getRegionSize(requestedSize) == region.size)
+	{
+		regionResizes.erase(light);
+		return requestedSize;
+	}
+
+	// Start counting when the light requests a new size. If the request changes again, the count restarts
+	unsigned int regionSize = shadowAtlas->getRegionSize(requestedSize);
+	auto it = regionResizes.find(light);
+	if (it == regionResizes.end() || it->second.size != regionSize)
+	{
+		regionResizes[light] = { regionSize, frame };
+		return region.size;
+	}
+
+	if (frame - it->second.sinceFrame < REGION_RESIZE_HOLD_FRAMES)
+		return region.size;
+
+	regionResizes.erase(it);
+	return requestedSize;
+}
+
+inline float JFF::RenderPassShadowCast::getSpotLightScreenCoverage(const SpotLightComponent* spotLight) const
+{
+	// Bounding sphere of the light cone
+	float innerHalfAngleDegrees, outerHalfAngleDegrees, zNear, zFar;
+	spotLight->getSpotLightImportanceVolume(innerHalfAngleDegrees, outerHalfAngleDegrees, zNear, zFar);
+
+	Vec4 lightDir4 = spotLight->gameObject->transform.getRotationMatrix() * Vec4::DOWN;
+	Vec3 lightDir(lightDir4.x, lightDir4.y, lightDir4.z);
+
+	float halfLength = zFar * 0.5f;
+	float coneRadius = zFar * JFF::tan(JFF::radians(outerHalfAngleDegrees));
+	Vec3 center = spotLight->gameObject->transform.getWorldPos() + lightDir * halfLength;
+	float radius = std::sqrt(halfLength * halfLength + coneRadius * coneRadius);
+
+	return getScreenCoverage(center, radius);
+}
+
+inline float JFF::RenderPassShadowCast::getScreenCoverage(const Vec3& center, float radius) const
+{
+	auto camera = engine->camera.lock();
+	if (!camera || !camera->hasAnyActiveCamera())
+		return 1.0f;
+
+	// Projected radius of the sphere relative to half screen height. Cameras inside the sphere are fully covered
+	float distance = JFF::distance(center, camera->getActiveCameraWorldPos());
+	if (distance <= radius)
+		return 1.0f;
+
+	float focalLength = (*camera->getActiveCameraProjectionMatrix())[5]; // Element [1][1] of projection matrix
+	float projectedRadius = radius / std::sqrt(distance * distance - radius * radius) * focalLength;
+
+	return JFF::clamp(projectedRadius, 0.0f, 1.0f);
+}
+
+inline void JFF::RenderPassShadowCast::updateStaticCasters()
+{
+	std::shared_ptr<Spatial> spatial = engine->spatial.lock();
+	anyDynamicCaster = false;
+	anyUnculledDynamicCaster = false;
+
+	for (size_t i = 0; i < renderables.size(); ++i)
+	{
+		RenderComponent* renderComponent = renderables[i];
+		CasterState& state = casterStates[i];
+
+		bool isStatic = renderComponent->isEnabled() && renderComponent->isStaticShadowCaster();
+		if (renderComponent->isEnabled() && !isStatic)
+		{
+			anyDynamicCaster = true;
+			anyUnculledDynamicCaster = anyUnculledDynamicCaster || !spatial || renderComponent->getSpatialProxy() == Spatial::INVALID_PROXY;
+		}
+
+		// Moves are detected from the transform version kept by the scene storage
+		unsigned int transformVersion = getTransformVersion(renderComponent);
+		if (isStatic == state.isStatic && (!isStatic || transformVersion == state.transformVersion))
+			continue;
+
+		// A static caster that is added, removed, enabled, disabled or moved invalidates the lights that see its old or new bounds
+		if (state.isStatic)
+			invalidateShadowCaches(state);
+
+		state.isStatic = isStatic;
+		state.transformVersion = transformVersion;
+		if (isStatic)
+		{
+			unsigned int spatialProxy = renderComponent->getSpatialProxy();
+			state.hasBounds = spatial && spatialProxy != Spatial::INVALID_PROXY;
+			if (state.hasBounds)
+				state.bounds = spatial->getProxyTightWorldBounds(spatialProxy);
+
+			invalidateShadowCaches(state);
+		}
+	}
+}
+
+inline void JFF::RenderPassShadowCast::invalidateShadowCaches(const CasterState& changedCaster)
+{
+	// Lights that aren't updated this frame keep their cache invalid until their next update
+	for (auto& cache : shadowCaches)
+	{
+		if (!changedCaster.hasBounds || isInShadowVolume(cache.second, changedCaster.bounds))
+			cache.second.staticCastersUpToDate = false;
+	}
+}
+
+inline bool JFF::RenderPassShadowCast::isInShadowVolume(const ShadowCache& cache, const AABB& bounds) const
+{
+	// Same volumes used to cull the casters of each light. A caster outside them was never rendered in the shadow map
+	if (cache.lightType == ShadowLightType::POINT)
+		return Sphere(cache.pointLightPosition, cache.pointLightRange).overlaps(bounds);
+
+	for (unsigned int i = 0; i < cache.numLightMatrices; ++i)
+	{
+		if (Frustum(cache.lightMatrices[i]).overlaps(bounds))
+			return true;
+	}
+
+	return false;
+}
+
+inline void JFF::RenderPassShadowCast::gatherShadowUpdates()
 {
 	auto renderer = engine->renderer.lock();
+	auto shadowAtlas = renderer->getShadowAtlas().lock();
+	unsigned long long int frame = renderer->getFrameCount();
+
+	shadowUpdates.clear();
+	dynamicCasters.clear();
+
+	for (LightComponent* light : directionalLights)
+	{
+		DirectionalLightComponent* lightComponent = static_cast<DirectionalLightComponent*>(light);
 
-	std::for_each(lights.begin(), lights.end(), [this, &renderer](LightComponent* lightComponent)
+		// If this light is not enabled or has no region in the shadow atlas, it doesn't cast shadows. Its cache is lost with its region
+		ShadowUpdate update;
+		if (!lightComponent->isEnabled() || !shadowAtlas->getRegion(lightComponent, update.region))
 		{
-			// If this light is not enabled, skip its rendering
-			if (!lightComponent->isEnabled())
-				return; // Technically, this is a 'continue' statement on a usual for loop
+			shadowCaches.erase(lightComponent);
+			continue;
+		}
 
-			// Enable each light's fbo to write results on depth buffer. Also clear the depth buffer and set the viewport size to match shadow map resolution
-			lightComponent->enableShadowMapFramebuffer();
-			unsigned int shadowMapWidth, shadowMapHeight;
-			lightComponent->getShadowMapSizePixels(shadowMapWidth, shadowMapHeight);
-			renderer->setViewport(0, 0, shadowMapWidth, shadowMapHeight);
+		// Fit the cascades to the camera of this frame. They move with the camera, so the light must be updated while the camera moves
+		lightComponent->updateCascades();
+
+		update.light = lightComponent;
+		update.lightType = ShadowLightType::DIRECTIONAL;
+		update.numLightMatrices = lightComponent->getNumCascades();
+		for (unsigned int cascade = 0; cascade < update.numLightMatrices; ++cascade)
+			update.lightMatrices[cascade] = lightComponent->getCascadeProjectionMatrix(cascade) * lightComponent->getCascadeViewMatrix(cascade);
+		update.cost = update.numLightMatrices;
+		update.pointLightPosition = Vec3::ZERO;
+		update.pointLightRange = 0.0f;
+		gatherDynamicCasters(update);
+
+		// Directional lights affect the whole screen
+		addShadowUpdate(update, 1.0f, frame);
+	}
 
-			// Enable light material to cast shadows
-			lightComponent->useMaterial();
+	for (LightComponent* light : spotLights)
+	{
+		SpotLightComponent* lightComponent = static_cast<SpotLightComponent*>(light);
 
-			// Send light matrices
-			lightComponent->sendMat4(ShaderCodeBuilder::VIEW_MATRIX.c_str(), lightComponent->getViewMatrix());
-			lightComponent->sendMat4(ShaderCodeBuilder::PROJECTION_MATRIX.c_str(), lightComponent->getProjectionMatrix());
+		// If this light is not enabled or has no region in the shadow atlas, it doesn't cast shadows. Its cache is lost with its region
+		ShadowUpdate update;
+		if (!lightComponent->isEnabled() || !shadowAtlas->getRegion(lightComponent, update.region))
+		{
+			shadowCaches.erase(lightComponent);
+			continue;
+		}
 
-			std::for_each(renderables.begin(), renderables.end(), [this, &lightComponent](RenderComponent* renderComponent)
-				{
-					// If this render component is not enabled, skip its rendering
-					if (!renderComponent->isEnabled())
-						return; // Technically, this is a 'continue' statement on a usual for loop
+		update.light = lightComponent;
+		update.lightType = ShadowLightType::SPOT;
+		update.numLightMatrices = 1u;
+		update.lightMatrices[0] = lightComponent->getProjectionMatrix() * lightComponent->getViewMatrix();
+		update.cost = 1u;
+		update.pointLightPosition = Vec3::ZERO;
+		update.pointLightRange = 0.0f;
+		gatherDynamicCasters(update);
+
+		addShadowUpdate(update, getSpotLightScreenCoverage(lightComponent), frame);
+	}
+
+	for (PointLightComponent* lightComponent : pointLights)
+	{
+		// If this light is not enabled, skip its rendering
+		if (!lightComponent->isEnabled())
+		{
+			shadowCaches.erase(lightComponent);
+			continue;
+		}
 
-					// Send Model matrix of light's material
-					lightComponent->sendMat4(ShaderCodeBuilder::MODEL_MATRIX.c_str(), renderComponent->gameObject->transform.getModelMatrix());
+		// The whole cubemap is used. The light position takes the place of the view matrix in the cache key
+		unsigned int shadowCubemapFaceWidth, shadowCubemapFaceHeight;
+		lightComponent->getShadowMapSizePixels(shadowCubemapFaceWidth, shadowCubemapFaceHeight);
+
+		Vec3 lightPos = lightComponent->gameObject->transform.getWorldPos();
+
+		ShadowUpdate update;
+		update.light = lightComponent;
+		update.lightType = ShadowLightType::POINT;
+		update.region = { 0u, 0u, shadowCubemapFaceWidth };
+		update.numLightMatrices = 1u;
+		update.lightMatrices[0] = lightComponent->getProjectionMatrix() * JFF::translate(Mat4(), lightPos);
+		update.cost = 6u; // All faces of the cubemap are rendered at once
+
+		float zNear, zFar;
+		lightComponent->getPointLightImportanceVolume(zNear, zFar);
+		update.pointLightPosition = lightPos;
+		update.pointLightRange = zFar;
+		gatherDynamicCasters(update);
+		addShadowUpdate(update, getScreenCoverage(lightPos, zFar), frame);
+	}
+}
+
+inline void JFF::RenderPassShadowCast::gatherDynamicCasters(ShadowUpdate& update)
+{
+	update.dynamicCastersBegin = dynamicCasters.size();
+	if (anyDynamicCaster)
+	{
+		// Same volumes used to cull the casters when the light is rendered
+		std::shared_ptr<Spatial> spatial = engine->spatial.lock();
+		casterQueryResults.clear();
+		if (spatial && update.lightType == ShadowLightType::POINT)
+		{
+			spatial->querySphere(Sphere(update.pointLightPosition, update.pointLightRange), Spatial::RENDERABLE, casterQueryResults);
+		}
+		else if (spatial)
+		{
+			for (unsigned int i = 0; i < update.numLightMatrices; ++i)
+				spatial->queryFrustum(Frustum(update.lightMatrices[i]), Spatial::RENDERABLE, casterQueryResults);
+		}
+
+		// Casters that are never culled are drawn into every shadow map
+		if (anyUnculledDynamicCaster)
+		{
+			for (RenderComponent* renderComponent : renderables)
+			{
+				if (!spatial || renderComponent->getSpatialProxy() == Spatial::INVALID_PROXY)
+					casterQueryResults.push_back(renderComponent);
+			}
+		}
+
+		for (Component* component : casterQueryResults)
+		{
+			// Only surface and translucent renderables are shadow casters (Check RendererGL::addRenderable())
+			RenderComponent* renderComponent = static_cast<RenderComponent*>(component);
+			Material::MaterialDomain domain = renderComponent->getMaterialDomain();
+			bool isCaster = domain == Material::MaterialDomain::SURFACE || domain == Material::MaterialDomain::TRANSLUCENT;
+			if (isCaster && renderComponent->isEnabled() && !renderComponent->isStaticShadowCaster())
+				dynamicCasters.push_back({ renderComponent, getTransformVersion(renderComponent) });
+		}
+
+		// Sorted and without duplicates (a caster may overlap several cascades), so ranges can be compared between frames
+		auto first = dynamicCasters.begin() + update.dynamicCastersBegin;
+		std::sort(first, dynamicCasters.end(), [](const DynamicCaster& a, const DynamicCaster& b) { return a.renderComponent < b.renderComponent; });
+		auto last = std::unique(first, dynamicCasters.end(), [](const DynamicCaster& a, const DynamicCaster& b) { return a.renderComponent == b.renderComponent; });
+		dynamicCasters.erase(last, dynamicCasters.end());
+	}
+
+	update.dynamicCastersEnd = dynamicCasters.size();
+	update.hasDynamicCasters = update.dynamicCastersEnd > update.dynamicCastersBegin;
+}
+
+inline bool JFF::RenderPassShadowCast::dynamicCastersChanged(const ShadowCache& cache, const ShadowUpdate& update) const
+{
+	// A dynamic caster outdates the shadow map if it entered or left the light volume, or moved since last update
+	size_t numDynamicCasters = update.dynamicCastersEnd - update.dynamicCastersBegin;
+	if (cache.dynamicCasters.size() != numDynamicCasters)
+		return true;
+
+	return !std::equal(cache.dynamicCasters.begin(), cache.dynamicCasters.end(), dynamicCasters.begin() + update.dynamicCastersBegin,
+		[](const DynamicCaster& a, const DynamicCaster& b) { return a.renderComponent == b.renderComponent && a.transformVersion == b.transformVersion; });
+}
+
+inline unsigned int JFF::RenderPassShadowCast::getTransformVersion(const RenderComponent* renderComponent) const
+{
+	// GameObjects out of a scene are never drawn
+	const GameObject* gameObject = renderComponent->gameObject;
+	return gameObject->getStorage() ? gameObject->getStorage()->getTransformVersion(gameObject->getStorageHandle()) : 0u;
+}
+
+inline void JFF::RenderPassShadowCast::addShadowUpdate(ShadowUpdate& update, float importance, unsigned long long int frame)
+{
+	auto it = shadowCaches.find(update.light);
+
+	// The shadow map is useless if the light moved or it was never rendered in its current region. It must be updated this frame
+	update.mandatory = it == shadowCaches.end() ||
+		it->second.numLightMatrices != update.numLightMatrices ||
+		std::memcmp(it->second.lightMatrices, update.lightMatrices, sizeof(Mat4) * update.numLightMatrices) != 0 ||
+		it->second.region.x != update.region.x || it->second.region.y != update.region.y || it->second.region.size != update.region.size;
+
+	bool staticCastersUpToDate = !update.mandatory && it->second.staticCastersUpToDate;
+
+	// Still dynamic casters don't outdate the shadow map. Those that were rendered and left the volume do
+	bool dynamicCastersOutdated = update.mandatory ? update.hasDynamicCasters : dynamicCastersChanged(it->second, update);
+
+	if (!update.mandatory && staticCastersUpToDate && !dynamicCastersOutdated)
+		return; // Nothing changed since last update
+
+	if (!update.light->hasStaticShadowMap())
+		update.cacheState = ShadowCacheState::DISABLED;
+	else
+		update.cacheState = staticCastersUpToDate ? ShadowCacheState::VALID : ShadowCacheState::INVALID;
+
+	// The longer a light waits, the higher its priority. Lights are refreshed in round-robin, at a rate given by their importance.
+	// Screen coverage accounts for the distance to the camera. A minimum importance prevents distant lights from starving
+	const float minImportance = 0.01f;
+	unsigned long long int framesWaiting = update.mandatory ? 1ull : frame - it->second.lastUpdateFrame;
+	update.priority = std::max(importance, minImportance) * (float)framesWaiting;
+	update.scheduled = false;
+
+	shadowUpdates.push_back(update);
+}
 
-					// Execute the draw call
-					renderComponent->draw();
-				});
+inline void JFF::RenderPassShadowCast::scheduleShadowUpdates()
+{
+	unsigned int budget = engine->renderer.lock()->getShadowUpdateBudget();
 
+	// Mandatory updates first, then the rest by priority
+	std::stable_sort(shadowUpdates.begin(), shadowUpdates.end(), [](const ShadowUpdate& a, const ShadowUpdate& b)
+		{
+			return a.mandatory != b.mandatory ? a.mandatory : a.priority > b.priority;
 		});
+
+	/*
+	* The budget is counted in rendered views: cascades of directional lights, spot light shadow maps and point light cubemap faces.
+	* Mandatory updates always happen, and at least one of the rest each frame, so lights don't wait forever while the camera moves.
+	* The last scheduled update may exceed the budget
+	*/
+	int remainingBudget = (int)budget;
+	bool anyDeferrableScheduled = false;
+	for (ShadowUpdate& update : shadowUpdates)
+	{
+		if (budget == 0u || update.mandatory || remainingBudget > 0 || !anyDeferrableScheduled)
+		{
+			update.scheduled = true;
+			remainingBudget -= (int)update.cost;
+			anyDeferrableScheduled = anyDeferrableScheduled || !update.mandatory;
+		}
+	}
 }
 
-inline void JFF::RenderPassShadowCast::renderOmnidirectionalLights()
+inline void JFF::RenderPassShadowCast::commitShadowCache(const ShadowUpdate& update, unsigned long long int frame)
+{
+	ShadowCache& cache = shadowCaches[update.light];
+	cache.lightType = update.lightType;
+	std::copy(update.lightMatrices, update.lightMatrices + update.numLightMatrices, cache.lightMatrices);
+	cache.numLightMatrices = update.numLightMatrices;
+	cache.pointLightPosition = update.pointLightPosition;
+	cache.pointLightRange = update.pointLightRange;
+	cache.region = update.region;
+	cache.staticCastersUpToDate = true;
+	cache.dynamicCasters.assign(dynamicCasters.begin() + update.dynamicCastersBegin, dynamicCasters.begin() + update.dynamicCastersEnd);
+	cache.lastUpdateFrame = frame;
+}
+
+inline void JFF::RenderPassShadowCast::renderShadowCasters(LightComponent* lightComponent, ShadowCacheState cacheState, const ShadowAtlas::Region* atlasRegion,
+	const std::function<void(CasterFilter)>& drawViews)
 {
 	auto renderer = engine->renderer.lock();
 
-	std::for_each(pointLights.begin(), pointLights.end(), [this, &renderer](PointLightComponent* lightComponent)
+	// Atlas regions are cleared one by one because the atlas is shared. Point lights clear their shadow maps when they're enabled
+	switch (cacheState)
+	{
+	case ShadowCacheState::DISABLED:
+		lightComponent->enableShadowMapFramebuffer();
+		if (atlasRegion)
+			renderer->clearDepthBuffer(atlasRegion->x, atlasRegion->y, atlasRegion->size, atlasRegion->size);
+
+		drawViews(CasterFilter::ALL);
+		break;
+	case ShadowCacheState::INVALID:
+		lightComponent->enableStaticShadowMapFramebuffer();
+		if (atlasRegion)
+			renderer->clearDepthBuffer(atlasRegion->x, atlasRegion->y, atlasRegion->size, atlasRegion->size);
+
+		drawViews(CasterFilter::STATIC);
+
+		lightComponent->restoreStaticShadowMap();
+		drawViews(CasterFilter::DYNAMIC);
+		break;
+	case ShadowCacheState::VALID:
+		lightComponent->restoreStaticShadowMap();
+		drawViews(CasterFilter::DYNAMIC);
+		break;
+	default:
+		break;
+	}
+}
+
+inline void JFF::RenderPassShadowCast::cullCasters(const Frustum& lightVolume)
+{
+	std::shared_ptr<Spatial> spatial = engine->spatial.lock();
+	if (!spatial)
+		return; // Without Spatial subsystem, render components have no bounds and they're never culled
+
+	++shadowCastMark;
+	casterQueryResults.clear();
+	spatial->queryFrustum(lightVolume, Spatial::RENDERABLE, casterQueryResults);
+	for (Component* renderable : casterQueryResults)
+		static_cast<RenderComponent*>(renderable)->setShadowCastMark(shadowCastMark);
+}
+
+inline void JFF::RenderPassShadowCast::cullCasters(const Sphere& lightVolume)
+{
+	std::shared_ptr<Spatial> spatial = engine->spatial.lock();
+	if (!spatial)
+		return; // Without Spatial subsystem, render components have no bounds and they're never culled
+
+	++shadowCastMark;
+	casterQueryResults.clear();
+	spatial->querySphere(lightVolume, Spatial::RENDERABLE, casterQueryResults);
+	for (Component* renderable : casterQueryResults)
+		static_cast<RenderComponent*>(renderable)->setShadowCastMark(shadowCastMark);
+}
+
+inline void JFF::RenderPassShadowCast::drawCasters(LightComponent* lightComponent, CasterFilter filter)
+{
+	std::for_each(renderables.begin(), renderables.end(), [this, &lightComponent, filter](RenderComponent* renderComponent)
 		{
-			// If this light is not enabled, skip its rendering
-			if (!lightComponent->isEnabled())
+			// If this render component is not enabled or it's outside the light volume, skip its rendering
+			if (!renderComponent->isEnabled() || renderComponent->isShadowCulled(shadowCastMark))
+				return; // Technically, this is a 'continue' statement on a usual for loop
+
+			if ((filter == CasterFilter::STATIC && !renderComponent->isStaticShadowCaster()) ||
+				(filter == CasterFilter::DYNAMIC && renderComponent->isStaticShadowCaster()))
 				return; // Technically, this is a 'continue' statement on a usual for loop
 
-			// Enable each light's fbo to write results on cubemap depth buffer. Also clear the depth buffer and set the viewport size to match shadow map resolution
-			lightComponent->enableShadowMapFramebuffer();
-			unsigned int shadowCubemapFaceWidth, shadowCubemapFaceHeight;
-			lightComponent->getShadowMapSizePixels(shadowCubemapFaceWidth, shadowCubemapFaceHeight);
-			renderer->setViewport(0, 0, shadowCubemapFaceWidth, shadowCubemapFaceHeight);
+			// Send Model matrix of light's material
+			lightComponent->sendMat4(ShaderCodeBuilder::MODEL_MATRIX.c_str(), renderComponent->gameObject->transform.getModelMatrix());
+
+			// Execute the draw call
+			renderComponent->draw();
+		});
+}
+
+inline void JFF::RenderPassShadowCast::drawOmnidirectionalCasters(PointLightComponent* lightComponent, CasterFilter filter)
+{
+	std::shared_ptr<Spatial> spatial = engine->spatial.lock();
 
-			// Enable light material to cast shadows
-			lightComponent->useMaterial();
+	std::for_each(renderables.begin(), renderables.end(), [this, &spatial, &lightComponent, filter](RenderComponent* renderComponent)
+		{
+			// If this render component is not enabled or it's outside the light sphere, skip its rendering
+			if (!renderComponent->isEnabled() || renderComponent->isShadowCulled(shadowCastMark))
+				return; // Technically, this is a 'continue' statement on a usual for loop
 
-			// Send light matrices and other needed uniforms
-			lightComponent->sendCubemapViewMatrices();
-			lightComponent->sendMat4(ShaderCodeBuilder::PROJECTION_MATRIX.c_str(), lightComponent->getProjectionMatrix());
-			lightComponent->sendVec3(ShaderCodeBuilder::LIGHT_POSITION.c_str(), lightComponent->gameObject->transform.getWorldPos());
+			if ((filter == CasterFilter::STATIC && !renderComponent->isStaticShadowCaster()) ||
+				(filter == CasterFilter::DYNAMIC && renderComponent->isStaticShadowCaster()))
+				return; // Technically, this is a 'continue' statement on a usual for loop
 
-			float zNear, zFar;
-			lightComponent->getPointLightImportanceVolume(zNear, zFar);
-			lightComponent->sendFloat(ShaderCodeBuilder::LIGHT_FAR_PLANE.c_str(), zFar);
+			// Only the cubemap faces touched by the bounds of the caster receive its triangles. Casters without bounds touch all of them
+			unsigned int faceMask = 0x3Fu;
+			unsigned int spatialProxy = renderComponent->getSpatialProxy();
+			if (spatial && spatialProxy != Spatial::INVALID_PROXY)
+			{
+				AABB worldBounds = spatial->getProxyWorldBounds(spatialProxy);
 
-			std::for_each(renderables.begin(), renderables.end(), [this, &lightComponent](RenderComponent* renderComponent) 
+				faceMask = 0u;
+				for (unsigned int face = 0; face < cubemapFaceFrustums.size(); ++face)
 				{
-					// If this render component is not enabled, skip its rendering
-					if (!renderComponent->isEnabled())
-						return; // Technically, this is a 'continue' statement on a usual for loop
+					if (cubemapFaceFrustums[face].overlaps(worldBounds))
+						faceMask |= 1u << face;
+				}
+
+				if (faceMask == 0u)
+					return; // Technically, this is a 'continue' statement on a usual for loop
+			}
+
+			// Send Model matrix and affected faces of light's material
+			lightComponent->sendMat4(ShaderCodeBuilder::MODEL_MATRIX.c_str(), renderComponent->gameObject->transform.getModelMatrix());
+			lightComponent->sendFloat(ShaderCodeBuilder::CUBEMAP_FACE_MASK.c_str(), (float)faceMask);
+
+			// Execute the draw call
+			renderComponent->draw();
+		});
+}
+
+inline void JFF::RenderPassShadowCast::renderDirectionalLight(const ShadowUpdate& update)
+{
+	auto renderer = engine->renderer.lock();
+	DirectionalLightComponent* lightComponent = static_cast<DirectionalLightComponent*>(update.light);
+	unsigned int numCascades = update.numLightMatrices;
 
-					// Send Model matrix of light's material
-					lightComponent->sendMat4(ShaderCodeBuilder::MODEL_MATRIX.c_str(), renderComponent->gameObject->transform.getModelMatrix());
+	// Enable light material to cast shadows
+	lightComponent->useMaterial();
 
-					// Execute the draw call
-					renderComponent->draw();
-				});
+	// The whole region is cleared and restored at once. Each cascade renders in its own tile
+	renderer->setViewport(update.region.x, update.region.y, update.region.size, update.region.size);
+	renderShadowCasters(lightComponent, update.cacheState, &update.region, [this, &renderer, lightComponent, numCascades](CasterFilter filter)
+		{
+			for (unsigned int cascade = 0; cascade < numCascades; ++cascade)
+			{
+				ShadowAtlas::Region cascadeRegion;
+				lightComponent->getCascadeRegion(cascade, cascadeRegion);
+				renderer->setViewport(cascadeRegion.x, cascadeRegion.y, cascadeRegion.size, cascadeRegion.size);
+
+				lightComponent->sendMat4(ShaderCodeBuilder::VIEW_MATRIX.c_str(), lightComponent->getCascadeViewMatrix(cascade));
+				lightComponent->sendMat4(ShaderCodeBuilder::PROJECTION_MATRIX.c_str(), lightComponent->getCascadeProjectionMatrix(cascade));
+
+				// The ortho box of the cascade is extended towards the light, so casters between the light and the cascade aren't culled
+				cullCasters(Frustum(lightComponent->getCascadeProjectionMatrix(cascade) * lightComponent->getCascadeViewMatrix(cascade)));
+				drawCasters(lightComponent, filter);
+			}
 		});
+}
+
+inline void JFF::RenderPassShadowCast::renderSpotLight(const ShadowUpdate& update)
+{
+	auto renderer = engine->renderer.lock();
+	LightComponent* lightComponent = update.light;
+
+	// Enable light material to cast shadows
+	lightComponent->useMaterial();
+
+	// Send light matrices
+	lightComponent->sendMat4(ShaderCodeBuilder::VIEW_MATRIX.c_str(), lightComponent->getViewMatrix());
+	lightComponent->sendMat4(ShaderCodeBuilder::PROJECTION_MATRIX.c_str(), lightComponent->getProjectionMatrix());
+
+	// Only casters inside the light frustum are rendered
+	cullCasters(Frustum(update.lightMatrices[0]));
+
+	// Render in the light's region of the shadow atlas
+	renderer->setViewport(update.region.x, update.region.y, update.region.size, update.region.size);
+	renderShadowCasters(lightComponent, update.cacheState, &update.region, 
+		[this, lightComponent](CasterFilter filter) { drawCasters(lightComponent, filter); });
+}
+
+inline void JFF::RenderPassShadowCast::renderOmnidirectionalLight(const ShadowUpdate& update)
+{
+	auto renderer = engine->renderer.lock();
+	PointLightComponent* lightComponent = static_cast<PointLightComponent*>(update.light);
+
+	Vec3 lightPos = lightComponent->gameObject->transform.getWorldPos();
+	Mat4 projectionMatrix = lightComponent->getProjectionMatrix();
+
+	// Enable light material to cast shadows
+	lightComponent->useMaterial();
+
+	// Send light matrices and other needed uniforms
+	lightComponent->sendCubemapViewMatrices();
+	lightComponent->sendMat4(ShaderCodeBuilder::PROJECTION_MATRIX.c_str(), projectionMatrix);
+	lightComponent->sendVec3(ShaderCodeBuilder::LIGHT_POSITION.c_str(), lightPos);
+
+	float zNear, zFar;
+	lightComponent->getPointLightImportanceVolume(zNear, zFar);
+	lightComponent->sendFloat(ShaderCodeBuilder::LIGHT_FAR_PLANE.c_str(), zFar);
+
+	// Only casters inside the light sphere are rendered, and only into the faces their bounds touch
+	cullCasters(Sphere(lightPos, zFar));
+
+	cubemapFaceFrustums.clear();
+	for (unsigned int face = 0; face < 6; ++face)
+		cubemapFaceFrustums.push_back(Frustum(projectionMatrix * lightComponent->getCubemapViewMatrix(face)));
+
+	// Set the viewport size to match shadow map resolution. All six faces are rendered at once through the geometry shader
+	unsigned int shadowCubemapFaceWidth, shadowCubemapFaceHeight;
+	lightComponent->getShadowMapSizePixels(shadowCubemapFaceWidth, shadowCubemapFaceHeight);
+	renderer->setViewport(0, 0, shadowCubemapFaceWidth, shadowCubemapFaceHeight);
+	renderShadowCasters(lightComponent, update.cacheState, nullptr, 
+		[this, lightComponent](CasterFilter filter) { drawOmnidirectionalCasters(lightComponent, filter); });
 }
\ No newline at end of file
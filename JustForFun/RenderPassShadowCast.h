@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,6 +13,13 @@
 #include "RenderPass.h"
 
 #include "PointLightComponent.h"
+#include "SpotLightComponent.h"
+#include "DirectionalLightComponent.h"
+#include "ShadowAtlas.h"
+#include "Bounds.h"
+
+#include <unordered_map>
+#include <functional>
 
 namespace JFF
 {
@@ -20,6 +27,10 @@ namespace JFF
 
 	class RenderPassShadowCast : public RenderPass
 	{
+	public:
+		// Frames that a spot light must request another shadow atlas region size before its region is resized
+		static const unsigned int REGION_RESIZE_HOLD_FRAMES;
+
 	public:
 		// Ctor & Dtor
 		explicit RenderPassShadowCast(Engine* const engine);
@@ -57,15 +68,137 @@ namespace JFF
 		virtual void removeEnvironmentMap(EnvironmentMapComponent* const envMap) override;
 
 	protected:
-		inline void renderLights(const std::vector<LightComponent*>& lights);
-		inline void renderOmnidirectionalLights();
+		// What a light needs to render, depending on its cached shadows of static casters
+		enum class ShadowCacheState : char
+		{
+			DISABLED,	// The light doesn't cache static casters. Render all casters
+			INVALID,	// The light or some static caster moved. Render static casters into the cache, then dynamic casters over it
+			VALID,		// Restore static casters from the cache and render dynamic casters over it
+		};
+
+		enum class ShadowLightType : char
+		{
+			DIRECTIONAL,
+			SPOT,
+			POINT,
+		};
+
+		enum class CasterFilter : char
+		{
+			ALL,
+			STATIC,
+			DYNAMIC,
+		};
+
+		// Dynamic caster inside the volume of a light, with the version of its transform at that moment
+		struct DynamicCaster
+		{
+			const RenderComponent* renderComponent;
+			unsigned int transformVersion;
+		};
+
+		// State of the shadow map of a light after its last update. If the key (matrices and region) changes, the shadow map is useless
+		struct ShadowCache
+		{
+			ShadowLightType lightType;
+			Mat4 lightMatrices[ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES]; // projectionMatrix * viewMatrix of each view (cascade) of the light
+			unsigned int numLightMatrices;
+			Vec3 pointLightPosition; // Point lights only. Their shadow volume is a sphere instead of the light matrices' frustum
+			float pointLightRange;
+			ShadowAtlas::Region region;
+			bool staticCastersUpToDate; // False if some static caster changed inside the light volume after last update
+			std::vector<DynamicCaster> dynamicCasters; // Rendered in last update, sorted. Empty if the shadow map holds the static casters only
+			unsigned long long int lastUpdateFrame;
+		};
+
+		// A light whose shadow map is out of date this frame
+		struct ShadowUpdate
+		{
+			LightComponent* light;
+			ShadowLightType lightType;
+			Mat4 lightMatrices[ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES];
+			unsigned int numLightMatrices;
+			Vec3 pointLightPosition;
+			float pointLightRange;
+			ShadowAtlas::Region region;
+			ShadowCacheState cacheState;
+			bool hasDynamicCasters; // Some dynamic caster is inside the light volume
+			size_t dynamicCastersBegin; // Range of RenderPassShadowCast::dynamicCasters with the dynamic casters inside the light volume
+			size_t dynamicCastersEnd;
+			bool mandatory; // The light moved or its shadow map was never rendered, so it can't wait
+			float priority;
+			unsigned int cost; // Number of rendered views
+			bool scheduled;
+		};
+
+		// Shadow cache state of a renderable, as it was last frame. Stored in the same order as renderables
+		struct CasterState
+		{
+			bool isStatic; // Enabled and static caster
+			bool hasBounds; // False if the renderable has no spatial proxy. Then it may affect any light
+			unsigned int transformVersion;
+			AABB bounds; // World bounds while it's static
+		};
+
+		inline void assignShadowAtlasRegions();
+		inline unsigned int holdRegionSize(const LightComponent* light, unsigned int requestedSize, unsigned long long int frame);
+		inline float getSpotLightScreenCoverage(const SpotLightComponent* spotLight) const;
+		inline float getScreenCoverage(const Vec3& center, float radius) const;
+		inline void updateStaticCasters();
+		inline void invalidateShadowCaches(const CasterState& changedCaster);
+		inline bool isInShadowVolume(const ShadowCache& cache, const AABB& bounds) const;
+		inline void gatherShadowUpdates();
+		inline void gatherDynamicCasters(ShadowUpdate& update);
+		inline bool dynamicCastersChanged(const ShadowCache& cache, const ShadowUpdate& update) const;
+		inline unsigned int getTransformVersion(const RenderComponent* renderComponent) const;
+		inline void addShadowUpdate(ShadowUpdate& update, float importance, unsigned long long int frame);
+		inline void scheduleShadowUpdates();
+		inline void commitShadowCache(const ShadowUpdate& update, unsigned long long int frame);
+		inline void renderShadowCasters(LightComponent* lightComponent, ShadowCacheState cacheState, const ShadowAtlas::Region* atlasRegion,
+			const std::function<void(CasterFilter)>& drawViews);
+		inline void cullCasters(const Frustum& lightVolume);
+		inline void cullCasters(const Sphere& lightVolume);
+		inline void drawCasters(LightComponent* lightComponent, CasterFilter filter);
+		inline void drawOmnidirectionalCasters(PointLightComponent* lightComponent, CasterFilter filter);
+		inline void renderDirectionalLight(const ShadowUpdate& update);
+		inline void renderSpotLight(const ShadowUpdate& update);
+		inline void renderOmnidirectionalLight(const ShadowUpdate& update);
 
 	protected:
 		Engine* engine;
 		std::vector<RenderComponent*> renderables;
+		std::vector<CasterState> casterStates;
 
 		std::vector<LightComponent*> directionalLights;
 		std::vector<PointLightComponent*> pointLights;
 		std::vector<LightComponent*> spotLights;
+
+		// Shadow atlas region size requested by each light this frame. Reused every frame to avoid allocations
+		std::vector<std::pair<LightComponent*, unsigned int>> regionRequests;
+
+		// Region size a spot light started to request, and when. Sizes are only changed after holding the request some frames
+		struct RegionResize
+		{
+			unsigned int size;
+			unsigned long long int sinceFrame;
+		};
+		std::unordered_map<const LightComponent*, RegionResize> regionResizes;
+
+		// True if some enabled renderable isn't a static caster, and if some of them is never culled because it has no spatial proxy
+		bool anyDynamicCaster;
+		bool anyUnculledDynamicCaster;
+
+		std::unordered_map<const LightComponent*, ShadowCache> shadowCaches;
+
+		// Lights whose shadow maps are out of date this frame. Only those that fit in the renderer's budget are updated
+		std::vector<ShadowUpdate> shadowUpdates;
+
+		// Dynamic casters inside the volume of each light this frame. Each light (ShadowUpdate) owns a range of it
+		std::vector<DynamicCaster> dynamicCasters;
+
+		// Casters are culled against the volume of each light (or cascade). Those inside get the current mark
+		unsigned long long int shadowCastMark;
+		std::vector<Component*> casterQueryResults;
+		std::vector<Frustum> cubemapFaceFrustums; // Frustum of each face of the point light being rendered
 	};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -195,16 +195,25 @@ inline void JFF::RenderPassTranslucent::renderPass(bool cullFrontFaces)
 	const int maxDirLights = renderer->getForwardShadingMaxDirectionalLights();
 	const int maxPointLights = renderer->getForwardShadingMaxPointLights();
 	const int maxSpotLights = renderer->getForwardShadingMaxSpotLights();
+	const unsigned long long int frame = renderer->getFrameCount();
 
 	// Cull selected faces for all renderables
 	renderer->faceCulling(cullFrontFaces ? Renderer::FaceCullOp::CULL_FRONT_FACES : Renderer::FaceCullOp::CULL_BACK_FACES);
 
-	std::for_each(renderables.begin(), renderables.end(), [this, cullFrontFaces, &maxDirLights, &maxPointLights, &maxSpotLights](RenderComponent* renderComponent)
+	std::for_each(renderables.begin(), renderables.end(), [this, cullFrontFaces, &maxDirLights, &maxPointLights, &maxSpotLights, frame](RenderComponent* renderComponent)
 		{
 			// If this component is not enabled, skip its rendering
 			if (!renderComponent->isEnabled())
 				return; // Technically, this is a 'continue' statement on a usual for loop
 
+			// If this component is outside the camera frustum, skip it
+			if (renderComponent->isCulled(frame))
+				return;
+
+			// If this component's shaders are still compiling, skip it until they are ready
+			if (!renderComponent->isMaterialReady())
+				return;
+
 			// Enable component material and bind all textures
 			renderComponent->useMaterial();
 
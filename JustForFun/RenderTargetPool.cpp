@@ -0,0 +1,141 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "RenderTargetPool.h"
+
+#include "Log.h"
+
+#include <algorithm>
+
+extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(const JFF::Framebuffer::Params& params);
+
+const unsigned long long JFF::RenderTargetPool::MAX_UNUSED_FRAMES = 60ull;
+
+JFF::RenderTargetPool::RenderTargetPool() :
+	renderTargets(),
+	frame(0ull)
+{
+	JFF_LOG_INFO("Ctor RenderTargetPool")
+}
+
+JFF::RenderTargetPool::~RenderTargetPool()
+{
+	JFF_LOG_INFO("Dtor RenderTargetPool")
+}
+
+std::shared_ptr<JFF::Framebuffer> JFF::RenderTargetPool::acquire(const Framebuffer::Params& params)
+{
+	for (RenderTarget& renderTarget : renderTargets)
+	{
+		if (!renderTarget.inUse && matches(renderTarget.params, params))
+		{
+			renderTarget.inUse = true;
+			renderTarget.lastUsedFrame = frame;
+			return renderTarget.fbo;
+		}
+	}
+
+	RenderTarget renderTarget;
+	renderTarget.params = params;
+	renderTarget.fbo = createFramebuffer(params);
+	renderTarget.inUse = true;
+	renderTarget.lastUsedFrame = frame;
+	renderTargets.push_back(renderTarget);
+
+	JFF_LOG_INFO("New render target in pool. Render targets: " << renderTargets.size())
+
+	return renderTarget.fbo;
+}
+
+void JFF::RenderTargetPool::release(const std::shared_ptr<Framebuffer>& fbo)
+{
+	auto it = std::find_if(renderTargets.begin(), renderTargets.end(), [&fbo](const RenderTarget& renderTarget) { return renderTarget.fbo == fbo; });
+	if (it == renderTargets.end())
+	{
+		JFF_LOG_WARNING("Framebuffer doesn't belong to this render target pool. Operation aborted")
+		return;
+	}
+
+	it->inUse = false;
+}
+
+void JFF::RenderTargetPool::endFrame()
+{
+	for (RenderTarget& renderTarget : renderTargets)
+	{
+		if (renderTarget.inUse)
+		{
+			JFF_LOG_WARNING("Render target wasn't released by its pass. Releasing it")
+			renderTarget.inUse = false;
+		}
+	}
+
+	// Destroy targets nobody asked for recently
+	auto it = std::remove_if(renderTargets.begin(), renderTargets.end(), [this](const RenderTarget& renderTarget)
+		{
+			if (frame - renderTarget.lastUsedFrame < MAX_UNUSED_FRAMES)
+				return false;
+
+			renderTarget.fbo->destroy();
+			return true;
+		});
+
+	if (it != renderTargets.end())
+	{
+		renderTargets.erase(it, renderTargets.end());
+		JFF_LOG_INFO("Unused render targets destroyed. Render targets: " << renderTargets.size())
+	}
+
+	++frame;
+}
+
+size_t JFF::RenderTargetPool::getNumRenderTargets() const
+{
+	return renderTargets.size();
+}
+
+void JFF::RenderTargetPool::destroy()
+{
+	std::for_each(renderTargets.begin(), renderTargets.end(), [](auto& renderTarget) { renderTarget.fbo->destroy(); });
+	renderTargets.clear();
+}
+
+inline bool JFF::RenderTargetPool::matches(const Framebuffer::Params& a, const Framebuffer::Params& b) const
+{
+	if (a.samplesPerPixel != b.samplesPerPixel || a.attachments.size() != b.attachments.size())
+		return false;
+
+	for (const auto& pair : a.attachments)
+	{
+		auto it = b.attachments.find(pair.first);
+		if (it == b.attachments.end() || !matches(pair.second, it->second))
+			return false;
+	}
+
+	return true;
+}
+
+inline bool JFF::RenderTargetPool::matches(const Framebuffer::AttachmentData& a, const Framebuffer::AttachmentData& b) const
+{
+	return
+		a.width == b.width &&
+		a.height == b.height &&
+		a.renderBuffer == b.renderBuffer &&
+		a.texType == b.texType &&
+		a.wrapMode.u == b.wrapMode.u && a.wrapMode.v == b.wrapMode.v && a.wrapMode.w == b.wrapMode.w &&
+		a.borderColor.x == b.borderColor.x && a.borderColor.y == b.borderColor.y &&
+		a.borderColor.z == b.borderColor.z && a.borderColor.w == b.borderColor.w &&
+		a.filterMode.minFilter == b.filterMode.minFilter &&
+		a.filterMode.magFilter == b.filterMode.magFilter &&
+		a.HDR == b.HDR &&
+		a.numColorChannels == b.numColorChannels &&
+		a.mipmapLevel == b.mipmapLevel &&
+		a.mipmaps == b.mipmaps;
+}
@@ -0,0 +1,79 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Framebuffer.h"
+
+#include <memory>
+#include <vector>
+
+namespace JFF
+{
+	/*
+	* Pool of reusable framebuffers for render targets that only live during one pass (e.g. the intermediate buffers of
+	* post-process FX). Passes acquire their targets when they start and release them when they finish, so passes whose
+	* lifetimes don't overlap share the same framebuffers if they request the same params.
+	* Targets that aren't requested for a while (e.g. after a resize or when an FX is disabled) are destroyed
+	*/
+	class RenderTargetPool final
+	{
+	public:
+		// Ctor & Dtor
+		RenderTargetPool();
+		~RenderTargetPool();
+
+		// Copy ctor and copy assignment
+		RenderTargetPool(const RenderTargetPool& other) = delete;
+		RenderTargetPool& operator=(const RenderTargetPool& other) = delete;
+
+		// Move ctor and assignment
+		RenderTargetPool(RenderTargetPool&& other) = delete;
+		RenderTargetPool operator=(RenderTargetPool&& other) = delete;
+
+		/*
+		* Gets a framebuffer created with params that isn't in use by other pass. It's created if there isn't any free.
+		* Contents are undefined: the pass must overwrite or clear them
+		*/
+		std::shared_ptr<Framebuffer> acquire(const Framebuffer::Params& params);
+
+		// Returns a framebuffer to the pool. Other passes can take it from here, so its contents are lost after this call
+		void release(const std::shared_ptr<Framebuffer>& fbo);
+
+		/*
+		* Call once per frame, after all passes finished. Targets are transient, so the ones that weren't released are
+		* released here. Destroys targets that weren't acquired in the last MAX_UNUSED_FRAMES frames
+		*/
+		void endFrame();
+
+		// Number of framebuffers alive in the pool (in use or not)
+		size_t getNumRenderTargets() const;
+
+		// Free GPU memory of all framebuffers of the pool
+		void destroy();
+
+	private:
+		inline bool matches(const Framebuffer::Params& a, const Framebuffer::Params& b) const;
+		inline bool matches(const Framebuffer::AttachmentData& a, const Framebuffer::AttachmentData& b) const;
+
+	private:
+		static const unsigned long long MAX_UNUSED_FRAMES;
+
+		struct RenderTarget
+		{
+			Framebuffer::Params params; // Params used on creation. The framebuffer may change some of them (e.g. attached mip level)
+			std::shared_ptr<Framebuffer> fbo;
+			bool inUse;
+			unsigned long long lastUsedFrame;
+		};
+		std::vector<RenderTarget> renderTargets;
+		unsigned long long frame;
+	};
+}
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -17,7 +17,11 @@
 #include "EnvironmentMapComponent.h"
 
 #include "Framebuffer.h"
+#include "ShadowAtlas.h"
+#include "RenderTargetPool.h"
+#include "ShaderCodeBuilder.h"
 #include <memory>
+#include <functional>
 
 namespace JFF
 {
@@ -111,17 +115,65 @@ namespace JFF
 		// Gets current render path
 		virtual RenderPath getRenderPath() const = 0;
 
+		// Gets the number of frames rendered since this renderer was loaded
+		virtual unsigned long long int getFrameCount() const = 0;
+
+		// ------------- Shader variants ------------- //
+
+		/*
+		* Records a shader variant (the params a material program is generated from) used in this run.
+		* Recorded variants are saved in the shader variant manifest. The next run generates their code again and
+		* pre-compiles it while loading, so materials cooked mid-session find their program already compiled
+		*/
+		virtual void recordShaderVariant(Material::MaterialDomain domain, Material::LightModel lightModel,
+			const ShaderCodeBuilder::Params& shaderCodeParams) = 0;
+
 		// ------------ Framebuffer functions -------------- //
 
 		// Get the framebuffer used to do pre-processing
 		virtual std::weak_ptr<Framebuffer> getFramebuffer() const = 0;
 		// Get the geometry framebuffer in deferred shading. In forward shading, this pre-process FBO
 		virtual std::weak_ptr<Framebuffer> getGeometryFramebuffer() const = 0;
+		// Get the pool of transient render targets. Passes acquire their intermediate framebuffers here and release them when they finish
+		virtual std::weak_ptr<RenderTargetPool> getRenderTargetPool() const = 0;
+
+		/*
+		* Adds or removes a listener that will receive a notification when render size is changed.
+		* The returned value is needed to remove the listener
+		*/
+		virtual unsigned long long int addOnRenderSizeChangedListener(const std::function<void(int, int)>& listener) = 0;
+		virtual void removeOnRenderSizeChangedListener(unsigned long long int listenerHandler) = 0;
+
+		/*
+		* Gets the size of the framebuffers used by 3D passes, in pixels. It's the default framebuffer size scaled by
+		* dynamic resolution, which changes the scale to hold a GPU frame time
+		*/
+		virtual void getRenderSize(int& outWidth, int& outHeight) const = 0;
+		// Gets the scale of the default framebuffer size used by 3D passes. It's always 1 if dynamic resolution is disabled
+		virtual float getResolutionScale() const = 0;
 
 		// Sets the viewport size, commonly used to do custom render passes that targets to framebuffers of different sizes
 		virtual void setViewport(int x, int y, int width, int height) = 0;
-		// Restore the viewport size of the default framebuffer
+		// Restore the viewport size of the framebuffers used by 3D passes (render size)
 		virtual void restoreViewport() = 0;
+		// Restore the viewport size of the default framebuffer. Passes that upscale the result of 3D passes to the screen use it
+		virtual void restoreScreenViewport() = 0;
+		// Clears the depth buffer of the bound framebuffer inside the rectangle only
+		virtual void clearDepthBuffer(int x, int y, int width, int height) = 0;
+
+		// ------------ Shadow functions -------------- //
+
+		// Get the shadow atlas shared by the shadow maps of directional and spot lights
+		virtual std::weak_ptr<ShadowAtlas> getShadowAtlas() const = 0;
+
+		// Returns true if lights cache the shadows of static casters, so they are only rendered when something changes
+		virtual bool isShadowStaticCacheEnabled() const = 0;
+
+		/*
+		* Gets the max number of shadow views (directional light cascades, spot light shadow maps and point light cubemap faces)
+		* updated per frame. Lights that don't fit are updated in later frames. 0 means no limit
+		*/
+		virtual unsigned int getShadowUpdateBudget() const = 0;
 
 		// Enables depth test. Render passes also writes to depth buffer by default
 		virtual void enableDepthTest() = 0;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -30,18 +30,29 @@
 #include "RenderPassSpotLightingDeferred.h"
 #include "RenderPassEnvironmentLightingDeferred.h"
 #include "RenderPassEmissiveLightingDeferred.h"
+#include "ImageReadbackGLSTBI.h"
 
 #define GLEW_STATIC // Used when linked against GLEW static library
 #include "GL/glew.h"
 
 #include <stdexcept>
 #include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cmath>
 
 extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(JFF::Framebuffer::PrefabFramebuffer fboType,
 	unsigned int width, unsigned int height, unsigned int samplesPerPixel = 0);
 
 extern std::shared_ptr<JFF::INIFile> createINIFile(const char* filepath);
 
+extern std::shared_ptr<JFF::ShaderCodeBuilder> createShaderCodeBuilder(
+	JFF::Renderer::RenderPath renderPath, JFF::Material::MaterialDomain domain, JFF::Material::LightModel lightModel);
+
+const float JFF::RendererGL::RESOLUTION_SCALE_STEP = 0.1f;
+const unsigned long long int JFF::RendererGL::RESOLUTION_CHANGE_COOLDOWN_FRAMES = 30ull;
+const std::string JFF::RendererGL::SHADER_VARIANT_MANIFEST_HEADER = "JFF shader variant manifest v2";
+
 JFF::RendererGL::RendererGL() : 
 	engine(nullptr),
 	activeRenderPath(RenderPath::FORWARD),
@@ -52,13 +63,43 @@ JFF::RendererGL::RendererGL() :
 	fbHeight(0),
 	samplesPerPixel(0),
 
+	renderWidth(0),
+	renderHeight(0),
+	dynamicResolutionEnabled(false),
+	dynamicResolutionTargetMs(0.0f),
+	dynamicResolutionMinScale(1.0f),
+	resolutionScale(1.0f),
+	smoothedGPUFrameTimeMs(0.0f),
+	lastResolutionChangeFrame(0ull),
+	gpuTimerQueries(),
+
+	renderSizeCallbacks(),
+	renderSizeCallbackIndex(0ull),
+
+	renderTargetPool(),
+
+	shadowAtlas(),
+	shadowAtlasSize(0u),
+	shadowAtlasMinRegionSize(0u),
+	shadowStaticCacheEnabled(false),
+	shadowUpdateBudget(0u),
+
 	framebufferCallbackHandler(0ull),
+	frameCount(0ull),
 
 	maxPointLightsForwardShading(0),
 	maxDirectionalLightsForwardShading(0),
 	maxSpotLightsForwardShading(0),
 
-	maxEnvironmentMapsForwardShading(1)
+	maxEnvironmentMapsForwardShading(1),
+
+	shaderVariantManifestEnabled(false),
+	shaderVariantManifestPath(),
+	shaderVariants(),
+	shaderVariantKeys(),
+	prewarmedTemplates(),
+
+	visibleRenderables()
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor subsystem: RendererGL")
 }
@@ -72,6 +113,22 @@ JFF::RendererGL::~RendererGL()
 
 	// Destroy framebuffers
 	std::for_each(FBOs.begin(), FBOs.end(), [](auto& fbo) { fbo->destroy(); });
+	if (renderTargetPool)
+		renderTargetPool->destroy();
+
+	if (dynamicResolutionEnabled)
+		glDeleteQueries(NUM_GPU_TIMER_QUERIES, gpuTimerQueries);
+
+	// Write pending captures to disk and free their pixel buffers while the graphics context is alive
+	ImageReadbackGLSTBI::getInstance().destroy();
+	if (shadowAtlas)
+		shadowAtlas->destroy();
+
+	// Save shader variants of previous runs and this one, and release pre-compiled programs (if no frame was rendered)
+	if (shaderVariantManifestEnabled)
+		saveShaderVariantManifest();
+
+	releasePrewarmedShaderVariants();
 }
 
 void JFF::RendererGL::load()
@@ -88,6 +145,15 @@ void JFF::RendererGL::load()
 	maxPointLightsForwardShading = params.maxPointLightsForwardShading;
 	maxDirectionalLightsForwardShading = params.maxDirectionalLightsForwardShading;
 	maxSpotLightsForwardShading = params.maxSpotLightsForwardShading;
+	shaderVariantManifestEnabled = params.shaderVariantManifestEnabled;
+	shaderVariantManifestPath = params.shaderVariantManifestPath;
+	shadowAtlasSize = params.shadowAtlasSize;
+	shadowAtlasMinRegionSize = params.shadowAtlasMinRegionSize;
+	shadowStaticCacheEnabled = params.shadowStaticCacheEnabled;
+	shadowUpdateBudget = params.shadowUpdateBudget;
+	dynamicResolutionEnabled = params.dynamicResolutionEnabled;
+	dynamicResolutionTargetMs = params.dynamicResolutionTargetMs;
+	dynamicResolutionMinScale = std::min(std::max(params.dynamicResolutionMinScale, RESOLUTION_SCALE_STEP), 1.0f);
 
 	JFF_LOG_INFO("Render path: " << (activeRenderPath == RenderPath::FORWARD ? "FORWARD" : "DEFERRED"))
 
@@ -123,6 +189,13 @@ void JFF::RendererGL::load()
 		glDebugMessageCallbackARB(callback, (void*)0);
 	}
 
+	// Let the driver compile shaders in as many threads as it wants. Materials poll completion instead of blocking
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		JFF_LOG_INFO("Parallel shader compilation is enabled")
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+	}
+
 	// ------------------------------------ Enable MSAA if it's available ------------------------------------ //
 
 	glGetIntegerv(GL_SAMPLES, &samplesPerPixel);
@@ -197,8 +270,10 @@ void JFF::RendererGL::postLoad(Engine* engine)
 
 	// ------------------------------------ DEFINE FRAMEBUFFERS ------------------------------------ //
 
-	// Retrieve default framebuffer size from context
+	// Retrieve default framebuffer size from context. 3D passes start at full resolution
 	this->engine->context.lock()->getFramebufferSizeInPixels(fbWidth, fbHeight);
+	renderWidth = fbWidth;
+	renderHeight = fbHeight;
 
 	// Set OpenGL Viewport size, in pixels. This size will be used from clip to window space
 	restoreViewport();
@@ -208,16 +283,24 @@ void JFF::RendererGL::postLoad(Engine* engine)
 	{
 	case JFF::Renderer::RenderPath::FORWARD:
 		// This will create a multisample or normal framebuffer depending on the number of samples per pixel (>=2 -> multisample)
-		FBOs.push_back(createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_PRE_PROCESS_FORWARD, fbWidth, fbHeight, samplesPerPixel));
+		FBOs.push_back(createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_PRE_PROCESS_FORWARD, renderWidth, renderHeight, samplesPerPixel));
 		break;
 	case JFF::Renderer::RenderPath::DEFERRED:
 		// This will create a framebuffer which stores geometry data and another to calculate light contributions
-		FBOs.push_back(createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_GEOMETRY_DEFERRED, fbWidth, fbHeight, samplesPerPixel));
-		FBOs.push_back(createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_LIGHTING_DEFERRED, fbWidth, fbHeight, samplesPerPixel));
+		FBOs.push_back(createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_GEOMETRY_DEFERRED, renderWidth, renderHeight, samplesPerPixel));
+		FBOs.push_back(createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_LIGHTING_DEFERRED, renderWidth, renderHeight, samplesPerPixel));
 		break;
 	default:
 		break;
 	}
+
+	// Transient framebuffers are created on demand by the passes that use them
+	renderTargetPool = std::make_shared<RenderTargetPool>();
+
+	// All directional and spot lights render their shadow maps in a region of this atlas
+	GLint maxTextureSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	shadowAtlas = std::make_shared<ShadowAtlas>(shadowAtlasSize, (unsigned int)maxTextureSize, shadowAtlasMinRegionSize, shadowStaticCacheEnabled);
 	
 	// Register framebuffer size changes and adapt Viewport and fbo to the new window size
 	framebufferCallbackHandler = engine->context.lock()->addOnFramebufferSizeChangedListener([this](int width, int height)
@@ -228,10 +311,17 @@ void JFF::RendererGL::postLoad(Engine* engine)
 			fbWidth = width;
 			fbHeight = height;
 
+			updateRenderSize(); // Keep the same resolution scale
 			restoreViewport();
-			std::for_each(FBOs.begin(), FBOs.end(), [this](auto& fbo) { fbo->setSize(fbWidth, fbHeight); });
 		});
 
+	// GPU frame time drives the resolution scale
+	if (dynamicResolutionEnabled)
+	{
+		glGenQueries(NUM_GPU_TIMER_QUERIES, gpuTimerQueries);
+		JFF_LOG_INFO("Dynamic resolution is enabled. Target GPU frame time: " << dynamicResolutionTargetMs << "ms Min scale: " << dynamicResolutionMinScale)
+	}
+
 	// --------------- CONFIGURE SOME ASPECTS OF OPENGL FIXED PIPELINE --------------- //
 
 	// Color buffer config
@@ -255,6 +345,15 @@ void JFF::RendererGL::postLoad(Engine* engine)
 
 	// Polygon mode
 	disableWireframeMode();
+
+	// ------------------------------------ PRE-COMPILE SHADER VARIANTS ------------------------------------ //
+
+	// Programs used in previous runs are submitted now, during loading, instead of when their materials are cooked
+	if (shaderVariantManifestEnabled)
+	{
+		loadShaderVariantManifest();
+		prewarmShaderVariants();
+	}
 }
 
 JFF::Subsystem::UnloadOrder JFF::RendererGL::getUnloadOrder() const
@@ -269,6 +368,10 @@ JFF::ExecutableSubsystem::ExecutionOrder JFF::RendererGL::getExecutionOrder() co
 
 bool JFF::RendererGL::execute()
 {
+	beginGPUFrameTimer();
+
+	cullRenderables();
+
 	switch (activeRenderPath)
 	{
 	case JFF::Renderer::RenderPath::FORWARD:
@@ -281,6 +384,23 @@ bool JFF::RendererGL::execute()
 		break;
 	}
 
+	endGPUFrameTimer();
+
+	// Release leaked transient targets and destroy the ones nobody used lately (e.g. sized for a previous resolution)
+	renderTargetPool->endFrame();
+
+	// Changes of scale are applied to the next frame
+	updateResolutionScale();
+
+	// Send the captures whose pixels already reached their buffers to the encoding thread
+	ImageReadbackGLSTBI::getInstance().update();
+
+	// Materials of the first scene are cooked by now. Pre-compiled programs that none of them claimed aren't kept all session
+	if (frameCount == 0ull)
+		releasePrewarmedShaderVariants();
+
+	++frameCount;
+
 	return true;
 }
 
@@ -449,6 +569,20 @@ JFF::Renderer::RenderPath JFF::RendererGL::getRenderPath() const
 	return activeRenderPath;
 }
 
+void JFF::RendererGL::recordShaderVariant(Material::MaterialDomain domain, Material::LightModel lightModel,
+	const ShaderCodeBuilder::Params& shaderCodeParams)
+{
+	if (!shaderVariantManifestEnabled)
+		return;
+
+	addShaderVariant({ domain, lightModel, shaderCodeParams });
+}
+
+unsigned long long int JFF::RendererGL::getFrameCount() const
+{
+	return frameCount;
+}
+
 std::weak_ptr<JFF::Framebuffer> JFF::RendererGL::getFramebuffer() const
 {
 	return FBOs.back();
@@ -459,16 +593,76 @@ std::weak_ptr<JFF::Framebuffer> JFF::RendererGL::getGeometryFramebuffer() const
 	return FBOs[0];
 }
 
+std::weak_ptr<JFF::RenderTargetPool> JFF::RendererGL::getRenderTargetPool() const
+{
+	return renderTargetPool;
+}
+
+unsigned long long int JFF::RendererGL::addOnRenderSizeChangedListener(const std::function<void(int, int)>& listener)
+{
+	renderSizeCallbacks[renderSizeCallbackIndex] = listener;
+	return renderSizeCallbackIndex++;
+}
+
+void JFF::RendererGL::removeOnRenderSizeChangedListener(unsigned long long int listenerHandler)
+{
+	auto numErased = renderSizeCallbacks.erase(listenerHandler);
+	if (numErased == 0)
+	{
+		JFF_LOG_WARNING("Couldn't remove Renderer render size listener. Listener with given handler was not found. Aborted")
+	}
+}
+
+void JFF::RendererGL::getRenderSize(int& outWidth, int& outHeight) const
+{
+	outWidth = renderWidth;
+	outHeight = renderHeight;
+}
+
+float JFF::RendererGL::getResolutionScale() const
+{
+	return resolutionScale;
+}
+
 void JFF::RendererGL::setViewport(int x, int y, int width, int height)
 {
 	glViewport(x, y, width, height);
 }
 
 void JFF::RendererGL::restoreViewport()
+{
+	glViewport(0, 0, renderWidth, renderHeight);
+}
+
+void JFF::RendererGL::restoreScreenViewport()
 {
 	glViewport(0, 0, fbWidth, fbHeight);
 }
 
+void JFF::RendererGL::clearDepthBuffer(int x, int y, int width, int height)
+{
+	// Scissor test limits glClear() to the rectangle
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(x, y, width, height);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+}
+
+std::weak_ptr<JFF::ShadowAtlas> JFF::RendererGL::getShadowAtlas() const
+{
+	return shadowAtlas;
+}
+
+bool JFF::RendererGL::isShadowStaticCacheEnabled() const
+{
+	return shadowStaticCacheEnabled;
+}
+
+unsigned int JFF::RendererGL::getShadowUpdateBudget() const
+{
+	return shadowUpdateBudget;
+}
+
 void JFF::RendererGL::enableDepthTest()
 {
 	glEnable(GL_DEPTH_TEST);
@@ -626,9 +820,204 @@ inline JFF::RendererGL::Params JFF::RendererGL::loadConfigFile() const
 	params.maxPointLightsForwardShading			= INIFile->has("renderer", "max-point-lights") ? INIFile->getInt("renderer", "max-point-lights") : 4;
 	params.maxSpotLightsForwardShading			= INIFile->has("renderer", "max-spot-lights") ? INIFile->getInt("renderer", "max-spot-lights") : 4;
 
+	params.shaderVariantManifestEnabled = INIFile->has("renderer", "shader-variant-manifest") ? 
+		INIFile->getString("renderer", "shader-variant-manifest") != "OFF" : true;
+	params.shaderVariantManifestPath = INIFile->has("renderer", "shader-variant-manifest-path") ?
+		INIFile->getString("renderer", "shader-variant-manifest-path") : "Config/ShaderVariants";
+
+	params.shadowAtlasSize			= INIFile->has("renderer", "shadow-atlas-size") ? INIFile->getInt("renderer", "shadow-atlas-size") : 4096;
+	params.shadowAtlasMinRegionSize	= INIFile->has("renderer", "shadow-atlas-min-region-size") ? INIFile->getInt("renderer", "shadow-atlas-min-region-size") : 256;
+	params.shadowStaticCacheEnabled = INIFile->has("renderer", "shadow-static-cache") ?
+		INIFile->getString("renderer", "shadow-static-cache") == "ON" : false;
+	params.shadowUpdateBudget = INIFile->has("renderer", "shadow-update-budget") ? INIFile->getInt("renderer", "shadow-update-budget") : 0;
+
+	params.dynamicResolutionEnabled = INIFile->has("renderer", "dynamic-resolution") ?
+		INIFile->getString("renderer", "dynamic-resolution") != "OFF" : false;
+	params.dynamicResolutionTargetMs = INIFile->has("renderer", "dynamic-resolution-target-ms") ? INIFile->getFloat("renderer", "dynamic-resolution-target-ms") : 16.6f;
+	params.dynamicResolutionMinScale = INIFile->has("renderer", "dynamic-resolution-min-scale") ? INIFile->getFloat("renderer", "dynamic-resolution-min-scale") : 0.5f;
+
 	return params;
 }
 
+inline std::string JFF::RendererGL::getShaderVariantManifestPath() const
+{
+	// Each render path generates different shader code, so each one has its own manifest
+	std::string manifestPath = std::string("Assets") + JFF_SLASH_STRING + toPlatformPath(shaderVariantManifestPath);
+	return manifestPath + (activeRenderPath == RenderPath::DEFERRED ? "Deferred.manifest" : "Forward.manifest");
+}
+
+inline void JFF::RendererGL::loadShaderVariantManifest()
+{
+	std::ifstream file(getShaderVariantManifestPath(), std::ios::binary);
+	if (!file.is_open())
+	{
+		JFF_LOG_INFO("No shader variant manifest found. It will be created when the renderer is destroyed")
+		return;
+	}
+
+	std::string header;
+	if (!std::getline(file, header) || header != SHADER_VARIANT_MANIFEST_HEADER)
+	{
+		JFF_LOG_WARNING("Shader variant manifest has an unknown format. It will be replaced when the renderer is destroyed")
+		return;
+	}
+
+	ShaderVariant variant;
+	while (readShaderVariant(file, variant))
+		addShaderVariant(variant);
+
+	if (!file.eof())
+	{
+		JFF_LOG_WARNING("Shader variant manifest is corrupted. Ignoring the rest of its variants")
+	}
+}
+
+inline void JFF::RendererGL::saveShaderVariantManifest() const
+{
+	std::ofstream file(getShaderVariantManifestPath(), std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		JFF_LOG_WARNING("Shader variant manifest couldn't be saved")
+		return;
+	}
+
+	// Variants loaded from the manifest are kept, so scenarios not visited in this run don't lose theirs
+	file << SHADER_VARIANT_MANIFEST_HEADER << '\n';
+	for (const ShaderVariant& variant : shaderVariants)
+		writeShaderVariant(file, variant);
+
+	JFF_LOG_INFO("Shader variant manifest saved with " << shaderVariants.size() << " variants")
+}
+
+inline void JFF::RendererGL::addShaderVariant(const ShaderVariant& variant)
+{
+	// A variant is identified by all the params stored in the manifest
+	std::ostringstream key;
+	writeShaderVariant(key, variant);
+	if (!shaderVariantKeys.insert(key.str()).second)
+		return;
+
+	shaderVariants.push_back(variant);
+}
+
+inline void JFF::RendererGL::prewarmShaderVariants()
+{
+	auto cache = engine->cache.lock();
+	auto context = engine->context.lock();
+
+	/*
+	* Code is generated by the same builders used by materials, with the shader version and max lights of this run.
+	* Compilation is only submitted here, so the driver compiles all variants while the scene is loading
+	* (in parallel if GL_KHR_parallel_shader_compile is available). Materials cooked later take them from the cache
+	*/
+	for (const ShaderVariant& variant : shaderVariants)
+	{
+		ShaderCodeBuilder::Params shaderCodeParams = variant.shaderCodeParams;
+		shaderCodeParams.shaderVersionMajor = context->getGraphicsAPIVersionMajor();
+		shaderCodeParams.shaderVersionMinor = context->getGraphicsAPIVersionMinor();
+		shaderCodeParams.shaderVersionRevision = context->getGraphicsAPIRevisionNumber();
+		shaderCodeParams.shaderProfile = context->getGraphicsAPIContexProfile();
+		shaderCodeParams.maxDirLights = getForwardShadingMaxDirectionalLights();
+		shaderCodeParams.maxPointLights = getForwardShadingMaxPointLights();
+		shaderCodeParams.maxSpotLights = getForwardShadingMaxSpotLights();
+
+		std::string vertexShaderCode;
+		std::string geometryShaderCode;
+		std::string fragmentShaderCode;
+		createShaderCodeBuilder(activeRenderPath, variant.domain, variant.lightModel)->generateCode(shaderCodeParams,
+			vertexShaderCode, geometryShaderCode, fragmentShaderCode);
+
+		std::string cacheName;
+		if (MaterialTemplateGL::findCachedTemplate(*cache, vertexShaderCode, geometryShaderCode, fragmentShaderCode, cacheName))
+			continue;
+
+		auto materialTemplate = std::make_shared<MaterialTemplateGL>(cacheName,
+			vertexShaderCode, geometryShaderCode, fragmentShaderCode, frameCount);
+		cache->addCacheItem(materialTemplate);
+		prewarmedTemplates.push_back(materialTemplate);
+	}
+
+	JFF_LOG_INFO("Pre-compiling " << prewarmedTemplates.size() << " shader variants")
+}
+
+inline void JFF::RendererGL::releasePrewarmedShaderVariants()
+{
+	// The cache only releases items without other owners, so references held here are dropped first. Claimed programs stay
+	std::vector<std::string> prewarmedCacheNames;
+	prewarmedCacheNames.reserve(prewarmedTemplates.size());
+	for (const auto& materialTemplate : prewarmedTemplates)
+		prewarmedCacheNames.push_back(materialTemplate->getCacheName());
+	prewarmedTemplates.clear();
+
+	auto cache = engine->cache.lock();
+	for (const std::string& cacheName : prewarmedCacheNames)
+		cache->releaseCacheItem(cacheName);
+}
+
+inline void JFF::RendererGL::writeShaderVariant(std::ostream& stream, const ShaderVariant& variant)
+{
+	/*
+	* Each variant is a line of params followed by its custom code, stored raw. Texture and cubemap names are GLSL identifiers:
+	* <domain> <light model> <debug display> <use normal map> <PBR workflow> <num textures> <textures...>
+	* <num cubemaps> <cubemaps...> <custom code size>\n<custom code>
+	*/
+	const ShaderCodeBuilder::Params& params = variant.shaderCodeParams;
+	stream << (int)variant.domain << ' ' << (int)variant.lightModel << ' ' << (int)params.debugDisplay << ' '
+		<< (params.useNormalMap ? 1 : 0) << ' ' << (int)params.pbrWorkflow;
+
+	stream << ' ' << params.textures.size();
+	for (const std::string& texture : params.textures)
+		stream << ' ' << texture;
+
+	stream << ' ' << params.cubemaps.size();
+	for (const std::string& cubemap : params.cubemaps)
+		stream << ' ' << cubemap;
+
+	stream << ' ' << params.customCode.size() << '\n' << params.customCode;
+}
+
+inline bool JFF::RendererGL::readShaderVariant(std::istream& stream, ShaderVariant& outVariant)
+{
+	ShaderCodeBuilder::Params& params = outVariant.shaderCodeParams;
+
+	int domain, lightModel, debugDisplay, useNormalMap, pbrWorkflow;
+	if (!(stream >> domain >> lightModel >> debugDisplay >> useNormalMap >> pbrWorkflow))
+		return false;
+
+	outVariant.domain = (Material::MaterialDomain)domain;
+	outVariant.lightModel = (Material::LightModel)lightModel;
+	params.debugDisplay = (ShaderCodeBuilder::DebugDisplay)debugDisplay;
+	params.useNormalMap = useNormalMap != 0;
+	params.pbrWorkflow = (ShaderCodeBuilder::PBRWorkflow)pbrWorkflow;
+
+	size_t numTextures;
+	if (!(stream >> numTextures))
+		return false;
+
+	params.textures.resize(numTextures);
+	for (std::string& texture : params.textures)
+		stream >> texture;
+
+	size_t numCubemaps;
+	if (!(stream >> numCubemaps))
+		return false;
+
+	params.cubemaps.resize(numCubemaps);
+	for (std::string& cubemap : params.cubemaps)
+		stream >> cubemap;
+
+	size_t customCodeSize;
+	if (!(stream >> customCodeSize))
+		return false;
+
+	stream.get(); // Skip line break before custom code
+	params.customCode.resize(customCodeSize);
+	if (customCodeSize > 0)
+		stream.read(&params.customCode[0], customCodeSize);
+
+	return (bool)stream;
+}
+
 inline void JFF::RendererGL::executeForward()
 {
 	// ----------------- SHADOW CAST RENDER PASS ----------------- //
@@ -658,6 +1047,7 @@ inline void JFF::RendererGL::executeForward()
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	restoreScreenViewport(); // Upscales the result of 3D passes if they use a lower resolution
 
 	renderables[Material::MaterialDomain::RENDER_TO_SCREEN]->execute();
 }
@@ -724,6 +1114,98 @@ inline void JFF::RendererGL::executeDeferred()
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	restoreScreenViewport(); // Upscales the result of 3D passes if they use a lower resolution
 
 	renderables[Material::MaterialDomain::RENDER_TO_SCREEN]->execute();
 }
+
+inline void JFF::RendererGL::cullRenderables()
+{
+	// Mark renderables inside the camera frustum as visible this frame. Render passes skip the rest, except shadow casting ones
+	std::shared_ptr<Spatial> spatial = engine->spatial.lock();
+	std::shared_ptr<Camera> camera = engine->camera.lock();
+	if (!spatial || !camera || !camera->hasAnyActiveCamera())
+		return; // Nothing is drawn without an active camera
+
+	Frustum frustum(camera->getActiveCameraProjectionMatrix() * camera->getActiveCameraViewMatrix());
+
+	visibleRenderables.clear();
+	spatial->queryFrustum(frustum, Spatial::RENDERABLE, visibleRenderables);
+	for (Component* renderable : visibleRenderables)
+		static_cast<RenderComponent*>(renderable)->setVisibleFrame(frameCount);
+}
+
+inline void JFF::RendererGL::beginGPUFrameTimer()
+{
+	if (!dynamicResolutionEnabled)
+		return;
+
+	glBeginQuery(GL_TIME_ELAPSED, gpuTimerQueries[frameCount % NUM_GPU_TIMER_QUERIES]);
+}
+
+inline void JFF::RendererGL::endGPUFrameTimer()
+{
+	if (!dynamicResolutionEnabled)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+}
+
+inline void JFF::RendererGL::updateResolutionScale()
+{
+	if (!dynamicResolutionEnabled || frameCount + 1 < NUM_GPU_TIMER_QUERIES)
+		return;
+
+	// Read the oldest query, which will be reused next frame. If the GPU is still behind, skip this measure
+	GLuint query = gpuTimerQueries[(frameCount + 1) % NUM_GPU_TIMER_QUERIES];
+	GLint available = 0;
+	glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+		return;
+
+	GLuint64 elapsedNanoseconds = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNanoseconds);
+	float gpuFrameTimeMs = (float)elapsedNanoseconds * 1.0e-6f;
+
+	// Smooth the measures, so single frame spikes don't change the resolution
+	smoothedGPUFrameTimeMs = smoothedGPUFrameTimeMs > 0.0f ? 
+		smoothedGPUFrameTimeMs + (gpuFrameTimeMs - smoothedGPUFrameTimeMs) * 0.1f : gpuFrameTimeMs;
+
+	if (frameCount - lastResolutionChangeFrame < RESOLUTION_CHANGE_COOLDOWN_FRAMES || smoothedGPUFrameTimeMs <= 0.0f)
+		return;
+
+	/*
+	* GPU time grows with the number of pixels, which is proportional to the square of the scale.
+	* Rounding down to a step drops the scale as soon as the target is exceeded, but raises it only with enough headroom
+	*/
+	float idealScale = resolutionScale * std::sqrt(dynamicResolutionTargetMs / smoothedGPUFrameTimeMs);
+	float newScale = std::floor(idealScale / RESOLUTION_SCALE_STEP + 0.001f) * RESOLUTION_SCALE_STEP;
+	newScale = std::min(std::max(newScale, dynamicResolutionMinScale), 1.0f);
+
+	if (std::abs(newScale - resolutionScale) < RESOLUTION_SCALE_STEP * 0.5f)
+		return;
+
+	JFF_LOG_INFO("Dynamic resolution scale: " << resolutionScale << " -> " << newScale << " GPU frame time: " << smoothedGPUFrameTimeMs << "ms")
+
+	resolutionScale = newScale;
+	lastResolutionChangeFrame = frameCount;
+	updateRenderSize();
+}
+
+inline void JFF::RendererGL::updateRenderSize()
+{
+	int width = std::max(1, (int)std::lround(fbWidth * resolutionScale));
+	int height = std::max(1, (int)std::lround(fbHeight * resolutionScale));
+	if (width == renderWidth && height == renderHeight)
+		return;
+
+	renderWidth = width;
+	renderHeight = height;
+
+	// Framebuffers of 3D passes and the ones that depend on them (e.g. post-process FX) are created again
+	std::for_each(FBOs.begin(), FBOs.end(), [this](auto& fbo) { fbo->setSize(renderWidth, renderHeight); });
+	std::for_each(renderSizeCallbacks.begin(), renderSizeCallbacks.end(), [this](const auto& pair)
+		{
+			pair.second(renderWidth, renderHeight);
+		});
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,9 +12,12 @@
 
 #include "Renderer.h"
 #include "RenderPass.h"
+#include "MaterialTemplateGL.h"
 
 #include <vector>
 #include <map>
+#include <unordered_set>
+#include <iosfwd>
 
 namespace JFF
 {
@@ -87,17 +90,61 @@ namespace JFF
 		// Gets current render path
 		virtual RenderPath getRenderPath() const override;
 
+		// Gets the number of frames rendered since this renderer was loaded
+		virtual unsigned long long int getFrameCount() const override;
+
+		// ------------- Shader variants ------------- //
+
+		// Records a shader variant used in this run. It's saved in the shader variant manifest when this renderer is destroyed
+		virtual void recordShaderVariant(Material::MaterialDomain domain, Material::LightModel lightModel,
+			const ShaderCodeBuilder::Params& shaderCodeParams) override;
+
 		// ------------ Framebuffer functions -------------- //
 
 		// Get the framebuffer used to do pre-processing
 		virtual std::weak_ptr<Framebuffer> getFramebuffer() const override;
 		// Get the geometry framebuffer in deferred shading. In forward shading, this pre-process FBO
 		virtual std::weak_ptr<Framebuffer> getGeometryFramebuffer() const override;
+		// Get the pool of transient render targets. Passes acquire their intermediate framebuffers here and release them when they finish
+		virtual std::weak_ptr<RenderTargetPool> getRenderTargetPool() const override;
+
+		/*
+		* Adds or removes a listener that will receive a notification when render size is changed.
+		* The returned value is needed to remove the listener
+		*/
+		virtual unsigned long long int addOnRenderSizeChangedListener(const std::function<void(int, int)>& listener) override;
+		virtual void removeOnRenderSizeChangedListener(unsigned long long int listenerHandler) override;
+
+		/*
+		* Gets the size of the framebuffers used by 3D passes, in pixels. It's the default framebuffer size scaled by
+		* dynamic resolution, which changes the scale to hold a GPU frame time
+		*/
+		virtual void getRenderSize(int& outWidth, int& outHeight) const override;
+		// Gets the scale of the default framebuffer size used by 3D passes. It's always 1 if dynamic resolution is disabled
+		virtual float getResolutionScale() const override;
 
 		// Sets the viewport size, commonly used to do custom render passes that targets to framebuffers of different sizes
 		virtual void setViewport(int x, int y, int width, int height) override;
-		// Restore the viewport size of the default framebuffer
+		// Restore the viewport size of the framebuffers used by 3D passes (render size)
 		virtual void restoreViewport() override;
+		// Restore the viewport size of the default framebuffer. Passes that upscale the result of 3D passes to the screen use it
+		virtual void restoreScreenViewport() override;
+		// Clears the depth buffer of the bound framebuffer inside the rectangle only
+		virtual void clearDepthBuffer(int x, int y, int width, int height) override;
+
+		// ------------ Shadow functions -------------- //
+
+		// Get the shadow atlas shared by the shadow maps of directional and spot lights
+		virtual std::weak_ptr<ShadowAtlas> getShadowAtlas() const override;
+
+		// Returns true if lights cache the shadows of static casters, so they are only rendered when something changes
+		virtual bool isShadowStaticCacheEnabled() const override;
+
+		/*
+		* Gets the max number of shadow views (directional light cascades, spot light shadow maps and point light cubemap faces)
+		* updated per frame. Lights that don't fit are updated in later frames. 0 means no limit
+		*/
+		virtual unsigned int getShadowUpdateBudget() const override;
 
 		// Enables depth test. Render passes also writes to depth buffer by default
 		virtual void enableDepthTest() override;
@@ -138,10 +185,46 @@ namespace JFF
 			int maxPointLightsForwardShading;
 			int maxDirectionalLightsForwardShading;
 			int maxSpotLightsForwardShading;
+
+			bool shaderVariantManifestEnabled;
+			std::string shaderVariantManifestPath;
+
+			unsigned int shadowAtlasSize;
+			unsigned int shadowAtlasMinRegionSize;
+			bool shadowStaticCacheEnabled;
+			unsigned int shadowUpdateBudget;
+
+			bool dynamicResolutionEnabled;
+			float dynamicResolutionTargetMs;
+			float dynamicResolutionMinScale;
 		};
 		inline Params loadConfigFile() const;
+
+		/*
+		* Params a material program is generated from, as stored in the shader variant manifest. Shader version and
+		* max lights aren't stored: code is generated again with the ones of the running context and renderer
+		*/
+		struct ShaderVariant
+		{
+			Material::MaterialDomain domain;
+			Material::LightModel lightModel;
+			ShaderCodeBuilder::Params shaderCodeParams;
+		};
+		inline std::string getShaderVariantManifestPath() const;
+		inline void loadShaderVariantManifest();
+		inline void saveShaderVariantManifest() const;
+		inline void addShaderVariant(const ShaderVariant& variant);
+		inline void prewarmShaderVariants();
+		inline void releasePrewarmedShaderVariants();
+		inline static void writeShaderVariant(std::ostream& stream, const ShaderVariant& variant);
+		inline static bool readShaderVariant(std::istream& stream, ShaderVariant& outVariant);
 		inline void executeForward();
 		inline void executeDeferred();
+		inline void cullRenderables();
+		inline void beginGPUFrameTimer();
+		inline void endGPUFrameTimer();
+		inline void updateResolutionScale();
+		inline void updateRenderSize();
 
 	protected:
 		Engine* engine;
@@ -154,12 +237,50 @@ namespace JFF
 		int fbWidth, fbHeight;
 		int samplesPerPixel;
 
+		// Dynamic resolution: FBOs of 3D passes have a scale of default framebuffer size, adjusted from the GPU frame time
+		static const int NUM_GPU_TIMER_QUERIES = 4; // Results are read NUM_GPU_TIMER_QUERIES - 1 frames later, so CPU never waits for GPU
+		static const float RESOLUTION_SCALE_STEP; // Scale changes in steps, so framebuffers aren't created again for small variations
+		static const unsigned long long int RESOLUTION_CHANGE_COOLDOWN_FRAMES; // Frames to measure the new scale before changing it again
+		int renderWidth, renderHeight;
+		bool dynamicResolutionEnabled;
+		float dynamicResolutionTargetMs;
+		float dynamicResolutionMinScale;
+		float resolutionScale;
+		float smoothedGPUFrameTimeMs;
+		unsigned long long int lastResolutionChangeFrame;
+		GLuint gpuTimerQueries[NUM_GPU_TIMER_QUERIES];
+
+		std::map<unsigned long long int, std::function<void(int, int)>> renderSizeCallbacks;
+		unsigned long long int renderSizeCallbackIndex; // Uniquely identifies each render size callback function inside renderSizeCallbacks map
+
+		// Intermediate framebuffers of passes that only need them while they execute (e.g. post-process FX)
+		std::shared_ptr<RenderTargetPool> renderTargetPool;
+
+		// Shadow maps of directional and spot lights. Created with the sizes of the config file
+		std::shared_ptr<ShadowAtlas> shadowAtlas;
+		unsigned int shadowAtlasSize;
+		unsigned int shadowAtlasMinRegionSize;
+		bool shadowStaticCacheEnabled;
+		unsigned int shadowUpdateBudget;
+
 		unsigned long long int framebufferCallbackHandler;
+		unsigned long long int frameCount;
 
 		int maxPointLightsForwardShading;
 		int maxDirectionalLightsForwardShading;
 		int maxSpotLightsForwardShading;
 		
 		const int maxEnvironmentMapsForwardShading;
+
+		// Shader variant manifest: programs used by previous runs are pre-compiled on load. Variants of this run are added to them
+		static const std::string SHADER_VARIANT_MANIFEST_HEADER; // First line of the manifest. Manifests of other formats are ignored
+		bool shaderVariantManifestEnabled;
+		std::string shaderVariantManifestPath; // Relative to the assets folder, without the render path suffix and extension
+		std::vector<ShaderVariant> shaderVariants; // Loaded from the manifest and recorded in this run
+		std::unordered_set<std::string> shaderVariantKeys; // shaderVariants as written in the manifest, to avoid duplicates
+		std::vector<std::shared_ptr<MaterialTemplateGL>> prewarmedTemplates; // Released after the first frame if no material claimed them
+
+		// Result of the frustum query of the current frame. Reused every frame to avoid allocations
+		std::vector<Component*> visibleRenderables;
 	};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -19,7 +19,8 @@
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name);
 
 JFF::Scene::Scene(Engine* const engine, const char* name) :
-	name(name)
+	name(name),
+	storage()
 {
 	JFF_LOG_INFO("Ctor Scene")
 
@@ -71,21 +72,31 @@ JFF::Scene::Scene(Engine* const engine, const char* name) :
 
 	// Add the root node to this scene
 	addNode(rootNodeObj);
+	storage.add(rootNodeObj);
 }
 
 JFF::Scene::~Scene()
 {
 	JFF_LOG_INFO("Dtor Scene")
+
+	// GameObjects may outlive the storage (it's destroyed before the graph nodes)
+	storage.clear();
 }
 
 void JFF::Scene::add(const std::shared_ptr<GameObject>& newObject)
 {
-	addNodeConnected(rootNode.lock(), newObject);
+	if (!addNodeConnected(rootNode.lock(), newObject))
+		return;
+
 	newObject->findParent();
+	storage.add(newObject);
 }
 
 void JFF::Scene::attach(const std::shared_ptr<GameObject>& parent, const std::shared_ptr<GameObject>& newObject)
 {
-	addNodeConnected(parent, newObject);
+	if (!addNodeConnected(parent, newObject))
+		return;
+
 	newObject->findParent();
+	storage.add(newObject);
 }
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,6 +12,7 @@
 
 #include "TreeGraph.h"
 #include "GameObject.h"
+#include "SceneStorage.h"
 
 namespace JFF
 {
@@ -39,7 +40,11 @@ namespace JFF
 		*/
 		virtual void attach(const std::shared_ptr<GameObject>& parent, const std::shared_ptr<GameObject>& newObject);
 
+		// Contiguous storage of this scene's GameObjects, used by per-frame systems to iterate them linearly
+		SceneStorage& getStorage() { return storage; }
+
 	protected:
 		std::string name;
+		SceneStorage storage;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,361 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "SceneStorage.h"
+
+#include "GameObject.h"
+#include "Log.h"
+
+#include <algorithm>
+
+JFF::SceneStorage::SceneStorage() :
+	sparse(),
+	freeHandles(),
+	childHandles(),
+
+	handles(),
+	gameObjects(),
+	parents(),
+	enabled(),
+	activeInHierarchy(),
+	dirtyTransforms(),
+	worldModelMatrices(),
+	worldRotationMatrices(),
+	transformVersions(),
+
+	nameIndex(),
+	tagIndex()
+{
+	JFF_LOG_INFO("Ctor SceneStorage")
+}
+
+JFF::SceneStorage::~SceneStorage()
+{
+	JFF_LOG_INFO("Dtor SceneStorage")
+
+	clear();
+}
+
+void JFF::SceneStorage::add(const std::shared_ptr<GameObject>& gameObject)
+{
+	if (gameObject->storage)
+	{
+		JFF_LOG_WARNING("GameObject " << gameObject->getName() << " is already stored in a scene. Operation aborted")
+		return;
+	}
+
+	// Parent must be stored before its children to keep parent-before-child order
+	int parentIndex = -1;
+	std::shared_ptr<GameObject> parent = gameObject->parent.lock();
+	if (parent)
+	{
+		if (parent->storage != this)
+		{
+			JFF_LOG_ERROR("Parent of GameObject " << gameObject->getName() << " isn't stored in this scene. Operation aborted")
+			return;
+		}
+
+		parentIndex = (int)sparse[parent->storageHandle];
+	}
+
+	// Reuse a free handle if possible
+	unsigned int handle;
+	if (!freeHandles.empty())
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else
+	{
+		handle = (unsigned int)sparse.size();
+		sparse.push_back(INVALID_HANDLE);
+		childHandles.emplace_back();
+	}
+
+	if (parent)
+		childHandles[parent->storageHandle].push_back(handle);
+
+	sparse[handle] = (unsigned int)gameObjects.size();
+	handles.push_back(handle);
+	gameObjects.push_back(gameObject.get());
+	parents.push_back(parentIndex);
+	enabled.push_back(gameObject->isEnabled());
+	activeInHierarchy.push_back(false);
+	dirtyTransforms.push_back(true);
+	worldModelMatrices.push_back(Mat4());
+	worldRotationMatrices.push_back(Mat4());
+	transformVersions.push_back(0u);
+
+	insertIntoIndex(nameIndex, gameObject->getName(), handle, gameObject);
+	if (!gameObject->getTag().empty())
+		insertIntoIndex(tagIndex, gameObject->getTag(), handle, gameObject);
+
+	gameObject->storage = this;
+	gameObject->storageHandle = handle;
+}
+
+void JFF::SceneStorage::remove(GameObject* gameObject)
+{
+	if (gameObject->storage != this)
+		return;
+
+	unsigned int handle = gameObject->storageHandle;
+	unsigned int index = sparse[handle];
+
+	// Children become roots. Their world transforms no longer include the removed parent
+	for (unsigned int childHandle : childHandles[handle])
+	{
+		unsigned int childIndex = sparse[childHandle];
+		parents[childIndex] = -1;
+		dirtyTransforms[childIndex] = true;
+	}
+	childHandles[handle].clear();
+
+	int parentIndex = parents[index];
+	if (parentIndex >= 0)
+	{
+		auto& siblings = childHandles[handles[parentIndex]];
+		auto sibling = std::find(siblings.begin(), siblings.end(), handle);
+		if (sibling != siblings.end())
+		{
+			*sibling = siblings.back();
+			siblings.pop_back();
+		}
+	}
+
+	// Swap with the last entry and pop it
+	unsigned int lastIndex = (unsigned int)(handles.size() - 1);
+	if (index != lastIndex)
+		swapEntries(index, lastIndex);
+
+	handles.pop_back();
+	gameObjects.pop_back();
+	parents.pop_back();
+	enabled.pop_back();
+	activeInHierarchy.pop_back();
+	dirtyTransforms.pop_back();
+	worldModelMatrices.pop_back();
+	worldRotationMatrices.pop_back();
+	transformVersions.pop_back();
+
+	/*
+	* The last entry has no children after it, so only its ancestors can be out of order.
+	* While the entry at the hole has its parent after it, they are swapped. Each swap moves up one level
+	*/
+	while (index < handles.size() && parents[index] > (int)index)
+		swapEntries(index, (unsigned int)parents[index]);
+
+	eraseFromIndex(nameIndex, gameObject->getName(), handle);
+	if (!gameObject->getTag().empty())
+		eraseFromIndex(tagIndex, gameObject->getTag(), handle);
+
+	sparse[handle] = INVALID_HANDLE;
+	freeHandles.push_back(handle);
+
+	gameObject->storage = nullptr;
+	gameObject->storageHandle = INVALID_HANDLE;
+}
+
+void JFF::SceneStorage::clear()
+{
+	for (GameObject* gameObject : gameObjects)
+	{
+		gameObject->storage = nullptr;
+		gameObject->storageHandle = INVALID_HANDLE;
+	}
+
+	sparse.clear();
+	freeHandles.clear();
+	childHandles.clear();
+
+	handles.clear();
+	gameObjects.clear();
+	parents.clear();
+	enabled.clear();
+	activeInHierarchy.clear();
+	dirtyTransforms.clear();
+	worldModelMatrices.clear();
+	worldRotationMatrices.clear();
+	transformVersions.clear();
+
+	nameIndex.clear();
+	tagIndex.clear();
+}
+
+void JFF::SceneStorage::renameGameObject(unsigned int handle, const std::string& oldName, const std::string& newName)
+{
+	std::weak_ptr<GameObject> gameObject = eraseFromIndex(nameIndex, oldName, handle);
+	insertIntoIndex(nameIndex, newName, handle, gameObject);
+}
+
+void JFF::SceneStorage::retagGameObject(unsigned int handle, const std::string& oldTag, const std::string& newTag)
+{
+	// Untagged GameObjects aren't in the tag index, so their weak reference is taken from the name index
+	std::weak_ptr<GameObject> gameObject;
+	if (!oldTag.empty())
+	{
+		gameObject = eraseFromIndex(tagIndex, oldTag, handle);
+	}
+	else
+	{
+		auto iter = nameIndex.find(gameObjects[sparse[handle]]->getName());
+		if (iter != nameIndex.end())
+		{
+			auto entry = std::find_if(iter->second.begin(), iter->second.end(), [handle](const auto& e) { return e.first == handle; });
+			if (entry != iter->second.end())
+				gameObject = entry->second;
+		}
+	}
+
+	if (!newTag.empty())
+		insertIntoIndex(tagIndex, newTag, handle, gameObject);
+}
+
+std::vector<std::weak_ptr<JFF::GameObject>> JFF::SceneStorage::findByName(const std::string& name) const
+{
+	return findInIndex(nameIndex, name);
+}
+
+std::vector<std::weak_ptr<JFF::GameObject>> JFF::SceneStorage::findByTag(const std::string& tag) const
+{
+	return findInIndex(tagIndex, tag);
+}
+
+void JFF::SceneStorage::setEnabled(unsigned int handle, bool enabled)
+{
+	this->enabled[sparse[handle]] = enabled;
+}
+
+void JFF::SceneStorage::executeEnabledGameObjects()
+{
+	// Parents come first, so their active state is already known when their children are reached
+	for (size_t i = 0; i < gameObjects.size(); ++i)
+	{
+		int parentIndex = parents[i];
+		bool active = enabled[i] && (parentIndex < 0 || activeInHierarchy[parentIndex]);
+		activeInHierarchy[i] = active;
+
+		if (active)
+			gameObjects[i]->executeComponents();
+	}
+}
+
+void JFF::SceneStorage::markTransformDirty(unsigned int handle)
+{
+	dirtyTransforms[sparse[handle]] = true;
+}
+
+bool JFF::SceneStorage::isWorldTransformValid(unsigned int handle) const
+{
+	// A world transform is outdated if the GameObject or any of its ancestors changed since the last update
+	int index = (int)sparse[handle];
+	while (index >= 0)
+	{
+		if (dirtyTransforms[index])
+			return false;
+
+		index = parents[index];
+	}
+
+	return true;
+}
+
+void JFF::SceneStorage::updateTransforms()
+{
+	// Dirty flags are propagated forward: parents are always processed before their children
+	for (size_t i = 0; i < gameObjects.size(); ++i)
+	{
+		int parentIndex = parents[i];
+		bool parentDirty = parentIndex >= 0 && dirtyTransforms[parentIndex];
+		if (!dirtyTransforms[i] && !parentDirty)
+			continue;
+
+		dirtyTransforms[i] = true;
+
+		TransformComponent& transform = gameObjects[i]->transform;
+		if (parentIndex >= 0)
+		{
+			worldModelMatrices[i] = worldModelMatrices[parentIndex] * transform.getLocalModelMatrix();
+			worldRotationMatrices[i] = worldRotationMatrices[parentIndex] * transform.getLocalRotationMatrix();
+		}
+		else
+		{
+			worldModelMatrices[i] = transform.getLocalModelMatrix();
+			worldRotationMatrices[i] = transform.getLocalRotationMatrix();
+		}
+
+		++transformVersions[i];
+	}
+
+	std::fill(dirtyTransforms.begin(), dirtyTransforms.end(), (char)false);
+}
+
+inline void JFF::SceneStorage::insertIntoIndex(Index& index, const std::string& key, unsigned int handle, const std::weak_ptr<GameObject>& gameObject)
+{
+	index[key].push_back(std::make_pair(handle, gameObject));
+}
+
+inline std::weak_ptr<JFF::GameObject> JFF::SceneStorage::eraseFromIndex(Index& index, const std::string& key, unsigned int handle)
+{
+	std::weak_ptr<GameObject> gameObject;
+
+	auto iter = index.find(key);
+	if (iter == index.end())
+		return gameObject;
+
+	auto& entries = iter->second;
+	auto entry = std::find_if(entries.begin(), entries.end(), [handle](const auto& e) { return e.first == handle; });
+	if (entry != entries.end())
+	{
+		gameObject = entry->second;
+		entries.erase(entry);
+	}
+
+	if (entries.empty())
+		index.erase(iter);
+
+	return gameObject;
+}
+
+inline std::vector<std::weak_ptr<JFF::GameObject>> JFF::SceneStorage::findInIndex(const Index& index, const std::string& key) const
+{
+	std::vector<std::weak_ptr<GameObject>> result;
+
+	auto iter = index.find(key);
+	if (iter == index.end())
+		return result;
+
+	result.reserve(iter->second.size());
+	for (const auto& entry : iter->second)
+		result.push_back(entry.second);
+
+	return result;
+}
+
+inline void JFF::SceneStorage::swapEntries(unsigned int indexA, unsigned int indexB)
+{
+	std::swap(handles[indexA], handles[indexB]);
+	std::swap(gameObjects[indexA], gameObjects[indexB]);
+	std::swap(parents[indexA], parents[indexB]);
+	std::swap(enabled[indexA], enabled[indexB]);
+	std::swap(activeInHierarchy[indexA], activeInHierarchy[indexB]);
+	std::swap(dirtyTransforms[indexA], dirtyTransforms[indexB]);
+	std::swap(worldModelMatrices[indexA], worldModelMatrices[indexB]);
+	std::swap(worldRotationMatrices[indexA], worldRotationMatrices[indexB]);
+	std::swap(transformVersions[indexA], transformVersions[indexB]);
+
+	sparse[handles[indexA]] = indexA;
+	sparse[handles[indexB]] = indexB;
+
+	for (unsigned int childHandle : childHandles[handles[indexA]])
+		parents[sparse[childHandle]] = (int)indexA;
+	for (unsigned int childHandle : childHandles[handles[indexB]])
+		parents[sparse[childHandle]] = (int)indexB;
+}
@@ -0,0 +1,134 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Mat.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace JFF
+{
+	class GameObject;
+
+	/*
+	* Sparse set that stores per-GameObject scene data in contiguous arrays (SoA), so per-frame systems iterate
+	* them linearly instead of chasing GameObject pointers through the scene graph.
+	* Each GameObject added to a scene gets a stable handle. Handles index a sparse array that points to dense arrays.
+	* Dense arrays are kept in parent-before-child order (a GameObject is always added after its parent),
+	* which lets a single forward pass resolve hierarchical state like world transforms or enabled flags.
+	* Removals swap the removed entry with the last one. If the moved entry lands before its parent, it's swapped
+	* with its ancestors until the order is restored, so a removal costs O(depth) instead of O(n)
+	*/
+	class SceneStorage
+	{
+	public:
+		static const unsigned int INVALID_HANDLE = 0xFFFFFFFFu;
+
+		// Ctor & Dtor
+		SceneStorage();
+		~SceneStorage();
+
+		// Copy ctor and copy assignment
+		SceneStorage(const SceneStorage& other) = delete;
+		SceneStorage& operator=(const SceneStorage& other) = delete;
+
+		// Move ctor and assignment
+		SceneStorage(SceneStorage&& other) = delete;
+		SceneStorage operator=(SceneStorage&& other) = delete;
+
+		// ------------------------------- ENTRIES ------------------------------- //
+
+		// Adds a GameObject. Its parent, if any, must have been added before. Otherwise, the GameObject is rejected
+		void add(const std::shared_ptr<GameObject>& gameObject);
+
+		// Removes a GameObject. Its children become roots. Order of the rest of entries isn't preserved, only parent-before-child order
+		void remove(GameObject* gameObject);
+
+		// Detaches all GameObjects from this storage
+		void clear();
+
+		// Gets the number of stored GameObjects
+		size_t size() const { return gameObjects.size(); }
+
+		// ------------------------------- NAME AND TAG INDICES ------------------------------- //
+
+		// Called by GameObject before its name or tag changes
+		void renameGameObject(unsigned int handle, const std::string& oldName, const std::string& newName);
+		void retagGameObject(unsigned int handle, const std::string& oldTag, const std::string& newTag);
+
+		// Gets all stored GameObjects with the given name or tag, in insertion order. O(1) expected lookup
+		std::vector<std::weak_ptr<GameObject>> findByName(const std::string& name) const;
+		std::vector<std::weak_ptr<GameObject>> findByTag(const std::string& tag) const;
+
+		// ------------------------------- ENABLED FLAGS ------------------------------- //
+
+		void setEnabled(unsigned int handle, bool enabled);
+
+		/*
+		* Executes components of all enabled GameObjects whose ancestors are enabled too, in a single linear pass.
+		* Parents are always executed before their children
+		*/
+		void executeEnabledGameObjects();
+
+		// ------------------------------- TRANSFORMS ------------------------------- //
+
+		// Flags the local transform of a GameObject as changed. Its world transform (and its children's) must be recalculated
+		void markTransformDirty(unsigned int handle);
+
+		// Returns true if the stored world matrices of this GameObject are up to date
+		bool isWorldTransformValid(unsigned int handle) const;
+
+		// Gets the stored world matrices. Check isWorldTransformValid() first
+		const Mat4& getWorldModelMatrix(unsigned int handle) const { return worldModelMatrices[sparse[handle]]; }
+		const Mat4& getWorldRotationMatrix(unsigned int handle) const { return worldRotationMatrices[sparse[handle]]; }
+
+		// Recalculates world matrices of all changed GameObjects and their children in a single linear pass
+		void updateTransforms();
+
+		// Gets a counter that increases each time the world matrices of this GameObject are recalculated
+		unsigned int getTransformVersion(unsigned int handle) const { return transformVersions[sparse[handle]]; }
+
+	private: // Aux functions
+		using Index = std::unordered_map<std::string, std::vector<std::pair<unsigned int, std::weak_ptr<GameObject>>>>;
+
+		inline void insertIntoIndex(Index& index, const std::string& key, unsigned int handle, const std::weak_ptr<GameObject>& gameObject);
+		inline std::weak_ptr<GameObject> eraseFromIndex(Index& index, const std::string& key, unsigned int handle);
+		inline std::vector<std::weak_ptr<GameObject>> findInIndex(const Index& index, const std::string& key) const;
+
+		// Swaps two dense entries and fixes the parent indices of their children
+		inline void swapEntries(unsigned int indexA, unsigned int indexB);
+
+	protected:
+		// Sparse arrays: handle -> dense index
+		std::vector<unsigned int> sparse;
+		std::vector<unsigned int> freeHandles;
+		std::vector<std::vector<unsigned int>> childHandles; // Handles of the stored children of each handle
+
+		// Dense arrays (SoA)
+		std::vector<unsigned int> handles;
+		std::vector<GameObject*> gameObjects;
+		std::vector<int> parents; // Dense index of the parent. -1 if it has no parent
+		std::vector<char> enabled;
+		std::vector<char> activeInHierarchy; // Enabled and all its ancestors enabled. Calculated on executeEnabledGameObjects()
+		std::vector<char> dirtyTransforms;
+		std::vector<Mat4> worldModelMatrices;
+		std::vector<Mat4> worldRotationMatrices;
+		std::vector<unsigned int> transformVersions;
+
+		// Name and tag -> stored GameObjects. GameObjects without a tag aren't indexed by tag
+		Index nameIndex;
+		Index tagIndex;
+	};
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -66,6 +66,15 @@
 #			endif
 #		pragma endregion
 
+#		pragma region Spatial
+#			ifdef JFF_SPATIAL_BVH // Dynamic bounding volume hierarchy
+#				include "SpatialBVH.h"
+				auto createSpatialSubsystem() { return std::make_shared<JFF::SpatialBVH>(); }
+#			else	
+#				error No API defined for spatial queries
+#			endif
+#		pragma endregion
+
 #		pragma region Logic
 #			ifdef JFF_LOGIC_STD // Standard logic
 #				include "LogicSTD.h"
@@ -395,6 +404,10 @@
 #			include "ShaderCodeBuilderEmissiveLightingDeferredBlinnPhongGL.h"
 #			include "ShaderCodeBuilderBackgroundGL.h"
 #			include "ShaderCodeBuilderUIGL.h"
+#			include "ShaderCodeBuilderSSAOBilateralBlurGL.h"
+#			include "ShaderCodeBuilderSSAOBilateralUpsampleGL.h"
+#			include "ShaderCodeBuilderBloomDownsampleGL.h"
+#			include "ShaderCodeBuilderBloomUpsampleGL.h"
 #			include "ShaderCodeBuilderGaussianBlurHorizontalGL.h"
 #			include "ShaderCodeBuilderGaussianBlurVerticalGL.h"
 #			include "ShaderCodeBuilderHighPassFilterGL.h"
@@ -502,6 +515,14 @@
 					return std::make_shared<JFF::ShaderCodeBuilderRenderToScreenGL>();
 				case JFF::Material::MaterialDomain::SSAO:
 					return std::make_shared<JFF::ShaderCodeBuilderSSAOGL>();
+				case JFF::Material::MaterialDomain::SSAO_BILATERAL_BLUR:
+					return std::make_shared<JFF::ShaderCodeBuilderSSAOBilateralBlurGL>();
+				case JFF::Material::MaterialDomain::SSAO_BILATERAL_UPSAMPLE:
+					return std::make_shared<JFF::ShaderCodeBuilderSSAOBilateralUpsampleGL>();
+				case JFF::Material::MaterialDomain::BLOOM_DOWNSAMPLE:
+					return std::make_shared<JFF::ShaderCodeBuilderBloomDownsampleGL>();
+				case JFF::Material::MaterialDomain::BLOOM_UPSAMPLE:
+					return std::make_shared<JFF::ShaderCodeBuilderBloomUpsampleGL>();
 				case JFF::Material::MaterialDomain::GAUSSIAN_BLUR_HORIZONTAL:
 					return std::make_shared<JFF::ShaderCodeBuilderGaussianBlurHorizontalGL>();
 				case JFF::Material::MaterialDomain::GAUSSIAN_BLUR_VERTICAL:
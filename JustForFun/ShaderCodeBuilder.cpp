@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -15,6 +15,7 @@ const std::string JFF::ShaderCodeBuilder::VIEW_MATRIX("viewMatrix");
 const std::string JFF::ShaderCodeBuilder::PROJECTION_MATRIX("projectionMatrix");
 const std::string JFF::ShaderCodeBuilder::NORMAL_MATRIX("normalMatrix");
 const std::string JFF::ShaderCodeBuilder::CUBEMAP_VIEW_MATRICES("cubemapViewMatrices");
+const std::string JFF::ShaderCodeBuilder::CUBEMAP_FACE_MASK("cubemapFaceMask");
 
 const std::string JFF::ShaderCodeBuilder::INPUT_UV_0("uv");
 
@@ -57,6 +58,7 @@ const std::string JFF::ShaderCodeBuilder::RANDOM_ROTATED_TANGENTS("randomRotated
 const std::string JFF::ShaderCodeBuilder::HEMISPHERE_RADIUS("hemisphereRadius");
 const std::string JFF::ShaderCodeBuilder::NUM_HEMISPHERE_SAMPLES("numSamples");
 const std::string JFF::ShaderCodeBuilder::HEMISPHERE_SAMPLES("hemisphereSamplesTangentSpace");
+const std::string JFF::ShaderCodeBuilder::BLUR_DIRECTION("blurDirection");
 const std::string JFF::ShaderCodeBuilder::EQUIRECTANGULAR_TEX("equirectangularTex");
 const std::string JFF::ShaderCodeBuilder::ROUGHNESS("roughness");
 const std::string JFF::ShaderCodeBuilder::ENVIRONMENT_MAP_FACE_WIDTH("envMapFaceWidth");
@@ -66,6 +68,7 @@ const std::string JFF::ShaderCodeBuilder::IRRADIANCE_MAP("irradianceMap");
 const std::string JFF::ShaderCodeBuilder::PRE_FILTERED_MAP("prefilteredEnvMap");
 const std::string JFF::ShaderCodeBuilder::BRDF_INTEGRATION_MAP("BRDFIntegrationMap");
 
+const std::string JFF::ShaderCodeBuilder::SHADOW_ATLAS("shadowAtlas");
 const std::string JFF::ShaderCodeBuilder::DIRECTIONAL_LIGHT_MATRIX("dirLightMatrix");
 const std::string JFF::ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT("directionalLight");
 const std::string JFF::ShaderCodeBuilder::DIRECTIONAL_LIGHT_MATRICES("dirLightMatrices");
@@ -74,7 +77,10 @@ const std::string JFF::ShaderCodeBuilder::DIRECTIONAL_LIGHT_STRUCT_ARRAY("direct
 	const std::string JFF::ShaderCodeBuilder::DIR_LIGHT_COLOR("color");
 	const std::string JFF::ShaderCodeBuilder::DIR_LIGHT_INTENSITY("intensity");
 	const std::string JFF::ShaderCodeBuilder::DIR_LIGHT_CAST_SHADOWS("castShadows");
-	const std::string JFF::ShaderCodeBuilder::DIR_LIGHT_SHADOW_MAP("shadowMap");
+	const std::string JFF::ShaderCodeBuilder::DIR_LIGHT_SHADOW_MAP_REGION("shadowMapRegion");
+	const std::string JFF::ShaderCodeBuilder::DIR_LIGHT_CASCADE_SPLITS("cascadeSplits");
+	const std::string JFF::ShaderCodeBuilder::DIR_LIGHT_NUM_CASCADES("numCascades");
+const int JFF::ShaderCodeBuilder::DIR_LIGHT_MAX_CASCADES;
 
 const std::string JFF::ShaderCodeBuilder::POINT_LIGHT_STRUCT("pointLight");
 const std::string JFF::ShaderCodeBuilder::POINT_LIGHT_STRUCT_ARRAY("pointLights");
@@ -100,7 +106,7 @@ const std::string JFF::ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY("spotLights");
 	const std::string JFF::ShaderCodeBuilder::SPOT_LIGHT_INNER_HALF_ANGLE_CUTOFF("innerHalfAngleCutoff");
 	const std::string JFF::ShaderCodeBuilder::SPOT_LIGHT_OUTER_HALF_ANGLE_CUTOFF("outerHalfAngleCutoff");
 	const std::string JFF::ShaderCodeBuilder::SPOT_LIGHT_CAST_SHADOWS("castShadows");
-	const std::string JFF::ShaderCodeBuilder::SPOT_LIGHT_SHADOW_MAP("shadowMap");
+	const std::string JFF::ShaderCodeBuilder::SPOT_LIGHT_SHADOW_MAP_REGION("shadowMapRegion");
 
 const std::string JFF::ShaderCodeBuilder::LIGHT_POSITION("lightPos");
 const std::string JFF::ShaderCodeBuilder::LIGHT_FAR_PLANE("farPlane");
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -82,6 +82,7 @@ namespace JFF
 		static const std::string PROJECTION_MATRIX;
 		static const std::string NORMAL_MATRIX;
 		static const std::string CUBEMAP_VIEW_MATRICES;
+		static const std::string CUBEMAP_FACE_MASK;
 
 		// UVs
 		static const std::string INPUT_UV_0;
@@ -127,6 +128,7 @@ namespace JFF
 		static const std::string HEMISPHERE_RADIUS;
 		static const std::string NUM_HEMISPHERE_SAMPLES;
 		static const std::string HEMISPHERE_SAMPLES;
+		static const std::string BLUR_DIRECTION;
 		static const std::string EQUIRECTANGULAR_TEX;
 		static const std::string ROUGHNESS;
 		static const std::string ENVIRONMENT_MAP_FACE_WIDTH;
@@ -138,6 +140,7 @@ namespace JFF
 		static const std::string BRDF_INTEGRATION_MAP;
 
 		// Light params
+		static const std::string SHADOW_ATLAS;
 		static const std::string DIRECTIONAL_LIGHT_MATRIX;
 		static const std::string DIRECTIONAL_LIGHT_STRUCT;
 		static const std::string DIRECTIONAL_LIGHT_MATRICES;
@@ -146,7 +149,12 @@ namespace JFF
 			static const std::string DIR_LIGHT_COLOR;
 			static const std::string DIR_LIGHT_INTENSITY;
 			static const std::string DIR_LIGHT_CAST_SHADOWS;
-			static const std::string DIR_LIGHT_SHADOW_MAP;
+			static const std::string DIR_LIGHT_SHADOW_MAP_REGION;
+			static const std::string DIR_LIGHT_CASCADE_SPLITS;
+			static const std::string DIR_LIGHT_NUM_CASCADES;
+
+		// Max number of shadow cascades of a directional light. In forward shading, each light uses a block of this size in DIRECTIONAL_LIGHT_MATRICES
+		static const int DIR_LIGHT_MAX_CASCADES = 4;
 
 		static const std::string POINT_LIGHT_STRUCT;
 		static const std::string POINT_LIGHT_STRUCT_ARRAY;
@@ -172,7 +180,7 @@ namespace JFF
 			static const std::string SPOT_LIGHT_INNER_HALF_ANGLE_CUTOFF;
 			static const std::string SPOT_LIGHT_OUTER_HALF_ANGLE_CUTOFF;
 			static const std::string SPOT_LIGHT_CAST_SHADOWS;
-			static const std::string SPOT_LIGHT_SHADOW_MAP;
+			static const std::string SPOT_LIGHT_SHADOW_MAP_REGION;
 
 		static const std::string LIGHT_POSITION;
 		static const std::string LIGHT_FAR_PLANE;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderBackgroundGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderBackgroundGL::ShaderCodeBuilderBackgroundGL()
 {
@@ -39,22 +39,16 @@ void JFF::ShaderCodeBuilderBackgroundGL::generateCode(const Params& params,
 
 inline std::string JFF::ShaderCodeBuilderBackgroundGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
-
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderBackgroundGL::getVertexShaderCode(const Params& params) const
@@ -138,15 +132,15 @@ inline std::string JFF::ShaderCodeBuilderBackgroundGL::getFragmentShaderCode(con
 			vec2 uv;
 		)glsl";
 
-	static std::string textureSampler = 
+	static const ShaderCodeTemplate textureSampler(
 		R"glsl(
 			uniform sampler2D @1;
-		)glsl";
+		)glsl", { "@1" });
 
-	static std::string cubemapSampler =
+	static const ShaderCodeTemplate cubemapSampler(
 		R"glsl(
 			uniform samplerCube @1;
-		)glsl";
+		)glsl", { "@1" });
 
 	static std::string mainFunctionCode =
 		R"glsl(			
@@ -168,15 +162,13 @@ inline std::string JFF::ShaderCodeBuilderBackgroundGL::getFragmentShaderCode(con
 	// Add all texture uniforms
 	for (const std::string& texName : params.textures)
 	{
-		std::regex samplerName("@1");
-		oss << std::regex_replace(textureSampler, samplerName, texName);
+		oss << textureSampler.build({ texName });
 	}
 
 	// Add all cubemap uniforms
 	for (const std::string& cubeName : params.cubemaps)
 	{
-		std::regex samplerName("@1");
-		oss << std::regex_replace(cubemapSampler, samplerName, cubeName);
+		oss << cubemapSampler.build({ cubeName });
 	}
 
 	// Add custom code and main function
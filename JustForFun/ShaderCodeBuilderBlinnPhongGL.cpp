@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderBlinnPhongGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderBlinnPhongGL::ShaderCodeBuilderBlinnPhongGL()
 {
@@ -36,28 +36,22 @@ void JFF::ShaderCodeBuilderBlinnPhongGL::generateCode(const Params& params,
 
 inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
-
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getVertexShaderCode(const Params& params) const
 {
 	// TODO: re-orthogonalize tangentWorldSpace and bitangentWorldSpace using Gram-Schmidt process
-	static std::string code =
+	static const ShaderCodeTemplate code(
 		R"glsl(
 			layout (location = 0) in vec3 vertexPosModelSpace;
 			layout (location = 1) in vec3 normalModelSpace;
@@ -75,7 +69,6 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getVertexShaderCode(const
 
 				vec2 uv;
 
-				vec4 fragPosDirLightSpace[@1];
 				vec4 fragPosSpotLightSpace[@3];
 			} jff_output;
 
@@ -91,8 +84,7 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getVertexShaderCode(const
 				vec3 cameraPosWorldSpace;
 			};
 
-			// Light matrices (Each matrix is light's projectionMatrix * viewMatrix)
-			uniform mat4 dirLightMatrices[@1];
+			// Light matrices (Each matrix is light's projectionMatrix * viewMatrix). Directional lights select their cascade per fragment
 			uniform mat4 spotLightMatrices[@3];
 
 			void main()
@@ -107,10 +99,6 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getVertexShaderCode(const
 
 				jff_output.uv = uvModelSpace.xy;
 
-				for(int i = 0; i < @1; ++i)
-				{
-					jff_output.fragPosDirLightSpace[i] = dirLightMatrices[i] * jff_output.fragPosWorldSpace;
-				}
 				for(int i = 0; i < @3; ++i)
 				{
 					jff_output.fragPosSpotLightSpace[i] = spotLightMatrices[i] * jff_output.fragPosWorldSpace;
@@ -118,16 +106,14 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getVertexShaderCode(const
 
 				gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(vertexPosModelSpace, 1.0);
 			}
-		)glsl";
+		)glsl", { "@1", "@2", "@3" });
 
 	// Replace max num lights of each type by concrete numbers
-	std::regex dirLights("@1");
-	std::regex pointLights("@2");
-	std::regex spotLights("@3");
+	std::string dirLights = std::to_string(params.maxDirLights);
+	std::string pointLights = std::to_string(params.maxPointLights);
+	std::string spotLights = std::to_string(params.maxSpotLights);
 
-	std::string codeReplaced = std::regex_replace(code, dirLights, std::to_string(params.maxDirLights));
-	codeReplaced = std::regex_replace(codeReplaced, pointLights, std::to_string(params.maxPointLights));
-	codeReplaced = std::regex_replace(codeReplaced, spotLights, std::to_string(params.maxSpotLights));
+	std::string codeReplaced = code.build({ dirLights, pointLights, spotLights });
 
 	std::ostringstream oss;
 	oss << getShaderVersionLine(params) << codeReplaced;
@@ -137,7 +123,7 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getVertexShaderCode(const
 
 inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(const Params& params) const
 {
-	static std::string attributesCode =
+	static const ShaderCodeTemplate attributesCode(
 		R"glsl(
 			in VertexShaderOutput
 			{
@@ -149,7 +135,6 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 
 				vec2 uv;
 
-				vec4 fragPosDirLightSpace[@1];
 				vec4 fragPosSpotLightSpace[@3];
 			} jff_input;
 
@@ -172,7 +157,9 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 				vec3 color;
 				float intensity;
 				float castShadows;
-				sampler2D shadowMap;
+				vec4 shadowMapRegion; // Region of the shadow atlas: offset (xy) and scale (zw) in texture coordinates
+				vec4 cascadeSplits; // Distance from the camera to the far plane of each cascade
+				float numCascades; // Cascades are tiles of 2x2 in the shadow map region. A single cascade takes the whole region
 			};
 
 			struct PointLight
@@ -198,12 +185,17 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 				float innerHalfAngleCutoff;
 				float outerHalfAngleCutoff;
 				float castShadows;
-				sampler2D shadowMap;
+				vec4 shadowMapRegion; // Region of the shadow atlas: offset (xy) and scale (zw) in texture coordinates
 			};
 
 			uniform DirectionalLight directionalLights[@1];
 			uniform PointLight pointLights[@2];
 			uniform SpotLight spotLights[@3];
+			uniform sampler2D shadowAtlas; // Shadow maps of all directional and spot lights
+
+			// Matrices of the shadow cascades (light's projectionMatrix * viewMatrix). Each directional light uses a block of MAX_CASCADES
+			const int MAX_CASCADES = @4;
+			uniform mat4 dirLightMatrices[@1 * MAX_CASCADES];
 
 			// Material output attributes
 
@@ -234,17 +226,17 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 			void parallaxMapping();
 			void parallaxMappingDisplacement(in sampler2D displacementMap);
 			void parallaxMappingHeight(in sampler2D heightMap);
-		)glsl";
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	static std::string textureSampler =
+	static const ShaderCodeTemplate textureSampler(
 		R"glsl(
 			uniform sampler2D @1;
-		)glsl";
+		)glsl", { "@1" });
 
-	static std::string cubemapSampler =
+	static const ShaderCodeTemplate cubemapSampler(
 		R"glsl(
 			uniform samplerCube @1;
-		)glsl";
+		)glsl", { "@1" });
 
 	static std::string normalMapping =
 		R"glsl(
@@ -263,7 +255,7 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 			}
 		)glsl";
 
-	static std::string mainFunctionCode =
+	static const ShaderCodeTemplate mainFunctionCode(
 		R"glsl(
 			// ---------------------------------- PARALLAX MAPPING FUNCTION ---------------------------------- //
 
@@ -434,19 +426,45 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 
 			float directionalLightShadowCast(int index) // 1.0: fragment in shadows; 0.0: fragment not in shadows; Middle value: penumbra (soft shadows)
 			{
-				vec4 fragPosLightSpace = jff_input.fragPosDirLightSpace[index];
+				// Select the cascade that contains the fragment by its distance to the camera. Fragments beyond the last cascade are not in shadows
+				float fragDepthViewSpace = -(viewMatrix * jff_input.fragPosWorldSpace).z;
+				int numCascades = int(directionalLights[index].numCascades);
+				int cascade = 0;
+				while (cascade < numCascades - 1 && fragDepthViewSpace > directionalLights[index].cascadeSplits[cascade])
+					++cascade;
+
+				if (fragDepthViewSpace > directionalLights[index].cascadeSplits[cascade])
+					return 0.0;
+
+				vec4 shadowMapRegion = directionalLights[index].shadowMapRegion;
+				if (numCascades > 1)
+				{
+					shadowMapRegion.zw *= 0.5;
+					shadowMapRegion.xy += vec2(cascade % 2, cascade / 2) * shadowMapRegion.zw;
+				}
+
+				vec4 fragPosLightSpace = dirLightMatrices[index * MAX_CASCADES + cascade] * jff_input.fragPosWorldSpace;
 				vec3 fragPosLightSpaceNDC = fragPosLightSpace.xyz / fragPosLightSpace.w; // From clip space [-w,w] to Normalice Device Coordinates [-1,1]
 				fragPosLightSpaceNDC = fragPosLightSpaceNDC * 0.5 + 0.5; // From [-1,1] to [0,1]
 
+				// Fragments outside the shadow frustum (in x and y) are not in shadows
+				if (any(lessThan(fragPosLightSpaceNDC.xy, vec2(0.0))) || any(greaterThan(fragPosLightSpaceNDC.xy, vec2(1.0))))
+					return 0.0;
+
+				// The shadow map is a region of the shadow atlas. Samples are clamped to the region to not read other lights' shadow maps
+				vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0); // Texel size (in normalized space) in LOD 0
+				vec2 shadowMapUV = shadowMapRegion.xy + fragPosLightSpaceNDC.xy * shadowMapRegion.zw;
+				vec2 regionMin = shadowMapRegion.xy + texelSize * 0.5;
+				vec2 regionMax = shadowMapRegion.xy + shadowMapRegion.zw - texelSize * 0.5;
+
 				// Soften shadows by taking an average of neighbours of a texel in shadowmap. PFC (Percentage-Closer Filtering)
 				float inShadows = 0.0;
 				float currentDepth = fragPosLightSpaceNDC.z;
-				vec2 texelSize = 1.0 / textureSize(directionalLights[index].shadowMap, 0); // Texel size (in normalized space) in LOD 0
 				for(int x = -1; x <= 1; ++x)
 				{
 					for(int y = -1; y <= 1; ++y)
 					{
-						float closestDepth = texture(directionalLights[index].shadowMap, fragPosLightSpaceNDC.xy + vec2(x,y) * texelSize).r;
+						float closestDepth = texture(shadowAtlas, clamp(shadowMapUV + vec2(x,y) * texelSize, regionMin, regionMax)).r;
 						inShadows += currentDepth > closestDepth ? 1.0 : 0.0;			
 					}
 				}
@@ -492,15 +510,24 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 				vec3 fragPosLightSpaceNDC = fragPosLightSpace.xyz / fragPosLightSpace.w; // From clip space [-w,w] to Normalice Device Coordinates [-1,1]
 				fragPosLightSpaceNDC = fragPosLightSpaceNDC * 0.5 + 0.5; // From [-1,1] to [0,1]
 
+				// Fragments outside the shadow frustum (in x and y) are not in shadows
+				if (any(lessThan(fragPosLightSpaceNDC.xy, vec2(0.0))) || any(greaterThan(fragPosLightSpaceNDC.xy, vec2(1.0))))
+					return 0.0;
+
+				// The shadow map is a region of the shadow atlas. Samples are clamped to the region to not read other lights' shadow maps
+				vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0); // Texel size (in normalized space) in LOD 0
+				vec2 shadowMapUV = spotLights[index].shadowMapRegion.xy + fragPosLightSpaceNDC.xy * spotLights[index].shadowMapRegion.zw;
+				vec2 regionMin = spotLights[index].shadowMapRegion.xy + texelSize * 0.5;
+				vec2 regionMax = spotLights[index].shadowMapRegion.xy + spotLights[index].shadowMapRegion.zw - texelSize * 0.5;
+
 				// Soften shadows by taking an average of neighbours of a texel in shadowmap. PFC (Percentage-Closer Filtering)
 				float inShadows = 0.0;
 				float currentDepth = fragPosLightSpaceNDC.z;
-				vec2 texelSize = 1.0 / textureSize(spotLights[index].shadowMap, 0); // Texel size (in normalized space) in LOD 0
 				for(int x = -1; x <= 1; ++x)
 				{
 					for(int y = -1; y <= 1; ++y)
 					{
-						float closestDepth = texture(spotLights[index].shadowMap, fragPosLightSpaceNDC.xy + vec2(x,y) * texelSize).r;
+						float closestDepth = texture(shadowAtlas, clamp(shadowMapUV + vec2(x,y) * texelSize, regionMin, regionMax)).r;
 						inShadows += currentDepth > closestDepth ? 1.0 : 0.0;		
 					}
 				}
@@ -620,20 +647,18 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 				normalMapping();
 				FragColor = vec4(directionalLightsContrib() + pointLightsContrib() + spotLightsContrib() + environmentFunction() + emissive.rgb, opacity.r);
 			}
-		)glsl";
+		)glsl", { "@1", "@2", "@3" });
 
 	// Replace max num lights of each type by concrete numbers
-	std::regex dirLights("@1");
-	std::regex pointLights("@2");
-	std::regex spotLights("@3");
+	std::string dirLights = std::to_string(params.maxDirLights);
+	std::string pointLights = std::to_string(params.maxPointLights);
+	std::string spotLights = std::to_string(params.maxSpotLights);
+
+	std::string dirLightCascades = std::to_string(DIR_LIGHT_MAX_CASCADES);
 
-	std::string attributesCodeReplaced = std::regex_replace(attributesCode, dirLights, std::to_string(params.maxDirLights));
-	attributesCodeReplaced = std::regex_replace(attributesCodeReplaced, pointLights, std::to_string(params.maxPointLights));
-	attributesCodeReplaced = std::regex_replace(attributesCodeReplaced, spotLights, std::to_string(params.maxSpotLights));
+	std::string attributesCodeReplaced = attributesCode.build({ dirLights, pointLights, spotLights, dirLightCascades });
 
-	std::string mainFunctionCodeReplaced = std::regex_replace(mainFunctionCode, dirLights, std::to_string(params.maxDirLights));
-	mainFunctionCodeReplaced = std::regex_replace(mainFunctionCodeReplaced, pointLights, std::to_string(params.maxPointLights));
-	mainFunctionCodeReplaced = std::regex_replace(mainFunctionCodeReplaced, spotLights, std::to_string(params.maxSpotLights));
+	std::string mainFunctionCodeReplaced = mainFunctionCode.build({ dirLights, pointLights, spotLights });
 
 	// Assemble code
 	std::ostringstream oss;
@@ -642,15 +667,13 @@ inline std::string JFF::ShaderCodeBuilderBlinnPhongGL::getFragmentShaderCode(con
 	// Add all texture uniforms
 	for (const std::string& texName : params.textures)
 	{
-		std::regex samplerName("@1");
-		oss << std::regex_replace(textureSampler, samplerName, texName);
+		oss << textureSampler.build({ texName });
 	}
 
 	// Add all cubemap uniforms
 	for (const std::string& cubeName : params.cubemaps)
 	{
-		std::regex samplerName("@1");
-		oss << std::regex_replace(cubemapSampler, samplerName, cubeName);
+		oss << cubemapSampler.build({ cubeName });
 	}
 
 	// Add normal mapping function code
@@ -0,0 +1,128 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "ShaderCodeBuilderBloomDownsampleGL.h"
+
+#include "Log.h"
+#include "ShaderCodeTemplate.h"
+
+#include <sstream>
+
+JFF::ShaderCodeBuilderBloomDownsampleGL::ShaderCodeBuilderBloomDownsampleGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Ctor ShaderCodeBuilderBloomDownsampleGL")
+}
+
+JFF::ShaderCodeBuilderBloomDownsampleGL::~ShaderCodeBuilderBloomDownsampleGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Dtor ShaderCodeBuilderBloomDownsampleGL")
+}
+
+void JFF::ShaderCodeBuilderBloomDownsampleGL::generateCode(
+	const Params& params, 
+	std::string& outVertexShaderCode, 
+	std::string& outGeometryShaderCode, 
+	std::string& outFragmentShaderCode) const
+{
+	outVertexShaderCode = getVertexShaderCode(params);
+	outFragmentShaderCode = getFragmentShaderCode(params);
+}
+
+inline std::string JFF::ShaderCodeBuilderBloomDownsampleGL::getShaderVersionLine(const Params& params) const
+{
+	static const ShaderCodeTemplate versionCode(
+		R"glsl(
+			#version @1@2@3 @4
+		)glsl", { "@1", "@2", "@3", "@4" });
+
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
+}
+
+inline std::string JFF::ShaderCodeBuilderBloomDownsampleGL::getVertexShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			layout (location = 0) in vec3 vertexPosModelSpace;
+			layout (location = 1) in vec3 normalModelSpace;
+			layout (location = 2) in vec3 tangentModelSpace;
+			layout (location = 3) in vec3 bitangentModelSpace;
+			layout (location = 4) in vec3 uvModelSpace;
+
+			out VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_output;
+
+			void main()
+			{
+				jff_output.uv = uvModelSpace.xy;
+				gl_Position = vec4(vertexPosModelSpace, 1.0);
+			}
+		)glsl";
+
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
+
+inline std::string JFF::ShaderCodeBuilderBloomDownsampleGL::getFragmentShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			in VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_input;
+
+			layout (location = 0) out vec4 FragColor;		// Color attachment 0
+
+			uniform sampler2D ppOutputColor; // Only the upper mip level is sampled
+
+			void main()
+			{
+				// 13 bilinear taps from the upper mip level: 4 overlapping 2x2 boxes around the center and 1 box at the center
+				// Overlapping boxes remove the pulsing and aliasing of a plain 2x2 box downsample
+				vec2 texelSize = 1.0 / textureSize(ppOutputColor, 0);
+				vec2 uv = jff_input.uv;
+
+				vec3 a = textureLod(ppOutputColor, uv + texelSize * vec2(-2.0,  2.0), 0.0).rgb;
+				vec3 b = textureLod(ppOutputColor, uv + texelSize * vec2( 0.0,  2.0), 0.0).rgb;
+				vec3 c = textureLod(ppOutputColor, uv + texelSize * vec2( 2.0,  2.0), 0.0).rgb;
+				vec3 d = textureLod(ppOutputColor, uv + texelSize * vec2(-2.0,  0.0), 0.0).rgb;
+				vec3 e = textureLod(ppOutputColor, uv, 0.0).rgb;
+				vec3 f = textureLod(ppOutputColor, uv + texelSize * vec2( 2.0,  0.0), 0.0).rgb;
+				vec3 g = textureLod(ppOutputColor, uv + texelSize * vec2(-2.0, -2.0), 0.0).rgb;
+				vec3 h = textureLod(ppOutputColor, uv + texelSize * vec2( 0.0, -2.0), 0.0).rgb;
+				vec3 i = textureLod(ppOutputColor, uv + texelSize * vec2( 2.0, -2.0), 0.0).rgb;
+				vec3 j = textureLod(ppOutputColor, uv + texelSize * vec2(-1.0,  1.0), 0.0).rgb;
+				vec3 k = textureLod(ppOutputColor, uv + texelSize * vec2( 1.0,  1.0), 0.0).rgb;
+				vec3 l = textureLod(ppOutputColor, uv + texelSize * vec2(-1.0, -1.0), 0.0).rgb;
+				vec3 m = textureLod(ppOutputColor, uv + texelSize * vec2( 1.0, -1.0), 0.0).rgb;
+
+				vec3 result = e * 0.125;
+				result += (a + c + g + i) * 0.03125;
+				result += (b + d + f + h) * 0.0625;
+				result += (j + k + l + m) * 0.125;
+
+				FragColor = vec4(result, 1.0);
+			}
+		)glsl";
+
+	// Assemble code
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
@@ -0,0 +1,45 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "ShaderCodeBuilder.h"
+
+namespace JFF
+{
+	class ShaderCodeBuilderBloomDownsampleGL: public ShaderCodeBuilder
+	{
+	public:
+		// Ctor & Dtor
+		ShaderCodeBuilderBloomDownsampleGL();
+		virtual ~ShaderCodeBuilderBloomDownsampleGL();
+
+		// Copy ctor and copy assignment
+		ShaderCodeBuilderBloomDownsampleGL(const ShaderCodeBuilderBloomDownsampleGL& other) = delete;
+		ShaderCodeBuilderBloomDownsampleGL& operator=(const ShaderCodeBuilderBloomDownsampleGL& other) = delete;
+
+		// Move ctor and assignment
+		ShaderCodeBuilderBloomDownsampleGL(ShaderCodeBuilderBloomDownsampleGL&& other) = delete;
+		ShaderCodeBuilderBloomDownsampleGL operator=(ShaderCodeBuilderBloomDownsampleGL&& other) = delete;
+
+		// ------------------------ SHADER CODE BUILDER INTERFACE ------------------------ //
+
+		// Generate a compilable shader code from params
+		virtual void generateCode(const Params& params,
+			std::string& outVertexShaderCode,
+			std::string& outGeometryShaderCode,
+			std::string& outFragmentShaderCode) const override;
+
+	private:
+		inline std::string getShaderVersionLine(const Params& params) const;
+		inline std::string getVertexShaderCode(const Params& params) const;
+		inline std::string getFragmentShaderCode(const Params& params) const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "ShaderCodeBuilderBloomUpsampleGL.h"
+
+#include "Log.h"
+#include "ShaderCodeTemplate.h"
+
+#include <sstream>
+
+JFF::ShaderCodeBuilderBloomUpsampleGL::ShaderCodeBuilderBloomUpsampleGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Ctor ShaderCodeBuilderBloomUpsampleGL")
+}
+
+JFF::ShaderCodeBuilderBloomUpsampleGL::~ShaderCodeBuilderBloomUpsampleGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Dtor ShaderCodeBuilderBloomUpsampleGL")
+}
+
+void JFF::ShaderCodeBuilderBloomUpsampleGL::generateCode(
+	const Params& params, 
+	std::string& outVertexShaderCode, 
+	std::string& outGeometryShaderCode, 
+	std::string& outFragmentShaderCode) const
+{
+	outVertexShaderCode = getVertexShaderCode(params);
+	outFragmentShaderCode = getFragmentShaderCode(params);
+}
+
+inline std::string JFF::ShaderCodeBuilderBloomUpsampleGL::getShaderVersionLine(const Params& params) const
+{
+	static const ShaderCodeTemplate versionCode(
+		R"glsl(
+			#version @1@2@3 @4
+		)glsl", { "@1", "@2", "@3", "@4" });
+
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
+}
+
+inline std::string JFF::ShaderCodeBuilderBloomUpsampleGL::getVertexShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			layout (location = 0) in vec3 vertexPosModelSpace;
+			layout (location = 1) in vec3 normalModelSpace;
+			layout (location = 2) in vec3 tangentModelSpace;
+			layout (location = 3) in vec3 bitangentModelSpace;
+			layout (location = 4) in vec3 uvModelSpace;
+
+			out VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_output;
+
+			void main()
+			{
+				jff_output.uv = uvModelSpace.xy;
+				gl_Position = vec4(vertexPosModelSpace, 1.0);
+			}
+		)glsl";
+
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
+
+inline std::string JFF::ShaderCodeBuilderBloomUpsampleGL::getFragmentShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			in VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_input;
+
+			layout (location = 0) out vec4 FragColor;		// Color attachment 0
+
+			uniform sampler2D ppOutputColor; // Only the lower mip level is sampled
+
+			void main()
+			{
+				// 3x3 tent filter over the lower mip level. The result is added to the level being rendered with additive blending
+				vec2 texelSize = 1.0 / textureSize(ppOutputColor, 0);
+				vec2 uv = jff_input.uv;
+
+				vec3 result = textureLod(ppOutputColor, uv, 0.0).rgb * 4.0;
+
+				result += textureLod(ppOutputColor, uv + texelSize * vec2( 0.0,  1.0), 0.0).rgb * 2.0;
+				result += textureLod(ppOutputColor, uv + texelSize * vec2(-1.0,  0.0), 0.0).rgb * 2.0;
+				result += textureLod(ppOutputColor, uv + texelSize * vec2( 1.0,  0.0), 0.0).rgb * 2.0;
+				result += textureLod(ppOutputColor, uv + texelSize * vec2( 0.0, -1.0), 0.0).rgb * 2.0;
+
+				result += textureLod(ppOutputColor, uv + texelSize * vec2(-1.0,  1.0), 0.0).rgb;
+				result += textureLod(ppOutputColor, uv + texelSize * vec2( 1.0,  1.0), 0.0).rgb;
+				result += textureLod(ppOutputColor, uv + texelSize * vec2(-1.0, -1.0), 0.0).rgb;
+				result += textureLod(ppOutputColor, uv + texelSize * vec2( 1.0, -1.0), 0.0).rgb;
+
+				FragColor = vec4(result / 16.0, 1.0);
+			}
+		)glsl";
+
+	// Assemble code
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
@@ -0,0 +1,45 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "ShaderCodeBuilder.h"
+
+namespace JFF
+{
+	class ShaderCodeBuilderBloomUpsampleGL: public ShaderCodeBuilder
+	{
+	public:
+		// Ctor & Dtor
+		ShaderCodeBuilderBloomUpsampleGL();
+		virtual ~ShaderCodeBuilderBloomUpsampleGL();
+
+		// Copy ctor and copy assignment
+		ShaderCodeBuilderBloomUpsampleGL(const ShaderCodeBuilderBloomUpsampleGL& other) = delete;
+		ShaderCodeBuilderBloomUpsampleGL& operator=(const ShaderCodeBuilderBloomUpsampleGL& other) = delete;
+
+		// Move ctor and assignment
+		ShaderCodeBuilderBloomUpsampleGL(ShaderCodeBuilderBloomUpsampleGL&& other) = delete;
+		ShaderCodeBuilderBloomUpsampleGL operator=(ShaderCodeBuilderBloomUpsampleGL&& other) = delete;
+
+		// ------------------------ SHADER CODE BUILDER INTERFACE ------------------------ //
+
+		// Generate a compilable shader code from params
+		virtual void generateCode(const Params& params,
+			std::string& outVertexShaderCode,
+			std::string& outGeometryShaderCode,
+			std::string& outFragmentShaderCode) const override;
+
+	private:
+		inline std::string getShaderVersionLine(const Params& params) const;
+		inline std::string getVertexShaderCode(const Params& params) const;
+		inline std::string getFragmentShaderCode(const Params& params) const;
+	};
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderColorCopyGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderColorCopyGL::ShaderCodeBuilderColorCopyGL()
 {
@@ -37,22 +37,16 @@ void JFF::ShaderCodeBuilderColorCopyGL::generateCode(
 
 inline std::string JFF::ShaderCodeBuilderColorCopyGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
-
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderColorCopyGL::getVertexShaderCode(const Params& params) const
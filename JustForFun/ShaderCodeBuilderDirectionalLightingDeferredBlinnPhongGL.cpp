@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL()
 {
@@ -37,22 +37,16 @@ void JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL::generateCode
 
 inline std::string JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
-
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL::getVertexShaderCode(const Params& params) const
@@ -85,7 +79,7 @@ inline std::string JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL
 
 inline std::string JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL::getFragmentShaderCode(const Params& params) const
 {
-	static std::string code =
+	static const ShaderCodeTemplate code(
 		R"glsl(
 			in VertexShaderOutput
 			{
@@ -134,11 +128,15 @@ inline std::string JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL
 				vec3 color;
 				float intensity;
 				float castShadows;
-				sampler2D shadowMap;
+				vec4 shadowMapRegion; // Region of the shadow atlas: offset (xy) and scale (zw) in texture coordinates
+				vec4 cascadeSplits; // Distance from the camera to the far plane of each cascade
+				float numCascades; // Cascades are tiles of 2x2 in the shadow map region. A single cascade takes the whole region
 			};
 
 			uniform DirectionalLight directionalLight;
-			uniform mat4 dirLightMatrix; // Light matrices (Each matrix is light's projectionMatrix * viewMatrix)
+			uniform sampler2D shadowAtlas; // Shadow maps of all directional and spot lights
+			const int MAX_CASCADES = @1;
+			uniform mat4 dirLightMatrix[MAX_CASCADES]; // Matrix of each shadow cascade (light's projectionMatrix * viewMatrix)
 
 			// ---------------------------------- G-BUFFER EXTRACTION FUNCTION ---------------------------------- //
 
@@ -195,19 +193,45 @@ inline std::string JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL
 
 			float directionalLightShadowCast() // 1.0: fragment in shadows; 0.0: fragment not in shadows; Middle value: penumbra (soft shadows)
 			{
-				vec4 fragPosLightSpace = dirLightMatrix * fragPosWorldSpace;
+				// Select the cascade that contains the fragment by its distance to the camera. Fragments beyond the last cascade are not in shadows
+				float fragDepthViewSpace = -(viewMatrix * fragPosWorldSpace).z;
+				int numCascades = int(directionalLight.numCascades);
+				int cascade = 0;
+				while (cascade < numCascades - 1 && fragDepthViewSpace > directionalLight.cascadeSplits[cascade])
+					++cascade;
+
+				if (fragDepthViewSpace > directionalLight.cascadeSplits[cascade])
+					return 0.0;
+
+				vec4 shadowMapRegion = directionalLight.shadowMapRegion;
+				if (numCascades > 1)
+				{
+					shadowMapRegion.zw *= 0.5;
+					shadowMapRegion.xy += vec2(cascade % 2, cascade / 2) * shadowMapRegion.zw;
+				}
+
+				vec4 fragPosLightSpace = dirLightMatrix[cascade] * fragPosWorldSpace;
 				vec3 fragPosLightSpaceNDC = fragPosLightSpace.xyz / fragPosLightSpace.w; // From clip space [-w,w] to Normalice Device Coordinates [-1,1]
 				fragPosLightSpaceNDC = fragPosLightSpaceNDC * 0.5 + 0.5; // From [-1,1] to [0,1]
 
+				// Fragments outside the shadow frustum (in x and y) are not in shadows
+				if (any(lessThan(fragPosLightSpaceNDC.xy, vec2(0.0))) || any(greaterThan(fragPosLightSpaceNDC.xy, vec2(1.0))))
+					return 0.0;
+
+				// The shadow map is a region of the shadow atlas. Samples are clamped to the region to not read other lights' shadow maps
+				vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0); // Texel size (in normalized space) in LOD 0
+				vec2 shadowMapUV = shadowMapRegion.xy + fragPosLightSpaceNDC.xy * shadowMapRegion.zw;
+				vec2 regionMin = shadowMapRegion.xy + texelSize * 0.5;
+				vec2 regionMax = shadowMapRegion.xy + shadowMapRegion.zw - texelSize * 0.5;
+
 				// Soften shadows by taking an average of neighbours of a texel in shadowmap. PFC (Percentage-Closer Filtering)
 				float inShadows = 0.0;
 				float currentDepth = fragPosLightSpaceNDC.z;
-				vec2 texelSize = 1.0 / textureSize(directionalLight.shadowMap, 0); // Texel size (in normalized space) in LOD 0
 				for(int x = -1; x <= 1; ++x)
 				{
 					for(int y = -1; y <= 1; ++y)
 					{
-						float closestDepth = texture(directionalLight.shadowMap, fragPosLightSpaceNDC.xy + vec2(x,y) * texelSize).r;
+						float closestDepth = texture(shadowAtlas, clamp(shadowMapUV + vec2(x,y) * texelSize, regionMin, regionMax)).r;
 						inShadows += currentDepth > closestDepth ? 1.0 : 0.0;			
 					}
 				}
@@ -244,10 +268,10 @@ inline std::string JFF::ShaderCodeBuilderDirectionalLightingDeferredBlinnPhongGL
 
 				FragColor = vec4(directionalLightsContrib(), 1.0);
 			}
-		)glsl";
+		)glsl", { "@1" });
 
 	std::ostringstream oss;
-	oss << getShaderVersionLine(params) << code;
+	oss << getShaderVersionLine(params) << code.build({ std::to_string(DIR_LIGHT_MAX_CASCADES) });
 
 	return oss.str();
 }
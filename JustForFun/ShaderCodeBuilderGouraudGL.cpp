@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderGouraudGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderGouraudGL::ShaderCodeBuilderGouraudGL()
 {
@@ -37,27 +37,21 @@ void JFF::ShaderCodeBuilderGouraudGL::generateCode(const Params& params,
 
 inline std::string JFF::ShaderCodeBuilderGouraudGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
-
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderGouraudGL::getVertexShaderCode(const Params& params) const
 {
-	static std::string attributesCode =
+	static const ShaderCodeTemplate attributesCode(
 		R"glsl(
 			layout (location = 0) in vec3 vertexPosModelSpace;
 			layout (location = 1) in vec3 normalModelSpace;
@@ -131,9 +125,9 @@ inline std::string JFF::ShaderCodeBuilderGouraudGL::getVertexShaderCode(const Pa
 			vec4 displacement;
 			vec4 lightmap;
 			vec4 reflection;
-		)glsl";
+		)glsl", { "@1", "@2", "@3" });
 
-	static std::string mainFunctionCode =
+	static const ShaderCodeTemplate mainFunctionCode(
 		R"glsl(
 			// Light functions
 			
@@ -252,20 +246,16 @@ inline std::string JFF::ShaderCodeBuilderGouraudGL::getVertexShaderCode(const Pa
 
 				gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(vertexPosModelSpace, 1.0);
 			}
-		)glsl";
+		)glsl", { "@1", "@2", "@3" });
 
 	// Replace max num lights of each type by concrete numbers
-	std::regex dirLights("@1");
-	std::regex pointLights("@2");
-	std::regex spotLights("@3");
+	std::string dirLights = std::to_string(params.maxDirLights);
+	std::string pointLights = std::to_string(params.maxPointLights);
+	std::string spotLights = std::to_string(params.maxSpotLights);
 
-	std::string attributesCodeReplaced = std::regex_replace(attributesCode, dirLights, std::to_string(params.maxDirLights));
-	attributesCodeReplaced = std::regex_replace(attributesCodeReplaced, pointLights, std::to_string(params.maxPointLights));
-	attributesCodeReplaced = std::regex_replace(attributesCodeReplaced, spotLights, std::to_string(params.maxSpotLights));
+	std::string attributesCodeReplaced = attributesCode.build({ dirLights, pointLights, spotLights });
 
-	std::string mainFunctionCodeReplaced = std::regex_replace(mainFunctionCode, dirLights, std::to_string(params.maxDirLights));
-	mainFunctionCodeReplaced = std::regex_replace(mainFunctionCodeReplaced, pointLights, std::to_string(params.maxPointLights));
-	mainFunctionCodeReplaced = std::regex_replace(mainFunctionCodeReplaced, spotLights, std::to_string(params.maxSpotLights));
+	std::string mainFunctionCodeReplaced = mainFunctionCode.build({ dirLights, pointLights, spotLights });
 
 	// Assemble code
 	std::ostringstream oss;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderOmnidirectionalShadowCastGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderOmnidirectionalShadowCastGL::ShaderCodeBuilderOmnidirectionalShadowCastGL()
 {
@@ -37,22 +37,16 @@ void JFF::ShaderCodeBuilderOmnidirectionalShadowCastGL::generateCode(const Param
 
 inline std::string JFF::ShaderCodeBuilderOmnidirectionalShadowCastGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
-
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderOmnidirectionalShadowCastGL::getVertexShaderCode(const Params& params) const
@@ -89,13 +83,18 @@ inline std::string JFF::ShaderCodeBuilderOmnidirectionalShadowCastGL::getGeometr
 
 			uniform mat4 cubemapViewMatrices[6]; // One view matrix per cubemap face
 			uniform mat4 projectionMatrix;
+			uniform float cubemapFaceMask; // Bit i is set if the mesh touches face i. Faces it doesn't touch don't get its triangles
 
 			out vec4 fragPosWorldSpace;
 
 			void main()
 			{
+				int faceMask = int(cubemapFaceMask);
 				for(int face = 0; face < 6; ++face)
 				{
+					if ((faceMask & (1 << face)) == 0)
+						continue;
+
 					for(int i = 0; i < 3; ++i)
 					{
 						// Selects the rendering target face of the cubemap. 
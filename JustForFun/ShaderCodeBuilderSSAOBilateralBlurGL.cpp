@@ -0,0 +1,146 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "ShaderCodeBuilderSSAOBilateralBlurGL.h"
+
+#include "Log.h"
+#include "ShaderCodeTemplate.h"
+
+#include <sstream>
+
+JFF::ShaderCodeBuilderSSAOBilateralBlurGL::ShaderCodeBuilderSSAOBilateralBlurGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Ctor ShaderCodeBuilderSSAOBilateralBlurGL")
+}
+
+JFF::ShaderCodeBuilderSSAOBilateralBlurGL::~ShaderCodeBuilderSSAOBilateralBlurGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Dtor ShaderCodeBuilderSSAOBilateralBlurGL")
+}
+
+void JFF::ShaderCodeBuilderSSAOBilateralBlurGL::generateCode(
+	const Params& params, 
+	std::string& outVertexShaderCode, 
+	std::string& outGeometryShaderCode, 
+	std::string& outFragmentShaderCode) const
+{
+	outVertexShaderCode = getVertexShaderCode(params);
+	outFragmentShaderCode = getFragmentShaderCode(params);
+}
+
+inline std::string JFF::ShaderCodeBuilderSSAOBilateralBlurGL::getShaderVersionLine(const Params& params) const
+{
+	static const ShaderCodeTemplate versionCode(
+		R"glsl(
+			#version @1@2@3 @4
+		)glsl", { "@1", "@2", "@3", "@4" });
+
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
+}
+
+inline std::string JFF::ShaderCodeBuilderSSAOBilateralBlurGL::getVertexShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			layout (location = 0) in vec3 vertexPosModelSpace;
+			layout (location = 1) in vec3 normalModelSpace;
+			layout (location = 2) in vec3 tangentModelSpace;
+			layout (location = 3) in vec3 bitangentModelSpace;
+			layout (location = 4) in vec3 uvModelSpace;
+
+			out VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_output;
+
+			void main()
+			{
+				jff_output.uv = uvModelSpace.xy;
+				gl_Position = vec4(vertexPosModelSpace, 1.0);
+			}
+		)glsl";
+
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
+
+inline std::string JFF::ShaderCodeBuilderSSAOBilateralBlurGL::getFragmentShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			in VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_input;
+
+			layout (location = 0) out float FragColor;		// Color attachment 0
+
+			uniform sampler2D ppOutputColor;	// Ambient occlusion (low resolution)
+			uniform sampler2D ppFragWorldPos;	// G-buffer positions (full resolution)
+			uniform vec2 blurDirection;			// (1, 0) for horizontal blur, (0, 1) for vertical blur
+
+			// Use uniform block for uniforms that doesn't change between programs
+			// This uniform block will use binding point 0
+			layout (std140) uniform CameraParams
+			{
+				mat4 viewMatrix;
+				mat4 projectionMatrix;
+				vec3 cameraPosWorldSpace;
+			};
+
+			const int NUM_WEIGHTS = 5;
+			float weights[NUM_WEIGHTS] = float[] (0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216); // Gaussian bell weights
+
+			// Neighbours whose depth differs more than 1/DEPTH_SHARPNESS of the fragment depth don't contribute
+			const float DEPTH_SHARPNESS = 20.0;
+
+			float linearDepth(vec2 uv)
+			{
+				return -(viewMatrix * vec4(texture(ppFragWorldPos, uv).xyz, 1.0)).z;
+			}
+
+			void main()
+			{
+				// Gaussian blur weighted by depth similarity, so occlusion doesn't bleed across object edges
+				vec2 texelSize = 1.0 / textureSize(ppOutputColor, 0);
+				float centerDepth = linearDepth(jff_input.uv);
+
+				float result = texture(ppOutputColor, jff_input.uv).r * weights[0];
+				float totalWeight = weights[0];
+
+				for (int i = 1; i < NUM_WEIGHTS; ++i) // Sample neighbours at both sides of the fragment
+				{
+					for (int side = -1; side <= 1; side += 2)
+					{
+						vec2 sampleUV = jff_input.uv + blurDirection * texelSize * float(i * side);
+						float depthDifference = abs(linearDepth(sampleUV) - centerDepth) / max(centerDepth, 0.0001);
+						float weight = weights[i] * max(0.0, 1.0 - depthDifference * DEPTH_SHARPNESS);
+
+						result += texture(ppOutputColor, sampleUV).r * weight;
+						totalWeight += weight;
+					}
+				}
+
+				FragColor = result / totalWeight;
+			}
+		)glsl";
+
+	// Assemble code
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
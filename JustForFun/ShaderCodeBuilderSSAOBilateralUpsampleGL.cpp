@@ -0,0 +1,144 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "ShaderCodeBuilderSSAOBilateralUpsampleGL.h"
+
+#include "Log.h"
+#include "ShaderCodeTemplate.h"
+
+#include <sstream>
+
+JFF::ShaderCodeBuilderSSAOBilateralUpsampleGL::ShaderCodeBuilderSSAOBilateralUpsampleGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Ctor ShaderCodeBuilderSSAOBilateralUpsampleGL")
+}
+
+JFF::ShaderCodeBuilderSSAOBilateralUpsampleGL::~ShaderCodeBuilderSSAOBilateralUpsampleGL()
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Dtor ShaderCodeBuilderSSAOBilateralUpsampleGL")
+}
+
+void JFF::ShaderCodeBuilderSSAOBilateralUpsampleGL::generateCode(
+	const Params& params, 
+	std::string& outVertexShaderCode, 
+	std::string& outGeometryShaderCode, 
+	std::string& outFragmentShaderCode) const
+{
+	outVertexShaderCode = getVertexShaderCode(params);
+	outFragmentShaderCode = getFragmentShaderCode(params);
+}
+
+inline std::string JFF::ShaderCodeBuilderSSAOBilateralUpsampleGL::getShaderVersionLine(const Params& params) const
+{
+	static const ShaderCodeTemplate versionCode(
+		R"glsl(
+			#version @1@2@3 @4
+		)glsl", { "@1", "@2", "@3", "@4" });
+
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
+}
+
+inline std::string JFF::ShaderCodeBuilderSSAOBilateralUpsampleGL::getVertexShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			layout (location = 0) in vec3 vertexPosModelSpace;
+			layout (location = 1) in vec3 normalModelSpace;
+			layout (location = 2) in vec3 tangentModelSpace;
+			layout (location = 3) in vec3 bitangentModelSpace;
+			layout (location = 4) in vec3 uvModelSpace;
+
+			out VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_output;
+
+			void main()
+			{
+				jff_output.uv = uvModelSpace.xy;
+				gl_Position = vec4(vertexPosModelSpace, 1.0);
+			}
+		)glsl";
+
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
+
+inline std::string JFF::ShaderCodeBuilderSSAOBilateralUpsampleGL::getFragmentShaderCode(const Params& params) const
+{
+	static std::string code =
+		R"glsl(
+			in VertexShaderOutput
+			{
+				vec2 uv;
+			} jff_input;
+
+			layout (location = 0) out vec4 FragColor;		// Color attachment 0
+
+			uniform sampler2D ppOutputColor;	// Ambient occlusion (low resolution)
+			uniform sampler2D ppFragWorldPos;	// G-buffer positions (full resolution)
+
+			// Use uniform block for uniforms that doesn't change between programs
+			// This uniform block will use binding point 0
+			layout (std140) uniform CameraParams
+			{
+				mat4 viewMatrix;
+				mat4 projectionMatrix;
+				vec3 cameraPosWorldSpace;
+			};
+
+			float linearDepth(vec2 uv)
+			{
+				return -(viewMatrix * vec4(texture(ppFragWorldPos, uv).xyz, 1.0)).z;
+			}
+
+			void main()
+			{
+				// Find the 4 low resolution texels around this fragment and its position between them
+				vec2 lowResSize = textureSize(ppOutputColor, 0);
+				vec2 texelPos = jff_input.uv * lowResSize - 0.5;
+				vec2 baseTexel = floor(texelPos);
+				vec2 fraction = texelPos - baseTexel;
+
+				float centerDepth = linearDepth(jff_input.uv);
+
+				// Bilinear weights scaled by depth similarity: texels from other surfaces barely contribute
+				float occlusion = 0.0;
+				float totalWeight = 0.0;
+				for (int i = 0; i < 4; ++i)
+				{
+					vec2 offset = vec2(i % 2, i / 2);
+					vec2 sampleUV = (baseTexel + offset + 0.5) / lowResSize;
+
+					vec2 bilinear = mix(1.0 - fraction, fraction, offset);
+					float depthDifference = abs(linearDepth(sampleUV) - centerDepth) / max(centerDepth, 0.0001);
+					float weight = bilinear.x * bilinear.y / (depthDifference + 0.001);
+
+					occlusion += texture(ppOutputColor, sampleUV).r * weight;
+					totalWeight += weight;
+				}
+
+				occlusion /= max(totalWeight, 0.0001);
+				FragColor = vec4(occlusion, occlusion, occlusion, 1.0);
+			}
+		)glsl";
+
+	// Assemble code
+	std::ostringstream oss;
+	oss << getShaderVersionLine(params) << code;
+
+	return oss.str();
+}
@@ -0,0 +1,45 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "ShaderCodeBuilder.h"
+
+namespace JFF
+{
+	class ShaderCodeBuilderSSAOBilateralUpsampleGL: public ShaderCodeBuilder
+	{
+	public:
+		// Ctor & Dtor
+		ShaderCodeBuilderSSAOBilateralUpsampleGL();
+		virtual ~ShaderCodeBuilderSSAOBilateralUpsampleGL();
+
+		// Copy ctor and copy assignment
+		ShaderCodeBuilderSSAOBilateralUpsampleGL(const ShaderCodeBuilderSSAOBilateralUpsampleGL& other) = delete;
+		ShaderCodeBuilderSSAOBilateralUpsampleGL& operator=(const ShaderCodeBuilderSSAOBilateralUpsampleGL& other) = delete;
+
+		// Move ctor and assignment
+		ShaderCodeBuilderSSAOBilateralUpsampleGL(ShaderCodeBuilderSSAOBilateralUpsampleGL&& other) = delete;
+		ShaderCodeBuilderSSAOBilateralUpsampleGL operator=(ShaderCodeBuilderSSAOBilateralUpsampleGL&& other) = delete;
+
+		// ------------------------ SHADER CODE BUILDER INTERFACE ------------------------ //
+
+		// Generate a compilable shader code from params
+		virtual void generateCode(const Params& params,
+			std::string& outVertexShaderCode,
+			std::string& outGeometryShaderCode,
+			std::string& outFragmentShaderCode) const override;
+
+	private:
+		inline std::string getShaderVersionLine(const Params& params) const;
+		inline std::string getVertexShaderCode(const Params& params) const;
+		inline std::string getFragmentShaderCode(const Params& params) const;
+	};
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderSSAOGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderSSAOGL::ShaderCodeBuilderSSAOGL()
 {
@@ -37,22 +37,16 @@ void JFF::ShaderCodeBuilderSSAOGL::generateCode(
 
 inline std::string JFF::ShaderCodeBuilderSSAOGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
-
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderSSAOGL::getVertexShaderCode(const Params& params) const
@@ -92,7 +86,7 @@ inline std::string JFF::ShaderCodeBuilderSSAOGL::getFragmentShaderCode(const Par
 				vec2 uv;
 			} jff_input;
 
-			layout (location = 0) out vec4 FragColor;		// Color attachment 0
+			layout (location = 0) out float FragColor;		// Color attachment 0
 
 			// Post processing textures
 			uniform sampler2D ppFragWorldPos;
@@ -127,13 +121,13 @@ inline std::string JFF::ShaderCodeBuilderSSAOGL::getFragmentShaderCode(const Par
 
 			float ssao()
 			{
-				// We need to scale the small noise texture to make it change many times on each uv change
-				vec2 noiseScale = textureSize(ppFragWorldPos, 0) / textureSize(randomRotatedTangents, 0);
+				// The small noise texture is tiled over the output pixels, whatever the resolution of the output is
+				ivec2 noiseTexel = ivec2(gl_FragCoord.xy) % textureSize(randomRotatedTangents, 0);
 
 				// Extract data from input textures
 				vec3 fragPosWorldSpace = texture(ppFragWorldPos, uv).xyz;
 				vec3 normalWorldSpace = texture(ppNormalWorldDir, uv).xyz;
-				vec3 randomTangentTangentSpace = texture(randomRotatedTangents, uv * noiseScale).xyz;
+				vec3 randomTangentTangentSpace = texelFetch(randomRotatedTangents, noiseTexel, 0).xyz;
 
 				// Orthogonalize tangent (this converts it to tangentWorldSpace) using Gramm-Schmidt process and build TBN matrix
 				vec3 randomTangentWorldSpace = normalize(randomTangentTangentSpace - normalWorldSpace * dot(randomTangentTangentSpace, normalWorldSpace)); 
@@ -186,8 +180,7 @@ inline std::string JFF::ShaderCodeBuilderSSAOGL::getFragmentShaderCode(const Par
 				// Setup some variables
 				uv = jff_input.uv;
 
-				float occlusion = ssao();
-				FragColor = vec4(occlusion, occlusion, occlusion, 1.0); // TODO: FragColor could be float instead of vec4
+				FragColor = ssao();
 			}
 		)glsl";
 
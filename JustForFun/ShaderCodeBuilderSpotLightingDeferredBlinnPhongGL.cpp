@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,9 +11,9 @@
 #include "ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL.h"
 
 #include "Log.h"
+#include "ShaderCodeTemplate.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL::ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL()
 {
@@ -37,22 +37,16 @@ void JFF::ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL::generateCode(
 
 inline std::string JFF::ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL::getShaderVersionLine(const Params& params) const
 {
-	static std::string versionCode =
+	static const ShaderCodeTemplate versionCode(
 		R"glsl(
 			#version @1@2@3 @4
-		)glsl";
-
-	std::regex reMajor("@1");
-	std::regex reMinor("@2");
-	std::regex reRev("@3");
-	std::regex reProfile("@4");
-
-	std::string version = std::regex_replace(versionCode, reMajor, std::to_string(params.shaderVersionMajor));
-	version = std::regex_replace(version, reMinor, std::to_string(params.shaderVersionMinor));
-	version = std::regex_replace(version, reRev, std::to_string(params.shaderVersionRevision));
-	version = std::regex_replace(version, reProfile, params.shaderProfile);
+		)glsl", { "@1", "@2", "@3", "@4" });
 
-	return version;
+	return versionCode.build({
+		std::to_string(params.shaderVersionMajor),
+		std::to_string(params.shaderVersionMinor),
+		std::to_string(params.shaderVersionRevision),
+		params.shaderProfile });
 }
 
 inline std::string JFF::ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL::getVertexShaderCode(const Params& params) const
@@ -137,10 +131,11 @@ inline std::string JFF::ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL::getFr
 				float innerHalfAngleCutoff;
 				float outerHalfAngleCutoff;
 				float castShadows;
-				sampler2D shadowMap;
+				vec4 shadowMapRegion; // Region of the shadow atlas: offset (xy) and scale (zw) in texture coordinates
 			};
 
 			uniform SpotLight spotLight;
+			uniform sampler2D shadowAtlas; // Shadow maps of all directional and spot lights
 			uniform mat4 spotLightMatrix; // Light matrices (Each matrix is light's projectionMatrix * viewMatrix)
 
 			// ---------------------------------- G-BUFFER EXTRACTION FUNCTION ---------------------------------- //
@@ -201,15 +196,24 @@ inline std::string JFF::ShaderCodeBuilderSpotLightingDeferredBlinnPhongGL::getFr
 				vec3 fragPosLightSpaceNDC = fragPosLightSpace.xyz / fragPosLightSpace.w; // From clip space [-w,w] to Normalice Device Coordinates [-1,1]
 				fragPosLightSpaceNDC = fragPosLightSpaceNDC * 0.5 + 0.5; // From [-1,1] to [0,1]
 
+				// Fragments outside the shadow frustum (in x and y) are not in shadows
+				if (any(lessThan(fragPosLightSpaceNDC.xy, vec2(0.0))) || any(greaterThan(fragPosLightSpaceNDC.xy, vec2(1.0))))
+					return 0.0;
+
+				// The shadow map is a region of the shadow atlas. Samples are clamped to the region to not read other lights' shadow maps
+				vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0); // Texel size (in normalized space) in LOD 0
+				vec2 shadowMapUV = spotLight.shadowMapRegion.xy + fragPosLightSpaceNDC.xy * spotLight.shadowMapRegion.zw;
+				vec2 regionMin = spotLight.shadowMapRegion.xy + texelSize * 0.5;
+				vec2 regionMax = spotLight.shadowMapRegion.xy + spotLight.shadowMapRegion.zw - texelSize * 0.5;
+
 				// Soften shadows by taking an average of neighbours of a texel in shadowmap. PFC (Percentage-Closer Filtering)
 				float inShadows = 0.0;
 				float currentDepth = fragPosLightSpaceNDC.z;
-				vec2 texelSize = 1.0 / textureSize(spotLight.shadowMap, 0); // Texel size (in normalized space) in LOD 0
 				for(int x = -1; x <= 1; ++x)
 				{
 					for(int y = -1; y <= 1; ++y)
 					{
-						float closestDepth = texture(spotLight.shadowMap, fragPosLightSpaceNDC.xy + vec2(x,y) * texelSize).r;
+						float closestDepth = texture(shadowAtlas, clamp(shadowMapUV + vec2(x,y) * texelSize, regionMin, regionMax)).r;
 						inShadows += currentDepth > closestDepth ? 1.0 : 0.0;		
 					}
 				}
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,7 +13,6 @@
 #include "Log.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::ShaderCodeBuilderUIGL::ShaderCodeBuilderUIGL()
 {
@@ -0,0 +1,85 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "ShaderCodeTemplate.h"
+
+#include <cstring>
+
+JFF::ShaderCodeTemplate::ShaderCodeTemplate(const char* code, std::initializer_list<const char*> placeholders) :
+	code(code),
+	fragments()
+{
+	const char* const* keys = placeholders.begin();
+	const int numKeys = (int)placeholders.size();
+
+	// Split code in fragments. The longest matching placeholder wins, so "@10" is never taken as "@1"
+	size_t fragmentStart = 0u;
+	size_t pos = 0u;
+	while (pos < this->code.size())
+	{
+		int matchedSlot = -1;
+		size_t matchedLength = 0u;
+		for (int i = 0; i < numKeys; ++i)
+		{
+			size_t keyLength = std::strlen(keys[i]);
+			if (keyLength > matchedLength && this->code.compare(pos, keyLength, keys[i]) == 0)
+			{
+				matchedSlot = i;
+				matchedLength = keyLength;
+			}
+		}
+
+		if (matchedSlot < 0)
+		{
+			++pos;
+			continue;
+		}
+
+		fragments.push_back({ fragmentStart, pos - fragmentStart, matchedSlot });
+		pos += matchedLength;
+		fragmentStart = pos;
+	}
+
+	fragments.push_back({ fragmentStart, this->code.size() - fragmentStart, -1 });
+}
+
+JFF::ShaderCodeTemplate::~ShaderCodeTemplate()
+{
+}
+
+std::string JFF::ShaderCodeTemplate::build(std::initializer_list<Value> values) const
+{
+	std::string outCode;
+	buildInto(outCode, values);
+	return outCode;
+}
+
+void JFF::ShaderCodeTemplate::buildInto(std::string& outCode, std::initializer_list<Value> values) const
+{
+	const Value* valueArray = values.begin();
+	const int numValues = (int)values.size();
+
+	// Compute final size first so there is only one allocation
+	size_t totalSize = outCode.size();
+	for (const Fragment& fragment : fragments)
+	{
+		totalSize += fragment.length;
+		if (fragment.slot >= 0 && fragment.slot < numValues)
+			totalSize += valueArray[fragment.slot].size;
+	}
+	outCode.reserve(totalSize);
+
+	for (const Fragment& fragment : fragments)
+	{
+		outCode.append(code, fragment.offset, fragment.length);
+		if (fragment.slot >= 0 && fragment.slot < numValues)
+			outCode.append(valueArray[fragment.slot].data, valueArray[fragment.slot].size);
+	}
+}
\ No newline at end of file
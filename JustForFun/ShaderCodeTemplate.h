@@ -0,0 +1,70 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+namespace JFF
+{
+	/*
+	* Piece of shader code with placeholders (@1, @F0, ...) that are substituted when the code is built.
+	* The code is split in fragments only once, on construction, so building it is a plain concatenation
+	* of fragments and values into a single pre-sized string. Meant to be stored as a function static.
+	*/
+	class ShaderCodeTemplate
+	{
+	public:
+		// Non-owning view of a substitution value. Valid as long as the referenced string lives
+		struct Value
+		{
+			Value(const char* str) : data(str), size(std::char_traits<char>::length(str)) {}
+			Value(const std::string& str) : data(str.data()), size(str.size()) {}
+
+			const char* data;
+			size_t size;
+		};
+
+		// Ctor & Dtor
+		ShaderCodeTemplate(const char* code, std::initializer_list<const char*> placeholders = {});
+		~ShaderCodeTemplate();
+
+		// Copy ctor and copy assignment
+		ShaderCodeTemplate(const ShaderCodeTemplate& other) = delete;
+		ShaderCodeTemplate& operator=(const ShaderCodeTemplate& other) = delete;
+
+		// Move ctor and assignment
+		ShaderCodeTemplate(ShaderCodeTemplate&& other) = delete;
+		ShaderCodeTemplate operator=(ShaderCodeTemplate&& other) = delete;
+
+		/*
+		* Builds the code replacing each placeholder by the value with the same index it had in the ctor.
+		* Missing values are replaced by an empty string
+		*/
+		std::string build(std::initializer_list<Value> values = {}) const;
+
+		// Appends built code to outCode, avoiding a temporary string
+		void buildInto(std::string& outCode, std::initializer_list<Value> values = {}) const;
+
+	private:
+		// Literal text of code, followed by the placeholder slot to substitute after it (-1 if none)
+		struct Fragment
+		{
+			size_t offset;
+			size_t length;
+			int slot;
+		};
+
+		std::string code;
+		std::vector<Fragment> fragments;
+	};
+}
\ No newline at end of file
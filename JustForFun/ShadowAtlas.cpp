@@ -0,0 +1,262 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "ShadowAtlas.h"
+
+#include "Log.h"
+
+#include <algorithm>
+
+extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(JFF::Framebuffer::PrefabFramebuffer fboType,
+	unsigned int width, unsigned int height, unsigned int samplesPerPixel = 0);
+
+JFF::ShadowAtlas::ShadowAtlas(unsigned int atlasSize, unsigned int maxAtlasSize, unsigned int minRegionSize, bool staticCache) :
+	atlasFBO(),
+	staticAtlasFBO(),
+	atlasSize(1u),
+	minRegionSize(1u),
+
+	nodes(),
+	allocations()
+{
+	JFF_LOG_INFO("Ctor ShadowAtlas")
+
+	// Quadtree regions need power of two sizes
+	while (this->atlasSize < atlasSize)
+		this->atlasSize <<= 1;
+	while (this->atlasSize > maxAtlasSize && this->atlasSize > 1u)
+		this->atlasSize >>= 1;
+
+	if (this->atlasSize < atlasSize)
+	{
+		JFF_LOG_WARNING("Shadow atlas size " << atlasSize << " exceeds the max texture size. Clamped to " << this->atlasSize)
+	}
+
+	while (this->minRegionSize < minRegionSize && this->minRegionSize < this->atlasSize)
+		this->minRegionSize <<= 1;
+
+	// One node per region of each size, from the whole atlas to the smallest region
+	size_t numNodes = 0;
+	size_t nodesInLevel = 1;
+	for (unsigned int size = this->atlasSize; size >= this->minRegionSize; size >>= 1)
+	{
+		numNodes += nodesInLevel;
+		nodesInLevel *= 4;
+	}
+	nodes.resize(numNodes, NodeState::FREE);
+
+	atlasFBO = createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_SHADOW_MAP, this->atlasSize, this->atlasSize);
+	if (staticCache)
+		staticAtlasFBO = createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_SHADOW_MAP, this->atlasSize, this->atlasSize);
+
+	JFF_LOG_INFO("Shadow atlas size: " << this->atlasSize << "x" << this->atlasSize << " Min region size: " << this->minRegionSize)
+}
+
+JFF::ShadowAtlas::~ShadowAtlas()
+{
+	JFF_LOG_INFO("Dtor ShadowAtlas")
+}
+
+bool JFF::ShadowAtlas::assignRegion(const LightComponent* light, unsigned int requestedSize)
+{
+	unsigned int regionSize = getRegionSize(requestedSize);
+
+	auto it = allocations.find(light);
+	if (it != allocations.end())
+	{
+		if (it->second.region.size == regionSize)
+			return true;
+
+		freeNode(it->second.node);
+		allocations.erase(it);
+	}
+
+	// If the atlas is full, degrade to smaller regions before giving up
+	for (unsigned int size = regionSize; size >= minRegionSize; size >>= 1)
+	{
+		Allocation allocation;
+		if (allocateNode(0, atlasSize, 0u, 0u, size, allocation.region, allocation.node))
+		{
+			allocations[light] = allocation;
+			return true;
+		}
+	}
+
+	JFF_LOG_WARNING("Shadow atlas is full. Light won't cast shadows")
+	return false;
+}
+
+unsigned int JFF::ShadowAtlas::getRegionSize(unsigned int requestedSize) const
+{
+	// Round to a power of two inside the valid range of region sizes
+	unsigned int regionSize = minRegionSize;
+	while (regionSize < requestedSize && regionSize < getMaxRegionSize())
+		regionSize <<= 1;
+
+	return regionSize;
+}
+
+void JFF::ShadowAtlas::releaseRegion(const LightComponent* light)
+{
+	auto it = allocations.find(light);
+	if (it == allocations.end())
+		return;
+
+	freeNode(it->second.node);
+	allocations.erase(it);
+}
+
+bool JFF::ShadowAtlas::getRegion(const LightComponent* light, Region& outRegion) const
+{
+	auto it = allocations.find(light);
+	if (it == allocations.end())
+		return false;
+
+	outRegion = it->second.region;
+	return true;
+}
+
+bool JFF::ShadowAtlas::getRegionUV(const LightComponent* light, Vec4& outOffsetScale) const
+{
+	Region region;
+	if (!getRegion(light, region))
+		return false;
+
+	float invAtlasSize = 1.0f / (float)atlasSize;
+	outOffsetScale = Vec4(region.x * invAtlasSize, region.y * invAtlasSize, region.size * invAtlasSize, region.size * invAtlasSize);
+	return true;
+}
+
+void JFF::ShadowAtlas::enable()
+{
+	atlasFBO->enable(false);
+}
+
+void JFF::ShadowAtlas::disable()
+{
+	atlasFBO->disable();
+}
+
+void JFF::ShadowAtlas::enableStatic()
+{
+	if (!staticAtlasFBO)
+	{
+		JFF_LOG_WARNING("Shadow atlas has no static cache. Operation aborted")
+		return;
+	}
+
+	staticAtlasFBO->enable(false);
+}
+
+void JFF::ShadowAtlas::restoreStaticRegion(const LightComponent* light)
+{
+	Region region;
+	if (!staticAtlasFBO || !getRegion(light, region))
+		return;
+
+	atlasFBO->copyBufferRegion(Framebuffer::AttachmentPoint::DEPTH, Framebuffer::AttachmentPoint::DEPTH, staticAtlasFBO, 
+		region.x, region.y, region.size, region.size);
+
+	// Copies change bound framebuffers
+	atlasFBO->enable(false);
+}
+
+bool JFF::ShadowAtlas::hasStaticCache() const
+{
+	return (bool)staticAtlasFBO;
+}
+
+std::weak_ptr<JFF::Framebuffer> JFF::ShadowAtlas::getFramebuffer() const
+{
+	return atlasFBO;
+}
+
+unsigned int JFF::ShadowAtlas::getSize() const
+{
+	return atlasSize;
+}
+
+unsigned int JFF::ShadowAtlas::getMinRegionSize() const
+{
+	return minRegionSize;
+}
+
+unsigned int JFF::ShadowAtlas::getMaxRegionSize() const
+{
+	// Half of the atlas, so at least four lights get the biggest region
+	return std::max(minRegionSize, atlasSize >> 1);
+}
+
+void JFF::ShadowAtlas::destroy()
+{
+	allocations.clear();
+	std::fill(nodes.begin(), nodes.end(), NodeState::FREE);
+
+	if (atlasFBO)
+		atlasFBO->destroy();
+
+	if (staticAtlasFBO)
+		staticAtlasFBO->destroy();
+}
+
+inline bool JFF::ShadowAtlas::allocateNode(int node, unsigned int nodeSize, unsigned int x, unsigned int y, unsigned int regionSize, Region& outRegion, int& outNode)
+{
+	if (nodes[node] == NodeState::USED)
+		return false;
+
+	if (nodeSize == regionSize)
+	{
+		if (nodes[node] != NodeState::FREE)
+			return false; // Some child is in use
+
+		nodes[node] = NodeState::USED;
+		outRegion = { x, y, nodeSize };
+		outNode = node;
+		return true;
+	}
+
+	// Split the node and look for space in its children. Children of a free node are always free
+	bool wasFree = nodes[node] == NodeState::FREE;
+	nodes[node] = NodeState::SPLIT;
+
+	unsigned int halfSize = nodeSize >> 1;
+	for (int i = 0; i < 4; ++i)
+	{
+		unsigned int childX = x + (i & 1) * halfSize;
+		unsigned int childY = y + (i >> 1) * halfSize;
+		if (allocateNode(node * 4 + 1 + i, halfSize, childX, childY, regionSize, outRegion, outNode))
+			return true;
+	}
+
+	if (wasFree)
+		nodes[node] = NodeState::FREE;
+
+	return false;
+}
+
+inline void JFF::ShadowAtlas::freeNode(int node)
+{
+	nodes[node] = NodeState::FREE;
+
+	// Merge with siblings while all of them are free
+	while (node > 0)
+	{
+		int parent = (node - 1) / 4;
+		int firstChild = parent * 4 + 1;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (nodes[firstChild + i] != NodeState::FREE)
+				return;
+		}
+
+		nodes[parent] = NodeState::FREE;
+		node = parent;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Framebuffer.h"
+#include "Vec.h"
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+namespace JFF
+{
+	class LightComponent;
+
+	/*
+	* Single depth texture shared by the shadow maps of all directional and spot lights.
+	* The atlas is split as a quadtree: each light owns a square region with a power of two size, so freed regions merge
+	* back with their siblings and the atlas doesn't fragment. The total shadow memory is the size of the atlas, no matter
+	* how many lights cast shadows, and lit shaders bind one texture for all of them.
+	* Optionally, a second atlas with the same layout caches the shadows of static casters, so they are only rendered again
+	* when a light or a static caster moves.
+	*/
+	class ShadowAtlas final
+	{
+	public:
+		// Square region of the atlas, in pixels
+		struct Region
+		{
+			unsigned int x;
+			unsigned int y;
+			unsigned int size;
+		};
+
+	public:
+		// Ctor & Dtor. The atlas size is clamped to maxAtlasSize, the biggest texture supported by the graphics API
+		ShadowAtlas(unsigned int atlasSize, unsigned int maxAtlasSize, unsigned int minRegionSize, bool staticCache);
+		~ShadowAtlas();
+
+		// Copy ctor and copy assignment
+		ShadowAtlas(const ShadowAtlas& other) = delete;
+		ShadowAtlas& operator=(const ShadowAtlas& other) = delete;
+
+		// Move ctor and assignment
+		ShadowAtlas(ShadowAtlas&& other) = delete;
+		ShadowAtlas operator=(ShadowAtlas&& other) = delete;
+
+		/*
+		* Assigns a region of requested size (rounded to a power of two) to a light. The light keeps its current region if
+		* it has the same size. If there isn't space enough, smaller regions are tried. Returns false if the light has no region
+		*/
+		bool assignRegion(const LightComponent* light, unsigned int requestedSize);
+
+		// Gets the size of the region that assignRegion() tries first for requested size
+		unsigned int getRegionSize(unsigned int requestedSize) const;
+
+		// Releases the region of a light, if any
+		void releaseRegion(const LightComponent* light);
+
+		// Returns false if the light has no region
+		bool getRegion(const LightComponent* light, Region& outRegion) const;
+
+		// Gets the region of a light in texture coordinates: offset (x, y) and scale (z, w). Returns false if the light has no region
+		bool getRegionUV(const LightComponent* light, Vec4& outOffsetScale) const;
+
+		// Uses the atlas framebuffer as render target. The atlas isn't cleared: each light clears its own region
+		void enable();
+		void disable();
+
+		// Uses the static atlas framebuffer as render target. Lights render their static casters in the same region they own in the atlas
+		void enableStatic();
+
+		// Copies the region of a light from the static atlas to the atlas and uses the atlas as render target
+		void restoreStaticRegion(const LightComponent* light);
+
+		// Returns true if shadows of static casters are cached in a static atlas
+		bool hasStaticCache() const;
+
+		std::weak_ptr<Framebuffer> getFramebuffer() const;
+
+		unsigned int getSize() const;
+		unsigned int getMinRegionSize() const;
+		unsigned int getMaxRegionSize() const;
+
+		// Free GPU memory of the atlas
+		void destroy();
+
+	private:
+		enum class NodeState : char
+		{
+			FREE,
+			SPLIT,
+			USED,
+		};
+
+		inline bool allocateNode(int node, unsigned int nodeSize, unsigned int x, unsigned int y, unsigned int regionSize, Region& outRegion, int& outNode);
+		inline void freeNode(int node);
+
+	private:
+		std::shared_ptr<Framebuffer> atlasFBO;
+		std::shared_ptr<Framebuffer> staticAtlasFBO; // nullptr if static cache is disabled
+		unsigned int atlasSize;
+		unsigned int minRegionSize;
+
+		// Complete quadtree stored in an array. Children of node i are 4i+1 ... 4i+4
+		std::vector<NodeState> nodes;
+
+		struct Allocation
+		{
+			Region region;
+			int node;
+		};
+		std::unordered_map<const LightComponent*, Allocation> allocations;
+	};
+}
\ No newline at end of file
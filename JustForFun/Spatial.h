@@ -0,0 +1,98 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "ExecutableSubsystem.h"
+#include "Bounds.h"
+
+#include <vector>
+
+namespace JFF
+{
+	class Component;
+
+	/*
+	* Spatial index over the world bounds of scene objects.
+	* Components register a proxy with their bounds in GameObject's local space. The Spatial subsystem keeps their world
+	* bounds up to date when their GameObject's transform changes, and answers spatial queries without walking the scene
+	*/
+	class Spatial : public ExecutableSubsystem
+	{
+	public:
+		static const unsigned int INVALID_PROXY = 0xFFFFFFFFu;
+
+		// Proxy layers. Queries accept a mask of layers to filter the results
+		enum Layer : unsigned int
+		{
+			RENDERABLE	= 1u << 0,
+			COLLIDER	= 1u << 1,
+			LIGHT		= 1u << 2,
+
+			ALL_LAYERS	= 0xFFFFFFFFu,
+		};
+
+		struct RayCastHit
+		{
+			Component* component;
+			float distance; // Distance to the world bounds of the hit proxy, measured in ray direction lengths
+		};
+
+		// Ctor & Dtor
+		Spatial() {}
+		virtual ~Spatial() {}
+
+		// Copy ctor and copy assignment
+		Spatial(const Spatial& other) = delete;
+		Spatial& operator=(const Spatial& other) = delete;
+
+		// Move ctor and assignment
+		Spatial(Spatial&& other) = delete;
+		Spatial operator=(Spatial&& other) = delete;
+
+		// ------------------------------------ Spatial interface ------------------------------------ //
+
+		/*
+		* Creates a proxy for a component. localBounds are in the space of the component's GameObject, and its world bounds
+		* follow the GameObject's transform automatically. The component must destroy its proxy before being destroyed
+		*/
+		virtual unsigned int createProxy(Component* component, const AABB& localBounds, Layer layer) = 0;
+
+		// Destroys a proxy created with createProxy()
+		virtual void destroyProxy(unsigned int proxy) = 0;
+
+		// Changes the local bounds of a proxy
+		virtual void setProxyLocalBounds(unsigned int proxy, const AABB& localBounds) = 0;
+
+		/*
+		* Gets the world bounds used by queries, as they were after last update. They may be enlarged (e.g. fat bounds
+		* of a BVH), so they can be bigger than the real ones. Use getProxyTightWorldBounds() to get the exact bounds
+		*/
+		virtual AABB getProxyWorldBounds(unsigned int proxy) const = 0;
+
+		// Gets the exact world bounds of a proxy: its local bounds transformed by the current transform of its GameObject
+		virtual AABB getProxyTightWorldBounds(unsigned int proxy) const = 0;
+
+		// Appends to outComponents all components of given layers whose world bounds are inside the frustum
+		virtual void queryFrustum(const Frustum& frustum, unsigned int layerMask, std::vector<Component*>& outComponents) const = 0;
+
+		// Appends to outComponents all components of given layers whose world bounds overlap the box
+		virtual void queryAABB(const AABB& box, unsigned int layerMask, std::vector<Component*>& outComponents) const = 0;
+
+		/*
+		* Appends to outComponents all components of given layers whose world bounds overlap the sphere.
+		* This is also the query used to assign lights to the objects inside their area of influence
+		*/
+		virtual void querySphere(const Sphere& sphere, unsigned int layerMask, std::vector<Component*>& outComponents) const = 0;
+
+		// Finds the closest component of given layers whose world bounds are hit by the ray. Returns false if nothing was hit
+		virtual bool rayCast(const Ray& ray, float maxDistance, unsigned int layerMask, RayCastHit& outHit) const = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,487 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#include "SpatialBVH.h"
+
+#include "Log.h"
+#include "GameObject.h"
+#include "SceneStorage.h"
+
+#include <algorithm>
+
+JFF::SpatialBVH::SpatialBVH() :
+	engine(nullptr),
+
+	nodes(),
+	root(NULL_NODE),
+	freeList(NULL_NODE),
+
+	leaves(),
+	queryStack(),
+
+	relativeMargin(0.1f)
+{
+	JFF_LOG_INFO_LOW_PRIORITY("Ctor subsystem: SpatialBVH")
+}
+
+JFF::SpatialBVH::~SpatialBVH()
+{
+	JFF_LOG_IMPORTANT("Dtor subsystem: SpatialBVH")
+
+	if (!leaves.empty())
+	{
+		JFF_LOG_WARNING("There are " << leaves.size() << " spatial proxies that weren't destroyed")
+	}
+}
+
+void JFF::SpatialBVH::load()
+{
+	JFF_LOG_IMPORTANT("Loading subsystem: SpatialBVH")
+}
+
+void JFF::SpatialBVH::postLoad(Engine* engine)
+{
+	JFF_LOG_IMPORTANT("Post-loading subsystem: SpatialBVH")
+	this->engine = engine;
+}
+
+JFF::Subsystem::UnloadOrder JFF::SpatialBVH::getUnloadOrder() const
+{
+	return UnloadOrder::SPATIAL;
+}
+
+JFF::ExecutableSubsystem::ExecutionOrder JFF::SpatialBVH::getExecutionOrder() const
+{
+	// Transforms are updated by Logic, and Renderer queries this subsystem to cull renderables
+	return ExecutableSubsystem::ExecutionOrder::BEFORE_RENDERER;
+}
+
+bool JFF::SpatialBVH::execute()
+{
+	// Refit proxies whose GameObject changed its world transform since last frame
+	for (int leaf : leaves)
+	{
+		Node& node = nodes[leaf];
+
+		SceneStorage* storage = node.gameObject->getStorage();
+		if (!storage)
+			continue;
+
+		unsigned int transformVersion = storage->getTransformVersion(node.gameObject->getStorageHandle());
+		if (transformVersion == node.transformVersion)
+			continue;
+		node.transformVersion = transformVersion;
+
+		// Small movements stay inside the fat bounds and don't change the tree
+		AABB tightBounds = calculateTightBounds(node);
+		if (node.bounds.contains(tightBounds))
+			continue;
+
+		removeLeaf(leaf);
+		nodes[leaf].bounds = calculateFatBounds(nodes[leaf]);
+		insertLeaf(leaf);
+	}
+
+	return true;
+}
+
+unsigned int JFF::SpatialBVH::createProxy(Component* component, const AABB& localBounds, Layer layer)
+{
+	int leaf = allocateNode();
+
+	Node& node = nodes[leaf];
+	node.layers = layer;
+	node.component = component;
+	node.gameObject = component->gameObject;
+	node.localBounds = localBounds;
+	node.leafSlot = (int)leaves.size();
+
+	SceneStorage* storage = node.gameObject->getStorage();
+	node.transformVersion = storage ? storage->getTransformVersion(node.gameObject->getStorageHandle()) : 0u;
+	node.bounds = calculateFatBounds(node);
+
+	leaves.push_back(leaf);
+	insertLeaf(leaf);
+
+	return (unsigned int)leaf;
+}
+
+void JFF::SpatialBVH::destroyProxy(unsigned int proxy)
+{
+	if (!isValidProxy(proxy))
+	{
+		JFF_LOG_WARNING("Cannot destroy an invalid spatial proxy. Operation aborted")
+		return;
+	}
+
+	int leaf = (int)proxy;
+	removeLeaf(leaf);
+
+	// Remove it from leaf list (swap with last)
+	int slot = nodes[leaf].leafSlot;
+	leaves[slot] = leaves.back();
+	nodes[leaves[slot]].leafSlot = slot;
+	leaves.pop_back();
+
+	freeNode(leaf);
+}
+
+void JFF::SpatialBVH::setProxyLocalBounds(unsigned int proxy, const AABB& localBounds)
+{
+	if (!isValidProxy(proxy))
+	{
+		JFF_LOG_WARNING("Cannot change bounds of an invalid spatial proxy. Operation aborted")
+		return;
+	}
+
+	int leaf = (int)proxy;
+	removeLeaf(leaf);
+	nodes[leaf].localBounds = localBounds;
+	nodes[leaf].bounds = calculateFatBounds(nodes[leaf]);
+	insertLeaf(leaf);
+}
+
+JFF::AABB JFF::SpatialBVH::getProxyWorldBounds(unsigned int proxy) const
+{
+	if (!isValidProxy(proxy))
+	{
+		JFF_LOG_WARNING("Cannot get bounds of an invalid spatial proxy")
+		return AABB();
+	}
+
+	return nodes[proxy].bounds;
+}
+
+JFF::AABB JFF::SpatialBVH::getProxyTightWorldBounds(unsigned int proxy) const
+{
+	if (!isValidProxy(proxy))
+	{
+		JFF_LOG_WARNING("Cannot get bounds of an invalid spatial proxy")
+		return AABB();
+	}
+
+	return calculateTightBounds(nodes[proxy]);
+}
+
+void JFF::SpatialBVH::queryFrustum(const Frustum& frustum, unsigned int layerMask, std::vector<Component*>& outComponents) const
+{
+	queryOverlaps(frustum, layerMask, outComponents);
+}
+
+void JFF::SpatialBVH::queryAABB(const AABB& box, unsigned int layerMask, std::vector<Component*>& outComponents) const
+{
+	queryOverlaps(box, layerMask, outComponents);
+}
+
+void JFF::SpatialBVH::querySphere(const Sphere& sphere, unsigned int layerMask, std::vector<Component*>& outComponents) const
+{
+	queryOverlaps(sphere, layerMask, outComponents);
+}
+
+bool JFF::SpatialBVH::rayCast(const Ray& ray, float maxDistance, unsigned int layerMask, RayCastHit& outHit) const
+{
+	if (root == NULL_NODE)
+		return false;
+
+	// Closest hit so far. Subtrees whose bounds are entered further than it are skipped
+	outHit.component = nullptr;
+	float closestDistance = maxDistance;
+
+	queryStack.clear();
+	queryStack.push_back(root);
+	while (!queryStack.empty())
+	{
+		const Node& node = nodes[queryStack.back()];
+		queryStack.pop_back();
+
+		float distance;
+		if (!(node.layers & layerMask) || !ray.intersects(node.bounds, closestDistance, distance))
+			continue;
+
+		if (node.isLeaf())
+		{
+			// Fat bounds only cull. The reported hit must come from the exact proxy bounds
+			if (!ray.intersects(calculateTightBounds(node), closestDistance, distance))
+				continue;
+
+			outHit.component = node.component;
+			outHit.distance = distance;
+			closestDistance = distance;
+		}
+		else
+		{
+			queryStack.push_back(node.child1);
+			queryStack.push_back(node.child2);
+		}
+	}
+
+	return outHit.component != nullptr;
+}
+
+inline int JFF::SpatialBVH::allocateNode()
+{
+	// Grow the pool if there aren't free nodes. Indices stay valid, but references to nodes don't
+	if (freeList == NULL_NODE)
+	{
+		Node node;
+		node.height = -1;
+		node.next = NULL_NODE;
+		nodes.push_back(node);
+		freeList = (int)nodes.size() - 1;
+	}
+
+	int index = freeList;
+	Node& node = nodes[index];
+	freeList = node.next;
+
+	node.bounds = AABB();
+	node.layers = 0u;
+	node.parent = NULL_NODE;
+	node.child1 = NULL_NODE;
+	node.child2 = NULL_NODE;
+	node.height = 0;
+	node.next = NULL_NODE;
+	node.component = nullptr;
+	node.gameObject = nullptr;
+	node.localBounds = AABB();
+	node.transformVersion = 0u;
+	node.leafSlot = -1;
+
+	return index;
+}
+
+inline void JFF::SpatialBVH::freeNode(int node)
+{
+	nodes[node].height = -1;
+	nodes[node].next = freeList;
+	freeList = node;
+}
+
+inline void JFF::SpatialBVH::insertLeaf(int leaf)
+{
+	if (root == NULL_NODE)
+	{
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Find the best sibling for the new leaf, descending where the surface area increases the least
+	AABB leafBounds = nodes[leaf].bounds;
+	int index = root;
+	while (!nodes[index].isLeaf())
+	{
+		const Node& node = nodes[index];
+		float area = node.bounds.surfaceArea();
+		float combinedArea = AABB::merge(node.bounds, leafBounds).surfaceArea();
+
+		// Cost of creating a new parent for this node and the new leaf
+		float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [this, &leafBounds, inheritanceCost](int child)
+		{
+			const Node& childNode = nodes[child];
+			float mergedArea = AABB::merge(childNode.bounds, leafBounds).surfaceArea();
+			return childNode.isLeaf() ?
+				mergedArea + inheritanceCost :
+				mergedArea - childNode.bounds.surfaceArea() + inheritanceCost;
+		};
+		float cost1 = descendCost(node.child1);
+		float cost2 = descendCost(node.child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+	int sibling = index;
+
+	// Create a new parent for sibling and leaf
+	int oldParent = nodes[sibling].parent;
+	int newParent = allocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (nodes[oldParent].child1 == sibling)
+			nodes[oldParent].child1 = newParent;
+		else
+			nodes[oldParent].child2 = newParent;
+	}
+	else
+	{
+		root = newParent;
+	}
+
+	refitAncestors(newParent);
+}
+
+inline void JFF::SpatialBVH::removeLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = NULL_NODE;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	// The sibling replaces the parent
+	if (grandParent != NULL_NODE)
+	{
+		if (nodes[grandParent].child1 == parent)
+			nodes[grandParent].child1 = sibling;
+		else
+			nodes[grandParent].child2 = sibling;
+		nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		refitAncestors(grandParent);
+	}
+	else
+	{
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		freeNode(parent);
+	}
+
+	nodes[leaf].parent = NULL_NODE;
+}
+
+inline int JFF::SpatialBVH::balance(int a)
+{
+	if (nodes[a].isLeaf() || nodes[a].height < 2)
+		return a;
+
+	int b = nodes[a].child1;
+	int c = nodes[a].child2;
+	int heightDiff = nodes[c].height - nodes[b].height;
+
+	// Rotate the higher child up. Its higher grandchild stays with it and the other one goes down to 'a'
+	if (heightDiff > 1 || heightDiff < -1)
+	{
+		int up = heightDiff > 1 ? c : b;
+		int other = heightDiff > 1 ? b : c;
+		int f = nodes[up].child1;
+		int g = nodes[up].child2;
+		int keep = nodes[f].height > nodes[g].height ? f : g;
+		int give = keep == f ? g : f;
+
+		// 'up' takes the place of 'a'
+		nodes[up].parent = nodes[a].parent;
+		if (nodes[up].parent != NULL_NODE)
+		{
+			if (nodes[nodes[up].parent].child1 == a)
+				nodes[nodes[up].parent].child1 = up;
+			else
+				nodes[nodes[up].parent].child2 = up;
+		}
+		else
+		{
+			root = up;
+		}
+
+		// 'a' becomes a child of 'up' and adopts the lower grandchild
+		nodes[up].child1 = a;
+		nodes[up].child2 = keep;
+		nodes[a].parent = up;
+		nodes[a].child1 = other;
+		nodes[a].child2 = give;
+		nodes[give].parent = a;
+
+		refitNode(a);
+		refitNode(up);
+		return up;
+	}
+
+	return a;
+}
+
+inline void JFF::SpatialBVH::refitNode(int node)
+{
+	Node& n = nodes[node];
+	const Node& child1 = nodes[n.child1];
+	const Node& child2 = nodes[n.child2];
+
+	n.bounds = AABB::merge(child1.bounds, child2.bounds);
+	n.layers = child1.layers | child2.layers;
+	n.height = 1 + std::max(child1.height, child2.height);
+}
+
+inline void JFF::SpatialBVH::refitAncestors(int node)
+{
+	// Walk back up the tree fixing bounds, layers and heights
+	int index = node;
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+		refitNode(index);
+		index = nodes[index].parent;
+	}
+}
+
+inline JFF::AABB JFF::SpatialBVH::calculateTightBounds(const Node& leaf) const
+{
+	return leaf.localBounds.transformed(leaf.gameObject->transform.getModelMatrix());
+}
+
+inline JFF::AABB JFF::SpatialBVH::calculateFatBounds(const Node& leaf) const
+{
+	AABB tightBounds = calculateTightBounds(leaf);
+
+	float size = 0.0f;
+	for (int i = 0; i < 3; ++i)
+		size = std::max(size, tightBounds.max[i] - tightBounds.min[i]);
+
+	return tightBounds.expanded(size * relativeMargin);
+}
+
+inline bool JFF::SpatialBVH::isValidProxy(unsigned int proxy) const
+{
+	return proxy < nodes.size() && nodes[proxy].height == 0 && nodes[proxy].component != nullptr;
+}
+
+template<typename _Test>
+inline void JFF::SpatialBVH::queryOverlaps(const _Test& test, unsigned int layerMask, std::vector<Component*>& outComponents) const
+{
+	if (root == NULL_NODE)
+		return;
+
+	queryStack.clear();
+	queryStack.push_back(root);
+	while (!queryStack.empty())
+	{
+		const Node& node = nodes[queryStack.back()];
+		queryStack.pop_back();
+
+		// Skip whole subtrees without requested layers or outside the query volume
+		if (!(node.layers & layerMask) || !test.overlaps(node.bounds))
+			continue;
+
+		if (node.isLeaf())
+		{
+			outComponents.push_back(node.component);
+		}
+		else
+		{
+			queryStack.push_back(node.child1);
+			queryStack.push_back(node.child2);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*
+* ---------------------------------------------------------------------------
+* JustForFun game engine
+* ---------------------------------------------------------------------------
+*
+* Copyright (c) 2022-2023, Francisco José Carmona.
+*
+* All Rights Reserved.
+*/
+
+#pragma once
+
+#include "Spatial.h"
+
+namespace JFF
+{
+	class GameObject;
+
+	/*
+	* Spatial subsystem implemented as a dynamic AABB tree (BVH).
+	* Leaves store fat world bounds (tight bounds plus a margin), so small movements don't change the tree.
+	* New leaves are inserted next to the sibling that least increases the tree's surface area, and the tree is kept
+	* balanced with rotations. Proxies are refitted once per frame, before rendering, only if their transform changed
+	*/
+	class SpatialBVH : public Spatial
+	{
+	public:
+		// Ctor & Dtor
+		SpatialBVH();
+		virtual ~SpatialBVH();
+
+		// Copy ctor and copy assignment
+		SpatialBVH(const SpatialBVH& other) = delete;
+		SpatialBVH& operator=(const SpatialBVH& other) = delete;
+
+		// Move ctor and assignment
+		SpatialBVH(SpatialBVH&& other) = delete;
+		SpatialBVH operator=(SpatialBVH&& other) = delete;
+
+		// Subsystem impl
+		virtual void load() override;
+		virtual void postLoad(Engine* engine) override;
+		virtual UnloadOrder getUnloadOrder() const override;
+
+		// ExecutableSubsystem impl
+		virtual ExecutableSubsystem::ExecutionOrder getExecutionOrder() const override;
+		virtual bool execute() override;
+
+		// ------------------------------------ Spatial interface ------------------------------------ //
+
+		/*
+		* Creates a proxy for a component. localBounds are in the space of the component's GameObject, and its world bounds
+		* follow the GameObject's transform automatically. The component must destroy its proxy before being destroyed
+		*/
+		virtual unsigned int createProxy(Component* component, const AABB& localBounds, Layer layer) override;
+
+		// Destroys a proxy created with createProxy()
+		virtual void destroyProxy(unsigned int proxy) override;
+
+		// Changes the local bounds of a proxy
+		virtual void setProxyLocalBounds(unsigned int proxy, const AABB& localBounds) override;
+
+		// Gets the world bounds of a proxy, as they were after last update. These bounds may be slightly bigger than the real ones
+		virtual AABB getProxyWorldBounds(unsigned int proxy) const override;
+
+		// Gets the exact world bounds of a proxy. They are calculated on each call
+		virtual AABB getProxyTightWorldBounds(unsigned int proxy) const override;
+
+		// Appends to outComponents all components of given layers whose world bounds are inside the frustum
+		virtual void queryFrustum(const Frustum& frustum, unsigned int layerMask, std::vector<Component*>& outComponents) const override;
+
+		// Appends to outComponents all components of given layers whose world bounds overlap the box
+		virtual void queryAABB(const AABB& box, unsigned int layerMask, std::vector<Component*>& outComponents) const override;
+
+		// Appends to outComponents all components of given layers whose world bounds overlap the sphere
+		virtual void querySphere(const Sphere& sphere, unsigned int layerMask, std::vector<Component*>& outComponents) const override;
+
+		// Finds the closest component of given layers whose world bounds are hit by the ray. Returns false if nothing was hit
+		virtual bool rayCast(const Ray& ray, float maxDistance, unsigned int layerMask, RayCastHit& outHit) const override;
+
+	protected:
+		static const int NULL_NODE = -1;
+
+		struct Node
+		{
+			AABB bounds;		// Fat world bounds on leaves. Union of children bounds on internal nodes
+			unsigned int layers;// Layer of the proxy on leaves. Union of children layers on internal nodes
+			int parent;
+			int child1;
+			int child2;
+			int height;			// Leaves have height 0. Free nodes have height -1
+			int next;			// Next free node
+
+			// Proxy data (Only on leaves)
+			Component* component;
+			GameObject* gameObject;
+			AABB localBounds;
+			unsigned int transformVersion;
+			int leafSlot;		// Index in 'leaves'
+
+			bool isLeaf() const { return child1 == NULL_NODE; }
+		};
+
+	private: // Aux functions
+		// Node pool
+		inline int allocateNode();
+		inline void freeNode(int node);
+
+		// Tree maintenance
+		inline void insertLeaf(int leaf);
+		inline void removeLeaf(int leaf);
+		inline int balance(int node);
+		inline void refitNode(int node);
+		inline void refitAncestors(int node);
+
+		// World bounds of a proxy from its GameObject's model matrix
+		inline AABB calculateTightBounds(const Node& leaf) const;
+		inline AABB calculateFatBounds(const Node& leaf) const;
+		inline bool isValidProxy(unsigned int proxy) const;
+
+		// Generic traversal used by overlap queries
+		template<typename _Test> inline void queryOverlaps(const _Test& test, unsigned int layerMask, std::vector<Component*>& outComponents) const;
+
+	protected:
+		Engine* engine;
+
+		std::vector<Node> nodes;
+		int root;
+		int freeList;
+
+		// Leaf nodes (proxies), checked every frame to find moved ones
+		std::vector<int> leaves;
+
+		// Traversal stack reused by all queries. Queries aren't reentrant nor thread safe
+		mutable std::vector<int> queryStack;
+
+		// Fat bounds margin, relative to the size of the tight bounds
+		float relativeMargin;
+	};
+}
\ No newline at end of file
@@ -3,22 +3,18 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "SpotLightComponent.h"
+#include "MathFunctions.h"
 
 #include "Log.h"
 #include "Engine.h"
 #include "ShaderCodeBuilder.h"
 
-#include <sstream>
-
-extern std::shared_ptr<JFF::Framebuffer> createFramebuffer(JFF::Framebuffer::PrefabFramebuffer fboType,
-	unsigned int width, unsigned int height, unsigned int samplesPerPixel = 0);
-
 extern std::shared_ptr<JFF::Material> createMaterial(JFF::Engine* const engine, const char* name);
 
 JFF::SpotLightComponent::SpotLightComponent(GameObject* const gameObject, const char* name, bool initiallyEnabled, 
@@ -32,7 +28,6 @@ JFF::SpotLightComponent::SpotLightComponent(GameObject* const gameObject, const
 	outerHalfAngleCutoff(0.0f),
 
 	shadowProjectionMatrix(),
-	shadowMapFBO(),
 	shadowCastMaterial()
 {
 	JFF_LOG_INFO("Ctor SpotLightComponent")
@@ -47,12 +42,9 @@ JFF::SpotLightComponent::~SpotLightComponent()
 
 void JFF::SpotLightComponent::onStart()
 {
-	// Create a shadowmap framebuffer if this light casts shadows
+	// Create the shadow cast material if this light casts shadows. The shadow map is a region of the renderer's shadow atlas
 	if (params.castShadows)
 	{
-		shadowMapFBO = createFramebuffer(Framebuffer::PrefabFramebuffer::FBO_SHADOW_MAP, 
-			params.shadowMapWidth, params.shadowMapHeight);
-
 		shadowCastMaterial = createMaterial(engine, "Spot light material");
 		shadowCastMaterial->setDomain(Material::MaterialDomain::SHADOW_CAST);
 		shadowCastMaterial->cook();
@@ -67,63 +59,48 @@ void JFF::SpotLightComponent::onDestroy() noexcept
 	// Unregister the light in Renderer
 	gameObject->engine->renderer.lock()->removeLight(this);
 
-	// Destroy framebuffer and material
-	if (shadowMapFBO)
-		shadowMapFBO->destroy();
-
+	// Destroy material
 	if (shadowCastMaterial)
 		shadowCastMaterial->destroy();
 }
 
 void JFF::SpotLightComponent::sendLightParams(RenderComponent* const renderComponent, int lightIndex)
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
 
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_POSITION;
 	auto lightWorldPos = gameObject->transform.getModelMatrix() * Vec4(0.0f, 0.0f, 0.0f, 1.0f);
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
+	renderComponent->sendVec3(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_POSITION.c_str()), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_DIRECTION;
 	auto lightDir = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightDir.x, lightDir.y, lightDir.z));
+	renderComponent->sendVec3(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_DIRECTION.c_str()), Vec3(lightDir.x, lightDir.y, lightDir.z));
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_COLOR;
-	renderComponent->sendVec3(ss.str().c_str(), params.color);
+	renderComponent->sendVec3(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_COLOR.c_str()), params.color);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_INTENSITY;
-	renderComponent->sendFloat(ss.str().c_str(), params.intensity);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_INTENSITY.c_str()), params.intensity);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_LINEAR_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.linearAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_LINEAR_ATTENUATION_FACTOR.c_str()), params.linearAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_QUADRATIC_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.quadraticAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_QUADRATIC_ATTENUATION_FACTOR.c_str()), params.quadraticAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_INNER_HALF_ANGLE_CUTOFF;
-	renderComponent->sendFloat(ss.str().c_str(), innerHalfAngleCutoff);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_INNER_HALF_ANGLE_CUTOFF.c_str()), innerHalfAngleCutoff);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_OUTER_HALF_ANGLE_CUTOFF;
-	renderComponent->sendFloat(ss.str().c_str(), outerHalfAngleCutoff);
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_OUTER_HALF_ANGLE_CUTOFF.c_str()), outerHalfAngleCutoff);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY << "[" << lightIndex << "]." << ShaderCodeBuilder::SPOT_LIGHT_CAST_SHADOWS;
-	renderComponent->sendFloat(ss.str().c_str(), params.castShadows ? 1.0f : 0.0f);
+	// Lights without a region in the shadow atlas (it's full) don't cast shadows
+	auto shadowAtlas = engine->renderer.lock()->getShadowAtlas().lock();
+	Vec4 shadowMapRegion;
+	bool hasShadowMap = params.castShadows && shadowAtlas->getRegionUV(this, shadowMapRegion);
 
-	if (params.castShadows)
+	renderComponent->sendFloat(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_CAST_SHADOWS.c_str()), hasShadowMap ? 1.0f : 0.0f);
+
+	if (hasShadowMap)
 	{
-		renderComponent->sendSpotLightShadowMap(lightIndex, shadowMapFBO);
+		renderComponent->sendSpotLightShadowMap(lightIndex, shadowAtlas->getFramebuffer());
 
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::SPOT_LIGHT_MATRICES << "[" << lightIndex << "]";
-		renderComponent->sendMat4(ss.str().c_str(), getProjectionMatrix() * getViewMatrix());
+		renderComponent->sendVec4(frameAllocator.format("%s[%d].%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT_ARRAY.c_str(), lightIndex, ShaderCodeBuilder::SPOT_LIGHT_SHADOW_MAP_REGION.c_str()), shadowMapRegion);
+
+		renderComponent->sendMat4(frameAllocator.format("%s[%d]", ShaderCodeBuilder::SPOT_LIGHT_MATRICES.c_str(), lightIndex), getProjectionMatrix() * getViewMatrix());
 	}
 	else
 	{
@@ -133,53 +110,41 @@ void JFF::SpotLightComponent::sendLightParams(RenderComponent* const renderCompo
 
 void JFF::SpotLightComponent::sendLightParams(RenderComponent* const renderComponent)
 {
-	std::string emptyString;
-	std::ostringstream ss(emptyString);
+	FrameAllocator& frameAllocator = gameObject->engine->frameAllocator;
+	FrameAllocator::Scope frameScope(frameAllocator); // Uniform names are only needed in this call
 
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_POSITION;
 	auto lightWorldPos = gameObject->transform.getModelMatrix() * Vec4(0.0f, 0.0f, 0.0f, 1.0f);
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
+	renderComponent->sendVec3(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_POSITION.c_str()), Vec3(lightWorldPos.x, lightWorldPos.y, lightWorldPos.z));
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_DIRECTION;
 	auto lightDir = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
-	renderComponent->sendVec3(ss.str().c_str(), Vec3(lightDir.x, lightDir.y, lightDir.z));
+	renderComponent->sendVec3(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_DIRECTION.c_str()), Vec3(lightDir.x, lightDir.y, lightDir.z));
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_COLOR;
-	renderComponent->sendVec3(ss.str().c_str(), params.color);
+	renderComponent->sendVec3(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_COLOR.c_str()), params.color);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_INTENSITY;
-	renderComponent->sendFloat(ss.str().c_str(), params.intensity);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_INTENSITY.c_str()), params.intensity);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_LINEAR_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.linearAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_LINEAR_ATTENUATION_FACTOR.c_str()), params.linearAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_QUADRATIC_ATTENUATION_FACTOR;
-	renderComponent->sendFloat(ss.str().c_str(), params.quadraticAttenuationFactor);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_QUADRATIC_ATTENUATION_FACTOR.c_str()), params.quadraticAttenuationFactor);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_INNER_HALF_ANGLE_CUTOFF;
-	renderComponent->sendFloat(ss.str().c_str(), innerHalfAngleCutoff);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_INNER_HALF_ANGLE_CUTOFF.c_str()), innerHalfAngleCutoff);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_OUTER_HALF_ANGLE_CUTOFF;
-	renderComponent->sendFloat(ss.str().c_str(), outerHalfAngleCutoff);
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_OUTER_HALF_ANGLE_CUTOFF.c_str()), outerHalfAngleCutoff);
 
-	ss.str(emptyString);
-	ss << ShaderCodeBuilder::SPOT_LIGHT_STRUCT << "." << ShaderCodeBuilder::SPOT_LIGHT_CAST_SHADOWS;
-	renderComponent->sendFloat(ss.str().c_str(), params.castShadows ? 1.0f : 0.0f);
+	// Lights without a region in the shadow atlas (it's full) don't cast shadows
+	auto shadowAtlas = engine->renderer.lock()->getShadowAtlas().lock();
+	Vec4 shadowMapRegion;
+	bool hasShadowMap = params.castShadows && shadowAtlas->getRegionUV(this, shadowMapRegion);
 
-	if (params.castShadows)
+	renderComponent->sendFloat(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_CAST_SHADOWS.c_str()), hasShadowMap ? 1.0f : 0.0f);
+
+	if (hasShadowMap)
 	{
-		renderComponent->sendSpotLightShadowMap(0, shadowMapFBO);
+		renderComponent->sendSpotLightShadowMap(0, shadowAtlas->getFramebuffer());
 
-		ss.str(emptyString);
-		ss << ShaderCodeBuilder::SPOT_LIGHT_MATRIX;
-		renderComponent->sendMat4(ss.str().c_str(), getProjectionMatrix() * getViewMatrix());
+		renderComponent->sendVec4(frameAllocator.format("%s.%s", ShaderCodeBuilder::SPOT_LIGHT_STRUCT.c_str(), ShaderCodeBuilder::SPOT_LIGHT_SHADOW_MAP_REGION.c_str()), shadowMapRegion);
+
+		renderComponent->sendMat4(ShaderCodeBuilder::SPOT_LIGHT_MATRIX.c_str(), getProjectionMatrix() * getViewMatrix());
 	}
 	else
 	{
@@ -189,18 +154,40 @@ void JFF::SpotLightComponent::sendLightParams(RenderComponent* const renderCompo
 
 void JFF::SpotLightComponent::enableShadowMapFramebuffer()
 {
-	shadowMapFBO->enable();
+	// Only binds the atlas. Its region is cleared by the shadow cast render pass
+	engine->renderer.lock()->getShadowAtlas().lock()->enable();
 }
 
 void JFF::SpotLightComponent::disableShadowMapFramebuffer()
 {
-	shadowMapFBO->disable();
+	engine->renderer.lock()->getShadowAtlas().lock()->disable();
+}
+
+bool JFF::SpotLightComponent::hasStaticShadowMap() const
+{
+	return engine->renderer.lock()->getShadowAtlas().lock()->hasStaticCache();
+}
+
+void JFF::SpotLightComponent::enableStaticShadowMapFramebuffer()
+{
+	// Static casters are cached in the same region of the static atlas
+	engine->renderer.lock()->getShadowAtlas().lock()->enableStatic();
+}
+
+void JFF::SpotLightComponent::restoreStaticShadowMap()
+{
+	engine->renderer.lock()->getShadowAtlas().lock()->restoreStaticRegion(this);
 }
 
 void JFF::SpotLightComponent::getShadowMapSizePixels(unsigned int& outWidth, unsigned int& outHeight) const
 {
-	outWidth = params.shadowMapWidth;
-	outHeight = params.shadowMapHeight;
+	// Size of this light's region in the shadow atlas
+	ShadowAtlas::Region region;
+	if (!engine->renderer.lock()->getShadowAtlas().lock()->getRegion(this, region))
+		region.size = 0u;
+
+	outWidth = region.size;
+	outHeight = region.size;
 }
 
 void JFF::SpotLightComponent::useMaterial()
@@ -234,7 +221,7 @@ JFF::Mat4 JFF::SpotLightComponent::getViewMatrix() const
 	Vec4 lightDir4 = gameObject->transform.getRotationMatrix() * Vec4::DOWN;
 	Vec3 lightDir(lightDir4.pitch, lightDir4.yaw, lightDir4.roll);
 
-	return gameObject->engine->math.lock()->lookAt(lightPos, lightPos + lightDir, Vec3::UP);
+	return JFF::lookAt<4>(lightPos, lightPos + lightDir, Vec3::UP);
 }
 
 JFF::Mat4 JFF::SpotLightComponent::getProjectionMatrix() const
@@ -281,20 +268,18 @@ float JFF::SpotLightComponent::getIntensity() const
 
 void JFF::SpotLightComponent::setSpotLightImportanceVolume(float innerHalfAngleDegrees, float outerHalfAngleDegrees, float zNear, float zFar)
 {
-	auto math = gameObject->engine->math.lock();
-
 	params.innerHalfAngleDegrees = innerHalfAngleDegrees;
 	params.outerHalfAngleDegrees = outerHalfAngleDegrees;
 	params.zNear = zNear;
 	params.zFar = zFar;
 
-	outerHalfAngleCutoff = math->cos(math->radians(outerHalfAngleDegrees));
-	innerHalfAngleCutoff = math->cos(math->radians(innerHalfAngleDegrees));
+	outerHalfAngleCutoff = JFF::cos(JFF::radians(outerHalfAngleDegrees));
+	innerHalfAngleCutoff = JFF::cos(JFF::radians(innerHalfAngleDegrees));
 
-	float fovyRad = math->radians(params.outerHalfAngleDegrees * 2.0f); // Double the angle of outerHalfAngleDegrees
-	float aspect = (float)params.shadowMapWidth / (float)params.shadowMapHeight;
+	float fovyRad = JFF::radians(params.outerHalfAngleDegrees * 2.0f); // Double the angle of outerHalfAngleDegrees
+	float aspect = 1.0f; // Shadow atlas regions are square
 
-	shadowProjectionMatrix = math->perspective(fovyRad, aspect, zNear, zFar);
+	shadowProjectionMatrix = JFF::perspective<4>(fovyRad, aspect, zNear, zFar);
 }
 
 float JFF::SpotLightComponent::getLinearAttenuationFactor() const
@@ -314,3 +299,8 @@ void JFF::SpotLightComponent::getSpotLightImportanceVolume(float& outInnerHalfAn
 	outZNear = params.zNear;
 	outZFar = params.zFar;
 }
+
+unsigned int JFF::SpotLightComponent::getShadowMapMaxSizePixels() const
+{
+	return std::max(params.shadowMapWidth, params.shadowMapHeight);
+}
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -51,7 +51,8 @@ namespace JFF
 			float innerHalfAngleDegrees; 
 			float outerHalfAngleDegrees;
 
-			// Shadow casting
+			// Shadow casting. The shadow map is a square region of the shadow atlas, sized by the importance of this light on screen.
+			// Its size is never bigger than the biggest of shadowMapWidth and shadowMapHeight
 			bool castShadows;
 			unsigned int shadowMapWidth, shadowMapHeight;
 
@@ -89,6 +90,9 @@ namespace JFF
 		virtual bool castShadows() const override { return params.castShadows; }
 		virtual void enableShadowMapFramebuffer() override;
 		virtual void disableShadowMapFramebuffer() override;
+		virtual bool hasStaticShadowMap() const override;
+		virtual void enableStaticShadowMapFramebuffer() override;
+		virtual void restoreStaticShadowMap() override;
 		virtual void getShadowMapSizePixels(unsigned int& outWidth, unsigned int& outHeight) const override;
 		virtual void useMaterial() override;
 		virtual void sendMat4(const char* variableName, const Mat4& matrix) override;
@@ -111,6 +115,7 @@ namespace JFF
 		virtual float getLinearAttenuationFactor() const;
 		virtual float getQuadraticAttenuationFactor() const;
 		virtual void getSpotLightImportanceVolume(float& outInnerHalfAngleDegrees, float& outOuterHalfAngleDegrees, float& outZNear, float& outZFar) const;
+		virtual unsigned int getShadowMapMaxSizePixels() const;
 
 	protected:
 		Engine* engine;
@@ -123,7 +128,6 @@ namespace JFF
 		float innerHalfAngleCutoff;
 		
 		Mat4 shadowProjectionMatrix;
-		std::shared_ptr<Framebuffer> shadowMapFBO;
 		std::shared_ptr<Material> shadowCastMaterial;
 	};
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -28,6 +28,7 @@ namespace JFF
 			CUSTOM_SUBSYSTEM = 1,
 
 			PHYSICS,
+			SPATIAL,
 			RENDERER,
 			CAMERA,
 			INPUT,
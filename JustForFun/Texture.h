@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -105,12 +105,21 @@ namespace JFF
 		// Make the texture available to the material sampler on the selected texture unit
 		virtual void use(int textureUnit) = 0;
 
-		// Free memory that contains this texture and makes it unavailable
+		/*
+		* Free memory that contains this texture and makes it unavailable.
+		* Don't call this on a cached texture because it may be shared. Use Cache::releaseCacheItem() instead
+		*/
 		virtual void destroy() = 0;
 
 		// Gets the texture name. This name will match the name of the shader's sampler
 		virtual std::string getName() const = 0;
 
+		/*
+		* Same as writeToFile(), but the render loop doesn't wait for the GPU nor for the encoding: pixels are copied to a GPU
+		* buffer and the file is written some frames later by a worker thread
+		*/
+		virtual void writeToFileAsync(const char* newFilename, bool storeInGeneratedSubfolder = true) = 0;
+
 		// Gets info about the internal image this texture is holding
 		virtual ImageInfo getImageInfo() const = 0;
 
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -15,9 +15,9 @@
 
 #include "stb_image_write.h"
 #include "FileSystemSetup.h"
+#include "ImageReadbackGLSTBI.h"
 
 #include <sstream>
-#include <regex>
 
 JFF::TextureGLSTBI::TextureGLSTBI(JFF::Engine* const engine, const char* name, const char* assetFilePath) :
 	engine(engine),
@@ -47,7 +47,7 @@ JFF::TextureGLSTBI::TextureGLSTBI(JFF::Engine* const engine, const char* name, c
 
 	// Extract other image loading parameters
 	if (iniFile->has("image", "folder"))
-		imgInfo.folder = std::regex_replace(iniFile->getString("image", "folder"), std::regex(R"raw(/)raw"), JFF_SLASH_STRING);
+		imgInfo.folder = toPlatformPath(iniFile->getString("image", "folder"));
 
 	bool flipVertically = true;
 	if (iniFile->has("image", "flip-vertically"))
@@ -114,12 +114,12 @@ JFF::TextureGLSTBI::~TextureGLSTBI()
 {
 	JFF_LOG_INFO("Dtor TextureGLSTBI")
 
-	// Ensure the texture GPU memory is destroyed
+	/*
+	* Ensure the texture GPU memory is destroyed. Cached textures are never destroyed by their users, 
+	* so this is the place where their GPU memory is released, once the cache and all materials drop them
+	*/
 	if (!isDestroyed)
-	{
-		JFF_LOG_WARNING("Texture GPU memory successfully destroyed on Texture's destructor. You should call destroy() before destructor is called")
 		destroy();
-	}
 }
 
 std::string JFF::TextureGLSTBI::getCacheName() const
@@ -145,19 +145,11 @@ void JFF::TextureGLSTBI::writeToFile(const char* newFilename, bool storeInGenera
 	GLenum imgFormat = extractImageFormat(numChannels, bgra);
 	GLenum imgType = extractImageType(HDR);
 
-	// Full path
-	std::ostringstream oss;
-	oss << "Assets" << JFF_SLASH;
-	if (storeInGeneratedSubfolder)
-		oss << "Generated" << JFF_SLASH;
-	oss << newFilename;
-
 	// Read data from OpenGL and write it to disk
 	if (HDR)
 	{
 		// HDR have .hdr extension
-		oss << ".hdr";
-		std::string fullPath = oss.str();
+		std::string fullPath = getFilePath(newFilename, storeInGeneratedSubfolder) + ".hdr";
 
 		float* pixels = new float[(size_t)width * height * numChannels]; // TODO: Keep in mind memory alignment (glPixelStorei())
 		glGetTexImage(GL_TEXTURE_2D, mipmapLevel, imgFormat, imgType, pixels);
@@ -167,8 +159,7 @@ void JFF::TextureGLSTBI::writeToFile(const char* newFilename, bool storeInGenera
 	else
 	{
 		// Non HDR have .png extension
-		oss << ".png";
-		std::string fullPath = oss.str();
+		std::string fullPath = getFilePath(newFilename, storeInGeneratedSubfolder) + ".png";
 
 		unsigned char* pixels = new unsigned char[(size_t)width * height * numChannels]; // TODO: Keep in mind memory alignment (glPixelStorei())
 		glGetTexImage(GL_TEXTURE_2D, mipmapLevel, imgFormat, imgType, pixels);
@@ -199,6 +190,35 @@ JFF::Texture::ImageInfo JFF::TextureGLSTBI::getImageInfo() const
 	return imgInfo;
 }
 
+void JFF::TextureGLSTBI::writeToFileAsync(const char* newFilename, bool storeInGeneratedSubfolder)
+{
+	// Select this as target texture
+	use(0); // Used texture unit 0 because it's not important here
+
+	int mipmapLevel = imgInfo.mipmapLevel;
+
+	ImageReadbackGLSTBI::Request request;
+	request.filePath	= getFilePath(newFilename, storeInGeneratedSubfolder); // Extension is added depending on HDR
+	request.width		= imgInfo.width / (int)std::pow(2, mipmapLevel);
+	request.height		= imgInfo.height / (int)std::pow(2, mipmapLevel);
+	request.numChannels = imgInfo.numChannels;
+	request.HDR			= imgInfo.HDR;
+	request.imgFormat	= extractImageFormat(imgInfo.numChannels, imgInfo.bgra);
+
+	ImageReadbackGLSTBI::getInstance().readTexImage(GL_TEXTURE_2D, mipmapLevel, request);
+}
+
+inline std::string JFF::TextureGLSTBI::getFilePath(const char* newFilename, bool storeInGeneratedSubfolder) const
+{
+	std::ostringstream oss;
+	oss << "Assets" << JFF_SLASH;
+	if (storeInGeneratedSubfolder)
+		oss << "Generated" << JFF_SLASH;
+	oss << newFilename;
+
+	return oss.str();
+}
+
 inline GLenum JFF::TextureGLSTBI::extractImageFormat(const std::shared_ptr<Image>& image) const
 {
 	const Image::Data& imgData = image->data();
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -51,7 +51,14 @@ namespace JFF
 		virtual std::string getName() const override;
 		virtual ImageInfo getImageInfo() const override;
 
+		/*
+		* Same as writeToFile(), but the render loop doesn't wait for the GPU nor for the encoding: pixels are copied to a GPU
+		* buffer and the file is written some frames later by a worker thread
+		*/
+		virtual void writeToFileAsync(const char* newFilename, bool storeInGeneratedSubfolder = true) override;
+
 	private:
+		inline std::string getFilePath(const char* newFilename, bool storeInGeneratedSubfolder) const;
 		inline GLenum extractImageFormat(const std::shared_ptr<Image>& image) const;
 		inline GLenum extractImageFormat(int numChannels, bool bgra) const;
 		inline GLenum extractImageType(const std::shared_ptr<Image>& image) const;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -11,7 +11,9 @@
 #include "TransformComponent.h"
 
 #include "Engine.h"
+#include "SceneStorage.h"
 #include "Log.h"
+#include "MathFunctions.h"
 
 JFF::TransformComponent::TransformComponent(
 	GameObject* const gameObject,
@@ -23,7 +25,7 @@ JFF::TransformComponent::TransformComponent(
 	Component(gameObject, name, initiallyEnabled),
 	
 	localPos(localPosition),
-	localRot(localRotation),
+	localRot(eulerDegreesToQuat(localRotation)),
 	localScale(localScale),
 	
 	dirtyMatrices(true),
@@ -42,7 +44,7 @@ JFF::TransformComponent::~TransformComponent()
 void JFF::TransformComponent::setLocalPos(Vec3 localPos)
 {
 	this->localPos = localPos;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalPos(float x, float y, float z)
@@ -51,64 +53,73 @@ void JFF::TransformComponent::setLocalPos(float x, float y, float z)
 	localPos.y = y;
 	localPos.z = z;
 
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalX(float x)
 {
 	localPos.x = x;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalY(float y)
 {
 	localPos.y = y;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalZ(float z)
 {
 	localPos.z = z;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalRotation(Vec3 localRot)
 {
-	this->localRot = localRot;
-	dirtyMatrices = true;
+	this->localRot = eulerDegreesToQuat(localRot);
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalRotation(float pitch, float yaw, float roll)
 {
-	localRot.pitch = pitch;
-	localRot.yaw = yaw;
-	localRot.roll = roll;
-
-	dirtyMatrices = true;
+	localRot = eulerDegreesToQuat(Vec3(pitch, yaw, roll));
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalPitch(float pitch)
 {
-	localRot.pitch = pitch;
-	dirtyMatrices = true;
+	Vec3 euler = quatToEulerDegrees(localRot);
+	euler.pitch = pitch;
+	localRot = eulerDegreesToQuat(euler);
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalYaw(float yaw)
 {
-	localRot.yaw = yaw;
-	dirtyMatrices = true;
+	Vec3 euler = quatToEulerDegrees(localRot);
+	euler.yaw = yaw;
+	localRot = eulerDegreesToQuat(euler);
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalRoll(float roll)
 {
-	localRot.roll = roll;
-	dirtyMatrices = true;
+	Vec3 euler = quatToEulerDegrees(localRot);
+	euler.roll = roll;
+	localRot = eulerDegreesToQuat(euler);
+	setDirty();
+}
+
+void JFF::TransformComponent::setLocalRotation(const Quat& localRot)
+{
+	this->localRot = JFF::normalize(localRot);
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalScale(Vec3 localScale)
 {
 	this->localScale = localScale;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalScale(float x, float y, float z)
@@ -117,31 +128,31 @@ void JFF::TransformComponent::setLocalScale(float x, float y, float z)
 	localScale.y = y;
 	localScale.z = z;
 
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalScaleX(float x)
 {
 	localScale.x = x;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalScaleY(float y)
 {
 	localScale.y = y;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::setLocalScaleZ(float z)
 {
 	localScale.z = z;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalPos(Vec3 addedLocalPos)
 {
 	localPos += addedLocalPos;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalPos(float x, float y, float z)
@@ -150,64 +161,75 @@ void JFF::TransformComponent::addToLocalPos(float x, float y, float z)
 	localPos.y += y;
 	localPos.z += z;
 
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalX(float x)
 {
 	localPos.x += x;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalY(float y)
 {
 	localPos.y += y;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalZ(float z)
 {
 	localPos.z += z;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalRotation(Vec3 addedLocalRot)
 {
-	localRot += addedLocalRot;
-	dirtyMatrices = true;
+	/*
+	* Increments are composed as quaternions instead of going through Euler angles: yaw is applied last around UP,
+	* pitch around the local RIGHT axis and roll first around the local FORWARD axis. Because of that, rotations
+	* keep spinning smoothly past 90º of pitch, where the Euler angles would flip
+	*/
+	Quat addedYaw = JFF::angleAxis(JFF::radians(addedLocalRot.yaw), Vec3::UP);
+	Quat addedPitch = JFF::angleAxis(JFF::radians(addedLocalRot.pitch), Vec3::RIGHT);
+	Quat addedRoll = JFF::angleAxis(JFF::radians(addedLocalRot.roll), Vec3::FORWARD);
+
+	localRot = JFF::normalize(addedYaw * localRot * addedPitch * addedRoll);
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalRotation(float pitch, float yaw, float roll)
 {
-	localRot.pitch += pitch;
-	localRot.yaw += yaw;
-	localRot.roll += roll;
-
-	dirtyMatrices = true;
+	addToLocalRotation(Vec3(pitch, yaw, roll));
 }
 
 void JFF::TransformComponent::addToLocalPitch(float pitch)
 {
-	localRot.pitch += pitch;
-	dirtyMatrices = true;
+	localRot = JFF::normalize(localRot * JFF::angleAxis(JFF::radians(pitch), Vec3::RIGHT));
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalYaw(float yaw)
 {
-	localRot.yaw += yaw;
-	dirtyMatrices = true;
+	localRot = JFF::normalize(JFF::angleAxis(JFF::radians(yaw), Vec3::UP) * localRot);
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalRoll(float roll)
 {
-	localRot.roll += roll;
-	dirtyMatrices = true;
+	localRot = JFF::normalize(localRot * JFF::angleAxis(JFF::radians(roll), Vec3::FORWARD));
+	setDirty();
+}
+
+void JFF::TransformComponent::addToLocalRotation(const Quat& addedLocalRot)
+{
+	localRot = JFF::normalize(addedLocalRot * localRot);
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalScale(Vec3 addedLocalScale)
 {
 	localScale += addedLocalScale;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalScale(float x, float y, float z)
@@ -216,25 +238,25 @@ void JFF::TransformComponent::addToLocalScale(float x, float y, float z)
 	localScale.y += y;
 	localScale.z += z;
 
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalScaleX(float x)
 {
 	localScale.x += x;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalScaleY(float y)
 {
 	localScale.y += y;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 void JFF::TransformComponent::addToLocalScaleZ(float z)
 {
 	localScale.z += z;
-	dirtyMatrices = true;
+	setDirty();
 }
 
 JFF::Vec3 JFF::TransformComponent::getLocalPos() const
@@ -259,22 +281,27 @@ float JFF::TransformComponent::getLocalZ() const
 
 JFF::Vec3 JFF::TransformComponent::getLocalRot() const
 {
-	return localRot;
+	return quatToEulerDegrees(localRot);
 }
 
 float JFF::TransformComponent::getLocalPitch() const
 {
-	return localRot.pitch;
+	return quatToEulerDegrees(localRot).pitch;
 }
 
 float JFF::TransformComponent::getLocalYaw() const
 {
-	return localRot.yaw;
+	return quatToEulerDegrees(localRot).yaw;
 }
 
 float JFF::TransformComponent::getLocalRoll() const
 {
-	return localRot.roll;
+	return quatToEulerDegrees(localRot).roll;
+}
+
+JFF::Quat JFF::TransformComponent::getLocalRotQuat() const
+{
+	return localRot;
 }
 
 JFF::Vec3 JFF::TransformComponent::getLocalScale() const
@@ -305,6 +332,11 @@ JFF::Vec3 JFF::TransformComponent::getWorldPos()
 
 JFF::Mat4 JFF::TransformComponent::getRotationMatrix()
 {
+	// World matrices are stored in the scene storage once per frame. Use them unless this transform (or a parent) changed since then
+	SceneStorage* storage = gameObject->getStorage();
+	if (storage && storage->isWorldTransformValid(gameObject->getStorageHandle()))
+		return storage->getWorldRotationMatrix(gameObject->getStorageHandle());
+
 	if (dirtyMatrices)
 	{
 		rebuildMatrices();
@@ -323,6 +355,10 @@ JFF::Mat4 JFF::TransformComponent::getRotationMatrix()
 
 JFF::Mat4 JFF::TransformComponent::getModelMatrix()
 {
+	SceneStorage* storage = gameObject->getStorage();
+	if (storage && storage->isWorldTransformValid(gameObject->getStorageHandle()))
+		return storage->getWorldModelMatrix(gameObject->getStorageHandle());
+
 	if (dirtyMatrices)
 	{
 		rebuildMatrices();
@@ -341,23 +377,47 @@ JFF::Mat4 JFF::TransformComponent::getModelMatrix()
 
 JFF::Mat3 JFF::TransformComponent::getNormalMatrix()
 {
-	// Extract Math subsystem
-	std::shared_ptr<Math> math = gameObject->engine->math.lock();
-
 	// To get more info about why next line builds a normal matrix, check: http://www.lighthouse3d.com/tutorials/glsl-12-tutorial/the-normal-matrix/
-	return math->transpose(math->inverse(getNormalMatrixRecursive()));
+	return JFF::transpose(JFF::inverse(getNormalMatrixRecursive()));
+}
+
+const JFF::Mat4& JFF::TransformComponent::getLocalModelMatrix()
+{
+	if (dirtyMatrices)
+	{
+		rebuildMatrices();
+		dirtyMatrices = false;
+	}
+
+	return modelMatrix;
+}
+
+const JFF::Mat4& JFF::TransformComponent::getLocalRotationMatrix()
+{
+	if (dirtyMatrices)
+	{
+		rebuildMatrices();
+		dirtyMatrices = false;
+	}
+
+	return rotationMatrix;
+}
+
+inline void JFF::TransformComponent::setDirty()
+{
+	dirtyMatrices = true;
+
+	SceneStorage* storage = gameObject->getStorage();
+	if (storage)
+		storage->markTransformDirty(gameObject->getStorageHandle());
 }
 
 inline void JFF::TransformComponent::rebuildMatrices()
 {
-	// Extract Math subsystem
-	std::shared_ptr<Math> math = gameObject->engine->math.lock();
 	Mat4 identityMatrix;
 
-	// Build a local rotation matrix (remember the order of application is reversed of the order of next lines)
-	rotationMatrix = JFF::rotate(identityMatrix, math->radians(localRot.yaw), Vec3::UP); // 3-yaw
-	rotationMatrix = JFF::rotate(rotationMatrix, math->radians(localRot.pitch), Vec3::RIGHT); // 2-pitch
-	rotationMatrix = JFF::rotate(rotationMatrix, math->radians(localRot.roll), Vec3::FORWARD); // 1-roll
+	// Build a local rotation matrix straight from the quaternion
+	rotationMatrix = JFF::toMat4(localRot);
 
 	// Build a local model matrix (remember the order of application is reversed of the order of next lines)
 	modelMatrix = JFF::translate(identityMatrix, localPos); // Last transformation is translate
@@ -365,11 +425,16 @@ inline void JFF::TransformComponent::rebuildMatrices()
 	modelMatrix = JFF::scale(modelMatrix, localScale); // Scale is applied first
 
 	// Remove translations from model
-	modelMatrixNoTranslations = math->reduceOrder(modelMatrix);
+	modelMatrixNoTranslations = JFF::reduceOrder<3>(modelMatrix);
 }
 
 inline JFF::Mat3 JFF::TransformComponent::getNormalMatrixRecursive()
 {
+	// Upper-left 3x3 of the world model matrix is the product of the upper-left 3x3 of each local model matrix
+	SceneStorage* storage = gameObject->getStorage();
+	if (storage && storage->isWorldTransformValid(gameObject->getStorageHandle()))
+		return JFF::reduceOrder<3>(storage->getWorldModelMatrix(gameObject->getStorageHandle()));
+
 	if (dirtyMatrices)
 	{
 		rebuildMatrices();
@@ -385,3 +450,14 @@ inline JFF::Mat3 JFF::TransformComponent::getNormalMatrixRecursive()
 		return gameObject->parent.lock()->transform.getNormalMatrixRecursive() * modelMatrixNoTranslations;
 	}
 }
+
+inline JFF::Quat JFF::TransformComponent::eulerDegreesToQuat(const Vec3& eulerDegrees)
+{
+	return JFF::eulerToQuat(Vec3(JFF::radians(eulerDegrees.pitch), JFF::radians(eulerDegrees.yaw), JFF::radians(eulerDegrees.roll)));
+}
+
+inline JFF::Vec3 JFF::TransformComponent::quatToEulerDegrees(const Quat& rotation)
+{
+	Vec3 eulerRadians = JFF::quatToEuler(rotation);
+	return Vec3(JFF::degrees(eulerRadians.pitch), JFF::degrees(eulerRadians.yaw), JFF::degrees(eulerRadians.roll));
+}
\ No newline at end of file
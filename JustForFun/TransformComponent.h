@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,6 +12,7 @@
 
 #include "Component.h"
 #include "Mat.h" // Includes Vec.h inside
+#include "Quat.h"
 
 namespace JFF
 {
@@ -49,11 +50,13 @@ namespace JFF
 		virtual void setLocalY(float y);
 		virtual void setLocalZ(float z);
 
+		// Euler rotations are in degrees. They are converted to the stored quaternion
 		virtual void setLocalRotation(Vec3 localRot);
 		virtual void setLocalRotation(float pitch, float yaw, float roll);
 		virtual void setLocalPitch(float pitch);
 		virtual void setLocalYaw(float yaw);
 		virtual void setLocalRoll(float roll);
+		virtual void setLocalRotation(const Quat& localRot);
 
 		virtual void setLocalScale(Vec3 localScale);
 		virtual void setLocalScale(float x, float y, float z);
@@ -61,7 +64,7 @@ namespace JFF
 		virtual void setLocalScaleY(float y);
 		virtual void setLocalScaleZ(float z);
 
-		// Local adders
+		// Local adders. Euler increments are composed with the stored quaternion (Check addToLocalRotation(Vec3))
 		virtual void addToLocalPos(Vec3 addedLocalPos);
 		virtual void addToLocalPos(float x, float y, float z);
 		virtual void addToLocalX(float x);
@@ -73,6 +76,7 @@ namespace JFF
 		virtual void addToLocalPitch(float pitch);
 		virtual void addToLocalYaw(float yaw);
 		virtual void addToLocalRoll(float roll);
+		virtual void addToLocalRotation(const Quat& addedLocalRot); // Applied after current local rotation (in parent space)
 
 		virtual void addToLocalScale(Vec3 addedLocalScale);
 		virtual void addToLocalScale(float x, float y, float z);
@@ -90,6 +94,7 @@ namespace JFF
 		virtual float getLocalPitch() const;
 		virtual float getLocalYaw() const;
 		virtual float getLocalRoll() const;
+		virtual Quat getLocalRotQuat() const;
 
 		virtual Vec3 getLocalScale() const;
 		virtual float getLocalScaleX() const;
@@ -104,13 +109,20 @@ namespace JFF
 		virtual Mat4 getModelMatrix();
 		virtual Mat3 getNormalMatrix();
 
+		// Local matrices (not affected by parents). Used by SceneStorage to build world matrices
+		const Mat4& getLocalModelMatrix();
+		const Mat4& getLocalRotationMatrix();
+
 	private:
+		inline void setDirty();
 		inline void rebuildMatrices();
 		inline Mat3 getNormalMatrixRecursive();
+		inline static Quat eulerDegreesToQuat(const Vec3& eulerDegrees);
+		inline static Vec3 quatToEulerDegrees(const Quat& rotation);
 
 	protected:
 		Vec3 localPos;
-		Vec3 localRot; // The order of rotation is 1-roll, 2-pitch, 3-yaw
+		Quat localRot; // Euler equivalent applies 1º-roll, 2º-pitch, 3º-yaw
 		Vec3 localScale;
 
 		bool dirtyMatrices;
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,6 +12,8 @@
 
 #include "VecSetup.h"
 
+#include <type_traits>
+
 namespace JFF
 {
 	template<int _Dim> class MatBase;
@@ -24,42 +26,43 @@ namespace JFF
 
 	JFF_VEC_GLOBAL_FUNCTIONS // Global functions to operate with vectors
 
+	/*
+	* Vectors only contain their floats. Component names are aliases of the same float, stored in anonymous unions.
+	* This makes them trivially copyable and as big as their data: arrays of vectors can be memcpy'd to uniform buffers,
+	* vertex buffers or SoA arrays directly. They have no alignment requirements, so they can be placed in 16-byte
+	* aligned storage when a buffer layout needs it
+	*/
+
 	template<>
 	class VecBase<2> final
 	{
 	public:
-		// Ctor & Dtor
+		// Ctor
 		explicit VecBase(float scalar = 0.0f);
 		VecBase(JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(2)); // Implicit ctor
 		VecBase(float x, float y);
-		~VecBase();
-
-		// Copy ctor and copy assignment
-		VecBase(const VecBase& other);
-		VecBase& operator=(const VecBase& other);
 
-		// Move ctor and assignment
-		VecBase(VecBase&& other) noexcept;
-		VecBase& operator=(VecBase&& other) noexcept;
+		// Copy, move and destruction are trivial
+		VecBase(const VecBase& other) = default;
+		VecBase& operator=(const VecBase& other) = default;
+		VecBase(VecBase&& other) noexcept = default;
+		VecBase& operator=(VecBase&& other) noexcept = default;
+		~VecBase() = default;
 
 		// Vector raw data
 		const float* operator*() const;
 
 	public:
-		float& x;
-		float& r;
-		float& s;
-
-		float& y;
-		float& g;
-		float& t;
+		union { float x; float r; float s; };
+		union { float y; float g; float t; };
 
 	public: // Predefined static Vec2
 		static const VecBase<2> ZERO;
 		static const VecBase<2> ONE;
 
-	protected: // Implementation dependant attributes
-		JFF_VEC_IMPL_DEPENDANT_ATTRS(2)
+	protected: // Implementation dependant view of this vector
+		JFF_VEC_IMPL_DEPENDANT_VIEW(2)
+
 		JFF_VEC_GLOBAL_FRIENDS
 		JFF_VEC_MAT_FRIEND_FUNCTIONS
 	};
@@ -68,43 +71,27 @@ namespace JFF
 	class VecBase<3> final
 	{
 	public:
-		// Ctor & Dtor
+		// Ctor
 		explicit VecBase(float scalar = 0.0f);
 		VecBase(JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(3)); // Implicit ctor
 		VecBase(float x, float y, float z);
-		~VecBase();
-
-		// Copy ctor and copy assignment
-		VecBase(const VecBase& other);
-		VecBase& operator=(const VecBase& other);
 
-		// Move ctor and assignment
-		VecBase(VecBase&& other) noexcept;
-		VecBase& operator=(VecBase&& other) noexcept;
+		// Copy, move and destruction are trivial
+		VecBase(const VecBase& other) = default;
+		VecBase& operator=(const VecBase& other) = default;
+		VecBase(VecBase&& other) noexcept = default;
+		VecBase& operator=(VecBase&& other) noexcept = default;
+		~VecBase() = default;
 
 		// Vector raw data
 		const float* operator*() const;
 
 	public:
-		float& x;
-		float& r;
-		float& s;
-		float& pitch;
-		float& red;
-
-		float& y;
-		float& g;
-		float& t;
-		float& yaw;
-		float& green;
-
-		float& z;
-		float& b;
-		float& p;
-		float& roll;
-		float& blue;
+		union { float x; float r; float s; float pitch; float red; };
+		union { float y; float g; float t; float yaw; float green; };
+		union { float z; float b; float p; float roll; float blue; };
 
-	public: // Predefined static Vec2
+	public: // Predefined static Vec3
 		static const VecBase<3> ZERO;
 		static const VecBase<3> ONE;
 
@@ -121,8 +108,9 @@ namespace JFF
 		static const VecBase<3> GREEN;
 		static const VecBase<3> BLUE;
 
-	protected: // Implementation dependant attributes
-		JFF_VEC_IMPL_DEPENDANT_ATTRS(3)
+	protected: // Implementation dependant view of this vector
+		JFF_VEC_IMPL_DEPENDANT_VIEW(3)
+
 		JFF_VEC_GLOBAL_FRIENDS
 		JFF_VEC_MAT_FRIEND_FUNCTIONS
 	};
@@ -131,48 +119,28 @@ namespace JFF
 	class VecBase<4> final
 	{
 	public:
-		// Ctor & Dtor
+		// Ctor
 		explicit VecBase(float scalar = 0.0f);
 		VecBase(JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(4)); // Implicit ctor
 		VecBase(float x, float y, float z, float w = 1.0f);
-		~VecBase();
-
-		// Copy ctor and copy assignment
-		VecBase(const VecBase& other);
-		VecBase& operator=(const VecBase& other);
 
-		// Move ctor and assignment
-		VecBase(VecBase&& other) noexcept;
-		VecBase& operator=(VecBase&& other) noexcept;
+		// Copy, move and destruction are trivial
+		VecBase(const VecBase& other) = default;
+		VecBase& operator=(const VecBase& other) = default;
+		VecBase(VecBase&& other) noexcept = default;
+		VecBase& operator=(VecBase&& other) noexcept = default;
+		~VecBase() = default;
 
 		// Vector raw data
 		const float* operator*() const;
 
 	public:
-		float& x;
-		float& r;
-		float& s;
-		float& red;
-		float& pitch;
-
-		float& y;
-		float& g;
-		float& t;
-		float& yaw;
-		float& green;
-
-		float& z;
-		float& b;
-		float& p;
-		float& roll;
-		float& blue;
-
-		float& w;
-		float& a;
-		float& q;
-		float& alpha;
+		union { float x; float r; float s; float red; float pitch; };
+		union { float y; float g; float t; float yaw; float green; };
+		union { float z; float b; float p; float roll; float blue; };
+		union { float w; float a; float q; float alpha; };
 
-	public: // Predefined static Vec2
+	public: // Predefined static Vec4
 		static const VecBase<4> ZERO;
 		static const VecBase<4> ONE;
 
@@ -189,8 +157,9 @@ namespace JFF
 		static const VecBase<4> GREEN;
 		static const VecBase<4> BLUE;
 
-	protected: // Implementation dependant attributes
-		JFF_VEC_IMPL_DEPENDANT_ATTRS(4)
+	protected: // Implementation dependant view of this vector
+		JFF_VEC_IMPL_DEPENDANT_VIEW(4)
+
 		JFF_VEC_GLOBAL_FRIENDS
 		JFF_VEC_MAT_FRIEND_FUNCTIONS
 	};
@@ -199,6 +168,10 @@ namespace JFF
 	using Vec2 = VecBase<2>;
 	using Vec3 = VecBase<3>;
 	using Vec4 = VecBase<4>;
+
+	static_assert(std::is_trivially_copyable<Vec2>::value && sizeof(Vec2) == 2 * sizeof(float), "Vec2 must be 2 tightly packed floats");
+	static_assert(std::is_trivially_copyable<Vec3>::value && sizeof(Vec3) == 3 * sizeof(float), "Vec3 must be 3 tightly packed floats");
+	static_assert(std::is_trivially_copyable<Vec4>::value && sizeof(Vec4) == 4 * sizeof(float), "Vec4 must be 4 tightly packed floats");
 }
 
 // Implementation dependant inline definitions
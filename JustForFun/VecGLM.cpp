@@ -3,14 +3,14 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
 
 #include "Vec.h"
 
-// NOTE: Template specializations need to be out of VecGLM.inl to avoid function redefinitions
+// NOTE: Static members need to be out of VecGLM.inl to avoid redefinitions
 
 const JFF::VecBase<2> JFF::VecBase<2>::ZERO(0.0f);
 const JFF::VecBase<3> JFF::VecBase<3>::ZERO(0.0f);
@@ -44,28 +44,4 @@ const JFF::VecBase<4> JFF::VecBase<4>::WHITE(1.0f, 1.0f, 1.0f, 1.0f);
 const JFF::VecBase<4> JFF::VecBase<4>::BLACK(0.0f, 0.0f, 0.0f, 1.0f);
 const JFF::VecBase<4> JFF::VecBase<4>::RED(1.0f, 0.0f, 0.0f, 1.0f);
 const JFF::VecBase<4> JFF::VecBase<4>::GREEN(0.0f, 1.0f, 0.0f, 1.0f);
-const JFF::VecBase<4> JFF::VecBase<4>::BLUE(0.0f, 0.0f, 1.0f, 1.0f);
-
-template<>
-float JFF::sqrtLength(const JFF::VecBase<2>& v)
-{
-	return v.x * v.x + v.y * v.y;
-}
-
-template<>
-float JFF::sqrtLength(const JFF::VecBase<3>& v)
-{
-	return v.x * v.x + v.y * v.y + v.z * v.z;
-}
-
-template<>
-float JFF::sqrtLength(const JFF::VecBase<4>& v)
-{
-	return v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w;
-}
-
-template<>
-JFF::VecBase<3> JFF::cross(const JFF::VecBase<3>& v1, const JFF::VecBase<3>& v2)
-{
-	return glm::cross(v1._vec, v2._vec);
-}
\ No newline at end of file
+const JFF::VecBase<4> JFF::VecBase<4>::BLUE(0.0f, 0.0f, 1.0f, 1.0f);
\ No newline at end of file
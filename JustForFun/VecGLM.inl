@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -13,428 +13,140 @@
 
 #pragma region Vec2
 inline JFF::VecBase<2>::VecBase(float scalar) :
-	_vec(scalar),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t)
+	x(scalar),
+	y(scalar)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor VecBase 2")
 }
 
 inline JFF::VecBase<2>::VecBase(JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(2)) :
-	_vec(vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t)
+	x(vec.x),
+	y(vec.y)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Platform dependant Ctor VecBase 2")
 }
 
 inline JFF::VecBase<2>::VecBase(float x, float y) :
-	_vec(x, y),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t)
+	x(x),
+	y(y)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor VecBase 2")
 }
 
-inline JFF::VecBase<2>::~VecBase()
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Dtor VecBase 2")
-}
-
-inline JFF::VecBase<2>::VecBase(const VecBase& other) :
-	_vec(other._vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t)
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Copy Ctor VecBase 2")
-}
-
-inline JFF::VecBase<2>& JFF::VecBase<2>::operator=(const VecBase& other)
-{
-	_vec = other._vec;
-	return *this;
-}
-
-inline JFF::VecBase<2>::VecBase(VecBase&& other) noexcept :
-	_vec(other._vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t)
-{
-	other.x = 0.0f;
-	other.y = 0.0f;
-	JFF_LOG_INFO_LOW_PRIORITY("Move Ctor VecBase 2")
-}
-
-inline JFF::VecBase<2>& JFF::VecBase<2>::operator=(VecBase&& other) noexcept
-{
-	_vec = other._vec;
-	other.x = 0.0f;
-	other.y = 0.0f;
-	return *this;
-}
-
 inline const float* JFF::VecBase<2>::operator*() const
 {
-	return glm::value_ptr(_vec);
+	return &x;
 }
 #pragma endregion
 
 #pragma region Vec3
 inline JFF::VecBase<3>::VecBase(float scalar) :
-	_vec(scalar),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z)
+	x(scalar),
+	y(scalar),
+	z(scalar)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor VecBase 3")
 }
 
 inline JFF::VecBase<3>::VecBase(JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(3)) :
-	_vec(vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z)
+	x(vec.x),
+	y(vec.y),
+	z(vec.z)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Platform dependant Ctor VecBase 3")
 }
 
 inline JFF::VecBase<3>::VecBase(float x, float y, float z) :
-	_vec(x, y, z),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z)
+	x(x),
+	y(y),
+	z(z)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor VecBase 3")
 }
 
-inline JFF::VecBase<3>::~VecBase()
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Dtor VecBase 3")
-}
-
-inline JFF::VecBase<3>::VecBase(const VecBase& other) :
-	_vec(other._vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z)
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Copy Ctor VecBase 3")
-}
-
-inline JFF::VecBase<3>& JFF::VecBase<3>::operator=(const VecBase& other)
-{
-	_vec = other._vec;
-	return *this;
-}
-
-inline JFF::VecBase<3>::VecBase(VecBase&& other) noexcept :
-	_vec(other._vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z)
-{
-	other.x = 0.0f;
-	other.y = 0.0f;
-	other.z = 0.0f;
-	JFF_LOG_INFO_LOW_PRIORITY("Move Ctor VecBase 3")
-}
-
-inline JFF::VecBase<3>& JFF::VecBase<3>::operator=(VecBase&& other) noexcept
-{
-	_vec = other._vec;
-	other.x = 0.0f;
-	other.y = 0.0f;
-	other.z = 0.0f;
-	return *this;
-}
-
 inline const float* JFF::VecBase<3>::operator*() const
 {
-	return glm::value_ptr(_vec);
+	return &x;
 }
 #pragma endregion
 
 #pragma region Vec4
 inline JFF::VecBase<4>::VecBase(float scalar) :
-	_vec(scalar),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z),
-	w(_vec.w),
-	a(_vec.a),
-	q(_vec.q),
-	alpha(_vec.w)
+	x(scalar),
+	y(scalar),
+	z(scalar),
+	w(scalar)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor VecBase 4")
 }
 
 inline JFF::VecBase<4>::VecBase(JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(4)) :
-	_vec(vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z),
-	w(_vec.w),
-	a(_vec.a),
-	q(_vec.q),
-	alpha(_vec.w)
+	x(vec.x),
+	y(vec.y),
+	z(vec.z),
+	w(vec.w)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Platform dependant Ctor VecBase 4")
 }
 
 inline JFF::VecBase<4>::VecBase(float x, float y, float z, float w) :
-	_vec(x, y, z, w),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z),
-	w(_vec.w),
-	a(_vec.a),
-	q(_vec.q),
-	alpha(_vec.w)
+	x(x),
+	y(y),
+	z(z),
+	w(w)
 {
 	JFF_LOG_INFO_LOW_PRIORITY("Ctor VecBase 4")
 }
 
-inline JFF::VecBase<4>::~VecBase()
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Dtor VecBase 4")
-}
-
-inline JFF::VecBase<4>::VecBase(const VecBase& other) :
-	_vec(other._vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z),
-	w(_vec.w),
-	a(_vec.a),
-	q(_vec.q),
-	alpha(_vec.w)
-{
-	JFF_LOG_INFO_LOW_PRIORITY("Copy Ctor VecBase 4")
-}
-
-inline JFF::VecBase<4>& JFF::VecBase<4>::operator=(const VecBase& other)
-{
-	_vec = other._vec;
-	return *this;
-}
-
-inline JFF::VecBase<4>::VecBase(VecBase&& other) noexcept :
-	_vec(other._vec),
-	x(_vec.x),
-	r(_vec.r),
-	s(_vec.s),
-	pitch(_vec.x),
-	red(_vec.x),
-	y(_vec.y),
-	g(_vec.g),
-	t(_vec.t),
-	yaw(_vec.y),
-	green(_vec.y),
-	z(_vec.z),
-	b(_vec.b),
-	p(_vec.p),
-	roll(_vec.z),
-	blue(_vec.z),
-	w(_vec.w),
-	a(_vec.a),
-	q(_vec.q),
-	alpha(_vec.w)
-{
-	other.x = 0.0f;
-	other.y = 0.0f;
-	other.z = 0.0f;
-	other.w = 0.0f;
-	JFF_LOG_INFO_LOW_PRIORITY("Move Ctor VecBase 4")
-}
-
-inline JFF::VecBase<4>& JFF::VecBase<4>::operator=(VecBase&& other) noexcept
-{
-	_vec = other._vec;
-	other.x = 0.0f;
-	other.y = 0.0f;
-	other.z = 0.0f;
-	other.w = 0.0f;
-	return *this;
-}
-
 inline const float* JFF::VecBase<4>::operator*() const
 {
-	return glm::value_ptr(_vec);
+	return &x;
 }
-
 #pragma endregion
 
 #pragma region Global operations
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::operator*(float scalar, const JFF::VecBase<_Dim>& v)
 {
-	return v._vec * scalar;
+	return v._vec() * scalar;
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::operator*(const JFF::VecBase<_Dim>& v, float scalar)
 {
-	return v._vec * scalar;
+	return v._vec() * scalar;
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::operator+(const JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	return v1._vec + v2._vec;
+	return v1._vec() + v2._vec();
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::operator-(const JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	return v1._vec - v2._vec;
+	return v1._vec() - v2._vec();
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim>& JFF::operator*=(JFF::VecBase<_Dim>& v, float scalar)
 {
-	v._vec *= scalar;
+	v._vec() *= scalar;
 	return v;
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim>& JFF::operator+=(JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	v1._vec += v2._vec;
+	v1._vec() += v2._vec();
 	return v1;
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim>& JFF::operator-=(JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	v1._vec -= v2._vec;
+	v1._vec() -= v2._vec();
 	return v1;
 }
 
@@ -447,66 +159,85 @@ JFF::VecBase<_Dim> JFF::operator+(const JFF::VecBase<_Dim>& v)
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::operator-(const JFF::VecBase<_Dim>& v)
 {
-	return -v._vec;
+	return -v._vec();
 }
 
 template<int _Dim>
 bool JFF::operator==(const JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	return v1._vec == v2._vec;
+	return v1._vec() == v2._vec();
 }
 
 template<int _Dim>
 bool JFF::operator!=(const JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	return v1._vec != v2._vec;
+	return v1._vec() != v2._vec();
 }
 
 template<int _Dim> 
 float JFF::length(const JFF::VecBase<_Dim>& v)
 {
-	return glm::length(v._vec);
+	return glm::length(v._vec());
 }
 
 template<int _Dim> 
 float JFF::distance(const JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	return glm::distance(v1._vec, v2._vec);
+	return glm::distance(v1._vec(), v2._vec());
 }
 
 template<int _Dim> 
 float JFF::dot(const JFF::VecBase<_Dim>& v1, const JFF::VecBase<_Dim>& v2)
 {
-	return glm::dot(v1._vec, v2._vec);
+	return glm::dot(v1._vec(), v2._vec());
 }
 
 template<int _Dim> 
 JFF::VecBase<_Dim> JFF::normalize(const VecBase<_Dim>& v)
 {
-	return glm::normalize(v._vec);
+	return glm::normalize(v._vec());
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::faceForward(const VecBase<_Dim>& n, const VecBase<_Dim>& i, const VecBase<_Dim>& nRef)
 {
-	return glm::faceforward(n._vec, i._vec, nRef._vec);
+	return glm::faceforward(n._vec(), i._vec(), nRef._vec());
 }
 
 template<int _Dim> 
 JFF::VecBase<_Dim> JFF::reflect(const VecBase<_Dim>& i, const VecBase<_Dim>& n)
 {
-	return glm::reflect(i._vec, n._vec);
+	return glm::reflect(i._vec(), n._vec());
 }
 
 template<int _Dim>
 JFF::VecBase<_Dim> JFF::refract(const VecBase<_Dim>& i, const VecBase<_Dim>& n, float refrIdx)
 {
-	return glm::refract(i._vec, n._vec, refrIdx);
+	return glm::refract(i._vec(), n._vec(), refrIdx);
 }
 
-#pragma endregion
-
+template<>
+inline float JFF::sqrtLength(const JFF::VecBase<2>& v)
+{
+	return v.x * v.x + v.y * v.y;
+}
 
+template<>
+inline float JFF::sqrtLength(const JFF::VecBase<3>& v)
+{
+	return v.x * v.x + v.y * v.y + v.z * v.z;
+}
 
+template<>
+inline float JFF::sqrtLength(const JFF::VecBase<4>& v)
+{
+	return v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w;
+}
 
+template<>
+inline JFF::VecBase<3> JFF::cross(const JFF::VecBase<3>& v1, const JFF::VecBase<3>& v2)
+{
+	return glm::cross(v1._vec(), v2._vec());
+}
 
+#pragma endregion
\ No newline at end of file
@@ -3,7 +3,7 @@
 * JustForFun game engine
 * ---------------------------------------------------------------------------
 *
-* Copyright (c) 2022-2023, Francisco Jos Carmona.
+* Copyright (c) 2022-2023, Francisco José Carmona.
 *
 * All Rights Reserved.
 */
@@ -12,13 +12,19 @@
 
 // Library dependant macros
 #if defined(JFF_GL) && defined(JFF_GLM)
+#	ifndef GLM_FORCE_INLINE
+#		define GLM_FORCE_INLINE // Vector and matrix functions are on the hottest paths of the engine
+#	endif
 #	include "GLM/glm.hpp"
 #	include "GLM/gtc/type_ptr.hpp"
-#	define JFF_VEC_IMPL_DEPENDANT_ATTRS(_Dim) glm::vec<_Dim, float, glm::qualifier::defaultp> _vec;
-#	define JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(_Dim) const glm::vec<_Dim, float, glm::qualifier::defaultp>& vec
+#	define JFF_VEC_IMPL_DEPENDANT_TYPE(_Dim) glm::vec<_Dim, float, glm::qualifier::defaultp>
+#	define JFF_VEC_IMPL_DEPENDANT_VIEW(_Dim) /* Vec floats are laid out like a packed glm::vec, so they are viewed as one without copies */ \
+		JFF_VEC_IMPL_DEPENDANT_TYPE(_Dim)& _vec() { return reinterpret_cast<JFF_VEC_IMPL_DEPENDANT_TYPE(_Dim)&>(x); } \
+		const JFF_VEC_IMPL_DEPENDANT_TYPE(_Dim)& _vec() const { return reinterpret_cast<const JFF_VEC_IMPL_DEPENDANT_TYPE(_Dim)&>(x); }
+#	define JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(_Dim) const JFF_VEC_IMPL_DEPENDANT_TYPE(_Dim)& vec
 #	define JFF_VEC_IMPL_DEPENDANT_INLINES "VecGLM.inl"
 #else
-#	define JFF_VEC_IMPL_DEPENDANT_ATTRS
+#	define JFF_VEC_IMPL_DEPENDANT_VIEW(_Dim)
 #	define JFF_VEC_IMPL_DEPENDANT_FUNC_PARAMS(_Dim)
 #	define JFF_VEC_IMPL_DEPENDANT_INLINES "Vec.h" // Placeholder include header
 #	error No API defined for Vec
@@ -84,8 +84,8 @@
 
  ///////////////////////////////////////////////////////////////////////////////
  //
- //  This file was modified by Francisco Jos Carmona Chavero.
- //  Copyright (c) 2022 Francisco Jos Carmona Chavero
+ //  This file was modified by Francisco José Carmona Chavero.
+ //  Copyright (c) 2022 Francisco José Carmona Chavero
  //  
  //  The main change is aimed to allow this library to read functions 
  //  embedded on INI files.